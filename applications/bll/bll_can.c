@@ -14,6 +14,9 @@
 #include "interface_can.h"
 #include "interface_dwin.h"
 #include "interface_curve.h"
+#include "interface_draw.h"
+#include "rule_engine.h"
+#include "can_route.h"
 #include "dwin_page_var.h"
 #include "dispatcher_can_dwin.h"
 #include "bll_can.h"
@@ -24,26 +27,155 @@
 #include <rtdbg.h>
 
 /*============================ MACROS ========================================*/
+#define PAGE_0_DRAW_ADDRESS				0x5100	//页面0基本图形变量地址
+#define PAGE_0_DRAW_SLOT_RUN_PROGRESS	0		//运行进度条
+#define PAGE_0_DRAW_SLOT_COUNT			1
+
+/* 报警规则参数 */
+#define ALARM_OVERSPEED_ON					80		//超速报警车速
+#define ALARM_OVERSPEED_OFF					75		//超速解除车速（回差）
+#define ALARM_OVERSPEED_DURATION_MS			1000	//超速持续时间
+#define ALARM_TORQUE_ON						2500	//扭矩超限
+#define ALARM_TORQUE_OFF					2300	//扭矩超限解除（回差）
+#define ALARM_TORQUE_DURATION_MS			500		//扭矩超限持续时间
+#define ALARM_LOST_DURATION_MS				2000	//Lost指示灯持续时间
+/* 0x101 指示灯、挡位的位定义，顺序与CAN数据说明一致 */
+#define LIGHT_BIT_ABS						(1 << 0)
+#define LIGHT_BIT_ACC						(1 << 1)
+#define LIGHT_BIT_SLIP						(1 << 2)
+#define LIGHT_BIT_LOST						(1 << 3)
+#define GEAR_BIT_P							(1 << 0)
+#define GEAR_BIT_R							(1 << 1)
+#define GEAR_BIT_D							(1 << 2)
+#define GEAR_BIT_N							(1 << 3)
+/* 报警变量（位变量图标）的位定义 */
+#define ALARM_BIT_OVERSPEED					(1 << 0)
+#define ALARM_BIT_TORQUE					(1 << 1)
+#define ALARM_BIT_LOST						(1 << 2)
+#define ALARM_BIT_SLIP_IN_DRIVE				(1 << 3)
 /*============================ TYPES =========================================*/
+/* 规则引擎使用的信号 */
+enum rule_signal
+{
+	RULE_SIGNAL_SELF_SPEED = 0,		// 本车车速
+	RULE_SIGNAL_LIGHT,				// 指示灯
+	RULE_SIGNAL_GEAR,				// 挡位
+	RULE_SIGNAL_TORQUE,				// 发动机扭矩（有符号）
+	RULE_SIGNAL_COUNT,
+};
 /*============================ GLOBAL VARIABLES ==============================*/
 /*============================ LOCAL VARIABLES ===============================*/
-static rt_uint16_t dwin_var_list[] =
-{
-	0,				// 运行进程（百分比）	数据显示	输入	0x5000
-	0,				// 本车加速度			数据显示	输入	0x5001
-	0,				// 方向盘转角			数据显示	输入	0x5002
-	0,				// 横摆角速度			数据显示	输入	0x5003
-	0,				// 发动机扭矩			数据显示	输入	0x5004
-	0,				// 本车车速（文本）		数据显示	输入	0x5005
-	SWAP_16(25000),	// 本车质量（文本）1	数据显示	输入	0x5006
-	0,				// 道路坡度（文本）1	数据显示	输入	0x5007
-	SWAP_16(2),		// 指示灯				位变量图标	输入	0x5008
-	SWAP_16(1),		// 挡位P				位变量图标	输入	0x5009
+/*
+	以下内容均由 dwin_var_table.h 生成：变量存储区及初值、各变量段的写命令帧头、变量段列表、地址到下标的对应表
+*/
+#define DWIN_PAGE_BEGIN(page, page_id, show_fun)
+#define DWIN_PAGE_END(page)
+#define DWIN_RANGE_BEGIN(range, address)
+#define DWIN_VAR(name, value)	SWAP_16(value),
+#define DWIN_RANGE_END(range)
+// 迪文变量存储区，按迪文的大端格式存放，同一变量段的变量连续存放
+static rt_uint16_t dwin_var_list[DWIN_VAR_COUNT] =
+{
+#include "dwin_var_table.h"
 };
+#undef DWIN_VAR
+#undef DWIN_RANGE_BEGIN
+
+// 变量段写命令帧头（常量，放在flash中）：5A A5 字节数 82 地址
+#define DWIN_RANGE_COUNT_OF(range)	(DWIN_RANGE_##range##_END_INDEX - DWIN_RANGE_##range##_START_INDEX)
+#define DWIN_RANGE_BEGIN(range, address) \
+	typedef char dwin_range_##range##_check[DWIN_RANGE_COUNT_OF(range) <= DWIN_VAR_RANGE_MAX_COUNT ? 1 : -1]; \
+	static const rt_uint8_t dwin_range_##range##_head[DWIN_VAR_FRAME_HEAD_SIZE] = \
+	{ \
+		0x5A, 0xA5, \
+		DWIN_RANGE_COUNT_OF(range) * 2 + 3, \
+		DWIN_COMMAND_WRITE, \
+		((address) >> 8) & 0xFF, (address) & 0xFF, \
+	};
+#define DWIN_VAR(name, value)
+#include "dwin_var_table.h"
+#undef DWIN_RANGE_BEGIN
+
+// 变量段列表，同一页面的变量段连续存放
+#define DWIN_RANGE_BEGIN(range, address) \
+	{ \
+		DWIN_RANGE_##range##_START_INDEX,	/* rt_uint16_t start_index */ \
+		(address),							/* rt_uint16_t var_address */ \
+		DWIN_RANGE_COUNT_OF(range),			/* rt_uint16_t count */ \
+		dwin_range_##range##_head,			/* const rt_uint8_t *frame_head */ \
+	},
+static const dwin_var_range_t dwin_range_list[DWIN_RANGE_COUNT] =
+{
+#include "dwin_var_table.h"
+};
+#undef DWIN_RANGE_BEGIN
+
+// 迪文地址到变量下标的对应表，按地址升序（描述表按地址升序书写，init_dwin_var 中检查），用于二分查找
+#define DWIN_RANGE_BEGIN(range, address)
+#undef DWIN_VAR
+#define DWIN_VAR(name, value)	{ DWIN_DATA_##name##_ADDRESS, DWIN_DATA_FRAME_##name##_INDEX },
+static const dwin_var_address_entry_t dwin_var_address_list[DWIN_VAR_COUNT] =
+{
+#include "dwin_var_table.h"
+};
+#undef DWIN_PAGE_BEGIN
+#undef DWIN_PAGE_END
+#undef DWIN_RANGE_BEGIN
+#undef DWIN_VAR
+#undef DWIN_RANGE_END
+
+// 页面0的基本图形图层，图元都是图片剪切粘贴
+static dwin_draw_layer_t page_0_draw_layer;
+// 运行进度条：原图在页面2的 (0,0)~(470,35)，470是运行进度条的宽度，粘贴到当前页 (14,10)
+static const dwin_progress_bar_t run_progress_bar =
+{
+	.pic_id = 2,
+	.xs = 0,
+	.ys = 0,
+	.xe = 470,
+	.ye = 35,
+	.x = 14,
+	.y = 10,
+	.max = 100,
+};
+
+// 报警规则的条件
+static const rule_condition_t overspeed_condition[] =
+{
+	{ RULE_SIGNAL_SELF_SPEED,	RULE_COND_ABOVE,	ALARM_OVERSPEED_ON,	ALARM_OVERSPEED_OFF },
+};
+static const rule_condition_t torque_condition[] =
+{
+	{ RULE_SIGNAL_TORQUE,		RULE_COND_ABOVE,	ALARM_TORQUE_ON,	ALARM_TORQUE_OFF },
+};
+static const rule_condition_t lost_condition[] =
+{
+	{ RULE_SIGNAL_LIGHT,		RULE_COND_BITS_ANY,	LIGHT_BIT_LOST,		0 },
+};
+static const rule_condition_t slip_in_drive_condition[] =
+{
+	{ RULE_SIGNAL_GEAR,			RULE_COND_BITS_ANY,	GEAR_BIT_D,			0 },
+	{ RULE_SIGNAL_LIGHT,		RULE_COND_BITS_ANY,	LIGHT_BIT_SLIP,		0 },
+};
+#define ALARM_RULE(condition, duration, bit) \
+	{ condition, sizeof(condition) / sizeof(rule_condition_t), (duration), \
+		{ .type = RULE_OUTPUT_DWIN_VAR, .var_index = DWIN_DATA_FRAME_ALARM_INDEX, .mask = (bit), .on_value = (bit), .off_value = 0 } }
+// 报警规则表：规则成立/解除时设置/清除报警变量对应的位
+static const rule_t alarm_rule_list[] =
+{
+	ALARM_RULE(overspeed_condition,		ALARM_OVERSPEED_DURATION_MS,	ALARM_BIT_OVERSPEED),
+	ALARM_RULE(torque_condition,		ALARM_TORQUE_DURATION_MS,		ALARM_BIT_TORQUE),
+	ALARM_RULE(lost_condition,			ALARM_LOST_DURATION_MS,			ALARM_BIT_LOST),
+	ALARM_RULE(slip_in_drive_condition,	0,								ALARM_BIT_SLIP_IN_DRIVE),
+};
+#undef ALARM_RULE
+
+#define CAN_ROUTE(id, offset, size, flags, target, index) \
+	{ (id), (offset), (size) | (flags), CAN_ROUTE_TARGET_##target, (index) }
+/*
+	默认CAN路由表：分区 "route" 中没有有效路由表时使用，不同车型的路由表由 tools/can_route_pack.py 生成后用 can_route_update 上传
+	同一CAN帧的迪文变量一起更新；曲线数据、规则信号在迪文变量之后处理
 
-/*============================ PROTOTYPES ====================================*/
-/*============================ INTERNAL IMPLEMENTATION =======================*/
-/**
 	CAN数据id : 0x101
 			索引位置 占用位数	取值范围
 	运行进程	0		8		0, 100
@@ -56,53 +188,13 @@ static rt_uint16_t dwin_var_list[] =
 	挡位R		3		1	
 	挡位D		3		1	
 	挡位N		3		1	
- */
-static void can_data_101_parser(rt_uint32_t id, rt_uint8_t *buff, rt_size_t size)
-{
-	rt_uint16_t value;
-	
-	value = buff[0];
-	dwin_var_list[DWIN_DATA_FRAME_RUN_PROGRESS_INDEX] = SWAP_16(value);//运行进程数据
-	
-	value = buff[1];
-	dwin_var_list[DWIN_DATA_FRAME_SELF_SPEED_INDEX] = SWAP_16(value);//本车车速数据
-
-	// 添加到曲线数据队列中
-	add_curve_data(CURVE_SELF_SPEED_INDEX, value);//本车车速曲线数据
-
-	value = buff[2];
-	dwin_var_list[DWIN_DATA_FRAME_LIGHT_INDEX] = SWAP_16(value);//所有指示灯共用2字节空间，不同指示灯占用的位不同
-	
-	value = buff[3];
-	dwin_var_list[DWIN_DATA_FRAME_GEAR_INDEX] = SWAP_16(value);//所有挡位共用2字节空间，不同指示灯占用的位不同
-}
 
-/*
 	CAN数据id : 0x201
 				索引位置 占用位数	取值范围		
 	本车加速度		0		16	-20, 10	0.01
 	估计加速度		2		16	-20, 10	0.01
 	方向盘转角		4		16	-720, 720	
-*/
-static void can_data_201_parser(rt_uint32_t id, rt_uint8_t *buff, rt_size_t size)
-{
-	rt_uint16_t value;
 
-	value = buff[1] | (buff[0] << 8);//buff[0]左移8位变成16位二进制数，再与buff[1]按位与，buff[1]高位补0，进行按位或运算
-	//拼凑一个16位二进制数，因为是buff[0]左移所以buff[0]的数据变为小端存储的16位二进制数的高位，仍然需要SWAP_16函数
-	dwin_var_list[DWIN_DATA_FRAME_SELF_ACC_INDEX] = SWAP_16(value);//本车加速度数据
-	// 添加到曲线数据队列
-	add_curve_data(CURVE_REAL_ACC_INDEX, value);//实际加速度曲线数据
-	
-	value = buff[3] | (buff[2] << 8);//
-	// 添加到曲线数据队列
-	add_curve_data(CURVE_ESTI_ACC_INDEX, value);//估计加速度曲线数据
-	
-	value = buff[5] | (buff[4] << 8);
-	dwin_var_list[DWIN_DATA_FRAME_STEERING_INDEX] = SWAP_16(value);//方向盘转角数据
-}
-
-/*
 	CAN数据id : 0x301
 				索引位置 占用位数	取值范围
 	横摆角速度		0		16		-20, 20	0.1
@@ -110,99 +202,164 @@ static void can_data_201_parser(rt_uint32_t id, rt_uint8_t *buff, rt_size_t size
 	本车质量		4		16		0, 50000	
 	道路坡度		6		8		-90, 90	
 */
-static void can_data_301_parser(rt_uint32_t id, rt_uint8_t *buff, rt_size_t size)
+static const can_route_entry_t default_route_list[] =
+{
+	CAN_ROUTE(0x101, 0, 1, 0,						DWIN_VAR,		DWIN_DATA_FRAME_RUN_PROGRESS_INDEX),//运行进程
+	CAN_ROUTE(0x101, 2, 1, 0,						DWIN_VAR,		DWIN_DATA_FRAME_LIGHT_INDEX),//所有指示灯共用2字节空间，不同指示灯占用的位不同
+	CAN_ROUTE(0x101, 3, 1, 0,						DWIN_VAR,		DWIN_DATA_FRAME_GEAR_INDEX),//所有挡位共用2字节空间
+	CAN_ROUTE(0x101, 1, 1, 0,						DWIN_VAR,		DWIN_DATA_FRAME_SELF_SPEED_INDEX),//本车车速
+	CAN_ROUTE(0x101, 1, 1, 0,						RULE_SIGNAL,	RULE_SIGNAL_SELF_SPEED),
+	CAN_ROUTE(0x101, 2, 1, 0,						RULE_SIGNAL,	RULE_SIGNAL_LIGHT),
+	CAN_ROUTE(0x101, 3, 1, 0,						RULE_SIGNAL,	RULE_SIGNAL_GEAR),
+	CAN_ROUTE(0x101, 1, 1, 0,						CURVE,			CURVE_SELF_SPEED_INDEX),//本车车速曲线
+
+	CAN_ROUTE(0x201, 4, 2, 0,						DWIN_VAR,		DWIN_DATA_FRAME_STEERING_INDEX),//方向盘转角
+	CAN_ROUTE(0x201, 0, 2, 0,						DWIN_VAR,		DWIN_DATA_FRAME_SELF_ACC_INDEX),//本车加速度
+	CAN_ROUTE(0x201, 0, 2, 0,						CURVE,			CURVE_REAL_ACC_INDEX),//实际加速度曲线
+	CAN_ROUTE(0x201, 2, 2, 0,						CURVE,			CURVE_ESTI_ACC_INDEX),//估计加速度曲线
+
+	CAN_ROUTE(0x301, 0, 2, 0,						DWIN_VAR,		DWIN_DATA_FRAME_YAW_INDEX),//横摆角速度
+	CAN_ROUTE(0x301, 2, 2, 0,						DWIN_VAR,		DWIN_DATA_FRAME_TORQUE_INDEX),//发动机扭矩
+	CAN_ROUTE(0x301, 2, 2, CAN_ROUTE_FLAG_SIGNED,	RULE_SIGNAL,	RULE_SIGNAL_TORQUE),
+};
+#undef CAN_ROUTE
+// 各类路由目标的下标上限
+static const rt_uint16_t route_target_limit[CAN_ROUTE_TARGET_COUNT] =
+{
+	DWIN_VAR_COUNT,			// CAN_ROUTE_TARGET_DWIN_VAR
+	CURVE_COUNT,			// CAN_ROUTE_TARGET_CURVE
+	RULE_SIGNAL_COUNT,		// CAN_ROUTE_TARGET_RULE_SIGNAL
+};
+
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 按路由表分发CAN数据
+ * @note 分发器列表中没有匹配id时调用；路由表在处理过程中可能被替换，取得的表在释放前不会被改写
+ */
+static void can_route_parser(rt_uint32_t id, rt_uint8_t *buff, rt_size_t size)
 {
+	const can_route_table_t *table = can_route_acquire();
+	const can_route_frame_t *frame = can_route_find(table, id);
+	const can_route_entry_t *route;
 	rt_uint16_t value;
-	
-	value = buff[1] | (buff[0] << 8);//buff[0]左移8位变成16位二进制数，再与buff[1]按位与，buff[1]高位补0，进行按位或运算
-	//拼凑一个16位二进制数，因为是buff[0]左移所以buff[0]的数据变为小端存储的16位二进制数的高位，仍然需要swap_16函数
-	dwin_var_list[DWIN_DATA_FRAME_YAW_INDEX] = SWAP_16(value);//横摆角速度数据
-	
-	value = buff[3] | (buff[2] << 8);
-	dwin_var_list[DWIN_DATA_FRAME_TORQUE_INDEX] = SWAP_16(value);//发动机扭矩数据
+	rt_uint16_t i;
+
+	if (frame == RT_NULL)
+	{
+		can_route_release(table);
+		LOG_I("CAN data (%04X) route not found!", id);
+		return;
+	}
+
+	dwin_var_write_begin();//同一CAN帧的变量一起更新，显示线程不会只发出其中一部分
+	for (i = 0; i < frame->count; i++)
+	{
+		route = &table->route_list[frame->first + i];
+		if (route->target_type == CAN_ROUTE_TARGET_DWIN_VAR
+				&& route->offset + (route->flags & CAN_ROUTE_FLAG_SIZE_MASK) <= size)
+		{
+			value = SWAP_16((rt_uint16_t) can_route_value(route, buff));
+			if (dwin_var_list[route->target_index] != value)//周期帧的值大多不变，不变时入场帧仍然有效
+			{
+				dwin_var_list[route->target_index] = value;
+				dwin_var_changed(route->target_index);//只让本变量所在页面的入场帧失效
+			}
+		}
+	}
+	dwin_var_write_end();
+
+	// 曲线数据、规则信号放在批量写之外，曲线互斥量等待不会拖长写过程
+	for (i = 0; i < frame->count; i++)
+	{
+		route = &table->route_list[frame->first + i];
+		if (route->offset + (route->flags & CAN_ROUTE_FLAG_SIZE_MASK) > size)
+		{
+			continue;
+		}
+		switch (route->target_type)
+		{
+		case CAN_ROUTE_TARGET_CURVE:
+			add_curve_data(route->target_index, (rt_uint16_t) can_route_value(route, buff));
+			break;
+		case CAN_ROUTE_TARGET_RULE_SIGNAL:
+			rule_engine_update_signal(route->target_index, can_route_value(route, buff));//只重新计算依赖变化信号的规则
+			break;
+		default:
+			break;
+		}
+	}
+	can_route_release(table);
 }
 
 static void page_0_show(void)
 {
-	// 这里实现运行进度条的绘画
-	// 迪文屏复制图像命令：5A A5 17 82 变量地址 0006 0001 0002 xss yss xse yse xt yt FF00
-	rt_uint8_t data_frame[] =
-	{
-		0x5A,
-		0xA5,
-		0x17,
-		0x82,
-		0x51,	// 显示变量地址
-		0x00,
-		0x00,	// 图形复制命令
-		0x06,
-		0x00,	// 复制一个
-		0x01,
-		0x00,	// 复制页面2
-		0x02,
-		0x01,	// xss	运行进度条原图的左上位置的横坐标
-		0x28,
-		0x00,	// yss	运行进度条原图的左上位置的纵坐标
-		0x00,
-		0x01,	// xse	运行进度条原图的右下位置的横坐标
-		0xD6,
-		0x00,	// yse	运行进度条原图的右下位置的横坐标
-		0x23,
-		0x00,	// xt	粘贴到当前页的横坐标
-		0x0E,
-		0x00,	// yt	粘贴到当前页的纵坐标
-		0x0A,
-		0xFF,
-		0x00,
-	};
-	rt_uint16_t run_progress;
-	rt_uint16_t xss;
-	
-	run_progress = SWAP_16(dwin_var_list[DWIN_DATA_FRAME_RUN_PROGRESS_INDEX]);//运行进度条数据
-	xss = (1 - run_progress / 100.0) * 470;//470是运行进度条的宽度
-	data_frame[12] = xss >> 8;//得到数据高8位
-	data_frame[13] = xss & 0xFF;//得到低8位
-	
-	dwin_serial_send(data_frame, sizeof(data_frame));
+	// 运行进度条：从页面2剪切进度条原图的一段粘贴到当前页，进度不变时不发送
+	dwin_draw_progress_bar(&page_0_draw_layer, PAGE_0_DRAW_SLOT_RUN_PROGRESS, &run_progress_bar,
+			SWAP_16(dwin_var_list[DWIN_DATA_FRAME_RUN_PROGRESS_INDEX]));
+	dwin_draw_flush(&page_0_draw_layer);
 }
 
 /*============================ EXTERNAL IMPLEMENTATION =======================*/
-void init_bll_can(void)
+/**
+ * @brief 初始化CAN数据显示的迪文页面和显示线程
+ * @note 启动时先于迪文串口和CAN初始化，屏幕尽早收到第一帧；之后调用 init_bll_can
+ */
+void init_bll_can_page(void)
 {
-	// CAN分发器系统列表，0x101、0x201、0x301用于分发器处理函数进行比对，这些数字实际上是自己规定的，在can数据发送输入规定的帧id就行
-	static can_dispatcher_t can_dispatcher_pool[] =
-	{
-		{ 0x101, can_data_101_parser},
-		{ 0x201, can_data_201_parser},
-		{ 0x301, can_data_301_parser},
-	};
-	// DWIN页面配置，这些参数传入init_dwin_var()函数用于给dwin_var变量赋值，再用dwin_var在dwin_var_show_dealer中进行比对
-	static one_page_info_t dwin_pages[] = 
-	{
-		{
-			0,									// rt_uint16_t page_id
-			DWIN_DATA_FRAME_RUN_PROGRESS_INDEX,	// rt_uint16_t start_index	0
-			DWIN_DATA_RUN_PROGRESS_ADDRESS,		// rt_uint16_t var_address	5000
-			10,									// rt_uint16_t count
-			page_0_show,						// dwin_page_show_fun show_fun
+	// DWIN页面配置，由 dwin_var_table.h 生成，这些参数传入init_dwin_var()函数用于给dwin_var变量赋值，再用dwin_var在dwin_var_show_dealer中进行比对
+#define DWIN_PAGE_BEGIN(page, page_id, show_fun) \
+		{ \
+			(page_id),												/* rt_uint16_t page_id */ \
+			&dwin_range_list[DWIN_PAGE_##page##_FIRST_RANGE],		/* const dwin_var_range_t *range_list */ \
+			DWIN_PAGE_##page##_END_RANGE - DWIN_PAGE_##page##_FIRST_RANGE,	/* rt_uint16_t range_count */ \
+			(show_fun),												/* dwin_page_show_fun show_fun */ \
 		},
-		//本项目只有页面0有大量数据，所以不添加其它页面的信息
+#define DWIN_PAGE_END(page)
+#define DWIN_RANGE_BEGIN(range, address)
+#define DWIN_VAR(name, value)
+#define DWIN_RANGE_END(range)
+	static const one_page_info_t dwin_pages[DWIN_PAGE_COUNT] = 
+	{
+#include "dwin_var_table.h"
 	};
+#undef DWIN_PAGE_BEGIN
+#undef DWIN_PAGE_END
+#undef DWIN_RANGE_BEGIN
+#undef DWIN_VAR
+#undef DWIN_RANGE_END
 
-	init_can();
-	init_can_dispatcher(can_dispatcher_pool, sizeof(can_dispatcher_pool) / sizeof(can_dispatcher_t));
+	dwin_draw_layer_init(&page_0_draw_layer, PAGE_0_DRAW_ADDRESS, DWIN_DRAW_CMD_CUT_PASTE, PAGE_0_DRAW_SLOT_COUNT);
+	init_dwin_var(dwin_var_list, dwin_var_address_list, DWIN_VAR_COUNT, dwin_pages, DWIN_PAGE_COUNT);
+	//规则输出会修改迪文变量，规则引擎在迪文变量之后、CAN接收之前初始化；显示线程也执行规则的到期检查
+	init_rule_engine(alarm_rule_list, sizeof(alarm_rule_list) / sizeof(rule_t), RULE_SIGNAL_COUNT);
+}
+/**
+ * @brief 初始化CAN路由表和CAN接收
+ * @note 在 init_bll_can_page 之后调用
+ */
+void init_bll_can(void)
+{
+	//路由表在CAN接收之前加载（分区中没有有效路由表时使用默认路由表）
+	init_can_route(default_route_list, sizeof(default_route_list) / sizeof(can_route_entry_t), route_target_limit);
 
-	init_dwin_var(dwin_var_list, sizeof(dwin_var_list) / sizeof(rt_uint16_t), 
-			dwin_pages, sizeof(dwin_pages) / sizeof(one_page_info_t));
+	init_can();
+	//所有CAN帧都由路由表分发，需要特殊处理的帧id可以放到分发器列表中，列表优先
+	init_can_dispatcher(RT_NULL, 0);
+	set_can_dispatcher_fallback(can_route_parser);
 }
 /**
  * @brief 设置迪文变量的值
  * @param var_index 变量索引值
  * @param value 变量数据
+ * @note 单独写一个变量也按批量写处理，可以在 dwin_var_write_begin/end 之间调用
  */
 void set_dwin_var_value(rt_uint16_t var_index, rt_uint16_t value)
 {
+	dwin_var_write_begin();
 	dwin_var_list[var_index] = value;
+	dwin_var_changed(var_index);
+	dwin_var_write_end();
 }
 /**
  * @brief 获取迪文变量的值
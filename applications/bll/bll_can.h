@@ -20,31 +20,79 @@ extern "C" {
 #endif
 
 /*============================ MACROS ========================================*/
-#define DWIN_DATA_FRAME_RUN_PROGRESS_INDEX	0       //运行进程数据在列表的索引值
-#define DWIN_DATA_FRAME_SELF_ACC_INDEX		1       //本车加速度在列表的索引值
-#define DWIN_DATA_FRAME_STEERING_INDEX		2       //方向盘转角在列表的索引值
-#define DWIN_DATA_FRAME_YAW_INDEX			3       //横摆角速度在列表的索引值
-#define DWIN_DATA_FRAME_TORQUE_INDEX		4       //发动机扭矩在列表的索引值
-#define DWIN_DATA_FRAME_SELF_SPEED_INDEX	5       //本车车速在列表的索引值
-#define DWIN_DATA_FRAME_QUALITY_INDEX		6       //本车质量在列表的索引值
-#define DWIN_DATA_FRAME_SLOPE_INDEX			7       //道路坡度在列表的索引值
-#define DWIN_DATA_FRAME_LIGHT_INDEX			8       //指示灯状态在列表的索引值
-#define DWIN_DATA_FRAME_GEAR_INDEX			9       //挡位状态在列表的索引值
+/*============================ TYPES =========================================*/
+/*
+	迪文屏变量下标、地址、变量段、页面均由 dwin_var_table.h 生成：
+	DWIN_DATA_FRAME_<name>_INDEX	变量在 dwin_var_list 中的下标
+	DWIN_DATA_<name>_ADDRESS		变量的迪文地址
+	DWIN_RANGE_<range>_START_INDEX / _END_INDEX / _ID，DWIN_PAGE_<page>_FIRST_RANGE / _END_RANGE
+	下标枚举中 _ADJUST 项把计数拉回，使段标记不占用下标
+*/
+#define DWIN_PAGE_BEGIN(page, page_id, show_fun)
+#define DWIN_PAGE_END(page)
+#define DWIN_RANGE_BEGIN(range, address)	DWIN_RANGE_##range##_START_INDEX, \
+											DWIN_RANGE_##range##_START_ADJUST = DWIN_RANGE_##range##_START_INDEX - 1,
+#define DWIN_VAR(name, value)				DWIN_DATA_FRAME_##name##_INDEX,
+#define DWIN_RANGE_END(range)				DWIN_RANGE_##range##_END_INDEX, \
+											DWIN_RANGE_##range##_END_ADJUST = DWIN_RANGE_##range##_END_INDEX - 1,
+// 变量在列表的索引值
+enum dwin_var_index
+{
+#include "dwin_var_table.h"
+	DWIN_VAR_COUNT			//变量个数
+};
+#undef DWIN_RANGE_BEGIN
+#undef DWIN_VAR
+#undef DWIN_RANGE_END
 
+#define DWIN_RANGE_BEGIN(range, address)	DWIN_RANGE_##range##_ADDRESS_BASE = (address) - 1,
+#define DWIN_VAR(name, value)				DWIN_DATA_##name##_ADDRESS,
+#define DWIN_RANGE_END(range)
 // 迪文屏变量地址定义
-#define DWIN_DATA_RUN_PROGRESS_ADDRESS		0x5000  //运行进程变量地址
-#define DWIN_DATA_SELF_ACC_ADDRESS			0x5001  //本车加速度变量地址
-#define DWIN_DATA_STEERING_ADDRESS			0x5002  //方向盘转角变量地址
-#define DWIN_DATA_YAW_ADDRESS				0x5003  //横摆角速度变量地址
-#define DWIN_DATA_TORQUE_ADDRESS			0x5004  //发动机扭矩变量地址
-#define DWIN_DATA_SELF_SPEED_ADDRESS		0x5005  //本车车速变量地址
-#define DWIN_DATA_QUALITY_ADDRESS			0x5006  //本车质量变量地址
-#define DWIN_DATA_SLOPE_ADDRESS				0x5007  //道路坡度变量地址
-#define DWIN_DATA_LIGHT_ADDRESS				0x5008  //指示灯变量地址
-#define DWIN_DATA_GEAR_ADDRESS				0x5009  //挡位状态变量地址
-/*============================ TYPES =========================================*/
+enum dwin_var_address
+{
+#include "dwin_var_table.h"
+};
+#undef DWIN_PAGE_BEGIN
+#undef DWIN_PAGE_END
+#undef DWIN_RANGE_BEGIN
+#undef DWIN_VAR
+#undef DWIN_RANGE_END
+
+#define DWIN_PAGE_BEGIN(page, page_id, show_fun)	DWIN_PAGE_##page##_FIRST_RANGE, \
+													DWIN_PAGE_##page##_FIRST_ADJUST = DWIN_PAGE_##page##_FIRST_RANGE - 1,
+#define DWIN_PAGE_END(page)							DWIN_PAGE_##page##_END_RANGE, \
+													DWIN_PAGE_##page##_END_ADJUST = DWIN_PAGE_##page##_END_RANGE - 1,
+#define DWIN_RANGE_BEGIN(range, address)			DWIN_RANGE_##range##_ID,
+#define DWIN_VAR(name, value)
+#define DWIN_RANGE_END(range)
+// 变量段编号，同一页面的变量段编号连续
+enum dwin_var_range_id
+{
+#include "dwin_var_table.h"
+	DWIN_RANGE_COUNT		//变量段个数
+};
+#undef DWIN_PAGE_BEGIN
+#undef DWIN_PAGE_END
+#undef DWIN_RANGE_BEGIN
+
+#define DWIN_PAGE_BEGIN(page, page_id, show_fun)	DWIN_PAGE_##page##_ORDER,
+#define DWIN_PAGE_END(page)
+#define DWIN_RANGE_BEGIN(range, address)
+// 页面编号
+enum dwin_page_order
+{
+#include "dwin_var_table.h"
+	DWIN_PAGE_COUNT			//页面个数
+};
+#undef DWIN_PAGE_BEGIN
+#undef DWIN_PAGE_END
+#undef DWIN_RANGE_BEGIN
+#undef DWIN_VAR
+#undef DWIN_RANGE_END
 /*============================ GLOBAL VARIABLES ==============================*/
 /*============================ PROTOTYPES ====================================*/
+void init_bll_can_page(void);
 void init_bll_can(void);
 
 void set_dwin_var_value(rt_uint16_t var_index, rt_uint16_t value);
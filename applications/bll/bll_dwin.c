@@ -13,11 +13,12 @@
 
 #include "bll_dwin.h"
 #include "bll_can.h"
-#include "interface_can.h"
 #include "interface_dwin.h"
 #include "interface_curve.h"
+#include "fixed_math.h"
 #include "dispatcher_can_dwin.h"
 #include "dwin_page_var.h"
+#include "param_sync.h"
 
 #define DBG_LEVEL	DBG_LOG
 #define DBG_TAG		"bll_dwin"
@@ -28,22 +29,59 @@
 #define DWIN_AUTO_LOAD_DATA_SLOPE			0x500B
 #define DWIN_AUTO_LOAD_DATA_SELECT_PAGE		0x500C
 #define DWIN_AUTO_LOAD_DATA_CURVE_BUTTON	0x500D
+#define DWIN_AUTO_LOAD_DATA_CURVE_SCROLL	0x500E
+#define DWIN_AUTO_LOAD_DATA_CURVE_ZOOM		0x500F
+
+#define CURVE_SELF_SPEED_DEPTH				20		//本车车速曲线深度，车速变化慢
+#define CURVE_ACC_DEPTH						40		//加速度曲线深度，加速度变化快，首次显示时多显示一段
+
+#define CURVE_SELF_SPEED_HISTORY_BLOCKS		15		//本车车速长历史压缩块个数（每块256字节）
+#define CURVE_ACC_HISTORY_BLOCKS			8		//加速度长历史压缩块个数
+
+#define CURVE_SELF_SPEED_STAT_CAPACITY		100		//本车车速统计窗口最多数据个数
+#define CURVE_SELF_SPEED_STAT_WINDOW_MS		5000	//本车车速统计时间窗口（ms）
+#define CURVE_ACC_STAT_CAPACITY				50		//加速度统计窗口数据个数
+
+#define AUTO_UPLOAD_CAN_ID					0x301	//触控参数上传的CAN帧id
+#define AUTO_UPLOAD_DEBOUNCE_MS				100		//滑块停止拖动后多久发送最终值
+#define AUTO_UPLOAD_MIN_INTERVAL_MS			500		//拖动滑块期间两帧之间的最小间隔
 /*============================ TYPES =========================================*/
+/* 触控上传参数id，即参数表下标 */
+enum auto_upload_param
+{
+	AUTO_UPLOAD_PARAM_SELF_QUALITY = 0,	// 本车质量
+	AUTO_UPLOAD_PARAM_SLOPE,			// 道路坡度
+	AUTO_UPLOAD_PARAM_COUNT,
+};
 /*============================ GLOBAL VARIABLES ==============================*/
 /*============================ LOCAL VARIABLES ===============================*/
-//自动上传数据列表
-static rt_uint8_t auto_upload_data[] =
+//自动上传参数在CAN帧中的位置
+static const param_sync_param_t auto_upload_param_list[AUTO_UPLOAD_PARAM_COUNT] =
+{
+	[AUTO_UPLOAD_PARAM_SELF_QUALITY]	= { 4, 2 },	//本车质量，第4、5字节
+	[AUTO_UPLOAD_PARAM_SLOPE]			= { 6, 1 },	//道路坡度，第6字节，坡度为-90~90，一个字节足够
+};
+//自动上传配置：0x301帧不回读确认（本项目0x301的接收帧是横摆角速度和扭矩，不是回读帧）
+static const param_sync_config_t auto_upload_config =
 {
-	0x00,
-	0x00,
-	0x00,
-	0x00,
-	0x00,
-	0x00,
-	0x00,
+	.can_id = AUTO_UPLOAD_CAN_ID,
+	.frame_size = 7,
+	.debounce_ms = AUTO_UPLOAD_DEBOUNCE_MS,
+	.min_interval_ms = AUTO_UPLOAD_MIN_INTERVAL_MS,
+	.echo_timeout_ms = 0,
+	.echo_retry = 0,
+	.param_list = auto_upload_param_list,
+	.param_count = AUTO_UPLOAD_PARAM_COUNT,
 };
 
 static rt_uint16_t lasted_curve_window_id;//上一次曲线窗口id
+static rt_uint16_t curve_scroll_page;//曲线回看的屏数，0为实时显示
+static rt_uint16_t curve_zoom = 1;//曲线缩放倍数（抽取步长）
+
+// 滑动刻度值 0~1000 转换成坡度值 -90~90
+static const linear_map_q16_t road_slope_map = LINEAR_MAP_Q16(0, 1000, -90, 90);
+// 加速度 -2000~1000 转换成曲线纵坐标 0~1000
+static const linear_map_q16_t acc_curve_map = LINEAR_MAP_Q16(-2000, 1000, 0, 1000);
 /*============================ PROTOTYPES ====================================*/
 /*============================ INTERNAL IMPLEMENTATION =======================*/
 /*本车质量分发器*/
@@ -58,11 +96,8 @@ static void self_quality_parser(rt_uint16_t address, rt_uint8_t *buff, rt_size_t
 	value *= 50;//滑动刻度值扩大50倍
 	set_dwin_var_value(DWIN_DATA_FRAME_QUALITY_INDEX, SWAP_16(value));//设置本车质量的值
 
-	// 按CAN格式发送数据到上位机
-	auto_upload_data[4] = (value >> 8) & 0xFF;//得到数据高位
-	auto_upload_data[5] = value & 0xFF;//得到数据低位
-	
-	can_send(0x301, auto_upload_data, sizeof(auto_upload_data));
+	// 更新参数表，由参数同步合并后按CAN格式发送到上位机
+	param_sync_set(AUTO_UPLOAD_PARAM_SELF_QUALITY, value);
 }
 /*道路坡度分发器*/
 static void road_slope_parser(rt_uint16_t address, rt_uint8_t *buff, rt_size_t size)
@@ -73,13 +108,11 @@ static void road_slope_parser(rt_uint16_t address, rt_uint8_t *buff, rt_size_t s
 	//拼凑一个16位二进制数，因为是buff[0]左移所以buff[0]的数据变为小端的16位二进制数的高位，仍然需要SWAP_16函数
 	// 滑动刻度取值范围为：0~1000
 	// 道路坡度取值范围为：-90~90
-	value = (value - 500) / 500.0 * 90;//滑动刻度值转换成坡度值
+	value = linear_map_q16(&road_slope_map, clamp_i32(value, 0, 1000));//滑动刻度值转换成坡度值
 	set_dwin_var_value(DWIN_DATA_FRAME_SLOPE_INDEX, SWAP_16(value));//设置道路坡度的值
 
-	// 按CAN格式发送数据到上位机
-	auto_upload_data[6] = value & 0xFF;//只使用一个字节存储是因为坡度为-90~90，一个字节足够
-	
-	can_send(0x301, auto_upload_data, sizeof(auto_upload_data));
+	// 更新参数表，由参数同步合并后按CAN格式发送到上位机
+	param_sync_set(AUTO_UPLOAD_PARAM_SLOPE, value);
 }
 /*页面选择分发器*/
 static void select_page_parser(rt_uint16_t address, rt_uint8_t *buff, rt_size_t size)
@@ -115,6 +148,30 @@ static void dwin_cruve_selected(rt_uint16_t address, rt_uint8_t *buff, rt_size_t
 		set_current_curve_window(CURVE_WINDOW_ACC);
 	}
 }
+/*曲线回看/缩放后刷新当前窗口的视图*/
+static void update_curve_view(void)
+{
+	rt_int16_t curve_window_id = get_current_curve_window();
+
+	if (curve_window_id == -1)
+	{
+		return;
+	}
+	// 回看距离以屏为单位，一屏为 DWIN_CURVE_DATA_MAX_COUNT 个点乘缩放倍数
+	set_curve_window_view(curve_window_id, (rt_uint32_t) curve_scroll_page * DWIN_CURVE_DATA_MAX_COUNT * curve_zoom, curve_zoom);
+}
+/*曲线回看分发器*/
+static void dwin_curve_scroll(rt_uint16_t address, rt_uint8_t *buff, rt_size_t size)
+{
+	curve_scroll_page = (buff[0] << 8) | buff[1];
+	update_curve_view();
+}
+/*曲线缩放分发器，实时显示（回看屏数为0）时也生效，按缩放倍数显示最新的一段长历史*/
+static void dwin_curve_zoom(rt_uint16_t address, rt_uint8_t *buff, rt_size_t size)
+{
+	curve_zoom = (buff[0] << 8) | buff[1];
+	update_curve_view();
+}
 /*本车车速数值调整*/
 static rt_uint16_t self_speed_adjust(rt_uint16_t value)
 {
@@ -126,9 +183,8 @@ static rt_uint16_t self_speed_adjust(rt_uint16_t value)
 /*实际加速度调整*/
 static rt_uint16_t real_acc_adjust(rt_uint16_t value)
 {
-	rt_int16_t data = (rt_uint16_t) value;
-	data = (data + 2000) / 3;
-	data = data > 1000 ? 1000 : data;
+	rt_int16_t data = (rt_int16_t) value;
+	data = clamp_i32(linear_map_q16(&acc_curve_map, data), 0, 1000);
 	data = SWAP_16(data);
 	
 	return (rt_uint16_t) data;
@@ -136,13 +192,17 @@ static rt_uint16_t real_acc_adjust(rt_uint16_t value)
 /*估计加速度*/
 static rt_uint16_t esti_acc_adjust(rt_uint16_t value)
 {
-	rt_int16_t data = (rt_uint16_t) value;
-	data = (data + 2000) / 3;
-	data = data > 1000 ? 1000 : data;
+	rt_int16_t data = (rt_int16_t) value;
+	data = clamp_i32(linear_map_q16(&acc_curve_map, data), 0, 1000);
 	data = SWAP_16(data);
 	
 	return (rt_uint16_t) data;
 }
+/*曲线统计量输出到迪文变量*/
+static void curve_stat_output(rt_uint16_t var_index, rt_uint16_t value)
+{
+	set_dwin_var_value(var_index, SWAP_16(value));
+}
 /*============================ EXTERNAL IMPLEMENTATION =======================*/
 void init_bll_dwin(void)
 {
@@ -153,11 +213,40 @@ void init_bll_dwin(void)
 		{ DWIN_AUTO_LOAD_DATA_SLOPE, 		road_slope_parser},
 		{ DWIN_AUTO_LOAD_DATA_SELECT_PAGE, 	select_page_parser},
 		{ DWIN_AUTO_LOAD_DATA_CURVE_BUTTON, dwin_cruve_selected},
+		{ DWIN_AUTO_LOAD_DATA_CURVE_SCROLL, dwin_curve_scroll},
+		{ DWIN_AUTO_LOAD_DATA_CURVE_ZOOM, 	dwin_curve_zoom},
 	};
 
-	init_curve(CURVE_SELF_SPEED_INDEX, 	DWIN_CURVE_CHANNEL1, self_speed_adjust);//初始化本车加速度曲线
-	init_curve(CURVE_REAL_ACC_INDEX, 	DWIN_CURVE_CHANNEL1, real_acc_adjust);//初始化实际加速度曲线
-	init_curve(CURVE_ESTI_ACC_INDEX, 	DWIN_CURVE_CHANNEL2, esti_acc_adjust);//初始化估计加速度曲线
+	init_param_sync(&auto_upload_config);//触控参数合并后发送到CAN总线，必须在迪文分发器之前初始化
+
+	init_curve(CURVE_SELF_SPEED_INDEX, 	DWIN_CURVE_CHANNEL1, CURVE_SELF_SPEED_DEPTH, self_speed_adjust);//初始化本车加速度曲线
+	init_curve(CURVE_REAL_ACC_INDEX, 	DWIN_CURVE_CHANNEL1, CURVE_ACC_DEPTH, real_acc_adjust);//初始化实际加速度曲线
+	init_curve(CURVE_ESTI_ACC_INDEX, 	DWIN_CURVE_CHANNEL2, CURVE_ACC_DEPTH, esti_acc_adjust);//初始化估计加速度曲线
+	
+	set_curve_sample_mode(CURVE_REAL_ACC_INDEX,	CURVE_SAMPLE_LINEAR);//加速度变化连续，采样时线性插值
+	set_curve_sample_mode(CURVE_ESTI_ACC_INDEX,	CURVE_SAMPLE_LINEAR);
+	
+	init_curve_history(CURVE_SELF_SPEED_INDEX,	CURVE_SELF_SPEED_HISTORY_BLOCKS);//开启曲线长历史，用于回看
+	init_curve_history(CURVE_REAL_ACC_INDEX,	CURVE_ACC_HISTORY_BLOCKS);
+	init_curve_history(CURVE_ESTI_ACC_INDEX,	CURVE_ACC_HISTORY_BLOCKS);
+	
+	//曲线统计量：车速按最近5秒统计，加速度按最近50个数据统计
+	init_curve_stat(CURVE_SELF_SPEED_INDEX,	CURVE_SELF_SPEED_STAT_CAPACITY, CURVE_SELF_SPEED_STAT_WINDOW_MS, RT_FALSE);
+	init_curve_stat(CURVE_REAL_ACC_INDEX,	CURVE_ACC_STAT_CAPACITY, 0, RT_TRUE);
+	init_curve_stat(CURVE_ESTI_ACC_INDEX,	CURVE_ACC_STAT_CAPACITY, 0, RT_TRUE);
+	bind_curve_stat(CURVE_SELF_SPEED_INDEX,	CURVE_STAT_MIN,		DWIN_DATA_FRAME_SPEED_MIN_INDEX);
+	bind_curve_stat(CURVE_SELF_SPEED_INDEX,	CURVE_STAT_MAX,		DWIN_DATA_FRAME_SPEED_MAX_INDEX);
+	bind_curve_stat(CURVE_SELF_SPEED_INDEX,	CURVE_STAT_MEAN,	DWIN_DATA_FRAME_SPEED_MEAN_INDEX);
+	bind_curve_stat(CURVE_SELF_SPEED_INDEX,	CURVE_STAT_RMS,		DWIN_DATA_FRAME_SPEED_RMS_INDEX);
+	bind_curve_stat(CURVE_REAL_ACC_INDEX,	CURVE_STAT_MIN,		DWIN_DATA_FRAME_REAL_ACC_MIN_INDEX);
+	bind_curve_stat(CURVE_REAL_ACC_INDEX,	CURVE_STAT_MAX,		DWIN_DATA_FRAME_REAL_ACC_MAX_INDEX);
+	bind_curve_stat(CURVE_REAL_ACC_INDEX,	CURVE_STAT_MEAN,	DWIN_DATA_FRAME_REAL_ACC_MEAN_INDEX);
+	bind_curve_stat(CURVE_REAL_ACC_INDEX,	CURVE_STAT_RMS,		DWIN_DATA_FRAME_REAL_ACC_RMS_INDEX);
+	bind_curve_stat(CURVE_ESTI_ACC_INDEX,	CURVE_STAT_MIN,		DWIN_DATA_FRAME_ESTI_ACC_MIN_INDEX);
+	bind_curve_stat(CURVE_ESTI_ACC_INDEX,	CURVE_STAT_MAX,		DWIN_DATA_FRAME_ESTI_ACC_MAX_INDEX);
+	bind_curve_stat(CURVE_ESTI_ACC_INDEX,	CURVE_STAT_MEAN,	DWIN_DATA_FRAME_ESTI_ACC_MEAN_INDEX);
+	bind_curve_stat(CURVE_ESTI_ACC_INDEX,	CURVE_STAT_RMS,		DWIN_DATA_FRAME_ESTI_ACC_RMS_INDEX);
+	set_curve_stat_output(curve_stat_output);
 	
 	add_curve_to_window(CURVE_SELF_SPEED_INDEX,	CURVE_WINDOW_SELF_SPEED);//添加本车车速曲线到窗口
 	add_curve_to_window(CURVE_REAL_ACC_INDEX,	CURVE_WINDOW_ACC);//添加实际加速度曲线窗口
@@ -167,4 +256,6 @@ void init_bll_dwin(void)
 	
 	init_dwin_serial();
 	init_dwin_dispatcher(dwin_dispatcher_pool, sizeof(dwin_dispatcher_pool) / sizeof(dwin_dispatcher_t));
+	
+	log_curve_memory_usage();//输出曲线占用的内存，串口打开之后再输出，不推迟屏幕的第一帧
 }
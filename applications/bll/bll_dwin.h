@@ -23,6 +23,7 @@ extern "C" {
 #define CURVE_SELF_SPEED_INDEX		0
 #define CURVE_REAL_ACC_INDEX		1
 #define CURVE_ESTI_ACC_INDEX		2
+#define CURVE_COUNT					3		//曲线个数，CAN路由表的曲线目标不能超过
 
 #define CURVE_WINDOW_SELF_SPEED		0
 #define CURVE_WINDOW_ACC			1
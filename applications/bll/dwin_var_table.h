@@ -0,0 +1,53 @@
+/**
+ * @file dwin_var_table.h
+ * @brief 业务逻辑 - 迪文屏页面/变量描述表
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  本文件没有包含保护，由 bll_can.h、bll_can.c 在定义不同的宏后多次包含（X-macro），
+ *		生成变量下标、变量地址、变量存储区及初值、常量帧头模板、变量段列表、地址到下标的对应表和页面列表，
+ *		增删变量只需要修改本文件，不再手工同步下标宏、地址宏和变量列表。
+ *		所有变量（跨变量段、跨页面）按迪文地址升序书写，地址表直接按书写顺序生成，用于二分查找。
+ *
+ *		DWIN_PAGE_BEGIN(page, page_id, show_fun)	页面开始：名称、页面id、页面特有的显示函数（可为RT_NULL）
+ *		DWIN_RANGE_BEGIN(range, address)			变量段开始：名称、段内第一个变量的迪文地址，段内地址连续
+ *		DWIN_VAR(name, value)						变量：生成 DWIN_DATA_FRAME_<name>_INDEX、DWIN_DATA_<name>_ADDRESS，value为初值（主机字节序）
+ *		DWIN_RANGE_END(range)						变量段结束，一段最多 DWIN_VAR_RANGE_MAX_COUNT 个变量
+ *		DWIN_PAGE_END(page)							页面结束，一个页面可以有多个变量段
+ */
+DWIN_PAGE_BEGIN(MAIN, 0, page_0_show)
+	DWIN_RANGE_BEGIN(MAIN_DATA, 0x5000)
+		DWIN_VAR(RUN_PROGRESS,		0)		// 运行进程（百分比）	数据显示	输入	0x5000
+		DWIN_VAR(SELF_ACC,			0)		// 本车加速度			数据显示	输入	0x5001
+		DWIN_VAR(STEERING,			0)		// 方向盘转角			数据显示	输入	0x5002
+		DWIN_VAR(YAW,				0)		// 横摆角速度			数据显示	输入	0x5003
+		DWIN_VAR(TORQUE,			0)		// 发动机扭矩			数据显示	输入	0x5004
+		DWIN_VAR(SELF_SPEED,		0)		// 本车车速（文本）		数据显示	输入	0x5005
+		DWIN_VAR(QUALITY,			25000)	// 本车质量（文本）1	数据显示	输入	0x5006
+		DWIN_VAR(SLOPE,				0)		// 道路坡度（文本）1	数据显示	输入	0x5007
+		DWIN_VAR(LIGHT,				2)		// 指示灯				位变量图标	输入	0x5008
+		DWIN_VAR(GEAR,				1)		// 挡位P				位变量图标	输入	0x5009
+	DWIN_RANGE_END(MAIN_DATA)
+	// 0x500A~0x500F为触控上传变量
+	DWIN_RANGE_BEGIN(CURVE_STAT, 0x5010)
+		DWIN_VAR(SPEED_MIN,			0)		// 本车车速最小值		数据显示	输入	0x5010
+		DWIN_VAR(SPEED_MAX,			0)		// 本车车速最大值		数据显示	输入	0x5011
+		DWIN_VAR(SPEED_MEAN,		0)		// 本车车速均值			数据显示	输入	0x5012
+		DWIN_VAR(SPEED_RMS,			0)		// 本车车速均方根		数据显示	输入	0x5013
+		DWIN_VAR(REAL_ACC_MIN,		0)		// 实际加速度最小值		数据显示	输入	0x5014
+		DWIN_VAR(REAL_ACC_MAX,		0)		// 实际加速度最大值		数据显示	输入	0x5015
+		DWIN_VAR(REAL_ACC_MEAN,		0)		// 实际加速度均值		数据显示	输入	0x5016
+		DWIN_VAR(REAL_ACC_RMS,		0)		// 实际加速度均方根		数据显示	输入	0x5017
+		DWIN_VAR(ESTI_ACC_MIN,		0)		// 估计加速度最小值		数据显示	输入	0x5018
+		DWIN_VAR(ESTI_ACC_MAX,		0)		// 估计加速度最大值		数据显示	输入	0x5019
+		DWIN_VAR(ESTI_ACC_MEAN,		0)		// 估计加速度均值		数据显示	输入	0x501A
+		DWIN_VAR(ESTI_ACC_RMS,		0)		// 估计加速度均方根		数据显示	输入	0x501B
+	DWIN_RANGE_END(CURVE_STAT)
+	DWIN_RANGE_BEGIN(ALARM, 0x501C)
+		DWIN_VAR(ALARM,				0)		// 报警（规则引擎输出）	位变量图标	输入	0x501C
+	DWIN_RANGE_END(ALARM)
+DWIN_PAGE_END(MAIN)
+//本项目只有页面0有大量数据，所以不添加其它页面的信息
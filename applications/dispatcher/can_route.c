@@ -0,0 +1,586 @@
+/**
+ * @file can_route.c
+ * @brief CAN信号路由表（可从FAL分区加载、运行中替换）
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ */
+/*============================ INCLUDES ======================================*/
+#include <stdlib.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "can_route.h"
+
+#ifdef INTERFACE_CFG_CAN_ROUTE_TABLE
+#include <fal.h>
+#include <ymodem.h>
+#include "interface_can.h"
+#endif /* INTERFACE_CFG_CAN_ROUTE_TABLE */
+
+#define DBG_LEVEL	DBG_LOG
+#define DBG_TAG		"can_route"
+#include <rtdbg.h>
+
+/*============================ MACROS ========================================*/
+#define CAN_ROUTE_FRAME_MAX_SIZE		8		//CAN帧数据最大字节数
+#define CAN_ROUTE_UPLOAD_TIMEOUT		10		//ymodem握手超时（s）
+#define CAN_ROUTE_SAVE_IDLE_TIME		200		//总线连续这么久（ms）没有帧才认为空闲，可以写分区
+#define CAN_ROUTE_SAVE_WAIT				10000	//等待总线空闲的最长时间（ms）
+#define CAN_ROUTE_SAVE_POLL				10		//检查总线空闲的间隔（ms）
+/*============================ TYPES =========================================*/
+/**
+ * @struct can_route_info
+ * @brief 路由表管理
+ */
+typedef struct can_route_info
+{
+	can_route_table_t table_list[2];	/**< 当前表和备用表 */
+	rt_atomic_t active;				/**< 当前表下标 */
+	rt_atomic_t users[2];			/**< 正在使用各表的线程数，备用表没有使用者时才能改写 */
+	struct rt_mutex mutex;			/**< 生成、切换路由表互斥 */
+	rt_uint16_t target_limit[CAN_ROUTE_TARGET_COUNT];	/**< 各类目标的下标上限 */
+	rt_uint32_t swap_count;			/**< 切换次数 */
+	rt_bool_t save_pending;			/**< 当前表是上传的，还没有写入分区 */
+}can_route_info_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+static can_route_info_t can_route;
+#ifdef INTERFACE_CFG_CAN_ROUTE_TABLE
+// 二进制路由表暂存区：上电读分区、上传接收、写分区都使用；上传和写分区只在shell线程中执行，不会同时使用
+static rt_align(RT_ALIGN_SIZE) rt_uint8_t can_route_image[CAN_ROUTE_IMAGE_MAX_SIZE];
+#endif /* INTERFACE_CFG_CAN_ROUTE_TABLE */
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 计算CRC32（多项式0xEDB88320，与 zlib.crc32 相同）
+ * @note 路由表只在上电和上传时校验，按位计算即可，不占用查表空间
+ */
+static rt_uint32_t can_route_crc32(const rt_uint8_t *buff, rt_size_t size)
+{
+	rt_uint32_t crc = 0xFFFFFFFF;
+	rt_uint8_t i;
+
+	while (size--)
+	{
+		crc ^= *buff++;
+		for (i = 0; i < 8; i++)
+		{
+			crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+		}
+	}
+
+	return ~crc;
+}
+/**
+ * @brief 检查一条路由项
+ */
+static rt_bool_t can_route_entry_check(const can_route_entry_t *route)
+{
+	rt_uint8_t size = route->flags & CAN_ROUTE_FLAG_SIZE_MASK;
+
+	if (size != 1 && size != 2)
+	{
+		return RT_FALSE;
+	}
+	if (route->offset + size > CAN_ROUTE_FRAME_MAX_SIZE)
+	{
+		return RT_FALSE;
+	}
+	if (route->target_type >= CAN_ROUTE_TARGET_COUNT
+			|| route->target_index >= can_route.target_limit[route->target_type])
+	{
+		return RT_FALSE;
+	}
+
+	return RT_TRUE;
+}
+/**
+ * @brief 由路由项生成运行时路由表
+ * @param table 生成的路由表
+ * @param route_list 路由项，任意顺序
+ * @param route_count 路由项个数
+ * @note 按帧id插入排序（稳定，同一帧内保持原顺序），再按帧id分组
+ */
+static rt_err_t can_route_build(can_route_table_t *table, const can_route_entry_t *route_list, rt_uint16_t route_count)
+{
+	rt_uint16_t i;
+	rt_int32_t j;
+
+	if (route_count == 0 || route_count > CAN_ROUTE_MAX_ROUTES)
+	{
+		LOG_E("route count %d out of range", route_count);
+		return -RT_EINVAL;
+	}
+
+	for (i = 0; i < route_count; i++)
+	{
+		if (can_route_entry_check(&route_list[i]) == RT_FALSE)
+		{
+			LOG_E("route %d (CAN 0x%03X) invalid", i, route_list[i].can_id);
+			return -RT_EINVAL;
+		}
+
+		for (j = i - 1; j >= 0 && table->route_list[j].can_id > route_list[i].can_id; j--)
+		{
+			table->route_list[j + 1] = table->route_list[j];
+		}
+		table->route_list[j + 1] = route_list[i];
+	}
+
+	table->frame_count = 0;
+	for (i = 0; i < route_count; i++)
+	{
+		if (i == 0 || table->route_list[i].can_id != table->route_list[i - 1].can_id)
+		{
+			if (table->frame_count >= CAN_ROUTE_MAX_FRAMES)
+			{
+				LOG_E("too many CAN ids");
+				return -RT_EFULL;
+			}
+			table->frame_list[table->frame_count].can_id = table->route_list[i].can_id;
+			table->frame_list[table->frame_count].first = i;
+			table->frame_list[table->frame_count].count = 0;
+			table->frame_count++;
+		}
+		table->frame_list[table->frame_count - 1].count++;
+	}
+	table->route_count = route_count;
+
+	return RT_EOK;
+}
+/**
+ * @brief 在备用表中生成路由表
+ * @return 生成的备用表，路由项无效时返回 RT_NULL
+ * @note 调用时已持有互斥量；备用表可能还有切换前取得它的使用者，等使用者释放后再改写
+ */
+static can_route_table_t *can_route_prepare(const can_route_entry_t *route_list, rt_uint16_t route_count,
+		rt_uint32_t crc, can_route_source_t source)
+{
+	rt_atomic_t standby = 1 - rt_atomic_load(&can_route.active);
+	can_route_table_t *table = &can_route.table_list[standby];
+
+	while (rt_atomic_load(&can_route.users[standby]) != 0)
+	{
+		rt_thread_mdelay(1);
+	}
+
+	if (can_route_build(table, route_list, route_count) != RT_EOK)
+	{
+		return RT_NULL;
+	}
+	table->crc = crc;
+	table->source = source;
+
+	return table;
+}
+/**
+ * @brief 把生成好的备用表切换为当前表
+ * @note 调用时已持有互斥量；切换是一次原子写，CAN接收线程下一帧开始使用新表
+ */
+static void can_route_swap(can_route_table_t *table)
+{
+	rt_atomic_store(&can_route.active, table - can_route.table_list);
+	can_route.swap_count++;
+	can_route.save_pending = (table->source == CAN_ROUTE_SOURCE_UPLOAD);
+	LOG_I("%d routes, %d CAN ids, crc %08X", table->route_count, table->frame_count, table->crc);
+}
+/**
+ * @brief 校验二进制路由表
+ * @param image 二进制路由表
+ * @param size 字节数，可以大于表长度（ymodem最后一包有填充）
+ * @return 校验通过返回表头，否则返回 RT_NULL
+ */
+static const can_route_head_t *can_route_image_check(const rt_uint8_t *image, rt_size_t size)
+{
+	const can_route_head_t *head = (const can_route_head_t *) image;
+
+	if (size < sizeof(can_route_head_t) || head->magic != CAN_ROUTE_MAGIC)
+	{
+		LOG_W("no route table");
+		return RT_NULL;
+	}
+	if (head->version != CAN_ROUTE_VERSION
+			|| head->route_count > CAN_ROUTE_MAX_ROUTES
+			|| head->length != sizeof(can_route_head_t) + head->route_count * sizeof(can_route_entry_t)
+			|| head->length > size)
+	{
+		LOG_W("route table head invalid");
+		return RT_NULL;
+	}
+	if (can_route_crc32(image + sizeof(can_route_head_t), head->length - sizeof(can_route_head_t)) != head->crc)
+	{
+		LOG_W("route table crc error");
+		return RT_NULL;
+	}
+
+	return head;
+}
+#ifdef INTERFACE_CFG_CAN_ROUTE_TABLE
+/**
+ * @brief 上电时从分区加载路由表
+ * @note 调用时已持有互斥量
+ */
+static rt_err_t can_route_load_partition(void)
+{
+	const struct fal_partition *part;
+	can_route_table_t *table;
+	can_route_head_t head;
+
+	if (fal_init() <= 0)
+	{
+		return -RT_ERROR;
+	}
+
+	part = fal_partition_find(CAN_ROUTE_PARTITION_NAME);
+	if (part == RT_NULL)
+	{
+		LOG_W("partition \"%s\" not found", CAN_ROUTE_PARTITION_NAME);
+		return -RT_ERROR;
+	}
+
+	// 先读表头确定长度，擦除后的分区（全FF）在这里就返回
+	if (fal_partition_read(part, 0, (rt_uint8_t *) &head, sizeof(head)) != sizeof(head)
+			|| head.magic != CAN_ROUTE_MAGIC
+			|| head.length > sizeof(can_route_image))
+	{
+		LOG_W("no route table in partition");
+		return -RT_ERROR;
+	}
+	if (fal_partition_read(part, 0, can_route_image, head.length) != head.length
+			|| can_route_image_check(can_route_image, head.length) == RT_NULL)
+	{
+		return -RT_ERROR;
+	}
+
+	table = can_route_prepare((const can_route_entry_t *) (can_route_image + sizeof(can_route_head_t)),
+			head.route_count, head.crc, CAN_ROUTE_SOURCE_FLASH);
+	if (table == RT_NULL)
+	{
+		return -RT_EINVAL;
+	}
+	can_route_swap(table);
+
+	return RT_EOK;
+}
+/**
+ * @brief 把二进制路由表写入分区
+ * @note 调用时已持有互斥量；写入后读回比较。
+ *		分区在片内flash，F412只有一个bank，擦除128K扇区时CPU停顿1~2s，中断也得不到执行，
+ *		bxCAN接收FIFO只有3帧，必然溢出；所以擦写期间暂停CAN接收，恢复后接着使用当前路由表
+ */
+static rt_err_t can_route_save_partition(const rt_uint8_t *image, rt_size_t size)
+{
+	const struct fal_partition *part = fal_partition_find(CAN_ROUTE_PARTITION_NAME);
+	rt_uint8_t buff[64];
+	rt_size_t offset;
+	rt_size_t length;
+	rt_err_t result = RT_EOK;
+
+	if (part == RT_NULL)
+	{
+		return -RT_ERROR;
+	}
+	can_rx_suspend();
+	if (fal_partition_erase(part, 0, size) < 0 || fal_partition_write(part, 0, image, size) < 0)
+	{
+		result = -RT_EIO;
+	}
+	can_rx_resume();
+	if (result != RT_EOK)
+	{
+		LOG_E("write partition \"%s\" failed", CAN_ROUTE_PARTITION_NAME);
+		return result;
+	}
+
+	for (offset = 0; offset < size; offset += length)
+	{
+		length = size - offset > sizeof(buff) ? sizeof(buff) : size - offset;
+		if (fal_partition_read(part, offset, buff, length) != length || rt_memcmp(buff, image + offset, length) != 0)
+		{
+			LOG_E("verify partition \"%s\" failed", CAN_ROUTE_PARTITION_NAME);
+			return -RT_EIO;
+		}
+	}
+
+	return RT_EOK;
+}
+#endif /* INTERFACE_CFG_CAN_ROUTE_TABLE */
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 初始化路由表
+ * @param default_list 默认路由项，分区中没有有效路由表时使用，需要一直有效
+ * @param default_count 默认路由项个数
+ * @param target_limit 各类目标的下标上限，路由项的目标下标必须小于上限
+ * @note 默认路由表必须有效，否则断言；在CAN接收线程启动之前调用
+ */
+void init_can_route(const can_route_entry_t *default_list, rt_uint16_t default_count,
+		const rt_uint16_t target_limit[CAN_ROUTE_TARGET_COUNT])
+{
+	can_route_table_t *table;
+
+	rt_memset(&can_route, 0, sizeof(can_route));
+	rt_memcpy(can_route.target_limit, target_limit, sizeof(can_route.target_limit));
+	rt_mutex_init(&can_route.mutex, "can_route", RT_IPC_FLAG_PRIO);
+
+	rt_mutex_take(&can_route.mutex, RT_WAITING_FOREVER);
+	table = can_route_prepare(default_list, default_count,
+			can_route_crc32((const rt_uint8_t *) default_list, default_count * sizeof(can_route_entry_t)),
+			CAN_ROUTE_SOURCE_DEFAULT);
+	RT_ASSERT(table != RT_NULL);
+	can_route_swap(table);
+#ifdef INTERFACE_CFG_CAN_ROUTE_TABLE
+	if (can_route_load_partition() != RT_EOK)
+	{
+		LOG_W("use default route table");
+	}
+#endif /* INTERFACE_CFG_CAN_ROUTE_TABLE */
+	rt_mutex_release(&can_route.mutex);
+}
+/**
+ * @brief 取得当前路由表
+ * @return const can_route_table_t* 当前路由表，释放前不会被改写
+ * @note 取得后再确认一次当前表没有切换，避免在写入者检查使用者之后才登记
+ */
+const can_route_table_t *can_route_acquire(void)
+{
+	rt_atomic_t index;
+
+	for (;;)
+	{
+		index = rt_atomic_load(&can_route.active);
+		rt_atomic_add(&can_route.users[index], 1);
+		if (rt_atomic_load(&can_route.active) == index)
+		{
+			return &can_route.table_list[index];
+		}
+		rt_atomic_sub(&can_route.users[index], 1);
+	}
+}
+/**
+ * @brief 释放路由表
+ */
+void can_route_release(const can_route_table_t *table)
+{
+	rt_atomic_sub(&can_route.users[table - can_route.table_list], 1);
+}
+/**
+ * @brief 查找CAN帧id对应的路由项范围
+ * @param table 路由表
+ * @param can_id CAN帧id
+ * @return const can_route_frame_t* 路由项范围，没有找到返回 RT_NULL
+ */
+const can_route_frame_t *can_route_find(const can_route_table_t *table, rt_uint32_t can_id)
+{
+	rt_uint16_t low = 0;
+	rt_uint16_t high = table->frame_count;
+	rt_uint16_t mid;
+
+	while (low < high)
+	{
+		mid = (low + high) / 2;
+		if (table->frame_list[mid].can_id < can_id)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	return (low < table->frame_count && table->frame_list[low].can_id == can_id) ? &table->frame_list[low] : RT_NULL;
+}
+/**
+ * @brief 校验二进制路由表并切换为当前路由表
+ * @param image 二进制路由表
+ * @param size 字节数
+ * @param source 来源
+ * @note 不写分区，切换前CAN接收线程继续使用原路由表
+ */
+rt_err_t can_route_apply(const rt_uint8_t *image, rt_size_t size, can_route_source_t source)
+{
+	const can_route_head_t *head = can_route_image_check(image, size);
+	can_route_table_t *table;
+
+	if (head == RT_NULL)
+	{
+		return -RT_EINVAL;
+	}
+
+	rt_mutex_take(&can_route.mutex, RT_WAITING_FOREVER);
+	table = can_route_prepare((const can_route_entry_t *) (image + sizeof(can_route_head_t)),
+			head->route_count, head->crc, source);
+	if (table != RT_NULL)
+	{
+		can_route_swap(table);
+	}
+	rt_mutex_release(&can_route.mutex);
+
+	return table != RT_NULL ? RT_EOK : -RT_EINVAL;
+}
+#ifdef INTERFACE_CFG_CAN_ROUTE_TABLE
+/**
+ * @brief 把当前路由表写入分区，重新上电后继续使用
+ * @param force RT_FALSE：等总线空闲（连续 CAN_ROUTE_SAVE_IDLE_TIME 没有帧）再写，
+ *		CAN_ROUTE_SAVE_WAIT 内总线不空闲返回 -RT_EBUSY，路由表只在RAM中生效；
+ *		RT_TRUE：不等待，擦写期间（1~2s）总线上的帧不接收
+ * @return rt_err_t 当前表已在分区中返回 RT_EOK
+ * @note 上传只在RAM中切换路由表，切换不丢帧；写片内flash会让CPU停顿，所以推迟到总线空闲（如熄火后）再写。
+ *		写入的是当前路由表（按帧id排序），crc 按排序后的路由项计算；在shell线程中调用（使用暂存区）
+ */
+rt_err_t can_route_save(rt_bool_t force)
+{
+	can_route_head_t *head = (can_route_head_t *) can_route_image;
+	const can_route_table_t *table;
+	rt_tick_t begin = rt_tick_get();
+	rt_err_t result;
+
+	while (force == RT_FALSE && can_rx_idle_time() < rt_tick_from_millisecond(CAN_ROUTE_SAVE_IDLE_TIME))
+	{
+		if (rt_tick_get() - begin >= rt_tick_from_millisecond(CAN_ROUTE_SAVE_WAIT))
+		{
+			return -RT_EBUSY;
+		}
+		rt_thread_mdelay(CAN_ROUTE_SAVE_POLL);
+	}
+
+	// 持有互斥量，写分区期间当前表不会被切换
+	rt_mutex_take(&can_route.mutex, RT_WAITING_FOREVER);
+	if (can_route.save_pending == RT_FALSE)
+	{
+		rt_mutex_release(&can_route.mutex);
+		return RT_EOK;
+	}
+	table = &can_route.table_list[rt_atomic_load(&can_route.active)];
+	head->magic = CAN_ROUTE_MAGIC;
+	head->version = CAN_ROUTE_VERSION;
+	head->route_count = table->route_count;
+	head->length = sizeof(can_route_head_t) + table->route_count * sizeof(can_route_entry_t);
+	rt_memcpy(can_route_image + sizeof(can_route_head_t), table->route_list, table->route_count * sizeof(can_route_entry_t));
+	head->crc = can_route_crc32(can_route_image + sizeof(can_route_head_t), table->route_count * sizeof(can_route_entry_t));
+	result = can_route_save_partition(can_route_image, head->length);
+	if (result == RT_EOK)
+	{
+		can_route.save_pending = RT_FALSE;
+	}
+	rt_mutex_release(&can_route.mutex);
+
+	return result;
+}
+#endif /* INTERFACE_CFG_CAN_ROUTE_TABLE */
+#ifdef RT_USING_FINSH
+/**
+ * @brief msh命令：打印当前路由表
+ */
+static void can_route_info(int argc, char **argv)
+{
+	static const char *source_name[] = { "default", "flash", "upload" };
+	static const char *target_name[] = { "var", "curve", "signal" };
+	const can_route_table_t *table = can_route_acquire();
+	const can_route_entry_t *route;
+	rt_uint16_t i;
+
+	rt_kprintf("source %s%s, %d routes, %d CAN ids, crc %08X, swapped %u\n", source_name[table->source],
+			can_route.save_pending ? " (not saved)" : "",
+			table->route_count, table->frame_count, table->crc, can_route.swap_count);
+	for (i = 0; i < table->route_count; i++)
+	{
+		route = &table->route_list[i];
+		rt_kprintf("  0x%03X byte %d size %d%s -> %s %d\n", route->can_id, route->offset,
+				route->flags & CAN_ROUTE_FLAG_SIZE_MASK, (route->flags & CAN_ROUTE_FLAG_SIGNED) ? " signed" : "",
+				target_name[route->target_type], route->target_index);
+	}
+	can_route_release(table);
+}
+MSH_CMD_EXPORT(can_route_info, show CAN route table);
+#ifdef INTERFACE_CFG_CAN_ROUTE_TABLE
+static rt_size_t can_route_upload_size;
+static enum rym_code can_route_upload_begin(struct rym_ctx *ctx, rt_uint8_t *buf, rt_size_t len)
+{
+	const char *file_size = (const char *) buf + rt_strlen((const char *) buf) + 1;
+	unsigned long size;
+	char *end;
+
+	// 文件头：文件名\0文件大小（十进制，后面可以跟空格和其它字段），没有大小、大小为0或超过暂存区的文件直接取消
+	size = strtoul(file_size, &end, 10);
+	if (end == file_size || (*end != '\0' && *end != ' ') || size == 0 || size > sizeof(can_route_image))
+	{
+		return RYM_CODE_CAN;
+	}
+	can_route_upload_size = 0;
+
+	return RYM_CODE_ACK;
+}
+static enum rym_code can_route_upload_data(struct rym_ctx *ctx, rt_uint8_t *buf, rt_size_t len)
+{
+	// 最后一包的填充超出暂存区的部分丢弃，表长度以表头为准
+	if (can_route_upload_size < sizeof(can_route_image))
+	{
+		len = len > sizeof(can_route_image) - can_route_upload_size ? sizeof(can_route_image) - can_route_upload_size : len;
+		rt_memcpy(&can_route_image[can_route_upload_size], buf, len);
+		can_route_upload_size += len;
+	}
+
+	return RYM_CODE_ACK;
+}
+/**
+ * @brief 打印写分区的结果
+ */
+static void can_route_save_report(rt_err_t result)
+{
+	if (result == -RT_EBUSY)
+	{
+		rt_kprintf("CAN bus busy, route table active in RAM only; "
+				"run can_route_save when the bus is idle, or can_route_save -f to pause CAN RX while writing\n");
+	}
+	else
+	{
+		rt_kprintf("route table %s\n", result == RT_EOK ? "saved" : "save failed");
+	}
+}
+/**
+ * @brief msh命令：从控制台以ymodem接收路由表，校验后切换，总线空闲时写入分区
+ * @note 接收期间不持有互斥量，CAN接收线程和 can_route_apply 照常工作；接收完成后在备用表中生成（检查路由项）并切换，
+ *		切换只在RAM中进行，不丢帧；写分区推迟到总线空闲，见 can_route_save
+ */
+static void can_route_update(int argc, char **argv)
+{
+	struct rym_ctx rctx;
+	rt_err_t result;
+
+	rt_kprintf("Send route table by ymodem, waiting...\n");
+	result = rym_recv_on_device(&rctx, rt_console_get_device(), RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_INT_RX,
+			can_route_upload_begin, can_route_upload_data, RT_NULL, CAN_ROUTE_UPLOAD_TIMEOUT);
+	rt_thread_mdelay(500);//等待终端软件退出ymodem
+	if (result != RT_EOK)
+	{
+		rt_kprintf("receive failed (%d)\n", result);
+		return;
+	}
+
+	if (can_route_apply(can_route_image, can_route_upload_size, CAN_ROUTE_SOURCE_UPLOAD) != RT_EOK)
+	{
+		rt_kprintf("route table invalid\n");
+		return;
+	}
+	rt_kprintf("route table active, waiting for an idle CAN bus to save it...\n");
+	can_route_save_report(can_route_save(RT_FALSE));
+}
+MSH_CMD_EXPORT(can_route_update, receive CAN route table by ymodem);
+/**
+ * @brief msh命令：把上传的路由表写入分区
+ * @note 默认等总线空闲再写；-f 立即写，擦写期间暂停CAN接收
+ */
+static void can_route_save_cmd(int argc, char **argv)
+{
+	rt_bool_t force = (argc > 1 && rt_strcmp(argv[1], "-f") == 0) ? RT_TRUE : RT_FALSE;
+
+	can_route_save_report(can_route_save(force));
+}
+MSH_CMD_EXPORT_ALIAS(can_route_save_cmd, can_route_save, save uploaded CAN route table (-f pauses CAN RX now));
+#endif /* INTERFACE_CFG_CAN_ROUTE_TABLE */
+#endif /* RT_USING_FINSH */
@@ -0,0 +1,148 @@
+/**
+ * @file can_route.h
+ * @brief CAN信号路由表（可从FAL分区加载、运行中替换）
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  路由项描述“CAN帧的哪几个字节送到哪里”：迪文变量、曲线或规则引擎信号。
+ *		分区 "route" 中存放二进制路由表（小端）：can_route_head_t + route_count 个 can_route_entry_t，
+ *		crc 为所有路由项的 CRC32（与 zlib.crc32 相同），由 tools/can_route_pack.py 生成。
+ *		上电时读取分区并校验，失败则使用编译进程序的默认路由表。
+ *		运行时路由表按帧id排序、同一帧的路由项连续存放，查找为二分查找，帧内路由项顺序遍历；
+ *		两份运行时路由表交替使用：新表在备用表中生成后原子切换，CAN接收线程不会看到生成到一半的表，也不丢帧。
+ *		分区在片内flash（F412单bank，擦除扇区时CPU停顿1~2s）：上传的表先只在RAM中切换，
+ *		总线空闲后才写入分区（can_route_save），擦写期间暂停CAN接收。
+ */
+#ifndef __CAN_ROUTE_H__
+#define __CAN_ROUTE_H__
+
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================ MACROS ========================================*/
+#define CAN_ROUTE_MAGIC					0x54524E43	//"CNRT"
+#define CAN_ROUTE_VERSION				1
+#define CAN_ROUTE_PARTITION_NAME		"route"		//FAL分区名
+#define CAN_ROUTE_MAX_FRAMES			32		//最多CAN帧id个数
+#define CAN_ROUTE_MAX_ROUTES			128		//最多路由项个数
+#define CAN_ROUTE_IMAGE_MAX_SIZE		(sizeof(can_route_head_t) + CAN_ROUTE_MAX_ROUTES * sizeof(can_route_entry_t))
+
+/* 路由项标志 */
+#define CAN_ROUTE_FLAG_SIZE_MASK		0x03	//取值字节数，1或2，多字节按大端
+#define CAN_ROUTE_FLAG_SIGNED			0x04	//有符号数，只影响送给规则引擎的信号值
+/*============================ TYPES =========================================*/
+/* 路由目标 */
+typedef enum can_route_target
+{
+	CAN_ROUTE_TARGET_DWIN_VAR = 0,	// 迪文变量，target_index 为 dwin_var_list 下标
+	CAN_ROUTE_TARGET_CURVE,			// 曲线数据，target_index 为曲线id
+	CAN_ROUTE_TARGET_RULE_SIGNAL,	// 规则引擎信号，target_index 为信号id
+	CAN_ROUTE_TARGET_COUNT,
+}can_route_target_t;
+
+/* 路由表来源 */
+typedef enum can_route_source
+{
+	CAN_ROUTE_SOURCE_DEFAULT = 0,	// 编译进程序的默认路由表
+	CAN_ROUTE_SOURCE_FLASH,			// 上电时从分区加载
+	CAN_ROUTE_SOURCE_UPLOAD,		// 运行中上传
+}can_route_source_t;
+
+/**
+ * @struct can_route_head
+ * @brief 二进制路由表头，16字节
+ */
+typedef struct can_route_head
+{
+	rt_uint32_t magic;				/**< CAN_ROUTE_MAGIC */
+	rt_uint16_t version;			/**< CAN_ROUTE_VERSION */
+	rt_uint16_t route_count;		/**< 路由项个数 */
+	rt_uint32_t length;				/**< 表头 + 路由项的总字节数 */
+	rt_uint32_t crc;				/**< 路由项的CRC32 */
+}can_route_head_t;
+/**
+ * @struct can_route_entry
+ * @brief 一条路由项，8字节，二进制表与运行时表格式相同
+ */
+typedef struct can_route_entry
+{
+	rt_uint32_t can_id;				/**< CAN帧id */
+	rt_uint8_t offset;				/**< 取值的起始字节 */
+	rt_uint8_t flags;				/**< CAN_ROUTE_FLAG_xxx */
+	rt_uint8_t target_type;			/**< 路由目标 can_route_target_t */
+	rt_uint8_t target_index;		/**< 目标下标 */
+}can_route_entry_t;
+/**
+ * @struct can_route_frame
+ * @brief 运行时路由表中一个CAN帧id的路由项范围
+ */
+typedef struct can_route_frame
+{
+	rt_uint32_t can_id;				/**< CAN帧id */
+	rt_uint16_t first;				/**< 第一条路由项下标 */
+	rt_uint16_t count;				/**< 路由项个数 */
+}can_route_frame_t;
+/**
+ * @struct can_route_table
+ * @brief 运行时路由表
+ */
+typedef struct can_route_table
+{
+	rt_uint16_t frame_count;		/**< CAN帧id个数 */
+	rt_uint16_t route_count;		/**< 路由项个数 */
+	rt_uint32_t crc;				/**< 路由项的CRC32 */
+	rt_uint8_t source;				/**< 来源 can_route_source_t */
+	can_route_frame_t frame_list[CAN_ROUTE_MAX_FRAMES];	/**< 按帧id升序 */
+	can_route_entry_t route_list[CAN_ROUTE_MAX_ROUTES];	/**< 按帧id排序，同一帧内保持原顺序 */
+}can_route_table_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ PROTOTYPES ====================================*/
+/* 初始化路由表：先使用默认路由表，再尝试从分区加载；target_limit 为各类目标的下标上限 */
+void init_can_route(const can_route_entry_t *default_list, rt_uint16_t default_count,
+		const rt_uint16_t target_limit[CAN_ROUTE_TARGET_COUNT]);
+/* 取得当前路由表，使用完必须调用 can_route_release */
+const can_route_table_t *can_route_acquire(void);
+void can_route_release(const can_route_table_t *table);
+/* 查找CAN帧id对应的路由项范围，没有找到返回 RT_NULL */
+const can_route_frame_t *can_route_find(const can_route_table_t *table, rt_uint32_t can_id);
+/* 校验二进制路由表并切换为当前路由表 */
+rt_err_t can_route_apply(const rt_uint8_t *image, rt_size_t size, can_route_source_t source);
+#ifdef INTERFACE_CFG_CAN_ROUTE_TABLE
+/* 把上传的路由表写入分区，默认等总线空闲再写 */
+rt_err_t can_route_save(rt_bool_t force);
+#endif /* INTERFACE_CFG_CAN_ROUTE_TABLE */
+/*============================ INLINE FUNCTIONS ==============================*/
+/**
+ * @brief 按路由项从CAN数据中取值
+ * @param route 路由项，字节范围已在生成路由表时检查
+ * @param buff CAN数据
+ * @return rt_int32_t 取值，有符号路由项做符号扩展
+ */
+rt_inline rt_int32_t can_route_value(const can_route_entry_t *route, const rt_uint8_t *buff)
+{
+	if ((route->flags & CAN_ROUTE_FLAG_SIZE_MASK) == 1)
+	{
+		return (route->flags & CAN_ROUTE_FLAG_SIGNED) ? (rt_int8_t) buff[route->offset] : buff[route->offset];
+	}
+	else
+	{
+		rt_uint16_t value = (buff[route->offset] << 8) | buff[route->offset + 1];
+
+		return (route->flags & CAN_ROUTE_FLAG_SIGNED) ? (rt_int16_t) value : value;
+	}
+}
+/*============================ INCLUDES ======================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CAN_ROUTE_H__ */
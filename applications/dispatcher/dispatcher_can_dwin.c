@@ -28,6 +28,7 @@ static struct
 {
 	can_dispatcher_t *list;	//分发器列表指针
 	rt_size_t count;		// 注册的分发器数量
+	can_data_parser_hook fallback;	// 列表中没有匹配id时的处理函数（路由表）
 }can_dispatcher_tab;
 /* 迪文屏自动加载分发器注册表 */
 static struct
@@ -37,6 +38,23 @@ static struct
 }dwin_auto_load_dispatcher_tab;
 /*============================ PROTOTYPES ====================================*/
 /*============================ INTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 把最多8字节数据按大端拼成两个字，用于日志输出
+ * @param buff 数据
+ * @param size 数据长度，超过8字节的部分不处理
+ * @param data 返回两个字，不足的字节为0
+ */
+static void pack_log_words(const rt_uint8_t *buff, rt_size_t size, rt_uint32_t data[2])
+{
+	rt_size_t i;
+
+	data[0] = 0;
+	data[1] = 0;
+	for (i = 0; i < size && i < 8; i++)
+	{
+		data[i / 4] |= (rt_uint32_t) buff[i] << (24 - (i % 4) * 8);
+	}
+}
 /*============================ EXTERNAL IMPLEMENTATION =======================*/
 /**
  * @brief 初始化CAN数据分发器系统，得到分发器列表指针，记录分发器数量
@@ -49,6 +67,15 @@ void init_can_dispatcher(can_dispatcher_t *list, rt_size_t count)
 	can_dispatcher_tab.list = list;		//赋值运算符右侧的list来自传入的参数，这条语句相当于什么也没做，但起到了清晰代码的作用
 	can_dispatcher_tab.count = count;	//赋值运算符右侧的count来自传入的参数，这条语句相当于什么也没做，但起到了清晰代码的作用
 }
+/**
+ * @brief 设置列表中没有匹配id时的处理函数
+ * @param hook 处理函数，RT_NULL为只输出提示信息
+ * @note 列表中的处理函数优先，其余CAN帧交给路由表处理
+ */
+void set_can_dispatcher_fallback(can_data_parser_hook hook)
+{
+	can_dispatcher_tab.fallback = hook;
+}
 /**
  * @brief 初始化迪文屏自动加载分发器系统，得到分发器列表指针，记录分发器数量
  * @param list  分发器配置列表指针
@@ -78,6 +105,11 @@ void can_data_parser(rt_uint32_t id, rt_uint8_t *buff, rt_size_t size)
 			return;
 		}
 	}
+	if (can_dispatcher_tab.fallback != RT_NULL)
+	{
+		can_dispatcher_tab.fallback(id, buff, size);
+		return;
+	}
 	// 未找到匹配处理器的日志
 	LOG_I("CAN data (%04X) parser not found!", id);
 }
@@ -108,39 +140,31 @@ void dwin_auto_load_data_parser(rt_uint16_t address, rt_uint8_t *buff, rt_size_t
  * @brief 默认CAN数据处理函数（调试用）
  * 
  * 以十六进制格式打印接收到的CAN数据
+ * @note 数据按大端拼成两个字输出，十六进制顺序与字节顺序一致；不在调用线程中拼接字符串，
+ *		格式串固定，二进制日志模式下同样可以解码
  */
 void default_can_data_parser(rt_uint32_t id, rt_uint8_t *buff, rt_size_t size)
 {
-	char str[512] = {0};// 初始化一个字符数组，用于存储格式化后的CAN数据信息
-	char tmp[8];// 临时字符数组，用于存储每个数据字节的格式化字符串
-	int i;
-	
-	rt_sprintf(str, "CAN data (%04X) :", id);// 将CAN数据的ID格式化到字符串中
-	for (i = 0; i < size; i++)
-	{
-		rt_sprintf(tmp, " %02X", buff[i]);// 格式化当前数据字节为两位的十六进制字符串
-		strcat(str, tmp);//字符串连接
-	}
-	
-	LOG_I(str);// 打印格式化后的CAN数据信息
+	rt_uint32_t data[2];
+
+	pack_log_words(buff, size, data);
+	LOG_I("CAN data (%04X) [%d] : %08X %08X", id, size, data[0], data[1]);
 }
 /**
  * @brief 默认迪文屏数据处理函数（调试用）
  * 
  * 以十六进制格式打印接收到的迪文屏数据
+ * @note 每8字节一条日志，+n 为该条第一个字节的偏移
  */
 void default_dwin_auto_load_data_parser(rt_uint16_t address, rt_uint8_t *buff, rt_size_t size)
 {
-	char str[512] = {0};// 初始化一个字符数组，用于存储格式化后的CAN数据信息
-	char tmp[8];// 临时字符数组，用于存储每个数据字节的格式化字符串
-	int i;
-	
-	rt_sprintf(str, "Dwin auto load data (%04X) :", address);// 将CAN数据的ID格式化到字符串中
-	for (i = 0; i < size * 2; i++)// 注意：迪文屏数据按字处理，也就是两字节，需要x2
+	rt_uint32_t data[2];
+	rt_size_t offset;
+
+	size *= 2;// 注意：迪文屏数据按字处理，也就是两字节，需要x2
+	for (offset = 0; offset < size; offset += 8)
 	{
-		rt_sprintf(tmp, " %02X", buff[i]);// 格式化当前数据字节为两位的十六进制字符串
-		strcat(str, tmp);//字符串连接
+		pack_log_words(&buff[offset], size - offset, data);
+		LOG_I("Dwin auto load data (%04X) +%d : %08X %08X", address, offset, data[0], data[1]);
 	}
-	
-	LOG_I(str);// 打印格式化后的CAN数据信息
 }
@@ -50,6 +50,8 @@ typedef struct dwin_dispatcher
 /*分发器系统初始化函数*/
 void init_can_dispatcher(can_dispatcher_t *list, rt_size_t count);
 void init_dwin_dispatcher(dwin_dispatcher_t *list, rt_size_t count);
+/*列表中没有匹配id时的CAN处理函数*/
+void set_can_dispatcher_fallback(can_data_parser_hook hook);
 /*分发器处理函数*/
 void can_data_parser(rt_uint32_t id, rt_uint8_t *buff, rt_size_t size);
 void dwin_auto_load_data_parser(rt_uint16_t address, rt_uint8_t *buff, rt_size_t size);
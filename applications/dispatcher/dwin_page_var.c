@@ -14,6 +14,10 @@
 #include "interface_dwin.h"
 #include "interface_curve.h"
 #include "dwin_page_var.h"
+#include "param_sync.h"
+#include "rule_engine.h"
+#include "reactor.h"
+#include "seqlock.h"
 
 #define DBG_LEVEL	DBG_LOG
 #define DBG_TAG		"dwin_page_var"
@@ -23,6 +27,8 @@
 #define DWIN_VAR_SHOW_THREAD_STACK_SIZE		1024	//线程栈大小
 #define DWIN_VAR_SHOW_THREAD_PRO			20		//线程优先级
 #define DWIN_VAR_SHOW_THREAD_SECTION		20		//线程时间片
+
+#define DWIN_VAR_PAGE_INDEX_NONE			(-1)	//页面索引表中没有配置的页面id
 /*============================ TYPES =========================================*/
 /*============================ GLOBAL VARIABLES ==============================*/
 /*============================ LOCAL VARIABLES ===============================*/
@@ -33,44 +39,221 @@
 typedef struct dwin_var_info
 {
 	rt_uint16_t *var_list;			/**< 所有迪文屏显示变量数据指针 */
+	const dwin_var_address_entry_t *address_list;	/**< 地址到下标的对应表，按地址升序，与 var_list 个数相同 */
 	rt_uint16_t var_count;			/**< 变量个数 */
 	
-	one_page_info_t *page_list;		/**< 当前迪文屏界面配置列表的指针 */
+	const one_page_info_t *page_list;	/**< 当前迪文屏界面配置列表的指针 */
 	rt_uint16_t page_count;			/**< 界面个数 */
 }dwin_var_info_t;
 
+/**
+ * @struct dwin_page_entry
+ * @brief 页面的入场帧：本页面所有变量段的写命令首尾相接，切换到本页面后一次发送
+ */
+typedef struct dwin_page_entry
+{
+	rt_uint8_t *frame;				/**< 入场帧，从 dwin_entry_frame_arena 分配 */
+	rt_uint16_t size;				/**< 入场帧字节数 */
+	rt_bool_t valid;				/**< 入场帧是否是某一时刻完整的变量状态 */
+	rt_uint16_t first_index;		/**< 本页面变量段的最小下标 */
+	rt_uint16_t end_index;			/**< 本页面变量段的最大下标加1 */
+	rt_atomic_t change_count;		/**< 本页面变量的修改次数，写者在批量写之内增加 */
+	rt_atomic_t version;			/**< 生成入场帧时的修改次数，与当前修改次数相同说明本页面变量没有再改变 */
+}dwin_page_entry_t;
+
 static dwin_var_info_t dwin_var;//定义dwin_var_info_t结构体类型的变量dwin_var
 static volatile rt_uint16_t page_id;	/**< 正在显示的界面id，默认值为0 */
-// 迪文屏命令帧模板（写操作）
-static rt_uint8_t dwin_command_buff[DWIN_DATA_FRAME_MAX_LENGTH] =
-{
-	0x5A, 0xA5,			/**< 迪文数据头部 */
-	0x00,				/**< 字节个数 */
-	DWIN_COMMAND_WRITE,	/**< 写指令 */
-	0x00, 0x00,			/**< 变量地址 */
-};
+/*
+	页面切换：页面id直接查索引表得到页面配置，不再遍历页面列表；
+	迪文接收线程设置页面后立即唤醒显示线程，显示线程切换后的第一次发送就是新页面的完整入场帧。
+	入场帧由显示线程在刷新间隙提前生成，切换时本页面的变量没有改变就直接发送，否则重新生成后发送；
+	每个页面有自己的修改次数，写者只增加所写变量所在页面的修改次数，其它页面的入场帧不用重新生成
+*/
+static rt_int8_t page_index_table[DWIN_VAR_PAGE_ID_MAX];	/**< 页面id -> 页面列表下标 */
+static dwin_page_entry_t page_entry_list[DWIN_VAR_PAGE_MAX_COUNT];	/**< 各页面的入场帧 */
+rt_align(RT_ALIGN_SIZE) static rt_uint8_t dwin_entry_frame_arena[DWIN_VAR_ENTRY_FRAME_ARENA_SIZE];	/**< 入场帧存储区 */
+#ifdef INTERFACE_CFG_USING_REACTOR
+static struct rt_timer dwin_var_refresh_timer;	/**< 周期置刷新事件 */
+#else
+static struct rt_completion dwin_var_refresh_cpt;	/**< 唤醒显示线程 */
+#endif /* INTERFACE_CFG_USING_REACTOR */
+static volatile rt_bool_t page_switch_pending;		/**< 页面已切换，入场帧尚未发送 */
+static volatile rt_tick_t page_switch_tick;			/**< 页面切换（触控上传）的时刻 */
+static dwin_page_switch_stat_t page_switch_stat;	/**< 触控到第一帧完整显示的延迟统计 */
+/*
+	变量存储区的一致性（顺序锁，见 seqlock.h）：CAN接收线程、迪文接收线程写变量，显示线程读变量发送。
+	写者不加锁、不等待，读者发现读取期间有写入时重试。
+	这样每一帧发送的都是某一时刻完整的变量状态，不会出现一个CAN帧的数据只更新了一半
+*/
+static seqlock_t dwin_var_lock;					/**< 变量存储区的顺序锁 */
+static rt_uint16_t dwin_var_snapshot[DWIN_VAR_RANGE_MAX_COUNT];	/**< 变量段快照，显示线程发送用 */
 /*============================ PROTOTYPES ====================================*/
 /*============================ INTERNAL IMPLEMENTATION =======================*/
 /**
- * @brief 准备正在显示的页面的迪文屏数据帧
- * @param one_page 当前页面配置
- * @return rt_int16_t 生成的数据帧长度
- * @note 函数填好迪文屏写命令帧模板并添加数据；返回值是数据帧长度，用于串口发送
+ * @brief 开始读变量存储区
+ * @param begin 返回当前的写开始次数
+ * @return rt_bool_t 没有写者正在修改返回RT_TRUE
  */
-static rt_int16_t prepared_dwin_data_frame(const one_page_info_t *one_page)
+rt_inline rt_bool_t dwin_var_read_begin(rt_atomic_t *begin)
 {
-	dwin_data_frame_format_t *dwin_data_frame_format;//定义一个dwin_data_frame_format_t结构体类型的指针变量dwin_data_frame_format
-	
-	dwin_data_frame_format = (dwin_data_frame_format_t *) dwin_command_buff;//将dwin_command_buff列表转换成指针，dwin_data_frame_format指向列表首元素
-	dwin_data_frame_format->command = DWIN_COMMAND_WRITE;//配置写命令
-	dwin_data_frame_format->var_address = SWAP_16(one_page->var_address);//转换迪文数据存放地址的字节顺序。迪文数据采用大端存储模式，而C语言采用小端存储模式，所以需要转换字节顺序
-	dwin_data_frame_format->byte_count = (rt_uint8_t) (one_page->count * 2 + 3);//计算数据长度。因为count记录的是迪文变量个数，而迪文数据是两字节的，byte_count是迪文数据帧统计包括写指令在内的所有字节个数，所以byte_count是count的2倍加3
-	// 拷贝变量数据到发送缓冲区
-	rt_memcpy((rt_uint8_t *) (dwin_command_buff + DWIN_WRITE_DATA_OFFSET), 
-		(rt_uint8_t *) (dwin_var.var_list + one_page->start_index), one_page->count * 2);//拷贝数据目的地址是dwin_command_buff后DWIN_WRITE_DATA_OFFSET个字节开始，即dwin_command_buff+6
-																						//源地址是var_list列表后start_index，也就是后第一个变量下标值，即6，即源地址从var_list列表的第七个字节开始拷贝
-																						//迪文屏变量占2字节，写入的字节数是迪文变量总数的2倍，所以count要乘2
-	return one_page->count * 2 + 6;//返回数据帧长度，也就是数据帧所有字节个数
+	return seqlock_read_begin(&dwin_var_lock, begin);
+}
+/**
+ * @brief 结束读变量存储区
+ * @param begin dwin_var_read_begin 得到的写开始次数
+ * @return rt_bool_t 读取期间没有写者开始修改返回RT_TRUE
+ */
+rt_inline rt_bool_t dwin_var_read_end(rt_atomic_t begin)
+{
+	return seqlock_read_end(&dwin_var_lock, begin);
+}
+/**
+ * @brief 根据页面id查找页面下标
+ * @param id 页面id
+ * @return rt_int16_t 页面在页面列表中的下标，没有配置该页面返回-1
+ */
+static rt_int16_t find_page_index(rt_uint16_t id)
+{
+	if (id >= DWIN_VAR_PAGE_ID_MAX)
+	{
+		return DWIN_VAR_PAGE_INDEX_NONE;
+	}
+
+	return page_index_table[id];
+}
+/**
+ * @brief 用当前的变量值生成页面的入场帧
+ * @param index 页面下标
+ * @return rt_bool_t 生成了一致的入场帧返回RT_TRUE
+ * @note 整个页面的所有变量段在同一次读取中拷贝，入场帧是某一时刻完整的页面状态
+ */
+static rt_bool_t render_page_entry(rt_uint16_t index)
+{
+	const one_page_info_t *page = &dwin_var.page_list[index];
+	dwin_page_entry_t *entry = &page_entry_list[index];
+	const dwin_var_range_t *range;
+	rt_uint8_t *frame;
+	rt_atomic_t version;
+	rt_atomic_t begin;
+	rt_uint16_t retry;
+	rt_uint16_t i;
+
+	for (retry = 0; retry < DWIN_VAR_SNAPSHOT_RETRY; retry++)
+	{
+		if (dwin_var_read_begin(&begin) == RT_FALSE)//有写者正在修改
+		{
+			continue;
+		}
+
+		//修改次数在写开始之后增加：拷贝成功时，之后的修改一定会让修改次数与 version 不同
+		version = rt_atomic_load(&entry->change_count);
+		frame = entry->frame;
+		for (i = 0; i < page->range_count; i++)
+		{
+			range = &page->range_list[i];
+			rt_memcpy(frame, range->frame_head, DWIN_VAR_FRAME_HEAD_SIZE);
+			frame += DWIN_VAR_FRAME_HEAD_SIZE;
+			rt_memcpy(frame, &dwin_var.var_list[range->start_index], range->count * 2);
+			frame += range->count * 2;
+		}
+
+		if (dwin_var_read_end(begin))//拷贝期间没有写者开始修改
+		{
+			entry->version = version;
+			entry->valid = RT_TRUE;
+			return RT_TRUE;
+		}
+	}
+
+	entry->valid = RT_FALSE;
+	return RT_FALSE;
+}
+/**
+ * @brief 判断页面的入场帧是否就是本页面当前的变量状态
+ * @param index 页面下标
+ * @note 只比较本页面的修改次数，其它页面的变量改变不影响本页面的入场帧
+ */
+static rt_bool_t is_page_entry_current(rt_uint16_t index)
+{
+	return page_entry_list[index].valid
+			&& page_entry_list[index].version == rt_atomic_load(&page_entry_list[index].change_count);
+}
+/**
+ * @brief 在刷新间隙提前生成其它页面的入场帧
+ * @param current_index 当前页面下标，当前页面不需要入场帧
+ */
+static void prerender_page_entries(rt_int16_t current_index)
+{
+	rt_uint16_t i;
+
+	for (i = 0; i < dwin_var.page_count; i++)
+	{
+		if (i != current_index && is_page_entry_current(i) == RT_FALSE)
+		{
+			render_page_entry(i);
+		}
+	}
+}
+/**
+ * @brief 记录一次页面切换的延迟
+ * @param tick 触控到第一帧发送完成经过的时钟节拍数
+ */
+static void record_page_switch_latency(rt_tick_t tick)
+{
+	page_switch_stat.last = tick;
+	page_switch_stat.min = (page_switch_stat.count == 0 || tick < page_switch_stat.min) ? tick : page_switch_stat.min;
+	page_switch_stat.max = tick > page_switch_stat.max ? tick : page_switch_stat.max;
+	page_switch_stat.total += tick;
+	page_switch_stat.count++;
+}
+/**
+ * @brief 读取变量段的一致快照
+ * @param range 变量段配置
+ * @return rt_bool_t 读到一致的快照返回RT_TRUE
+ * @note 写者优先级高于显示线程，只有写者在批量写中途阻塞时才会读到不一致，
+ *		最多尝试 DWIN_VAR_SNAPSHOT_RETRY 次，不会一直占用CPU
+ */
+static rt_bool_t read_dwin_var_snapshot(const dwin_var_range_t *range)
+{
+	rt_atomic_t begin;
+	rt_uint16_t retry;
+	rt_uint16_t index;
+
+	for (retry = 0; retry < DWIN_VAR_SNAPSHOT_RETRY; retry++)
+	{
+		if (dwin_var_read_begin(&begin) == RT_FALSE)//有写者正在修改
+		{
+			continue;
+		}
+
+		for (index = 0; index < range->count; index++)
+		{
+			dwin_var_snapshot[index] = ((volatile rt_uint16_t *) dwin_var.var_list)[range->start_index + index];
+		}
+
+		if (dwin_var_read_end(begin))//拷贝期间没有写者开始修改
+		{
+			return RT_TRUE;
+		}
+	}
+
+	return RT_FALSE;
+}
+/**
+ * @brief 发送一个变量段
+ * @param range 变量段配置
+ * @note 帧头是编译时生成的常量，直接从flash发送；变量取一致快照后发送，快照不一致时本轮跳过该段，
+ *		屏上保持上一帧的完整状态；迪文屏串口只由显示线程发送，两次写之间不会插入其它数据
+ */
+static void send_dwin_var_range(const dwin_var_range_t *range)
+{
+	if (read_dwin_var_snapshot(range) == RT_FALSE)
+	{
+		return;
+	}
+
+	dwin_serial_send(range->frame_head, DWIN_VAR_FRAME_HEAD_SIZE);
+	dwin_serial_send((const rt_uint8_t *) dwin_var_snapshot, range->count * 2);
 }
 /**
  * @brief 显示当前曲线窗口的曲线
@@ -79,6 +262,7 @@ static void show_current_curve_window(void)
 {
 	rt_int16_t current_curve_window_id;
 	
+	curve_sample_poll();//按公共采样周期重采样所有曲线，没有曲线窗口的页面也继续采样
 	current_curve_window_id = get_current_curve_window();//从get_current_curve_window的返回值得到当前曲线窗口的id值
 	if (current_curve_window_id == -1)//无活动曲线窗口
 	{
@@ -87,8 +271,7 @@ static void show_current_curve_window(void)
 	
 	if (is_curve_window_first_show(current_curve_window_id))
 	{
-		//首次显示：清除旧数据并显示全部数据;标记不是第一次显示
-		clean_curve();
+		//首次显示：清除旧数据并显示全部数据（合并为一帧）;标记不是第一次显示
 		curve_show(current_curve_window_id, RT_TRUE);
 		set_curve_window_not_first_show(current_curve_window_id);
 	}
@@ -99,48 +282,204 @@ static void show_current_curve_window(void)
 	}
 }
 /**
- * @brief 迪文变量显示线程处理函数
- * 
- * 定期刷新当前活动页面的显示内容
+ * @brief 发送页面的入场帧
+ * @param index 页面下标
+ * @note 入场帧不是当前的变量状态时先重新生成；仍生成不了一致的入场帧时退回按变量段发送
  */
-static void dwin_var_show_dealer(void *arg)
+static void send_page_entry(rt_uint16_t index)
+{
+	rt_uint16_t i;
+
+	if (is_page_entry_current(index) || render_page_entry(index))
+	{
+		dwin_serial_send(page_entry_list[index].frame, page_entry_list[index].size);
+		return;
+	}
+
+	for (i = 0; i < dwin_var.page_list[index].range_count; i++)
+	{
+		send_dwin_var_range(&dwin_var.page_list[index].range_list[i]);
+	}
+}
+/**
+ * @brief 刷新一次迪文屏显示
+ * @note 页面刚切换时发送新页面的入场帧，否则依次发送当前页面的变量段；之后执行页面显示逻辑和周期任务
+ */
+static void dwin_var_show_once(void)
 {
+	const one_page_info_t *page;
+	rt_int16_t index;
+	rt_tick_t switch_tick;
 	int i;
-	int len;
 
-	while (1)
+	if (page_switch_pending)
 	{
-		for (i = 0; i < dwin_var.page_count; i++)//遍历所有页面
+		// 页面刚切换：第一次发送就是新页面的完整入场帧
+		page_switch_pending = RT_FALSE;
+		switch_tick = page_switch_tick;
+		index = find_page_index(page_id);
+		if (index != DWIN_VAR_PAGE_INDEX_NONE)
 		{
-			if (page_id == dwin_var.page_list[i].page_id)//如果迪文页面配置结构体的页面列表的页面id值等于当前页面id
-			
-				// 1. 准备并发送变量数据帧
-				len = prepared_dwin_data_frame(&dwin_var.page_list[i]);//&dwin_var.page_list由init_dwin_var传入的参数赋值得到，所以prepared_dwin_data_frame函数的返回值就是数据帧长度
-				dwin_serial_send(dwin_command_buff, len);//串口发送迪文命令帧,第一参数就是数据帧缓冲区，第二参数是数据帧长度
-				// 2. 执行页面特有的显示逻辑，本项目没有体现
-				dwin_var.page_list[i].show_fun();
-				
-				// 显示当前曲线窗口
-				show_current_curve_window();
+			send_page_entry(index);
+			record_page_switch_latency(rt_tick_get() - switch_tick);
+		}
+	}
+	else
+	{
+		// 依次发送本页面的各个变量段
+		index = find_page_index(page_id);
+		if (index != DWIN_VAR_PAGE_INDEX_NONE)
+		{
+			page = &dwin_var.page_list[index];
+			for (i = 0; i < page->range_count; i++)
+			{
+				send_dwin_var_range(&page->range_list[i]);
 			}
 		}
 	}
+
+	// 执行页面特有的显示逻辑
+	if (index != DWIN_VAR_PAGE_INDEX_NONE && dwin_var.page_list[index].show_fun != RT_NULL)
+	{
+		dwin_var.page_list[index].show_fun();
+	}
+	
+	// 显示当前曲线窗口，每轮只显示一次，与页面配置了几段变量无关
+	show_current_curve_window();
+
+	// 触控参数到达发送条件时发送到CAN总线
+	param_sync_poll();
+
+	// 报警规则的持续时间到期检查
+	rule_engine_poll();
+
+	// 刷新间隙提前生成其它页面的入场帧
+	prerender_page_entries(index);
 }
+#ifdef INTERFACE_CFG_USING_REACTOR
+/**
+ * @brief 刷新定时器超时函数：置刷新事件
+ */
+static void dwin_var_refresh_timeout(void *parameter)
+{
+	reactor_signal(REACTOR_EVENT_DWIN_SHOW);
+}
+#else
+/**
+ * @brief 迪文变量显示线程处理函数
+ * 
+ * 每 DWIN_VAR_REFRESH_PERIOD 毫秒刷新一次当前活动页面的显示内容，页面切换时立即唤醒
+ */
+static void dwin_var_show_dealer(void *arg)
+{
+	while (1)
+	{
+		rt_completion_wait(&dwin_var_refresh_cpt, rt_tick_from_millisecond(DWIN_VAR_REFRESH_PERIOD));
+		dwin_var_show_once();
+	}
+}
+#endif /* INTERFACE_CFG_USING_REACTOR */
+#ifdef RT_USING_FINSH
+/**
+ * @brief msh命令：打印页面切换延迟统计
+ */
+static void dwin_page_latency(int argc, char **argv)
+{
+	dwin_page_switch_stat_t stat;
+
+	get_dwin_page_switch_stat(&stat);
+	if (stat.count == 0)
+	{
+		rt_kprintf("no page switch yet\n");
+		return;
+	}
+	rt_kprintf("page switch: %u times, last %u ms, min %u ms, max %u ms, avg %u ms\n",
+			stat.count,
+			stat.last * 1000 / RT_TICK_PER_SECOND,
+			stat.min * 1000 / RT_TICK_PER_SECOND,
+			stat.max * 1000 / RT_TICK_PER_SECOND,
+			stat.total / stat.count * 1000 / RT_TICK_PER_SECOND);
+}
+MSH_CMD_EXPORT(dwin_page_latency, show touch to first page frame latency);
+#endif /* RT_USING_FINSH */
 /*============================ EXTERNAL IMPLEMENTATION =======================*/
 /**
  * @brief 初始化迪文屏变量的页面显示配置
- * @note 所有的参数会在业务逻辑层bll.c得到，第一参数dwin_var_list就是数据帧列表的指针，第三参数dwin_pages就是页面列表的指针，第二、第四参数可以通过第一、第三参数计算得到
+ * @note 所有的参数会在业务逻辑层bll.c得到，第一参数dwin_var_list就是数据帧列表的指针，第四参数dwin_pages就是页面列表的指针，
+ *		第二参数address_list是地址到下标的对应表（按地址升序，个数与变量个数相同），第三、第五参数可以通过第一、第四参数计算得到
  */
-void init_dwin_var(rt_uint16_t *var_list, rt_uint16_t var_count, one_page_info_t *page_list, rt_uint16_t page_count)
+void init_dwin_var(rt_uint16_t *var_list, const dwin_var_address_entry_t *address_list, rt_uint16_t var_count,
+		const one_page_info_t *page_list, rt_uint16_t page_count)
 {
+#ifndef INTERFACE_CFG_USING_REACTOR
 	rt_thread_t thread;
+#endif /* INTERFACE_CFG_USING_REACTOR */
+	rt_uint16_t i;
+	rt_uint16_t j;
+	rt_size_t arena_used = 0;
+	const dwin_var_range_t *range;
+
+	RT_ASSERT(page_count <= DWIN_VAR_PAGE_MAX_COUNT);
+	for (i = 0; i < var_count; i++)//地址表严格升序才能二分查找，下标不超出变量存储区
+	{
+		RT_ASSERT(address_list[i].index < var_count);
+		RT_ASSERT(i == 0 || address_list[i - 1].address < address_list[i].address);
+	}
+	for (i = 0; i < DWIN_VAR_PAGE_ID_MAX; i++)
+	{
+		page_index_table[i] = DWIN_VAR_PAGE_INDEX_NONE;
+	}
+
+	for (i = 0; i < page_count; i++)//检查变量段不超出变量存储区，帧头字节数与段长度一致
+	{
+		RT_ASSERT(page_list[i].page_id < DWIN_VAR_PAGE_ID_MAX);//页面id直接作为索引表下标
+		RT_ASSERT(page_index_table[page_list[i].page_id] == DWIN_VAR_PAGE_INDEX_NONE);//页面id不能重复
+		page_index_table[page_list[i].page_id] = i;
+
+		page_entry_list[i].size = 0;
+		page_entry_list[i].first_index = var_count;
+		page_entry_list[i].end_index = 0;
+		for (j = 0; j < page_list[i].range_count; j++)
+		{
+			range = &page_list[i].range_list[j];
+			RT_ASSERT(range->start_index + range->count <= var_count);
+			RT_ASSERT(range->frame_head[DWIN_DATA_BYTE_COUNT_INDEX] == range->count * 2 + 3);
+			page_entry_list[i].size += DWIN_VAR_FRAME_HEAD_SIZE + range->count * 2;
+			//变量表中同一页面的变量下标连续，取各段下标的范围判断写入的变量属于哪个页面
+			if (range->start_index < page_entry_list[i].first_index)
+			{
+				page_entry_list[i].first_index = range->start_index;
+			}
+			if (range->start_index + range->count > page_entry_list[i].end_index)
+			{
+				page_entry_list[i].end_index = range->start_index + range->count;
+			}
+		}
+		//入场帧从存储区顺序分配，按 RT_ALIGN_SIZE 对齐
+		RT_ASSERT(arena_used + page_entry_list[i].size <= DWIN_VAR_ENTRY_FRAME_ARENA_SIZE);
+		page_entry_list[i].frame = &dwin_entry_frame_arena[arena_used];
+		page_entry_list[i].valid = RT_FALSE;
+		arena_used = RT_ALIGN(arena_used + page_entry_list[i].size, RT_ALIGN_SIZE);
+	}
+
 	//dwin_var就是dwin_var_info_t结构体类型的变量dwin_var
 	dwin_var.var_list = var_list;//传入的var_list来自
 	//赋值符右边的var_list是传入的参数，在业务逻辑层得到分发器分发的数据，左边的var_list在dwin_var结构体内，也就是把传入的var_list保存到dwin_var结构体中
+	dwin_var.address_list = address_list;//传入的address_list保存到dwin_var结构体中
 	dwin_var.var_count = var_count;//传入的var_count保存到dwin_var结构体中
 	
 	dwin_var.page_list = page_list;//传入的page_list保存到dwin_var结构体中
 	dwin_var.page_count = page_count;//传入的page_count保存到dwin_var结构体中
+#ifdef INTERFACE_CFG_USING_REACTOR
+	//刷新事件由周期定时器和页面切换置位，在事件循环线程中刷新
+	reactor_register(REACTOR_EVENT_DWIN_SHOW, dwin_var_show_once);
+	rt_timer_init(&dwin_var_refresh_timer, "dwin_show", dwin_var_refresh_timeout, RT_NULL,
+			rt_tick_from_millisecond(DWIN_VAR_REFRESH_PERIOD), RT_TIMER_FLAG_PERIODIC);
+	rt_timer_start(&dwin_var_refresh_timer);
+	reactor_signal(REACTOR_EVENT_DWIN_SHOW);//启动后立即刷新一次，不等第一个刷新周期
+#else
+	rt_completion_init(&dwin_var_refresh_cpt);
+	rt_completion_done(&dwin_var_refresh_cpt);//启动后立即刷新一次，不等第一个刷新周期
 	//创建页面显示线程
 	thread = rt_thread_create("DWIN_SHOW", dwin_var_show_dealer, RT_NULL,
 			DWIN_VAR_SHOW_THREAD_STACK_SIZE,
@@ -153,6 +492,90 @@ void init_dwin_var(rt_uint16_t *var_list, rt_uint16_t var_count, one_page_info_t
 	}
 	//启动线程
 	rt_thread_startup(thread);
+#endif /* INTERFACE_CFG_USING_REACTOR */
+}
+/**
+ * @brief 批量写迪文变量开始
+ * @note 与 dwin_var_write_end 成对使用，期间写入的变量不会被拆到两帧显示；可以嵌套，写者不会被阻塞
+ */
+void dwin_var_write_begin(void)
+{
+	seqlock_write_begin(&dwin_var_lock);
+}
+/**
+ * @brief 批量写迪文变量结束
+ */
+void dwin_var_write_end(void)
+{
+	seqlock_write_end(&dwin_var_lock);
+}
+/**
+ * @brief 记录迪文变量被修改
+ * @param var_index 变量下标
+ * @note 在 dwin_var_write_begin/end 之间、写入变量之后调用，增加变量所在页面的修改次数，
+ *		该页面的入场帧在下次使用前重新生成；可以在中断中调用
+ */
+void dwin_var_changed(rt_uint16_t var_index)
+{
+	rt_uint16_t i;
+
+	for (i = 0; i < dwin_var.page_count; i++)
+	{
+		if (var_index >= page_entry_list[i].first_index && var_index < page_entry_list[i].end_index)
+		{
+			rt_atomic_add(&page_entry_list[i].change_count, 1);
+		}
+	}
+}
+/**
+ * @brief 修改迪文变量的部分位
+ * @param var_index 变量下标
+ * @param mask 修改的位（主机字节序）
+ * @param value 新的值（主机字节序），只取 mask 对应的位
+ * @note 用于位变量图标等多个来源共用一个变量的场合，修改过程在批量写之内
+ */
+void modify_dwin_var(rt_uint16_t var_index, rt_uint16_t mask, rt_uint16_t value)
+{
+	rt_uint16_t old_value;
+
+	RT_ASSERT(var_index < dwin_var.var_count);
+
+	dwin_var_write_begin();
+	old_value = SWAP_16(dwin_var.var_list[var_index]);
+	dwin_var.var_list[var_index] = SWAP_16((old_value & ~mask) | (value & mask));
+	dwin_var_changed(var_index);
+	dwin_var_write_end();
+}
+/**
+ * @brief 根据迪文地址查找变量下标
+ * @param var_address 迪文变量地址
+ * @return rt_int16_t 变量在变量存储区中的下标，地址不是迪文变量时返回-1
+ * @note 在按地址升序的地址表中二分查找
+ */
+rt_int16_t get_dwin_var_index(rt_uint16_t var_address)
+{
+	rt_uint16_t low = 0;
+	rt_uint16_t high = dwin_var.var_count;
+	rt_uint16_t middle;
+
+	while (low < high)
+	{
+		middle = low + (high - low) / 2;
+		if (dwin_var.address_list[middle].address < var_address)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	if (low < dwin_var.var_count && dwin_var.address_list[low].address == var_address)
+	{
+		return dwin_var.address_list[low].index;
+	}
+	return -1;
 }
 /**
  * @brief 设置当前活动页面ID
@@ -162,6 +585,13 @@ void init_dwin_var(rt_uint16_t *var_list, rt_uint16_t var_count, one_page_info_t
 void set_current_page_id(rt_uint16_t current_page_id)
 {
 	page_id = current_page_id;
+	page_switch_tick = rt_tick_get();
+	page_switch_pending = RT_TRUE;
+#ifdef INTERFACE_CFG_USING_REACTOR
+	reactor_signal(REACTOR_EVENT_DWIN_SHOW);//立即刷新，发送新页面的入场帧
+#else
+	rt_completion_done(&dwin_var_refresh_cpt);//立即唤醒显示线程发送新页面的入场帧
+#endif /* INTERFACE_CFG_USING_REACTOR */
 }
 /**
  * @brief 获取当前活动页面ID
@@ -171,3 +601,16 @@ rt_uint16_t get_current_page_id(void)
 {
 	return page_id;//返回默认值0
 }
+/**
+ * @brief 获取页面切换延迟统计
+ * @param stat 返回统计结果，单位为时钟节拍
+ * @note 延迟从 set_current_page_id（触控上传的页面切换数据解析完成）开始，到新页面入场帧发送完成为止
+ */
+void get_dwin_page_switch_stat(dwin_page_switch_stat_t *stat)
+{
+	rt_base_t level;
+
+	level = rt_hw_interrupt_disable();
+	*stat = page_switch_stat;
+	rt_hw_interrupt_enable(level);
+}
@@ -20,8 +20,35 @@ extern "C" {
 #endif
 
 /*============================ MACROS ========================================*/
+#define DWIN_VAR_FRAME_HEAD_SIZE		6		//写命令帧头长度：5A A5 字节数 82 地址
+#define DWIN_VAR_RANGE_MAX_COUNT		126		//一个变量段最多变量个数，字节数（count * 2 + 3）不能超过255
+#define DWIN_VAR_SNAPSHOT_RETRY			4		//读取变量段快照的最多尝试次数，仍不一致时本轮不发送该段
+#define DWIN_VAR_REFRESH_PERIOD			20		//显示线程刷新周期（ms），页面切换时立即刷新
+#define DWIN_VAR_PAGE_ID_MAX			32		//页面id上限，页面id直接作为页面索引表下标
+#define DWIN_VAR_PAGE_MAX_COUNT			8		//最多页面个数
+#define DWIN_VAR_ENTRY_FRAME_ARENA_SIZE	512		//所有页面入场帧的总字节数
 /*============================ TYPES =========================================*/
 typedef void (*dwin_page_show_fun)(void);//定义一个函数指针类型
+/**
+ * @struct dwin_var_range
+ * @brief 一段地址连续的迪文屏变量
+ */
+typedef struct dwin_var_range
+{
+	rt_uint16_t start_index;		/**< 本段第一个变量的下标 */
+	rt_uint16_t var_address;		/**< 本段第一个变量的地址（迪文屏地址） */
+	rt_uint16_t count;				/**< 本段变量个数 */
+	const rt_uint8_t *frame_head;	/**< 本段写命令帧头，编译时生成的常量，放在flash中 */
+}dwin_var_range_t;
+/**
+ * @struct dwin_var_address_entry
+ * @brief 迪文地址到变量下标的对应，列表按地址升序排列，用于二分查找
+ */
+typedef struct dwin_var_address_entry
+{
+	rt_uint16_t address;			/**< 变量的迪文地址 */
+	rt_uint16_t index;				/**< 变量在变量存储区中的下标 */
+}dwin_var_address_entry_t;
 /**
  * @struct one_page_info
  * @brief 当前页面的信息配置
@@ -29,19 +56,42 @@ typedef void (*dwin_page_show_fun)(void);//定义一个函数指针类型
 typedef struct one_page_info
 {
 	rt_uint16_t page_id;			/**< 本界面id */
-	rt_uint16_t start_index;		/**< 本界面第一个变量的下标 */
-	rt_uint16_t var_address;		/**< 本界面第一个变量的地址（迪文屏地址） */
-	rt_uint16_t count;				/**< 本界面显示变量个数 */
+	const dwin_var_range_t *range_list;	/**< 本界面的变量段，一个界面可以有多段地址不连续的变量 */
+	rt_uint16_t range_count;		/**< 本界面变量段个数 */
 	dwin_page_show_fun show_fun;	/**< show_fun是dwin_page_show_fun类型的变量，将指向与其相同参数的函数，这里预设指向的是本界面其它显示处理函数 */
 }one_page_info_t;
+/**
+ * @struct dwin_page_switch_stat
+ * @brief 页面切换延迟统计（触控上传到新页面第一帧发送完成），单位为时钟节拍
+ */
+typedef struct dwin_page_switch_stat
+{
+	rt_uint32_t count;				/**< 切换次数 */
+	rt_tick_t last;					/**< 最近一次延迟 */
+	rt_tick_t min;					/**< 最小延迟 */
+	rt_tick_t max;					/**< 最大延迟 */
+	rt_tick_t total;				/**< 延迟总和，用于计算平均值 */
+}dwin_page_switch_stat_t;
 /*============================ GLOBAL VARIABLES ==============================*/
 /*============================ PROTOTYPES ====================================*/
 /* 迪文数据显示线程初始化函数 */
-void init_dwin_var(rt_uint16_t *var_list, rt_uint16_t var_count, one_page_info_t *page_list, rt_uint16_t page_count);
+void init_dwin_var(rt_uint16_t *var_list, const dwin_var_address_entry_t *address_list, rt_uint16_t var_count,
+		const one_page_info_t *page_list, rt_uint16_t page_count);
+/* 批量写迪文变量开始、结束，期间写入的变量在同一帧中一起显示 */
+void dwin_var_write_begin(void);
+void dwin_var_write_end(void);
+/* 记录迪文变量被修改，在批量写之内调用 */
+void dwin_var_changed(rt_uint16_t var_index);
+/* 修改迪文变量的部分位 */
+void modify_dwin_var(rt_uint16_t var_index, rt_uint16_t mask, rt_uint16_t value);
+/* 根据迪文地址查找变量下标，找不到返回-1 */
+rt_int16_t get_dwin_var_index(rt_uint16_t var_address);
 /* 设置当前曲线窗口id */
 void set_current_page_id(rt_uint16_t current_page_id);
 /* 获取当前曲线窗口id */
 rt_uint16_t get_current_page_id(void);
+/* 获取页面切换延迟统计 */
+void get_dwin_page_switch_stat(dwin_page_switch_stat_t *stat);
 /*============================ INCLUDES ======================================*/
 
 #ifdef __cplusplus
@@ -0,0 +1,218 @@
+/**
+ * @file param_sync.c
+ * @brief 触控参数同步到CAN总线
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "interface_can.h"
+#include "param_sync.h"
+
+#define DBG_LEVEL	DBG_LOG
+#define DBG_TAG		"param_sync"
+#include <rtdbg.h>
+
+/*============================ MACROS ========================================*/
+/*============================ TYPES =========================================*/
+/**
+ * @struct param_sync_info
+ * @brief 参数同步的运行状态
+ */
+typedef struct param_sync_info
+{
+	const param_sync_config_t *config;	/**< 配置 */
+	struct rt_mutex mutex;			/**< 保护参数表，触控线程修改、显示线程发送、CAN接收线程确认 */
+	rt_uint8_t frame[PARAM_SYNC_FRAME_MAX_SIZE];	/**< 参数表（当前的CAN帧映像） */
+	rt_uint8_t sent_frame[PARAM_SYNC_FRAME_MAX_SIZE];	/**< 最近发送的帧，初始与参数表相同，参数没有修改时不发送 */
+	rt_bool_t echo_pending;			/**< 等待回读确认 */
+	rt_uint8_t echo_retry;			/**< 已重发次数 */
+	rt_tick_t change_tick;			/**< 参数最近一次变化的时刻 */
+	rt_tick_t send_tick;			/**< 最近一次发送的时刻 */
+	rt_tick_t debounce_tick;		/**< 防抖时间（节拍） */
+	rt_tick_t min_interval_tick;	/**< 最小发送间隔（节拍） */
+	rt_tick_t echo_timeout_tick;	/**< 回读确认超时（节拍） */
+	param_sync_stat_t stat;			/**< 统计 */
+}param_sync_info_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+static param_sync_info_t param_sync;
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 判断是否到了发送时刻
+ * @param now 当前时刻
+ * @note 调用时已持有互斥量
+ */
+static rt_bool_t param_sync_should_send(rt_tick_t now)
+{
+	const param_sync_config_t *config = param_sync.config;
+
+	if (rt_memcmp(param_sync.frame, param_sync.sent_frame, config->frame_size) == 0)
+	{
+		// 与上次发送的内容相同：不重复发送，只有等待回读确认超时才重发
+		return param_sync.echo_pending && now - param_sync.send_tick >= param_sync.echo_timeout_tick;
+	}
+
+	// 参数已稳定（防抖）或持续变化已超过最小间隔
+	return now - param_sync.change_tick >= param_sync.debounce_tick
+			|| now - param_sync.send_tick >= param_sync.min_interval_tick;
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 初始化参数同步
+ * @param config 配置，参数表初始全为0
+ */
+void init_param_sync(const param_sync_config_t *config)
+{
+	rt_uint16_t i;
+
+	RT_ASSERT(config->frame_size <= PARAM_SYNC_FRAME_MAX_SIZE);
+	for (i = 0; i < config->param_count; i++)
+	{
+		RT_ASSERT(config->param_list[i].size >= 1 && config->param_list[i].size <= 4);
+		RT_ASSERT(config->param_list[i].offset + config->param_list[i].size <= config->frame_size);
+	}
+
+	rt_memset(&param_sync, 0, sizeof(param_sync));
+	param_sync.config = config;
+	param_sync.debounce_tick = rt_tick_from_millisecond(config->debounce_ms);
+	param_sync.min_interval_tick = rt_tick_from_millisecond(config->min_interval_ms);
+	param_sync.echo_timeout_tick = rt_tick_from_millisecond(config->echo_timeout_ms);
+	param_sync.send_tick = rt_tick_get() - param_sync.min_interval_tick;//上电后第一次修改不受最小间隔限制
+	rt_mutex_init(&param_sync.mutex, "param_sync", RT_IPC_FLAG_PRIO);
+}
+/**
+ * @brief 修改参数
+ * @param param_id 参数id（参数表下标）
+ * @param value 参数值，按参数字节数截取低位，大端写入帧映像
+ */
+void param_sync_set(rt_uint16_t param_id, rt_uint32_t value)
+{
+	const param_sync_param_t *param;
+	rt_uint8_t buff[4];
+	rt_uint8_t i;
+
+	RT_ASSERT(param_id < param_sync.config->param_count);
+	param = &param_sync.config->param_list[param_id];
+	for (i = 0; i < param->size; i++)
+	{
+		buff[i] = (value >> ((param->size - 1 - i) * 8)) & 0xFF;
+	}
+
+	rt_mutex_take(&param_sync.mutex, RT_WAITING_FOREVER);
+	param_sync.stat.update_count++;
+	if (rt_memcmp(&param_sync.frame[param->offset], buff, param->size) != 0)
+	{
+		rt_memcpy(&param_sync.frame[param->offset], buff, param->size);
+		param_sync.change_tick = rt_tick_get();
+	}
+	rt_mutex_release(&param_sync.mutex);
+}
+/**
+ * @brief 到达发送条件时发送CAN帧
+ * @note 在显示线程中周期调用，CAN发送不再阻塞迪文接收线程
+ */
+void param_sync_poll(void)
+{
+	const param_sync_config_t *config = param_sync.config;
+	rt_uint8_t frame[PARAM_SYNC_FRAME_MAX_SIZE];
+	rt_tick_t now = rt_tick_get();
+
+	if (config == RT_NULL)
+	{
+		return;
+	}
+
+	rt_mutex_take(&param_sync.mutex, RT_WAITING_FOREVER);
+	if (param_sync_should_send(now) == RT_FALSE)
+	{
+		rt_mutex_release(&param_sync.mutex);
+		return;
+	}
+
+	if (param_sync.echo_pending && rt_memcmp(param_sync.frame, param_sync.sent_frame, config->frame_size) == 0)
+	{
+		// 重发同一帧
+		if (param_sync.echo_retry >= config->echo_retry)
+		{
+			param_sync.echo_pending = RT_FALSE;
+			param_sync.stat.confirm_fail_count++;
+			rt_mutex_release(&param_sync.mutex);
+			LOG_W("CAN 0x%03X not confirmed", config->can_id);
+			return;
+		}
+		param_sync.echo_retry++;
+		param_sync.stat.retry_count++;
+	}
+	else
+	{
+		param_sync.echo_retry = 0;
+	}
+
+	rt_memcpy(param_sync.sent_frame, param_sync.frame, config->frame_size);
+	rt_memcpy(frame, param_sync.frame, config->frame_size);
+	param_sync.echo_pending = config->echo_timeout_ms != 0;
+	param_sync.send_tick = now;
+	param_sync.stat.send_count++;
+	rt_mutex_release(&param_sync.mutex);
+
+	can_send(config->can_id, frame, config->frame_size);//发送时不持有互斥量，触控线程不会等待CAN发送
+}
+/**
+ * @brief 收到回读帧
+ * @param buff 回读帧数据
+ * @param size 回读帧字节数
+ * @note 在CAN接收分发函数中调用，不需要确认时直接忽略
+ */
+void param_sync_echo(rt_uint8_t *buff, rt_size_t size)
+{
+	const param_sync_config_t *config = param_sync.config;
+
+	if (config == RT_NULL || config->echo_timeout_ms == 0 || size != config->frame_size)
+	{
+		return;
+	}
+
+	rt_mutex_take(&param_sync.mutex, RT_WAITING_FOREVER);
+	if (param_sync.echo_pending && rt_memcmp(buff, param_sync.sent_frame, size) == 0)
+	{
+		param_sync.echo_pending = RT_FALSE;
+	}
+	rt_mutex_release(&param_sync.mutex);
+}
+/**
+ * @brief 获取统计
+ * @param stat 返回统计结果
+ */
+void get_param_sync_stat(param_sync_stat_t *stat)
+{
+	rt_mutex_take(&param_sync.mutex, RT_WAITING_FOREVER);
+	*stat = param_sync.stat;
+	rt_mutex_release(&param_sync.mutex);
+}
+#ifdef RT_USING_FINSH
+/**
+ * @brief msh命令：打印参数同步统计
+ */
+static void param_sync_info(int argc, char **argv)
+{
+	param_sync_stat_t stat;
+
+	if (param_sync.config == RT_NULL)
+	{
+		rt_kprintf("param sync not initialized\n");
+		return;
+	}
+	get_param_sync_stat(&stat);
+	rt_kprintf("updates %u, frames %u (retry %u), unconfirmed %u\n",
+			stat.update_count, stat.send_count, stat.retry_count, stat.confirm_fail_count);
+}
+MSH_CMD_EXPORT(param_sync_info, show touch parameter to CAN sync statistics);
+#endif /* RT_USING_FINSH */
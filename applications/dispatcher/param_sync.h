@@ -0,0 +1,82 @@
+/**
+ * @file param_sync.h
+ * @brief 触控参数同步到CAN总线
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  触控处理函数只修改参数表（CAN帧映像），不直接发送；显示线程周期调用 param_sync_poll，
+ *		帧映像与上次发送的内容不同，并且参数停止变化超过防抖时间，或者距上次发送超过最小间隔时，才发送一帧。
+ *		拖动滑块时屏幕连续上传，总线上最多每个最小间隔一帧，松手后再发送最终值；
+ *		可选回读确认：对端把收到的帧原样回发，超时未收到则重发。
+ */
+#ifndef __PARAM_SYNC_H__
+#define __PARAM_SYNC_H__
+
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================ MACROS ========================================*/
+#define PARAM_SYNC_FRAME_MAX_SIZE		8		//CAN帧数据最大字节数
+/*============================ TYPES =========================================*/
+/**
+ * @struct param_sync_param
+ * @brief 参数在CAN帧中的位置，多字节参数按大端存放
+ */
+typedef struct param_sync_param
+{
+	rt_uint8_t offset;				/**< 参数在帧中的起始字节 */
+	rt_uint8_t size;				/**< 参数字节数，1~4 */
+}param_sync_param_t;
+/**
+ * @struct param_sync_config
+ * @brief 参数同步配置
+ */
+typedef struct param_sync_config
+{
+	rt_uint32_t can_id;				/**< 发送的CAN帧id */
+	rt_uint8_t frame_size;			/**< CAN帧数据字节数 */
+	rt_uint16_t debounce_ms;		/**< 参数停止变化多久后发送（ms） */
+	rt_uint16_t min_interval_ms;	/**< 参数持续变化时两帧之间的最小间隔（ms） */
+	rt_uint16_t echo_timeout_ms;	/**< 等待回读确认的时间（ms），0为不需要确认 */
+	rt_uint8_t echo_retry;			/**< 回读确认超时后最多重发次数 */
+	const param_sync_param_t *param_list;	/**< 参数表，下标即参数id */
+	rt_uint16_t param_count;		/**< 参数个数 */
+}param_sync_config_t;
+/**
+ * @struct param_sync_stat
+ * @brief 参数同步统计，用于评估合并效果
+ */
+typedef struct param_sync_stat
+{
+	rt_uint32_t update_count;		/**< 参数修改次数（触控上传次数） */
+	rt_uint32_t send_count;			/**< 实际发送帧数（含重发） */
+	rt_uint32_t retry_count;		/**< 回读确认超时重发帧数 */
+	rt_uint32_t confirm_fail_count;	/**< 重发后仍未确认的次数 */
+}param_sync_stat_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ PROTOTYPES ====================================*/
+/* 初始化参数同步，配置需要一直有效 */
+void init_param_sync(const param_sync_config_t *config);
+/* 修改参数，只更新参数表，由 param_sync_poll 决定何时发送 */
+void param_sync_set(rt_uint16_t param_id, rt_uint32_t value);
+/* 周期调用，到达发送条件时发送CAN帧，在显示线程中调用 */
+void param_sync_poll(void);
+/* 收到回读帧时调用，内容与最近发送的帧相同即确认 */
+void param_sync_echo(rt_uint8_t *buff, rt_size_t size);
+/* 获取统计 */
+void get_param_sync_stat(param_sync_stat_t *stat);
+/*============================ INCLUDES ======================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PARAM_SYNC_H__ */
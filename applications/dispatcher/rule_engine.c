@@ -0,0 +1,287 @@
+/**
+ * @file rule_engine.c
+ * @brief 信号变化触发的规则引擎（指示灯、报警）
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "interface_can.h"
+#include "dwin_page_var.h"
+#include "rule_engine.h"
+
+#define DBG_LEVEL	DBG_LOG
+#define DBG_TAG		"rule_engine"
+#include <rtdbg.h>
+
+/*============================ MACROS ========================================*/
+/*============================ TYPES =========================================*/
+/**
+ * @struct rule_state
+ * @brief 一条规则的运行状态
+ */
+typedef struct rule_state
+{
+	rt_uint8_t condition_state;		/**< 各条件当前是否成立（按位），用于回差 */
+	rt_bool_t pending;				/**< 条件全部成立，等待持续时间到期 */
+	rt_bool_t active;				/**< 规则是否成立 */
+	rt_tick_t since;				/**< 条件全部成立的起始时刻 */
+}rule_state_t;
+/**
+ * @struct rule_engine_info
+ * @brief 规则引擎
+ */
+typedef struct rule_engine_info
+{
+	const rule_t *rule_list;		/**< 规则表 */
+	rt_uint16_t rule_count;			/**< 规则个数 */
+	rt_uint16_t signal_count;		/**< 信号个数 */
+	struct rt_mutex mutex;			/**< CAN接收线程更新信号、显示线程处理持续时间 */
+	rt_int32_t signal_value[RULE_ENGINE_MAX_SIGNALS];	/**< 信号当前值 */
+	rt_uint32_t signal_valid;		/**< 信号是否收到过（按位），没有收到过的信号条件不成立 */
+	rule_state_t state_list[RULE_ENGINE_MAX_RULES];	/**< 规则运行状态 */
+	rt_uint32_t pending_mask;		/**< 等待持续时间到期的规则（按位） */
+	/* 依赖关系：信号 s 的依赖规则为 depend_list[depend_start[s]] ~ depend_list[depend_start[s + 1] - 1] */
+	rt_uint8_t depend_start[RULE_ENGINE_MAX_SIGNALS + 1];
+	rt_uint8_t depend_list[RULE_ENGINE_MAX_DEPENDS];
+}rule_engine_info_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+static rule_engine_info_t rule_engine;
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 计算一个条件
+ * @param condition 条件
+ * @param last 条件上次是否成立，用于回差
+ */
+static rt_bool_t rule_condition_eval(const rule_condition_t *condition, rt_bool_t last)
+{
+	rt_int32_t value;
+
+	if ((rule_engine.signal_valid & (1UL << condition->signal)) == 0)
+	{
+		return RT_FALSE;
+	}
+
+	value = rule_engine.signal_value[condition->signal];
+	switch (condition->type)
+	{
+	case RULE_COND_ABOVE:
+		return last ? value > condition->off_level : value > condition->on_level;
+	case RULE_COND_BELOW:
+		return last ? value < condition->off_level : value < condition->on_level;
+	case RULE_COND_BITS_ALL:
+		return (value & condition->on_level) == condition->on_level;
+	case RULE_COND_BITS_ANY:
+		return (value & condition->on_level) != 0;
+	default:
+		return RT_FALSE;
+	}
+}
+/**
+ * @brief 执行规则输出
+ * @param rule 规则
+ * @param active 规则新的状态
+ */
+static void rule_output(const rule_t *rule, rt_bool_t active)
+{
+	const rule_output_t *output = &rule->output;
+	const rt_uint8_t *data;
+
+	switch (output->type)
+	{
+	case RULE_OUTPUT_DWIN_VAR:
+		modify_dwin_var(output->var_index, output->mask, active ? output->on_value : output->off_value);
+		break;
+	case RULE_OUTPUT_CAN:
+		data = active ? output->can_on_data : output->can_off_data;
+		if (data != RT_NULL)
+		{
+			can_send(output->can_id, (rt_uint8_t *) data, output->can_size);
+		}
+		break;
+	default:
+		break;
+	}
+}
+/**
+ * @brief 设置规则状态，状态变化时执行输出
+ */
+static void rule_set_active(rt_uint16_t index, rt_bool_t active)
+{
+	rule_state_t *state = &rule_engine.state_list[index];
+
+	if (state->active != active)
+	{
+		state->active = active;
+		rule_output(&rule_engine.rule_list[index], active);
+	}
+}
+/**
+ * @brief 重新计算一条规则
+ * @param index 规则下标
+ * @param now 当前时刻
+ * @note 调用时已持有互斥量
+ */
+static void rule_eval(rt_uint16_t index, rt_tick_t now)
+{
+	const rule_t *rule = &rule_engine.rule_list[index];
+	rule_state_t *state = &rule_engine.state_list[index];
+	rt_uint8_t condition_state = 0;
+	rt_uint8_t i;
+
+	for (i = 0; i < rule->condition_count; i++)
+	{
+		if (rule_condition_eval(&rule->condition_list[i], (state->condition_state >> i) & 1))
+		{
+			condition_state |= 1 << i;
+		}
+	}
+	state->condition_state = condition_state;
+
+	if (condition_state != (1 << rule->condition_count) - 1)//有条件不成立，立即解除
+	{
+		state->pending = RT_FALSE;
+		rule_engine.pending_mask &= ~(1UL << index);
+		rule_set_active(index, RT_FALSE);
+		return;
+	}
+
+	if (state->active)
+	{
+		return;
+	}
+
+	if (state->pending == RT_FALSE)
+	{
+		state->pending = RT_TRUE;
+		state->since = now;
+	}
+
+	if (now - state->since >= rt_tick_from_millisecond(rule->duration_ms))
+	{
+		state->pending = RT_FALSE;
+		rule_engine.pending_mask &= ~(1UL << index);
+		rule_set_active(index, RT_TRUE);
+	}
+	else
+	{
+		rule_engine.pending_mask |= 1UL << index;//持续时间未到，由 rule_engine_poll 继续检查
+	}
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 初始化规则引擎
+ * @param rule_list 规则表
+ * @param rule_count 规则个数
+ * @param signal_count 信号个数，信号id为 0 ~ signal_count - 1
+ * @note 由规则表生成信号到规则的依赖关系，同一规则对同一信号只记录一次
+ */
+void init_rule_engine(const rule_t *rule_list, rt_uint16_t rule_count, rt_uint16_t signal_count)
+{
+	rt_uint16_t signal;
+	rt_uint16_t depend_count = 0;
+	rt_uint16_t i;
+	rt_uint8_t j;
+
+	RT_ASSERT(rule_count <= RULE_ENGINE_MAX_RULES);
+	RT_ASSERT(signal_count <= RULE_ENGINE_MAX_SIGNALS);
+
+	rt_memset(&rule_engine, 0, sizeof(rule_engine));
+	rule_engine.rule_list = rule_list;
+	rule_engine.rule_count = rule_count;
+	rule_engine.signal_count = signal_count;
+
+	for (signal = 0; signal < signal_count; signal++)
+	{
+		rule_engine.depend_start[signal] = depend_count;
+		for (i = 0; i < rule_count; i++)
+		{
+			RT_ASSERT(rule_list[i].condition_count > 0 && rule_list[i].condition_count <= RULE_MAX_CONDITIONS);
+			for (j = 0; j < rule_list[i].condition_count; j++)
+			{
+				RT_ASSERT(rule_list[i].condition_list[j].signal < signal_count);
+				if (rule_list[i].condition_list[j].signal == signal)
+				{
+					RT_ASSERT(depend_count < RULE_ENGINE_MAX_DEPENDS);
+					rule_engine.depend_list[depend_count++] = i;
+					break;
+				}
+			}
+		}
+	}
+	rule_engine.depend_start[signal_count] = depend_count;
+
+	rt_mutex_init(&rule_engine.mutex, "rule", RT_IPC_FLAG_PRIO);
+	LOG_I("%d rules, %d signals, %d dependencies", rule_count, signal_count, depend_count);
+}
+/**
+ * @brief 更新信号
+ * @param signal 信号id
+ * @param value 信号值
+ * @note 信号值没有变化时不计算；在CAN分发函数中调用，放在迪文变量批量写之外
+ */
+void rule_engine_update_signal(rt_uint16_t signal, rt_int32_t value)
+{
+	rt_tick_t now = rt_tick_get();
+	rt_uint16_t i;
+
+	RT_ASSERT(signal < rule_engine.signal_count);
+
+	rt_mutex_take(&rule_engine.mutex, RT_WAITING_FOREVER);
+	if ((rule_engine.signal_valid & (1UL << signal)) && rule_engine.signal_value[signal] == value)
+	{
+		rt_mutex_release(&rule_engine.mutex);
+		return;
+	}
+
+	rule_engine.signal_value[signal] = value;
+	rule_engine.signal_valid |= 1UL << signal;
+	for (i = rule_engine.depend_start[signal]; i < rule_engine.depend_start[signal + 1]; i++)
+	{
+		rule_eval(rule_engine.depend_list[i], now);
+	}
+	rt_mutex_release(&rule_engine.mutex);
+}
+/**
+ * @brief 处理持续时间到期的规则
+ * @note 信号不再变化时，持续时间条件也能按时生效
+ */
+void rule_engine_poll(void)
+{
+	rt_tick_t now = rt_tick_get();
+	rt_uint16_t i;
+
+	if (rule_engine.pending_mask == 0)
+	{
+		return;
+	}
+
+	rt_mutex_take(&rule_engine.mutex, RT_WAITING_FOREVER);
+	for (i = 0; i < rule_engine.rule_count; i++)
+	{
+		if (rule_engine.pending_mask & (1UL << i))
+		{
+			rule_eval(i, now);
+		}
+	}
+	rt_mutex_release(&rule_engine.mutex);
+}
+/**
+ * @brief 获取规则状态
+ * @param rule_index 规则下标
+ * @return rt_bool_t 规则是否成立
+ */
+rt_bool_t get_rule_state(rt_uint16_t rule_index)
+{
+	RT_ASSERT(rule_index < rule_engine.rule_count);
+
+	return rule_engine.state_list[rule_index].active;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file rule_engine.h
+ * @brief 信号变化触发的规则引擎（指示灯、报警）
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  CAN分发函数把解码后的信号交给 rule_engine_update_signal，引擎只重新计算依赖该信号的规则；
+ *		依赖关系在 init_rule_engine 时由规则表生成（信号 -> 规则下标列表）。
+ *		一条规则由若干条件组成（全部成立才成立），条件支持阈值、回差、位掩码，规则可要求条件持续一段时间才生效；
+ *		规则状态变化时才执行输出：修改迪文变量（如位变量图标）或发送CAN帧。
+ */
+#ifndef __RULE_ENGINE_H__
+#define __RULE_ENGINE_H__
+
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================ MACROS ========================================*/
+#define RULE_ENGINE_MAX_SIGNALS			32		//最多信号个数
+#define RULE_ENGINE_MAX_RULES			32		//最多规则个数
+#define RULE_ENGINE_MAX_DEPENDS			64		//信号 -> 规则依赖关系的最多条数
+#define RULE_MAX_CONDITIONS				8		//一条规则最多条件个数
+/*============================ TYPES =========================================*/
+/* 条件类型 */
+typedef enum rule_condition_type
+{
+	RULE_COND_ABOVE = 0,		// 信号 > on_level 时成立，成立后信号 <= off_level 才不成立（off_level < on_level 即回差）
+	RULE_COND_BELOW,			// 信号 < on_level 时成立，成立后信号 >= off_level 才不成立（off_level > on_level 即回差）
+	RULE_COND_BITS_ALL,			// (信号 & mask) == mask
+	RULE_COND_BITS_ANY,			// (信号 & mask) != 0
+}rule_condition_type_t;
+
+/* 输出类型 */
+typedef enum rule_output_type
+{
+	RULE_OUTPUT_NONE = 0,
+	RULE_OUTPUT_DWIN_VAR,		// 修改迪文变量中 mask 对应的位
+	RULE_OUTPUT_CAN,			// 发送CAN帧
+}rule_output_type_t;
+
+/**
+ * @struct rule_condition
+ * @brief 规则中的一个条件
+ */
+typedef struct rule_condition
+{
+	rt_uint16_t signal;				/**< 信号id */
+	rt_uint16_t type;				/**< 条件类型 rule_condition_type_t */
+	rt_int32_t on_level;			/**< 阈值，位掩码条件为掩码 */
+	rt_int32_t off_level;			/**< 回差阈值，位掩码条件不使用 */
+}rule_condition_t;
+/**
+ * @struct rule_output
+ * @brief 规则状态变化时的输出
+ */
+typedef struct rule_output
+{
+	rt_uint16_t type;				/**< 输出类型 rule_output_type_t */
+	rt_uint16_t var_index;			/**< 迪文变量下标 */
+	rt_uint16_t mask;				/**< 修改的位 */
+	rt_uint16_t on_value;			/**< 规则成立时写入的值（主机字节序） */
+	rt_uint16_t off_value;			/**< 规则不成立时写入的值 */
+	rt_uint32_t can_id;				/**< CAN帧id */
+	const rt_uint8_t *can_on_data;	/**< 规则成立时发送的数据 */
+	const rt_uint8_t *can_off_data;	/**< 规则不成立时发送的数据，RT_NULL为不发送 */
+	rt_uint8_t can_size;			/**< CAN帧数据字节数 */
+}rule_output_t;
+/**
+ * @struct rule
+ * @brief 一条规则
+ */
+typedef struct rule
+{
+	const rule_condition_t *condition_list;	/**< 条件列表，全部成立时规则成立 */
+	rt_uint8_t condition_count;		/**< 条件个数 */
+	rt_uint16_t duration_ms;		/**< 条件持续成立多久后规则才成立，0为立即成立；条件不成立时立即解除 */
+	rule_output_t output;			/**< 输出 */
+}rule_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ PROTOTYPES ====================================*/
+/* 初始化规则引擎，规则表需要一直有效 */
+void init_rule_engine(const rule_t *rule_list, rt_uint16_t rule_count, rt_uint16_t signal_count);
+/* 更新信号，只重新计算依赖该信号的规则 */
+void rule_engine_update_signal(rt_uint16_t signal, rt_int32_t value);
+/* 周期调用，处理持续时间到期的规则，在显示线程中调用 */
+void rule_engine_poll(void);
+/* 获取规则状态 */
+rt_bool_t get_rule_state(rt_uint16_t rule_index);
+/*============================ INCLUDES ======================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RULE_ENGINE_H__ */
@@ -14,6 +14,7 @@
 
 #include "interface_can.h"
 #include "dispatcher_can_dwin.h"
+#include "reactor.h"
 
 #define DBG_LEVEL	DBG_LOG
 #define DBG_TAG		"interface_can"
@@ -25,12 +26,15 @@
 /*============================ LOCAL VARIABLES ===============================*/
 /*
 	CAN设备
-	非阻塞侦听线程：用完成量（简化设计、避免忙等待）
+	非阻塞侦听线程：用门铃（计数唤醒，突发的多帧不会丢失通知，避免忙等待）
 */
 static struct 
 {
 	rt_device_t device;//CAN设备
-	struct rt_completion cpt;//接收完成量
+	volatile rt_tick_t rx_tick;//最近一次收到帧的时刻，判断总线是否空闲
+#ifndef INTERFACE_CFG_USING_REACTOR
+	struct rt_doorbell bell;//接收门铃，每收到一帧响一次
+#endif /* INTERFACE_CFG_USING_REACTOR */
 }interface_can;
 /*============================ PROTOTYPES ====================================*/
 /*============================ INTERNAL IMPLEMENTATION =======================*/
@@ -43,9 +47,34 @@ static struct
  */
 static rt_err_t can_rx_callback(rt_device_t dev, rt_size_t size)
 {
-	rt_completion_done(&interface_can.cpt);//释放完成量
+	interface_can.rx_tick = rt_tick_get();
+#ifdef INTERFACE_CFG_USING_REACTOR
+	reactor_signal(REACTOR_EVENT_CAN_RX);//通知事件循环
+#else
+	rt_doorbell_ring(&interface_can.bell);//按门铃，只有计数从0变1时才唤醒线程
+#endif /* INTERFACE_CFG_USING_REACTOR */
 	return RT_EOK;
 }
+#ifdef INTERFACE_CFG_USING_REACTOR
+/**
+ * @brief CAN接收事件处理函数（事件循环线程）
+ * @note 多次接收通知可能合并为一个事件，一次读完接收缓冲区中的所有帧
+ */
+static void can_rx_handler(void)
+{
+	static struct rt_can_msg can_receive_msg;
+
+	while (1)
+	{
+		can_receive_msg.hdr_index = -1;
+		if (rt_device_read(interface_can.device, 0, &can_receive_msg, sizeof(struct rt_can_msg)) != sizeof(struct rt_can_msg))
+		{
+			break;
+		}
+		can_data_parser(can_receive_msg.id, can_receive_msg.data, can_receive_msg.len);
+	}
+}
+#else
 /**
  * @brief CAN数据接收处理函数
  * @param parameter 线程参数（未使用）
@@ -54,37 +83,48 @@ static rt_err_t can_rx_callback(rt_device_t dev, rt_size_t size)
 static void can_rx_dealer(void *parameter)
 {
 	static struct rt_can_msg can_receive_msg;//can接收数据消息原型
+	rt_uint32_t count;//上次唤醒之后收到的帧数
 	while (1)//数据接收处理线程要一直运行，所以用while(1)
 	{
-		can_receive_msg.hdr_index = -1;//不过滤硬件参数表,也就是要处理所有数据
-		rt_completion_wait(&interface_can.cpt, RT_WAITING_FOREVER);//等待can数据接收完成
-		rt_device_read(interface_can.device, 0, &can_receive_msg, sizeof(struct rt_can_msg));//读取CAN数据帧 
-		// 将CAN数据帧中的数据，交给can数据分发器处理函数处理
-		can_data_parser(can_receive_msg.id, can_receive_msg.data, can_receive_msg.len);
-#if 0		
+		rt_doorbell_wait(&interface_can.bell, &count, RT_WAITING_FOREVER);//等待can数据接收完成
+		//每响一次门铃对应一帧，读完这count帧；驱动接收缓冲溢出丢帧时会提前读空
+		while (count--)
 		{
-			int i;
-			// 回环测试
-			can_send(can_receive_msg.id, can_receive_msg.data, can_receive_msg.len);
-			rt_kprintf("Received CAN data frame:(%04X) ->", can_receive_msg.id);
-			for (i = 0; i < can_receive_msg.len; i++)
+			can_receive_msg.hdr_index = -1;//不过滤硬件参数表,也就是要处理所有数据
+			if (rt_device_read(interface_can.device, 0, &can_receive_msg, sizeof(struct rt_can_msg)) != sizeof(struct rt_can_msg))//读取CAN数据帧
 			{
-				rt_kprintf(" %02X", can_receive_msg.data[i]);
+				break;
+			}
+			// 将CAN数据帧中的数据，交给can数据分发器处理函数处理
+			can_data_parser(can_receive_msg.id, can_receive_msg.data, can_receive_msg.len);
+#if 0		
+			{
+				int i;
+				// 回环测试
+				can_send(can_receive_msg.id, can_receive_msg.data, can_receive_msg.len);
+				rt_kprintf("Received CAN data frame:(%04X) ->", can_receive_msg.id);
+				for (i = 0; i < can_receive_msg.len; i++)
+				{
+					rt_kprintf(" %02X", can_receive_msg.data[i]);
+				}
 			}
-		}
 #endif
+		}
 	}
 }
+#endif /* INTERFACE_CFG_USING_REACTOR */
 
 /*============================ EXTERNAL IMPLEMENTATION =======================*/
 /**
  * @brief 初始化CAN总线接口
- * @note 1.查找设备 2.配置波特率 3.设置接收回调 4.创建接收线程
+ * @note 1.查找设备 2.配置波特率 3.设置接收回调 4.创建接收线程（使用事件循环时注册接收事件处理函数）
  */
 void init_can(void)
 {
 	rt_err_t res;//res作为rt_err_t类型的变量会被多次使用，进行控制设备、打开设备成功与否的判断
+#ifndef INTERFACE_CFG_USING_REACTOR
 	rt_thread_t thread;//迪文接收线程变量
+#endif /* INTERFACE_CFG_USING_REACTOR */
 	//查找CAN设备
 	interface_can.device = rt_device_find(INTERFACE_CFG_CAN_NAME);//INTERFACE_CFG_CAN_NAME是设备名称的宏
 	if (interface_can.device == RT_NULL)//当查找设备失败时，断言挂起线程
@@ -106,10 +146,15 @@ void init_can(void)
 		LOG_E("CAN config failure!");
 		RT_ASSERT(0);
 	}
+#ifdef INTERFACE_CFG_USING_REACTOR
+	//接收事件处理函数在接收回调之前注册
+	reactor_register(REACTOR_EVENT_CAN_RX, can_rx_handler);
+	rt_device_set_rx_indicate(interface_can.device, can_rx_callback);
+#else
+	//门铃初始化，要在设置接收回调之前
+	rt_doorbell_init(&interface_can.bell);
 	//设置异步接收回调的核心函数。设备接收到数据时，通过回调函数主动通知应用程序，实现异步处理机制，回调函数被动响应节省了CPU资源
 	rt_device_set_rx_indicate(interface_can.device, can_rx_callback);//can_rx_callback是回调函数
-	//完成量初始化
-	rt_completion_init(&interface_can.cpt);
 	//创建线程
 	thread = rt_thread_create("CAN_RX", can_rx_dealer, RT_NULL, //can_rx_dealer是can数据接收处理函数
 	INTERFACE_CFG_CAN_THREAD_SIZE,//INTERFACE_CFG_CAN_THREAD_SIZE是接收数据缓冲区大小
@@ -122,6 +167,7 @@ void init_can(void)
 	}
 	//启动线程
 	rt_thread_startup(thread);
+#endif /* INTERFACE_CFG_USING_REACTOR */
 }
 /**
  * @brief 发送CAN数据帧
@@ -136,6 +182,11 @@ rt_err_t can_send(rt_uint32_t id, rt_uint8_t *buff, rt_size_t size)
 	int i;
 	rt_uint16_t len;//len用来得到实际发送数据的长度
 	rt_uint16_t length = sizeof(struct rt_can_msg);//lenth用来代替要发送的消息原型所占字节数
+	//启动时显示先于CAN初始化，CAN打开之前（触控参数同步等）不发送
+	if (interface_can.device == RT_NULL)
+	{
+		return RT_ERROR;
+	}
 	//rt-thread消息原型配置
 	can_msg.id = id;
 	can_msg.ide = RT_CAN_STDID;     /**< 标准格式 */
@@ -157,3 +208,43 @@ rt_err_t can_send(rt_uint32_t id, rt_uint8_t *buff, rt_size_t size)
 	
 	return RT_EOK;
 }
+/**
+ * @brief 获取CAN总线的空闲时间
+ * @return rt_tick_t 距最近一次收到帧经过的时钟节拍数
+ */
+rt_tick_t can_rx_idle_time(void)
+{
+	return rt_tick_get() - interface_can.rx_tick;
+}
+/**
+ * @brief 暂停CAN接收
+ * @note 关闭接收中断，暂停期间总线上的帧不接收（硬件FIFO只保留最早的3帧）；与 can_rx_resume 成对使用。
+ *		用于写片内flash：F412只有一个bank，擦写期间CPU停顿，接收本来就会溢出，暂停后丢帧是确定的、可预期的
+ */
+void can_rx_suspend(void)
+{
+	if (interface_can.device != RT_NULL)
+	{
+		rt_device_control(interface_can.device, RT_DEVICE_CTRL_CLR_INT, (void *) RT_DEVICE_FLAG_INT_RX);
+	}
+}
+/**
+ * @brief 恢复CAN接收
+ */
+void can_rx_resume(void)
+{
+	if (interface_can.device != RT_NULL)
+	{
+		rt_device_control(interface_can.device, RT_DEVICE_CTRL_SET_INT, (void *) RT_DEVICE_FLAG_INT_RX);
+	}
+}
+#if defined(RT_USING_FINSH) && defined(RT_DOORBELL_USING_HIGH_WATER) && !defined(INTERFACE_CFG_USING_REACTOR)
+/**
+ * @brief msh命令：打印并清零CAN接收门铃的最大突发深度（一次唤醒取走的最多帧数）
+ */
+static void can_rx_burst(void)
+{
+	rt_kprintf("can rx burst high water: %u\n", rt_doorbell_high_water(&interface_can.bell, RT_TRUE));
+}
+MSH_CMD_EXPORT(can_rx_burst, print and reset the CAN RX doorbell burst high water);
+#endif /* defined(RT_USING_FINSH) && defined(RT_DOORBELL_USING_HIGH_WATER) && ... */
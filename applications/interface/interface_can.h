@@ -26,6 +26,10 @@ extern "C" {
 /*============================ PROTOTYPES ====================================*/
 void init_can(void);
 rt_err_t can_send(rt_uint32_t id, rt_uint8_t *buff, rt_size_t size);
+/* 总线空闲时间，暂停、恢复接收（写片内flash时使用） */
+rt_tick_t can_rx_idle_time(void);
+void can_rx_suspend(void);
+void can_rx_resume(void);
 /*============================ INCLUDES ======================================*/
 
 #ifdef __cplusplus
@@ -11,6 +11,7 @@
 /*============================ INCLUDES ======================================*/
 #include <board.h>
 #include <string.h>
+#include <math.h>
 
 #include "interface_dwin.h"
 #include "interface_curve.h"
@@ -20,78 +21,39 @@
 #include <rtdbg.h>
 
 /*============================ MACROS ========================================*/
-#define CLEAN_CURVE_CAHNNEL_INDEX	4	//
+/**
+ * @brief 曲线帧相关的长度和索引
+ * @note  曲线数据（5A A5 通道数 00 + 各通道数据）写到 0x0310；切换窗口时，
+ *		需要清零的通道状态字（0x0301+2n ~ 0x030F）正好紧挨在 0x0310 前面，
+ *		因此清零和重新填充可以合并成一次从低地址开始的连续写
+ */
+#define CURVE_FRAME_HEAD_SIZE		6		//帧头+写指令+地址
+#define CURVE_CLEAR_WORD_MAX		15		//0x0301~0x030F，最多清零的字数
+#define CURVE_DATA_ADDRESS			0x0310	//曲线数据写入地址
+#define CURVE_PAYLOAD_OFFSET		(CURVE_FRAME_HEAD_SIZE + CURVE_CLEAR_WORD_MAX * 2)	//曲线数据在发送缓冲区中的位置
+#define CURVE_PAYLOAD_MAX_LENGTH	(DWIN_DATA_FRAME_MAX_LENGTH - CURVE_FRAME_HEAD_SIZE)	//曲线数据最大长度
+
+/* 历史视图（回看）和缩放的实时视图都从长历史取数据 */
+#define IS_CURVE_HISTORY_VIEW(window)	((window)->view_offset > 0 || (window)->view_step > 1)
+
+#define CURVE_CHANNEL_COUNT_INDEX	2		//曲线数据内通道数索引
+#define CURVE_DATA_START_INDEX		4		//曲线数据内第一条曲线的位置
+
 /*============================ TYPES =========================================*/
 /*============================ GLOBAL VARIABLES ==============================*/
 /*============================ LOCAL VARIABLES ===============================*/
 /*
-	为了能清空曲线，应该将所有“已使用”曲线通道全部记录下来。
-	实现思路：在初始化曲线时，需要提供该曲线所有通道，然后记录不重复的曲线通道
+	为了能清空曲线，需要知道迪文屏上哪些通道“有数据”。
+	实现思路：每次向通道写入数据就置位，清零后复位；初始化曲线时通道状态未知，也先置位
 */
-/**
- * @brief 清空曲线列表
- * @note 用于清空曲线和曲线是否第一次显示处理
- */
-static struct curve_clean_info
-{
-	rt_int16_t curve_channel;// 曲线通道地址
-	rt_bool_t used;			// 通道使用标记
-}curve_clean_list[DWIN_CURVE_CHANNEL_MAX_COUNT] =			//8个元素
-{
-	//曲线通道清理列表初始化，通道0301~030F
-	{DWIN_CURVE_CHANNEL1, RT_FALSE},
-	{DWIN_CURVE_CHANNEL2, RT_FALSE},
-	{DWIN_CURVE_CHANNEL3, RT_FALSE},
-	{DWIN_CURVE_CHANNEL4, RT_FALSE},
-	{DWIN_CURVE_CHANNEL5, RT_FALSE},
-	{DWIN_CURVE_CHANNEL6, RT_FALSE},
-	{DWIN_CURVE_CHANNEL7, RT_FALSE},
-	{DWIN_CURVE_CHANNEL8, RT_FALSE},
-};
+static rt_uint8_t curve_channel_dirty;			//屏上有数据的通道，bit n 对应通道n
 
 /**
- * @brief 清空曲线命令模板
- * @note  用于清空曲线
+ * @brief 曲线帧发送缓冲区
+ * @note  前 CURVE_PAYLOAD_OFFSET 字节预留给帧头和通道清零字，曲线数据从 CURVE_PAYLOAD_OFFSET 开始填写，
+ *		发送时根据要清零的通道在曲线数据前面补上清零字和帧头
  */
-static rt_uint8_t clean_curve_command[] = 
-{
-	0x5A,
-	0xA5,
-	0x05,
-	0x82,
-	0x03,		// 曲线通道编号
-	0x00,
-	0x00,		// 数据个数为0，自然清空了曲线通道
-	0x00
-};
-
-/**
- * @brief 清空曲线数据的相关索引
- * @note  用于清空
- */
-#define CURVE_CHANNEL_COUNT_INDEX	8	//通道数索引
-#define CURVE_DATA_START_INDEX		10	//曲线数据起始索引
-
-/**
- * @brief 曲线数据帧模板
- * @param DWIN_DATA_FRAME_MAX_LENGTH	255
- * @note  用于准备显示曲线的数据帧
- */
-static rt_uint8_t curve_data_frame[DWIN_DATA_FRAME_MAX_LENGTH] =
-{
-	//帧头+写指令
-	0x5A,
-	0xA5,
-	0x00,		// 后续字节数	DWIN_DATA_BYTE_COUNT_INDEX
-	0x82,
-	0x03,
-	0x10,
-	//曲线数据头
-	0x5A,
-	0xA5,
-	0x00,		// 同时写入的曲线通道个数
-	0x00,
-};
+static rt_uint8_t curve_data_frame[CURVE_PAYLOAD_OFFSET + CURVE_PAYLOAD_MAX_LENGTH];
 
 /**
  * @brief 曲线数据帧相关的索引
@@ -103,10 +65,10 @@ static rt_uint8_t curve_data_frame[DWIN_DATA_FRAME_MAX_LENGTH] =
 
 /**
  * @brief 单曲线发送缓冲区
- * @param DWIN_CURVE_DATA_MAX_COUNT	20
+ * @param DWIN_CURVE_DATA_MAX_DEPTH	120
  * @note  用于接收曲线数据
  */
-static rt_uint8_t one_curve_data_buff[DWIN_CURVE_DATA_MAX_COUNT * 2 + 2] =
+static rt_uint8_t one_curve_data_buff[DWIN_CURVE_DATA_MAX_DEPTH * 2 + 2] =
 {
 	0x00,		// 曲线通道编号00~07
 	0x00,		// 本次写入的数据个数
@@ -114,9 +76,19 @@ static rt_uint8_t one_curve_data_buff[DWIN_CURVE_DATA_MAX_COUNT * 2 + 2] =
 
 /**
  * @brief 曲线列表
- * @note  用于存储多条曲线数据
+ * @note  用于存储多条曲线数据；曲线结构体和数据队列在 init_curve 时从曲线存储区分配，未使用的曲线只占一个指针
  */
-static curve_data_t curve_list[DWIN_CURVE_MAX_COUNT];//曲线列表，32个元素，用于存储曲线数据
+static curve_data_t *curve_list[DWIN_CURVE_MAX_COUNT];//曲线列表，32个元素，用于存储曲线数据
+
+/**
+ * @brief 曲线存储区
+ * @note  曲线结构体、数据队列、长历史（控制结构和压缩块）和统计窗口都从这里顺序分配，分配后不再释放
+ */
+rt_align(RT_ALIGN_SIZE)
+static rt_uint8_t curve_arena[DWIN_CURVE_BUFFER_ARENA_SIZE + DWIN_CURVE_HISTORY_ARENA_SIZE + DWIN_CURVE_STAT_ARENA_SIZE];
+static rt_size_t curve_arena_used;								//已分配字节数
+
+static curve_stat_output_t curve_stat_output;					//统计量输出函数
 
 /* 曲线窗口配置 */
 static struct curve_window
@@ -124,37 +96,354 @@ static struct curve_window
 	rt_int16_t curve_index_list[DWIN_CURVE_IN_WINDOW_MAX_COUNT];//曲线下标列表，8个元素
 	rt_int16_t curve_count;										//曲线数量
 	rt_bool_t first_show;										//首次显示标记
+	rt_uint32_t view_offset;									//历史视图：距最新数据的点数，0为实时显示
+	rt_uint16_t view_step;										//历史视图：抽取步长（缩放）
+	rt_uint32_t view_end;										//缩放的实时视图：上次画到的长历史序号
 }curve_window_list[DWIN_CURVE_WINDOW_MAX_COUNT];//16个元素
 
 static volatile rt_int16_t current_curve_window_index;			//当前窗口索引
 static volatile rt_int16_t last_curve_window_index;				//上一次窗口索引
+
+static rt_tick_t next_sample_tick;								//下一个公共采样时刻
+static rt_bool_t sample_started;								//是否已开始采样
 /*============================ PROTOTYPES ====================================*/
 /*============================ INTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 从曲线存储区分配内存
+ * @param size 字节数，按 RT_ALIGN_SIZE 对齐
+ * @return void* 分配到的内存
+ * @note  存储区不足时输出日志并断言
+ */
+static void *curve_arena_alloc(rt_size_t size)
+{
+	void *buff;
+
+	size = RT_ALIGN(size, RT_ALIGN_SIZE);
+	if (curve_arena_used + size > sizeof(curve_arena))//存储区不足
+	{
+		LOG_W("curve arena overflow (%d + %d > %d)!", curve_arena_used, size, sizeof(curve_arena));
+		RT_ASSERT(0);
+	}
+
+	buff = curve_arena + curve_arena_used;
+	curve_arena_used += size;
+
+	return buff;
+}
+/**
+ * @brief 获取已初始化的曲线
+ * @param curve_id 曲线ID
+ * @return curve_data_t* 曲线
+ * @note  ID超限或曲线未初始化时输出日志并断言
+ */
+static curve_data_t *get_curve(rt_uint16_t curve_id)
+{
+	if (curve_id >= DWIN_CURVE_MAX_COUNT)//id大于最大曲线通道数，也就是曲线已满
+	{
+		LOG_W("curve index (%d) too large!", curve_id);
+		RT_ASSERT(0);
+	}
+
+	if (curve_list[curve_id] == RT_NULL)
+	{
+		LOG_W("curve (%d) not initialized!", curve_id);
+		RT_ASSERT(0);
+	}
+
+	return curve_list[curve_id];
+}
+/**
+ * @brief 统计比较用的数值
+ * @note  有符号数据按 rt_int16_t 解释，保证单调队列和均值对负数正确
+ */
+static rt_int32_t curve_stat_key(const curve_stat_t *stat, rt_uint16_t value)
+{
+	return stat->is_signed ? (rt_int32_t) (rt_int16_t) value : (rt_int32_t) value;
+}
+/**
+ * @brief 最旧的数据移出统计窗口
+ * @note  单调队列队首正是这个数据时一并移出；均值和方差按 Welford 方法反向更新
+ */
+static void curve_stat_remove_oldest(curve_stat_t *stat)
+{
+	float x = (float) curve_stat_key(stat, stat->sample_list[stat->head].value);
+	float delta;
+
+	if (stat->min_count > 0 && stat->min_deque[stat->min_head] == stat->head)
+	{
+		stat->min_head = (stat->min_head + 1) % stat->capacity;
+		--stat->min_count;
+	}
+	if (stat->max_count > 0 && stat->max_deque[stat->max_head] == stat->head)
+	{
+		stat->max_head = (stat->max_head + 1) % stat->capacity;
+		--stat->max_count;
+	}
+
+	stat->head = (stat->head + 1) % stat->capacity;
+	--stat->count;
+
+	if (stat->count == 0)//窗口清空，同时消除累计的舍入误差
+	{
+		stat->mean = 0;
+		stat->m2 = 0;
+		return;
+	}
+
+	delta = x - stat->mean;
+	stat->mean -= delta / stat->count;
+	stat->m2 -= delta * (x - stat->mean);
+	if (stat->m2 < 0)
+	{
+		stat->m2 = 0;
+	}
+}
+/**
+ * @brief 数据进入统计窗口
+ * @note  先移出超出个数或时间的旧数据；单调队列从队尾弹出被新数据“压住”的下标后再入队
+ */
+static void curve_stat_add(curve_stat_t *stat, rt_tick_t tick, rt_uint16_t value)
+{
+	rt_int32_t key = curve_stat_key(stat, value);
+	rt_uint16_t slot;
+	float delta;
+
+	if (stat->count == stat->capacity)
+	{
+		curve_stat_remove_oldest(stat);
+	}
+	while (stat->window_tick != 0 && stat->count > 0
+			&& tick - stat->sample_list[stat->head].tick >= stat->window_tick)
+	{
+		curve_stat_remove_oldest(stat);
+	}
+
+	slot = (stat->head + stat->count) % stat->capacity;
+	stat->sample_list[slot].tick = tick;
+	stat->sample_list[slot].value = value;
+	++stat->count;
+
+	delta = key - stat->mean;
+	stat->mean += delta / stat->count;
+	stat->m2 += delta * (key - stat->mean);
+
+	while (stat->min_count > 0 && curve_stat_key(stat,
+			stat->sample_list[stat->min_deque[(stat->min_head + stat->min_count - 1) % stat->capacity]].value) >= key)
+	{
+		--stat->min_count;
+	}
+	stat->min_deque[(stat->min_head + stat->min_count) % stat->capacity] = slot;
+	++stat->min_count;
+
+	while (stat->max_count > 0 && curve_stat_key(stat,
+			stat->sample_list[stat->max_deque[(stat->max_head + stat->max_count - 1) % stat->capacity]].value) <= key)
+	{
+		--stat->max_count;
+	}
+	stat->max_deque[(stat->max_head + stat->max_count) % stat->capacity] = slot;
+	++stat->max_count;
+}
+/**
+ * @brief 把绑定的统计量输出到迪文变量
+ * @note  输出为原始数据单位（四舍五入），字节序和显示换算由输出函数决定
+ */
+static void curve_stat_publish(const curve_stat_t *stat)
+{
+	rt_int32_t value[CURVE_STAT_TYPE_COUNT];
+	float rms;
+	rt_uint16_t type;
+
+	if (curve_stat_output == RT_NULL || stat->count == 0)
+	{
+		return;
+	}
+
+	rms = sqrtf(stat->mean * stat->mean + stat->m2 / stat->count);
+	value[CURVE_STAT_MIN] = curve_stat_key(stat, stat->sample_list[stat->min_deque[stat->min_head]].value);
+	value[CURVE_STAT_MAX] = curve_stat_key(stat, stat->sample_list[stat->max_deque[stat->max_head]].value);
+	value[CURVE_STAT_MEAN] = (rt_int32_t) (stat->mean + (stat->mean < 0 ? -0.5f : 0.5f));
+	value[CURVE_STAT_RMS] = (rt_int32_t) (rms + 0.5f);
+
+	for (type = 0; type < CURVE_STAT_TYPE_COUNT; type++)
+	{
+		if (stat->var_index[type] >= 0)
+		{
+			curve_stat_output(stat->var_index[type], (rt_uint16_t) value[type]);
+		}
+	}
+}
+/**
+ * @brief 从长历史读取窗口视图对应的一屏数据
+ * @param curve 曲线
+ * @param curve_window 曲线窗口，提供视图偏移和步长
+ * @param buff 输出缓冲区
+ * @return rt_uint16_t 读取的数据点数
+ * @note  视图右端为最新数据往前 view_offset 个点，向左取 view_step * DWIN_CURVE_DATA_MAX_COUNT 个点；
+ *		翻到最旧数据时停在最旧的一屏
+ */
+static rt_uint16_t read_curve_history(curve_data_t *curve, const struct curve_window *curve_window, rt_uint16_t *buff)
+{
+	rt_uint32_t span = (rt_uint32_t) curve_window->view_step * DWIN_CURVE_DATA_MAX_COUNT;//一屏覆盖的数据点数
+	rt_uint32_t first;
+	rt_uint32_t next;
+	rt_uint32_t end;
+	rt_uint32_t start;
+
+	if (curve->history == RT_NULL)//未开启长历史的曲线在历史视图中不显示
+	{
+		return 0;
+	}
+
+	first = curve_history_first_seq(curve->history);
+	next = curve_history_next_seq(curve->history);
+	if (curve_window->view_offset == 0)//缩放的实时视图，右端按步长对齐，每前进一个步长画面整体左移一个点
+	{
+		next -= next % curve_window->view_step;
+	}
+	end = next > curve_window->view_offset ? next - curve_window->view_offset : 0;
+	if (end < first + span)
+	{
+		end = next < first + span ? next : first + span;
+	}
+	start = end > first + span ? end - span : first;
+
+	return curve_history_read(curve->history, start, curve_window->view_step, buff, DWIN_CURVE_DATA_MAX_COUNT);
+}
+/**
+ * @brief 缩放的实时视图右端的长历史序号（按步长对齐）
+ * @note  取窗口中第一条开启长历史的曲线，同一窗口的曲线同时采样，序号只差开始采样前的几个周期
+ */
+static rt_uint32_t get_live_view_end(const struct curve_window *curve_window)
+{
+	curve_data_t *curve;
+	rt_uint32_t next;
+	rt_int16_t index;
+
+	for (index = 0; index < curve_window->curve_count; index++)
+	{
+		curve = curve_list[curve_window->curve_index_list[index]];
+		if (curve->history != RT_NULL)
+		{
+			next = curve_history_next_seq(curve->history);
+			return next - next % curve_window->view_step;
+		}
+	}
+
+	return 0;
+}
+/**
+ * @brief 计算曲线在 tick 时刻的值
+ * @param curve 曲线
+ * @param tick  公共采样时刻
+ * @return rt_uint16_t 重采样后的数据
+ * @note  tick 不早于最近一个数据时保持最近值；落在前后两个数据之间时按方式保持前值或线性插值；
+ *		tick 早于前一个数据（原始数据比采样周期密）时取前值。
+ *		插值按16位有符号差值计算，适用于有符号和无符号数据（相邻数据跳变不超过32767）
+ */
+static rt_uint16_t sample_curve_value(const curve_data_t *curve, rt_tick_t tick)
+{
+	rt_int32_t delta;
+	rt_int32_t span;
+	rt_int32_t elapsed;
+
+	if ((rt_int32_t) (tick - curve->last_tick) >= 0 || curve->raw_count < 2)
+	{
+		return curve->last_value;
+	}
+
+	elapsed = (rt_int32_t) (tick - curve->prev_tick);
+	if (curve->sample_mode != CURVE_SAMPLE_LINEAR || elapsed <= 0)
+	{
+		return curve->prev_value;
+	}
+
+	span = (rt_int32_t) (curve->last_tick - curve->prev_tick);
+	delta = (rt_int16_t) (curve->last_value - curve->prev_value);
+
+	return (rt_uint16_t) (curve->prev_value + delta * elapsed / span);
+}
+/**
+ * @brief 组帧并发送：清零通道 + 曲线数据
+ * @param clear_mask 需要清零的通道，bit n 对应通道n
+ * @param payload_length 曲线数据长度，曲线数据已填写在 curve_data_frame + CURVE_PAYLOAD_OFFSET，0表示只清零
+ * @note  从最低的待清零通道状态字写到 0x0310 之后，中间经过的通道要么待清零，要么本来就没有数据，
+ *		写0不影响显示；合并后超过一帧长度时退化为清零帧+数据帧两帧
+ */
+static void send_curve_frame(rt_uint8_t clear_mask, rt_uint16_t payload_length)
+{
+	rt_uint8_t *frame;
+	rt_uint16_t address = CURVE_DATA_ADDRESS;
+	rt_uint16_t clear_words = 0;
+	rt_uint16_t length;
+	rt_uint16_t channel;
+
+	if (clear_mask != 0)
+	{
+		for (channel = 0; (clear_mask & (1 << channel)) == 0; channel++);//最低的待清零通道
+		address = DWIN_CURVE_CHANNEL1 + channel * 2;
+		clear_words = CURVE_DATA_ADDRESS - address;
+	}
+
+	if (clear_words > 0 && payload_length > 0
+		&& CURVE_FRAME_HEAD_SIZE + clear_words * 2 + payload_length > DWIN_DATA_FRAME_MAX_LENGTH)
+	{
+		send_curve_frame(clear_mask, 0);
+		send_curve_frame(0, payload_length);
+		return;
+	}
+
+	frame = curve_data_frame + CURVE_PAYLOAD_OFFSET - clear_words * 2 - CURVE_FRAME_HEAD_SIZE;
+	length = CURVE_FRAME_HEAD_SIZE + clear_words * 2 + payload_length;
+	frame[0] = 0x5A;
+	frame[1] = 0xA5;
+	frame[DWIN_DATA_BYTE_COUNT_INDEX] = (length - 3) & 0xFF;
+	frame[3] = DWIN_COMMAND_WRITE;
+	frame[DWIN_DATA_FRAME_ADDRESS_INDEX] = (address >> 8) & 0xFF;
+	frame[DWIN_DATA_FRAME_ADDRESS_INDEX + 1] = address & 0xFF;
+	rt_memset(frame + CURVE_FRAME_HEAD_SIZE, 0, clear_words * 2);//通道状态字清零，数据个数为0，自然清空了曲线通道
+
+	dwin_serial_send(frame, length);
+	curve_channel_dirty &= ~clear_mask;
+}
 /**
  * @brief 获取并预处理曲线数据
  * @param curve_id 曲线ID
  * @param all 是否获取全部数据
+ * @param curve_window 曲线所在窗口，处于历史视图时从长历史取数据
+ * @param max_count 本帧剩余空间最多能放的数据个数，数据更多时只取最新的
  * @return rt_uint16_t 有效数据点数
  */
-static rt_uint16_t get_and_adjust_curve_data(rt_uint16_t curve_id, rt_bool_t all)
+static rt_uint16_t get_and_adjust_curve_data(rt_uint16_t curve_id, rt_bool_t all, const struct curve_window *curve_window,
+		rt_uint16_t max_count)
 {
-	curve_data_t *curve = &curve_list[curve_id];//获取曲线id地址
+	curve_data_t *curve = curve_list[curve_id];//获取曲线id地址
 	rt_uint16_t curve_data_count = 0;			//曲线数量计数
 	rt_uint16_t *curve_data_list;				//获取曲线数据列表地址
 	rt_uint16_t index;
 	/* curve_data_list是曲线数据列表指针，曲线数据本身，先把把缓冲区的数据强制类型转换成rt_uint16_t，跳过两字节得到指针 */
 	curve_data_list = (rt_uint16_t *) (one_curve_data_buff + CURVE_DATA_OFFSET_INDEX);
+	if (max_count > DWIN_CURVE_DATA_MAX_DEPTH)
+	{
+		max_count = DWIN_CURVE_DATA_MAX_DEPTH;
+	}
 	/* 从队列获取数据（带互斥锁保护），关闭接收数据 */
-	rt_mutex_take(curve->mutex, RT_WAITING_FOREVER);
-	if (all == RT_TRUE)//如果需要获取所有数据，则调用相应函数，否则，仅获取最新数据
+	rt_mutex_take(&curve->mutex, RT_WAITING_FOREVER);
+	if (IS_CURVE_HISTORY_VIEW(curve_window))//历史视图，从长历史解码一屏数据
+	{
+		if (max_count >= DWIN_CURVE_DATA_MAX_COUNT)
+		{
+			curve_data_count = read_curve_history(curve, curve_window, curve_data_list);
+		}
+	}
+	else if (all == RT_TRUE)//如果需要获取所有数据，则调用相应函数，否则，仅获取最新数据
 	{
-		curve_data_count = curve_data_queue_get_all_data(&curve->queue, curve_data_list);//获取所有数据
+		curve_data_count = curve_data_queue_get_all_data(&curve->queue, curve_data_list, max_count);//获取所有数据
 	}
 	else 
 	{
-		curve_data_count = curve_data_queue_get_last_data(&curve->queue, curve_data_list);//获取最新数据
+		curve_data_count = curve_data_queue_get_last_data(&curve->queue, curve_data_list, max_count);//获取最新数据
 	}
-	rt_mutex_release(curve->mutex);// 释放互斥锁
+	rt_mutex_release(&curve->mutex);// 释放互斥锁
 	
 	if (curve_data_count == 0)// 如果没有获取到任何数据，则直接返回
 	{
@@ -177,6 +466,9 @@ static rt_uint16_t get_and_adjust_curve_data(rt_uint16_t curve_id, rt_bool_t all
  * @brief 曲线显示
  * @param curve_window_id 曲线窗口ID，用于指定哪个窗口的曲线数据需要显示
  * @param all 是否显示所有曲线数据的标志，为真时显示所有数据，为假时按一定规则筛选数据
+ * @note  all 为真表示窗口切换（或视图改变）后的首次显示：屏上有数据的通道（上一个窗口留下的，
+ *		以及本窗口通道里的旧数据）和本窗口的全部数据合并成一帧发出，不再逐通道清空和延时。
+ *		回看的历史视图是静止的，只在首次显示时画；缩放的实时视图每积累一个步长的新数据整屏重画一次
  */
 void curve_show(rt_int16_t curve_window_id, rt_bool_t all)
 {
@@ -186,38 +478,77 @@ void curve_show(rt_int16_t curve_window_id, rt_bool_t all)
 	rt_uint16_t index;
 	rt_uint16_t one_curve_data_count = 0;// 单条曲线数据数量计数
 	rt_uint16_t curve_data_offset = CURVE_DATA_START_INDEX;// 曲线数据偏移量，用于确定曲线数据在数据帧中的位置
+	rt_uint8_t *payload = curve_data_frame + CURVE_PAYLOAD_OFFSET;// 曲线数据（5A A5 通道数 00 ...）
+	rt_uint8_t channel_count = 0;// 实际写入的通道数
+	rt_uint8_t filled_mask = 0;// 本次写入数据的通道
+	rt_uint8_t clear_mask = 0;// 本次需要清零的通道
+	rt_uint16_t share;// 本条曲线可用的帧空间（字节）
+	rt_uint32_t end;// 缩放的实时视图右端的长历史序号
 	
 	curve_window = &curve_window_list[curve_window_id];// 曲线窗口列表指针
 	show_curve_count = curve_window->curve_count;// 获取当前窗口中曲线的数量
 
-	curve_data_frame[CURVE_CHANNEL_COUNT_INDEX] = show_curve_count & 0xFF;//CURVE_CHANNEL_COUNT_INDEX为8，也就是曲线数据帧模板列表第九个元素，这个元素表明曲线通道数量
+	if (IS_CURVE_HISTORY_VIEW(curve_window))
+	{
+		end = get_live_view_end(curve_window);
+		if (all == RT_FALSE && (curve_window->view_offset > 0 || end == curve_window->view_end))//画面没有变化
+		{
+			return;
+		}
+		curve_window->view_end = end;
+		all = RT_TRUE;//从长历史取的一屏数据不能追加，只能清零后重画
+	}
+
+	if (all == RT_TRUE)//首次显示：屏上所有有数据的通道都要先清零，本窗口的通道随后在同一帧中重新填充
+	{
+		clear_mask = curve_channel_dirty;
+	}
+
 	/* 遍历窗口内所有曲线 */
 	for (index = 0; index < show_curve_count; index++)
 	{
+		// 帧剩余空间由剩下的曲线平分，深度大的曲线数据多时只取最新的，保证同一窗口的曲线都能放进一帧
+		share = (CURVE_PAYLOAD_MAX_LENGTH - curve_data_offset) / (show_curve_count - index);
+		if (share <= 2)// 一帧放不下，丢弃后面的曲线
+		{
+			LOG_W("curve window (%d) data too long!", curve_window_id);
+			break;
+		}
 		// 获取并调整单条曲线的数据，根据'all'参数决定是否获取所有数据
-		one_curve_data_count = get_and_adjust_curve_data(curve_window->curve_index_list[index], all);
+		one_curve_data_count = get_and_adjust_curve_data(curve_window->curve_index_list[index], all, curve_window,
+				(share - 2) / 2);
 		if (one_curve_data_count <= 0)// 如果当前曲线没有数据，则跳过当前循环
 		{
 			continue;
 		}
 		// 到这里说明已经取出一条曲线的相关数据，且，已经构成这条曲线的数据
 		// 且所形成的曲线数据字节数为：one_curve_data_count * 2 + 2
-		// 需要将上述字节内容，复制到curve_data_frame的相关位置。
-		// curve_data_frame的相关位置（偏移量）初始值为：CURVE_DATA_START_INDEX
+		// 需要将上述字节内容，复制到曲线数据的相关位置。
+		// 相关位置（偏移量）初始值为：CURVE_DATA_START_INDEX
 		// 以后，每增加一条curve的数据，偏移量需要加one_curve_data_count * 2 + 2
-		rt_memcpy(curve_data_frame + curve_data_offset, one_curve_data_buff, one_curve_data_count * 2 + 2);
+		rt_memcpy(payload + curve_data_offset, one_curve_data_buff, one_curve_data_count * 2 + 2);
 		curve_data_offset += one_curve_data_count * 2 + 2;
 		
 		show_curve_data_count += one_curve_data_count;// 累加显示的曲线数据数量
+		filled_mask |= 1 << one_curve_data_buff[CURVE_CHANNEL_ID_INDEX];
+		++channel_count;
 	}
 	
-	if (show_curve_data_count <= 0)// 如果没有曲线数据需要显示，则直接返回
+	if (show_curve_data_count <= 0)// 如果没有曲线数据需要显示，则只清零
 	{
+		if (clear_mask != 0)
+		{
+			send_curve_frame(clear_mask, 0);
+		}
 		return;
 	}
 	
-	curve_data_frame[DWIN_DATA_BYTE_COUNT_INDEX] = (curve_data_offset - 3) & 0xFF;
-	dwin_serial_send(curve_data_frame, curve_data_offset);
+	payload[0] = 0x5A;
+	payload[1] = 0xA5;
+	payload[CURVE_CHANNEL_COUNT_INDEX] = channel_count;// 同时写入的曲线通道个数
+	payload[CURVE_CHANNEL_COUNT_INDEX + 1] = 0x00;
+	send_curve_frame(clear_mask, curve_data_offset);
+	curve_channel_dirty |= filled_mask;
 	
 /*
 	要显示的曲线数据个数 = 0;
@@ -294,24 +625,131 @@ void set_current_curve_window(rt_int16_t curve_window_id)
 	current_curve_window_index = curve_window_id;// 当前曲线窗口id交给当前曲线窗口索引，其它用到current_curve_window_index时就显示曲线窗口id值的曲线
 }
 
+/**
+ * @brief 设置曲线窗口的历史视图
+ * @param curve_window_id	曲线窗口id
+ * @param back_offset		视图右端距最新数据的点数，0表示实时显示
+ * @param step				抽取步长，1为原始分辨率，越大显示的时间跨度越长
+ * @note  视图改变后标记窗口为首次显示，由显示线程清空曲线并重画整屏；
+ *		实时显示且步长大于1时为缩放的实时视图，从长历史取最新的一屏，未开启长历史的曲线不显示
+ */
+void set_curve_window_view(rt_int16_t curve_window_id, rt_uint32_t back_offset, rt_uint16_t step)
+{
+	struct curve_window *curve_window;
+
+	if (curve_window_id < 0 || curve_window_id >= DWIN_CURVE_WINDOW_MAX_COUNT)
+	{
+		LOG_W("curve window index (%d) error!", curve_window_id);
+		return;
+	}
+
+	if (step == 0)
+	{
+		step = 1;
+	}
+	else if (step > DWIN_CURVE_HISTORY_MAX_STEP)
+	{
+		step = DWIN_CURVE_HISTORY_MAX_STEP;
+	}
+
+	curve_window = &curve_window_list[curve_window_id];
+	if (curve_window->view_offset == back_offset && curve_window->view_step == step)
+	{
+		return;
+	}
+
+	curve_window->view_offset = back_offset;
+	curve_window->view_step = step;
+	curve_window->first_show = RT_TRUE;
+}
+
 /* 
  * @brief 添加曲线数据
  * @param curve_id			曲线id
  * @param data				要添加的数据，来源是上位机发送的数据帧，被分发器分发的数据
  * @note  先判断曲线通道是否已满，已满输出日志并断言，若未满，先互斥锁线锁住曲线列表，不再取数据，之后互斥锁放开曲线列表。
- * 		曲线数据的接收来自can侦听线程，发送来自显示线程，使用互斥锁保证线程安全
+ * 		曲线数据的接收来自can侦听线程，发送来自显示线程，使用互斥锁保证线程安全。
+ * 		数据在这里打上时间戳，由 curve_sample_poll 统一重采样；开启统计的曲线同时更新统计窗口并输出统计量
 */
 void add_curve_data(rt_uint16_t curve_id, rt_uint16_t data)
 {
-	if (curve_id >= DWIN_CURVE_MAX_COUNT)//id大于最大曲线通道数，也就是曲线已满
+	curve_data_t *curve = get_curve(curve_id);
+
+	rt_mutex_take(&curve->mutex, RT_WAITING_FOREVER);//使用互斥量让曲线列表不再取数据
+	// 只记录带时间戳的原始数据，由 curve_sample_poll 按公共时刻重采样后进入队列
+	curve->prev_tick = curve->last_tick;
+	curve->prev_value = curve->last_value;
+	curve->last_tick = rt_tick_get();
+	curve->last_value = data;
+	if (curve->raw_count < 2)
 	{
-		LOG_W("curve index (%d) too large!", curve_id);
-		RT_ASSERT(0);
+		++curve->raw_count;
 	}
-	
-	rt_mutex_take(curve_list[curve_id].mutex, RT_WAITING_FOREVER);//使用互斥量让曲线列表不再取数据
-	curve_data_queue_add_data(&curve_list[curve_id].queue, data);//曲线数据队列添加数据
-	rt_mutex_release(curve_list[curve_id].mutex);//放开互斥量
+	if (curve->stat != RT_NULL)//统计按原始数据增量更新，不受重采样影响
+	{
+		curve_stat_add(curve->stat, curve->last_tick, data);
+		curve_stat_publish(curve->stat);
+	}
+	rt_mutex_release(&curve->mutex);//放开互斥量
+}
+/**
+ * @brief 按公共采样周期对所有曲线重采样
+ * @note  由显示线程调用。每到一个采样时刻，所有已收到数据的曲线在同一时刻取值，
+ *		写入曲线数据队列和长历史，同窗口的曲线因此按时间对齐，不受各CAN帧周期和抖动影响；
+ *		工作量只与经过的采样周期数有关，与收到的CAN帧数无关。
+ *		显示线程滞后超过 DWIN_CURVE_SAMPLE_CATCH_UP 个周期时，丢弃更早的周期。
+ *		取值时刻比采样时刻晚一个周期：采样时刻到达时，其后的数据还没收到，只能保持最近值，线性插值不起作用；
+ *		退后一个周期后，取值时刻通常落在前后两个原始数据之间。所有曲线因此固定延迟一个采样周期显示
+ */
+void curve_sample_poll(void)
+{
+	rt_tick_t now = rt_tick_get();
+	rt_tick_t period = rt_tick_from_millisecond(DWIN_CURVE_SAMPLE_PERIOD);
+	curve_data_t *curve;
+	rt_uint16_t index;
+	rt_uint16_t value;
+
+	if (sample_started == RT_FALSE)
+	{
+		next_sample_tick = now;
+		sample_started = RT_TRUE;
+	}
+
+	if ((rt_int32_t) (now - next_sample_tick) >= (rt_int32_t) (period * DWIN_CURVE_SAMPLE_CATCH_UP))
+	{
+		next_sample_tick = now - period * (DWIN_CURVE_SAMPLE_CATCH_UP - 1);
+	}
+
+	while ((rt_int32_t) (now - next_sample_tick) >= 0)
+	{
+		for (index = 0; index < DWIN_CURVE_MAX_COUNT; index++)
+		{
+			curve = curve_list[index];
+			if (curve == RT_NULL || curve->raw_count == 0)//未初始化或还没有数据
+			{
+				continue;
+			}
+
+			rt_mutex_take(&curve->mutex, RT_WAITING_FOREVER);
+			value = sample_curve_value(curve, next_sample_tick - period);//退后一个周期取值，见函数说明
+			curve_data_queue_add_data(&curve->queue, value);//曲线数据队列添加数据
+			if (curve->history != RT_NULL)//同时写入长历史
+			{
+				curve_history_add_data(curve->history, value);
+			}
+			rt_mutex_release(&curve->mutex);
+		}
+		next_sample_tick += period;
+	}
+}
+/**
+ * @brief 设置曲线重采样方式
+ * @param curve_id 曲线id
+ * @param mode 保持或线性插值，默认为保持
+ */
+void set_curve_sample_mode(rt_uint16_t curve_id, curve_sample_mode_t mode)
+{
+	get_curve(curve_id)->sample_mode = mode;
 }
 
 /* 
@@ -325,11 +763,7 @@ void add_curve_to_window(rt_uint16_t curve_id, rt_uint16_t curve_window_id)
 {
 	rt_uint16_t curve_count;//记录目标窗口曲线数量
 	
-	if (curve_id >= DWIN_CURVE_MAX_COUNT)//检查 curve_id 是否超出最大允许值，若超出则记录警告并断言失败。
-	{
-		LOG_W("curve index (%d) too large!", curve_id);
-		RT_ASSERT(0);
-	}
+	get_curve(curve_id);//检查 curve_id 是否超出最大允许值、曲线是否已初始化，否则记录警告并断言失败。
 	
 	if (curve_window_id >= DWIN_CURVE_WINDOW_MAX_COUNT)//检查 curve_window_id 是否超出最大允许值，若超出则同样记录警告并断言失败。
 	{
@@ -345,87 +779,213 @@ void add_curve_to_window(rt_uint16_t curve_id, rt_uint16_t curve_window_id)
 /* 
  * @brief 清空曲线
  * @param 无
- * @note  遍历曲线清理列表 curve_clean_list，将标记为“已使用”（used == RT_TRUE）的通道信息打包成清理命令 clean_curve_command，
-		并通过串口发送出去，每次发送后延时1毫秒，确保串口有足够时间处理数据。 
+ * @note  把屏上所有有数据的通道（curve_channel_dirty）用一帧连续写清零，不需要逐通道发送和延时
 */
 void clean_curve(void)
 {
-	int index;
-	//遍历所有通道
-	for (index = 0; index < DWIN_CURVE_CHANNEL_MAX_COUNT; index++)
+	if (curve_channel_dirty != 0)
 	{
-		if (curve_clean_list[index].used == RT_TRUE)//若曲线窗口被使用过，则提取通道号并组成曲线清除命令；
-		{
-			//下面两个赋值语句是把清空曲线通道列表的通道地址的低字节和高字节分别放入清空曲线指令列表的第五、第六元素，
-			//由于curve_clean_list列表存储数据的方式是小端存储，所以实际放入第五、第六字节就是03和xx
-			clean_curve_command[CLEAN_CURVE_CAHNNEL_INDEX] = curve_clean_list[index].curve_channel & 0xFF;
-			clean_curve_command[CLEAN_CURVE_CAHNNEL_INDEX + 1] = (curve_clean_list[index].curve_channel >> 8) & 0xFF;
-#if 0			
-			{
-				int i;
-				char str[128];
-				char tmp[16];
-				
-				rt_sprintf(str, "clean command :");
-				for (i = 0; i < sizeof(clean_curve_command); i++)
-				{
-					rt_sprintf(tmp, " %02X", clean_curve_command[i]);
-					strcat(str, tmp);
-				}
-				LOG_I(str);
-			}
-#endif
-			dwin_serial_send(clean_curve_command, sizeof(clean_curve_command));//串口发送清空曲线命令到迪文屏，清空曲线数据
-			// 串口数据的发送，实际上是通过rt_thread提供的底层操作完成的。
-			// 有可能是通过线程实现的，也有可能是通过中断实现的；
-			// 串口数据发送是耗时的，因此，需要适当的延时。
-			rt_thread_mdelay(1);
-		}
+		send_curve_frame(curve_channel_dirty, 0);
 	}
 }
 /**
  * @brief 初始化曲线配置
  * @param curve_id 曲线的ID，用于标识特定的曲线
  * @param curve_channel 曲线的通道，用于区分不同的数据通道
+ * @param depth 曲线数据队列深度（数据个数），变化快的信号可以给深一些，首次显示时显示更长的时间段；
+ *		不超过 DWIN_CURVE_DATA_MAX_DEPTH，0表示使用默认深度 DWIN_CURVE_DATA_MAX_COUNT
  * @param adjust_fun 曲线数据调整函数指针，用于后续对曲线数据的调整
- * @note  mutex用于线程安全
+ * @note  曲线结构体和数据队列从曲线存储区分配，每条曲线只能初始化一次；mutex用于线程安全
  */
-void init_curve(rt_uint16_t curve_id, rt_uint16_t curve_channel, curve_data_adjust_t adjust_fun)
+void init_curve(rt_uint16_t curve_id, rt_uint16_t curve_channel, rt_uint16_t depth, curve_data_adjust_t adjust_fun)
 {
-	rt_uint16_t index;
-	
+	curve_data_t *curve;
+
 	if (curve_id >= DWIN_CURVE_MAX_COUNT)//检查曲线ID是否超出最大数量限制，如果超出，记录警告日志并断言失败
 	{
 		LOG_W("curve index (%d) too large!", curve_id);
 		RT_ASSERT(0);
 	}
 	
-	if (!IS_DWIN_CURVE_CHANNEL(curve_channel))// 检查曲线通道是否符合预期的值，如果不符合，记录警告日志并断言失败
+	if (curve_list[curve_id] != RT_NULL)//存储区只分配不释放，不能重复初始化
 	{
-		LOG_W("error curve channel : %0x4X", curve_channel);
+		LOG_W("curve (%d) already initialized!", curve_id);
 		RT_ASSERT(0);
 	}
 	
-	for (index = 0; index < DWIN_CURVE_CHANNEL_MAX_COUNT; index++)// 遍历曲线通道列表，寻找匹配的曲线通道
+	if (depth == 0)
 	{
-		if (curve_clean_list[index].curve_channel == curve_channel)// 如果找到匹配的通道，将其标记为已使用，并跳出循环
-		{
-			curve_clean_list[index].used = RT_TRUE;
-			break;
-		}
+		depth = DWIN_CURVE_DATA_MAX_COUNT;
+	}
+	else if (depth > DWIN_CURVE_DATA_MAX_DEPTH)
+	{
+		LOG_W("curve (%d) depth %d too large!", curve_id, depth);
+		depth = DWIN_CURVE_DATA_MAX_DEPTH;
 	}
 	
-	curve_data_queue_init(&curve_list[curve_id].queue);//曲线数据队列初始化
-	curve_list[curve_id].curve_channel = ((curve_channel & 0x0F) - 1) >> 1;// 设置曲线通道，通道号通过曲线通道配置得到
-	curve_list[curve_id].mutex = rt_mutex_create("CURVE", RT_IPC_FLAG_PRIO);//创建一个名为"CURVE"的动态互斥量，创建规则直接按RT-Tread例程就行，用于保护曲线数据的完整性
+	if (!IS_DWIN_CURVE_CHANNEL(curve_channel))// 检查曲线通道是否符合预期的值，如果不符合，记录警告日志并断言失败
+	{
+		LOG_W("error curve channel : %0x4X", curve_channel);
+		RT_ASSERT(0);
+	}
+	
+	curve = curve_arena_alloc(sizeof(curve_data_t));
+	rt_memset(curve, 0, sizeof(curve_data_t));
+	curve_data_queue_init(&curve->queue,
+			curve_arena_alloc(CURVE_DATA_QUEUE_SIZE(depth) * sizeof(struct array_link_element)),
+			CURVE_DATA_QUEUE_SIZE(depth));//曲线数据队列初始化
+	curve->curve_channel = ((curve_channel & 0x0F) - 1) >> 1;// 设置曲线通道，通道号通过曲线通道配置得到
+	curve_channel_dirty |= 1 << curve->curve_channel;// 上电时屏上该通道的内容未知，首次显示时清零
+	rt_mutex_init(&curve->mutex, "CURVE", RT_IPC_FLAG_PRIO);//静态互斥量，对象在曲线存储区内，不占用堆，用于保护曲线数据的完整性
 	
 	if (adjust_fun == RT_NULL)//若未提供数据调整函数，则使用默认函数。
 	{
 		adjust_fun = default_curve_data_adjust;
 	}
-	//将数据调整函数交给曲线下标列表索引的adjust_fun
-	curve_list[curve_id].adjust_fun = adjust_fun;
+	//将数据调整函数交给曲线的adjust_fun
+	curve->adjust_fun = adjust_fun;
+	curve->history = RT_NULL;
+	curve->stat = RT_NULL;
+	curve->sample_mode = CURVE_SAMPLE_HOLD;
+	
+	curve_list[curve_id] = curve;
+}
+/**
+ * @brief 为曲线开启长历史
+ * @param curve_id 曲线ID，需先调用init_curve
+ * @param block_count 压缩块个数，每块 CURVE_HISTORY_BLOCK_SIZE 字节
+ * @note  长历史从曲线存储区分配，存储区不足时输出日志并断言；
+ *		压缩比与信号有关：保持段几乎不占空间，车速类平缓信号约6倍，带噪声的加速度约3倍，
+ *		实际曲线用 msh 命令 curve_history_info 查看
+ */
+void init_curve_history(rt_uint16_t curve_id, rt_uint16_t block_count)
+{
+	curve_data_t *curve = get_curve(curve_id);
+	rt_size_t size;
+	curve_history_t *history;
+
+	size = block_count * sizeof(struct curve_history_block);
+	history = curve_arena_alloc(sizeof(curve_history_t));
+	curve_history_init(history, curve_arena_alloc(size), size);
+
+	rt_mutex_take(&curve->mutex, RT_WAITING_FOREVER);
+	curve->history = history;
+	rt_mutex_release(&curve->mutex);
+}
+
+/**
+ * @brief 为曲线开启滑动窗口统计
+ * @param curve_id 曲线ID，需先调用init_curve
+ * @param capacity 窗口最多数据个数（按个数的窗口长度）
+ * @param window_ms 时间窗口长度（ms），0表示只按个数；两者同时生效，先到者为准
+ * @param is_signed 数据是否为有符号数
+ * @note  统计在 add_curve_data 中随原始数据更新。时间窗口只在新数据到来时向前推进，
+ *		信号中断期间统计量保持不变
+ */
+void init_curve_stat(rt_uint16_t curve_id, rt_uint16_t capacity, rt_uint32_t window_ms, rt_bool_t is_signed)
+{
+	curve_data_t *curve = get_curve(curve_id);
+	curve_stat_t *stat;
+	rt_uint16_t type;
+
+	RT_ASSERT(capacity > 0);
+
+	stat = curve_arena_alloc(sizeof(curve_stat_t));
+	rt_memset(stat, 0, sizeof(curve_stat_t));
+	stat->sample_list = curve_arena_alloc(capacity * sizeof(struct curve_stat_sample));
+	stat->min_deque = curve_arena_alloc(capacity * sizeof(rt_uint16_t));
+	stat->max_deque = curve_arena_alloc(capacity * sizeof(rt_uint16_t));
+	stat->capacity = capacity;
+	stat->window_tick = rt_tick_from_millisecond(window_ms);
+	stat->is_signed = is_signed;
+	for (type = 0; type < CURVE_STAT_TYPE_COUNT; type++)
+	{
+		stat->var_index[type] = -1;
+	}
+
+	rt_mutex_take(&curve->mutex, RT_WAITING_FOREVER);
+	curve->stat = stat;
+	rt_mutex_release(&curve->mutex);
+}
+/**
+ * @brief 绑定统计量到迪文变量
+ * @param curve_id 曲线ID，需先调用init_curve_stat
+ * @param type 统计量
+ * @param var_index 迪文变量下标（dwin_var_list），统计量随页面刷新显示
+ */
+void bind_curve_stat(rt_uint16_t curve_id, curve_stat_type_t type, rt_uint16_t var_index)
+{
+	curve_data_t *curve = get_curve(curve_id);
+
+	if (curve->stat == RT_NULL || type >= CURVE_STAT_TYPE_COUNT)
+	{
+		LOG_W("curve (%d) stat (%d) bind error!", curve_id, type);
+		RT_ASSERT(0);
+	}
+
+	curve->stat->var_index[type] = var_index;
+}
+/**
+ * @brief 设置统计量输出函数
+ * @param output_fun 输出函数，由业务逻辑层提供，把统计量写入迪文变量
+ */
+void set_curve_stat_output(curve_stat_output_t output_fun)
+{
+	curve_stat_output = output_fun;
+}
+
+/**
+ * @brief 输出曲线内存占用
+ * @note  曲线存储区按实际配置分配，静态部分是曲线列表、窗口配置和发送缓冲区；在所有曲线初始化完成后调用
+ */
+void log_curve_memory_usage(void)
+{
+	rt_uint16_t index;
+	rt_uint16_t curve_count = 0;
+
+	for (index = 0; index < DWIN_CURVE_MAX_COUNT; index++)
+	{
+		if (curve_list[index] != RT_NULL)
+		{
+			++curve_count;
+		}
+	}
+
+	LOG_I("curve RAM: %d curves, arena %d / %d bytes, static %d bytes", curve_count, curve_arena_used, sizeof(curve_arena),
+			sizeof(curve_list) + sizeof(curve_window_list) + sizeof(curve_data_frame) + sizeof(one_curve_data_buff));
+}
+#ifdef RT_USING_FINSH
+/**
+ * @brief msh命令：打印各曲线长历史保存的数据个数、占用字节数和压缩比（原始16位数据 / 占用字节）
+ * @note  反映实际CAN信号的压缩效果，运行一段时间后查看
+ */
+static void curve_history_info(void)
+{
+	curve_data_t *curve;
+	rt_uint32_t held;
+	rt_size_t bytes;
+	rt_uint32_t ratio;
+	rt_uint16_t index;
+
+	rt_kprintf("curve samples  bytes    blocks  ratio\n");
+	for (index = 0; index < DWIN_CURVE_MAX_COUNT; index++)
+	{
+		curve = curve_list[index];
+		if (curve == RT_NULL || curve->history == RT_NULL)
+		{
+			continue;
+		}
+		rt_mutex_take(&curve->mutex, RT_WAITING_FOREVER);
+		held = curve_history_next_seq(curve->history) - curve_history_first_seq(curve->history);
+		bytes = curve_history_used_bytes(curve->history);
+		rt_kprintf("%-5u %-8u %-8u %3u/%-3u ", index, held, bytes, curve->history->used, curve->history->block_count);
+		rt_mutex_release(&curve->mutex);
+		ratio = bytes != 0 ? (rt_uint32_t) ((rt_uint64_t) held * 2 * 100 / bytes) : 0;
+		rt_kprintf("%u.%02u\n", ratio / 100, ratio % 100);
+	}
 }
+MSH_CMD_EXPORT(curve_history_info, show curve history compression ratio);
+#endif /* RT_USING_FINSH */
 
 /* 
 	@ brief	曲线默认数据 
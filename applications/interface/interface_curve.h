@@ -15,19 +15,26 @@
 #include <rtthread.h>
 #include <rtdevice.h>
 
-#define DWIN_CURVE_DATA_MAX_COUNT	20	//一条曲线最多只读取20个数据，也就是曲线显示的只有最新的20个数据
-#define MAX_COUNT DWIN_CURVE_DATA_MAX_COUNT
 #include "util.h"
+#include "curve_history.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /*============================ MACROS ========================================*/
+#define DWIN_CURVE_DATA_MAX_COUNT		20		//曲线默认深度，也是历史视图一屏的数据个数
+#define DWIN_CURVE_DATA_MAX_DEPTH		120		//曲线最大深度，受一帧（255字节）能容纳的数据个数限制
 #define DWIN_CURVE_MAX_COUNT			32		//曲线最大数量
 #define DWIN_CURVE_WINDOW_MAX_COUNT		16		//曲线窗口最大数量
 #define DWIN_CURVE_IN_WINDOW_MAX_COUNT	8		//单个窗口曲线最大数量
 #define DWIN_CURVE_CHANNEL_MAX_COUNT	8		//单个窗口曲线通道数
+#define DWIN_CURVE_BUFFER_ARENA_SIZE	2048	//曲线控制结构和数据队列存储区字节数，所有曲线共用
+#define DWIN_CURVE_HISTORY_ARENA_SIZE	8192	//长历史压缩存储区字节数，所有曲线共用
+#define DWIN_CURVE_HISTORY_MAX_STEP		16		//历史视图最大抽取步长，限制单帧解码量
+#define DWIN_CURVE_SAMPLE_PERIOD		50		//曲线公共采样周期（ms），所有曲线在同一时刻取样，保证同窗口曲线对齐；取值固定延迟一个周期，便于插值
+#define DWIN_CURVE_SAMPLE_CATCH_UP		DWIN_CURVE_DATA_MAX_COUNT	//显示线程滞后时最多补采的周期数
+#define DWIN_CURVE_STAT_ARENA_SIZE		3072	//统计窗口存储区字节数，所有曲线共用
 /* 迪文屏曲线通道地址 */
 #define DWIN_CURVE_CHANNEL1		0x0301
 #define DWIN_CURVE_CHANNEL2		0x0303
@@ -48,16 +55,75 @@ extern "C" {
 	|| DWIN_CURVE_CHANNEL8 == (val) \
 	)
 /*============================ TYPES =========================================*/
+/* 曲线重采样方式 */
+typedef enum curve_sample_mode
+{
+	CURVE_SAMPLE_HOLD = 0,		// 保持最近一个数据
+	CURVE_SAMPLE_LINEAR,		// 在前后两个数据之间线性插值
+}curve_sample_mode_t;
+
+/* 曲线统计量 */
+typedef enum curve_stat_type
+{
+	CURVE_STAT_MIN = 0,			// 窗口最小值
+	CURVE_STAT_MAX,				// 窗口最大值
+	CURVE_STAT_MEAN,			// 窗口均值
+	CURVE_STAT_RMS,				// 窗口均方根
+	CURVE_STAT_TYPE_COUNT,
+}curve_stat_type_t;
+
 /* 定义函数指针类型，当被指向的函数的参数为rt_uint16_t value，被指向的函数执行相关功能 */ 
 typedef rt_uint16_t (*curve_data_adjust_t)(rt_uint16_t value);
+/* 统计量输出函数，把统计结果（原始数据单位）写到迪文变量 var_index */
+typedef void (*curve_stat_output_t)(rt_uint16_t var_index, rt_uint16_t value);
+
+/* 统计窗口内的一个数据 */
+struct curve_stat_sample
+{
+	rt_tick_t tick;					// 数据时刻
+	rt_uint16_t value;				// 原始数据
+};
+
+/**
+ * @brief 曲线滑动窗口统计
+ * @note  均值和方差按 Welford 方法随数据进出窗口增量更新；最小、最大值各用一个单调队列维护，
+ *		队首即为窗口内的最值。每个数据进出窗口各一次，平均每个数据 O(1)
+ */
+typedef struct curve_stat
+{
+	struct curve_stat_sample *sample_list;	// 窗口数据环形队列
+	rt_uint16_t *min_deque;			// 单调递增队列（存 sample_list 下标），队首为最小值
+	rt_uint16_t *max_deque;			// 单调递减队列（存 sample_list 下标），队首为最大值
+	rt_uint16_t capacity;			// 窗口最多数据个数，三个队列长度相同
+	rt_uint16_t head;				// 最旧数据下标
+	rt_uint16_t count;				// 窗口内数据个数
+	rt_uint16_t min_head;
+	rt_uint16_t min_count;
+	rt_uint16_t max_head;
+	rt_uint16_t max_count;
+	rt_tick_t window_tick;			// 时间窗口长度，0表示只按个数
+	rt_bool_t is_signed;			// 数据按 rt_int16_t 解释
+	float mean;						// 均值
+	float m2;						// 与均值之差的平方和
+	rt_int16_t var_index[CURVE_STAT_TYPE_COUNT];	// 绑定的迪文变量下标，-1为未绑定
+}curve_stat_t;
 
 /* 曲线数据结构体，配置曲线的一些相关功能*/
 typedef struct curve_data
 {
-	struct curve_data_queue queue;	// 曲线数据队列，队列本身的初始化以及用于添加、读取曲线数据
+	struct curve_data_queue queue;	// 曲线数据队列，队列本身的初始化以及用于添加、读取曲线数据，深度由 init_curve 指定
 	rt_uint16_t curve_channel;		// 曲线通道
-	rt_mutex_t mutex;				// 互斥量，曲线数据存数据和取数据可能是在不同线程进行的，使用互斥量让添加数据取数据互斥进行能保证线程安全
+	struct rt_mutex mutex;			// 互斥量，曲线数据存数据和取数据可能是在不同线程进行的，使用互斥量让添加数据取数据互斥进行能保证线程安全
 	curve_data_adjust_t adjust_fun;	// 数值转换函数,把can接收到的数据转换成迪文屏能显示的数据
+	curve_history_t *history;		// 长历史（压缩存储），未配置时为RT_NULL
+	curve_stat_t *stat;				// 滑动窗口统计，未配置时为RT_NULL
+	/* 时间基准：add_curve_data 记录带时间戳的原始数据，采样时按公共时刻重采样后才进入队列和长历史 */
+	rt_tick_t last_tick;			// 最近一个原始数据的时刻
+	rt_tick_t prev_tick;			// 前一个原始数据的时刻
+	rt_uint16_t last_value;			// 最近一个原始数据
+	rt_uint16_t prev_value;			// 前一个原始数据
+	rt_uint8_t raw_count;			// 已收到的原始数据个数（最多记到2）
+	rt_uint8_t sample_mode;			// 重采样方式 curve_sample_mode_t
 }curve_data_t;
 /*============================ GLOBAL VARIABLES ==============================*/
 /*============================ PROTOTYPES ====================================*/
@@ -73,9 +139,15 @@ void set_curve_window_not_first_show(rt_int16_t curve_window_id);
 rt_int16_t get_current_curve_window(void);
 /* 设置曲线窗口id */
 void set_current_curve_window(rt_int16_t curve_window_id);
+/* 设置曲线窗口的历史视图 */
+void set_curve_window_view(rt_int16_t curve_window_id, rt_uint32_t back_offset, rt_uint16_t step);
 
 /* 添加曲线数据 */
 void add_curve_data(rt_uint16_t curve_id, rt_uint16_t data);
+/* 按公共采样周期对所有曲线重采样 */
+void curve_sample_poll(void);
+/* 设置曲线重采样方式 */
+void set_curve_sample_mode(rt_uint16_t curve_id, curve_sample_mode_t mode);
 /* 添加曲线到窗口 */
 void add_curve_to_window(rt_uint16_t curve_id, rt_uint16_t curve_window_id);
 
@@ -83,7 +155,17 @@ void add_curve_to_window(rt_uint16_t curve_id, rt_uint16_t curve_window_id);
 void clean_curve(void);
 
 /* 初始化曲线配置 */
-void init_curve(rt_uint16_t curve_id, rt_uint16_t curve_channel, curve_data_adjust_t adjust_fun);
+void init_curve(rt_uint16_t curve_id, rt_uint16_t curve_channel, rt_uint16_t depth, curve_data_adjust_t adjust_fun);
+/* 为曲线开启长历史 */
+void init_curve_history(rt_uint16_t curve_id, rt_uint16_t block_count);
+/* 为曲线开启滑动窗口统计 */
+void init_curve_stat(rt_uint16_t curve_id, rt_uint16_t capacity, rt_uint32_t window_ms, rt_bool_t is_signed);
+/* 绑定统计量到迪文变量 */
+void bind_curve_stat(rt_uint16_t curve_id, curve_stat_type_t type, rt_uint16_t var_index);
+/* 设置统计量输出函数 */
+void set_curve_stat_output(curve_stat_output_t output_fun);
+/* 输出曲线内存占用 */
+void log_curve_memory_usage(void);
 
 /* 默认曲线数据 */
 rt_uint16_t default_curve_data_adjust(rt_uint16_t data);
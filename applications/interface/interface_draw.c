@@ -0,0 +1,238 @@
+/**
+ * @file interface_draw.c
+ * @brief 迪文屏基本图形（保留模式绘图）
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "interface_dwin.h"
+#include "interface_draw.h"
+
+#define DBG_LEVEL	DBG_LOG
+#define DBG_TAG		"interface_draw"
+#include <rtdbg.h>
+
+/*============================ MACROS ========================================*/
+#define DWIN_DRAW_CMD_OFFSET		DWIN_WRITE_DATA_OFFSET	//指令类型在帧中的偏移
+#define DWIN_DRAW_COUNT_OFFSET		(DWIN_DRAW_CMD_OFFSET + 2)	//图元个数在帧中的偏移
+#define DWIN_DRAW_SLOT_OFFSET		(DWIN_DRAW_CMD_OFFSET + DWIN_DRAW_HEAD_WORDS * 2)	//第一个槽位在帧中的偏移
+/*============================ TYPES =========================================*/
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 以大端格式写一个字
+ */
+rt_inline void draw_put_word(rt_uint8_t *buff, rt_uint16_t value)
+{
+	buff[0] = (value >> 8) & 0xFF;
+	buff[1] = value & 0xFF;
+}
+/**
+ * @brief 填写写命令帧头
+ * @param frame 帧缓冲区
+ * @param address 写入的迪文变量地址
+ * @param data_size 写入的数据字节数
+ */
+static void draw_put_head(rt_uint8_t *frame, rt_uint16_t address, rt_uint16_t data_size)
+{
+	frame[0] = 0x5A;
+	frame[1] = 0xA5;
+	frame[DWIN_DATA_BYTE_COUNT_INDEX] = (data_size + 3) & 0xFF;
+	frame[3] = DWIN_COMMAND_WRITE;
+	draw_put_word(&frame[DWIN_DATA_FRAME_ADDRESS_INDEX], address);
+}
+/**
+ * @brief 更新一个槽位的几何数据
+ * @param layer 图层
+ * @param slot 槽位
+ * @param command 图元类型，必须与图层一致
+ * @param words 图元数据（主机字节序），共 layer->slot_words 个字
+ * @note 与上次发送的数据相同时不做标记
+ */
+static void draw_slot_update(dwin_draw_layer_t *layer, rt_uint16_t slot, rt_uint16_t command, const rt_uint16_t *words)
+{
+	rt_uint8_t buff[DWIN_DRAW_SLOT_MAX_WORDS * 2];
+	rt_uint8_t *slot_data;
+	rt_uint16_t i;
+
+	RT_ASSERT(layer->command == command);
+	RT_ASSERT(slot < layer->slot_count);
+
+	for (i = 0; i < layer->slot_words; i++)
+	{
+		draw_put_word(&buff[i * 2], words[i]);
+	}
+
+	slot_data = &layer->frame[DWIN_DRAW_SLOT_OFFSET + slot * layer->slot_words * 2];
+	if (rt_memcmp(slot_data, buff, layer->slot_words * 2) != 0)
+	{
+		rt_memcpy(slot_data, buff, layer->slot_words * 2);
+		layer->dirty_mask |= 1UL << slot;
+	}
+}
+/**
+ * @brief 图元类型对应的字数
+ */
+static rt_uint16_t draw_command_words(rt_uint16_t command)
+{
+	switch (command)
+	{
+	case DWIN_DRAW_CMD_RECT_FILL:
+	case DWIN_DRAW_CMD_LINE:
+		return 5;
+	case DWIN_DRAW_CMD_CUT_PASTE:
+		return 7;
+	default:
+		RT_ASSERT(0);
+		return 0;
+	}
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 初始化图层
+ * @param layer 图层
+ * @param var_address 基本图形变量地址
+ * @param command 图元类型（DWIN_DRAW_CMD_xxx）
+ * @param slot_count 槽位个数，所有槽位初始为空图元（不显示）
+ */
+void dwin_draw_layer_init(dwin_draw_layer_t *layer, rt_uint16_t var_address, rt_uint16_t command, rt_uint16_t slot_count)
+{
+	rt_uint16_t slot_words = draw_command_words(command);
+	rt_uint16_t frame_size = DWIN_DRAW_FRAME_SIZE(slot_words, slot_count);
+
+	RT_ASSERT(slot_count > 0 && slot_count <= DWIN_DRAW_LAYER_MAX_SLOTS);
+	RT_ASSERT(frame_size <= DWIN_DATA_FRAME_MAX_LENGTH);
+
+	layer->var_address = var_address;
+	layer->command = command;
+	layer->slot_words = slot_words;
+	layer->slot_count = slot_count;
+	layer->dirty_mask = 0;
+	layer->full_pending = RT_TRUE;
+
+	rt_memset(layer->frame, 0, sizeof(layer->frame));
+	draw_put_head(layer->frame, var_address, frame_size - DWIN_WRITE_DATA_OFFSET);
+	draw_put_word(&layer->frame[DWIN_DRAW_CMD_OFFSET], command);
+	draw_put_word(&layer->frame[DWIN_DRAW_COUNT_OFFSET], slot_count);
+	draw_put_word(&layer->frame[frame_size - DWIN_DRAW_END_WORDS * 2], 0xFF00);
+}
+/**
+ * @brief 线段
+ */
+void dwin_draw_line(dwin_draw_layer_t *layer, rt_uint16_t slot,
+		rt_uint16_t xs, rt_uint16_t ys, rt_uint16_t xe, rt_uint16_t ye, rt_uint16_t color)
+{
+	rt_uint16_t words[] = { color, xs, ys, xe, ye };
+
+	draw_slot_update(layer, slot, DWIN_DRAW_CMD_LINE, words);
+}
+/**
+ * @brief 矩形填充
+ */
+void dwin_draw_rect_fill(dwin_draw_layer_t *layer, rt_uint16_t slot,
+		rt_uint16_t xs, rt_uint16_t ys, rt_uint16_t xe, rt_uint16_t ye, rt_uint16_t color)
+{
+	rt_uint16_t words[] = { xs, ys, xe, ye, color };
+
+	draw_slot_update(layer, slot, DWIN_DRAW_CMD_RECT_FILL, words);
+}
+/**
+ * @brief 图片剪切粘贴：把 pic_id 页面上 (xs,ys)~(xe,ye) 区域粘贴到当前页 (x,y)
+ */
+void dwin_draw_cut_paste(dwin_draw_layer_t *layer, rt_uint16_t slot, rt_uint16_t pic_id,
+		rt_uint16_t xs, rt_uint16_t ys, rt_uint16_t xe, rt_uint16_t ye, rt_uint16_t x, rt_uint16_t y)
+{
+	rt_uint16_t words[] = { pic_id, xs, ys, xe, ye, x, y };
+
+	draw_slot_update(layer, slot, DWIN_DRAW_CMD_CUT_PASTE, words);
+}
+/**
+ * @brief 进度条
+ * @param bar 进度条配置
+ * @param value 当前进度，超过 bar->max 按满进度显示
+ * @note 显示长度四舍五入到像素，进度变化不足一个像素时不发送
+ */
+void dwin_draw_progress_bar(dwin_draw_layer_t *layer, rt_uint16_t slot, const dwin_progress_bar_t *bar, rt_uint16_t value)
+{
+	rt_uint32_t width;
+
+	value = value > bar->max ? bar->max : value;
+	width = ((rt_uint32_t) (bar->xe - bar->xs) * value + bar->max / 2) / bar->max;
+
+	dwin_draw_cut_paste(layer, slot, bar->pic_id, bar->xe - width, bar->ys, bar->xe, bar->ye, bar->x, bar->y);
+}
+/**
+ * @brief 图标
+ * @param sheet 图标表
+ * @param icon_id 图标在图标表中的序号
+ * @param x 显示位置
+ * @param y
+ */
+void dwin_draw_icon(dwin_draw_layer_t *layer, rt_uint16_t slot, const dwin_icon_sheet_t *sheet,
+		rt_uint16_t icon_id, rt_uint16_t x, rt_uint16_t y)
+{
+	rt_uint16_t xs = sheet->x + (icon_id % sheet->per_row) * sheet->width;
+	rt_uint16_t ys = sheet->y + (icon_id / sheet->per_row) * sheet->height;
+
+	dwin_draw_cut_paste(layer, slot, sheet->pic_id, xs, ys, xs + sheet->width - 1, ys + sheet->height - 1, x, y);
+}
+/**
+ * @brief 隐藏图元：槽位数据全部清零（零尺寸图元不显示）
+ */
+void dwin_draw_hide(dwin_draw_layer_t *layer, rt_uint16_t slot)
+{
+	rt_uint16_t words[DWIN_DRAW_SLOT_MAX_WORDS] = { 0 };
+
+	draw_slot_update(layer, slot, layer->command, words);
+}
+/**
+ * @brief 发送变化的槽位
+ * @note 需要整条发送时发送整条指令；否则把第一个到最后一个变化槽位合并成一次写命令，
+ *		帧头和槽位数据分两次交给串口，迪文屏串口只由显示线程发送，中间不会插入其它数据
+ */
+void dwin_draw_flush(dwin_draw_layer_t *layer)
+{
+	rt_uint8_t head[DWIN_WRITE_DATA_OFFSET];
+	rt_uint16_t first;
+	rt_uint16_t last;
+	rt_uint16_t size;
+
+	if (layer->full_pending)
+	{
+		dwin_serial_send(layer->frame, DWIN_DRAW_FRAME_SIZE(layer->slot_words, layer->slot_count));
+		layer->full_pending = RT_FALSE;
+		layer->dirty_mask = 0;
+		return;
+	}
+
+	if (layer->dirty_mask == 0)
+	{
+		return;
+	}
+
+	for (first = 0; (layer->dirty_mask & (1UL << first)) == 0; first++);
+	for (last = layer->slot_count - 1; (layer->dirty_mask & (1UL << last)) == 0; last--);
+
+	size = (last - first + 1) * layer->slot_words * 2;
+	draw_put_head(head, layer->var_address + DWIN_DRAW_HEAD_WORDS + first * layer->slot_words, size);
+	dwin_serial_send(head, sizeof(head));
+	dwin_serial_send(&layer->frame[DWIN_DRAW_SLOT_OFFSET + first * layer->slot_words * 2], size);
+	layer->dirty_mask = 0;
+}
+/**
+ * @brief 要求下次整条指令重新发送
+ * @note 迪文屏单独复位后变量内容丢失，调用本函数后下一次 dwin_draw_flush 重新发送所有槽位
+ */
+void dwin_draw_invalidate(dwin_draw_layer_t *layer)
+{
+	layer->full_pending = RT_TRUE;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file interface_draw.h
+ * @brief 迪文屏基本图形（保留模式绘图）
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  迪文屏的基本图形变量（如0x5100）存放的是一条绘图指令：指令类型、图元个数、各图元的数据，0xFF00结束，
+ *		屏幕按变量内容反复绘制，同一个变量只能放一种图元。
+ *		本模块为每个基本图形变量建一个图层，图层内每个图元占一个固定的槽位，并记录上次发送的几何数据；
+ *		页面显示函数每轮声明各控件的当前状态，只有几何数据变化的槽位被标记，
+ *		dwin_draw_flush 把第一个到最后一个变化槽位合并成一次写命令发送，没有变化时不发送。
+ *		控件的声明和发送都在显示线程中进行，不需要加锁。
+ */
+#ifndef __INTERFACE_DRAW_H__
+#define __INTERFACE_DRAW_H__
+
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "interface_dwin.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================ MACROS ========================================*/
+/* 基本图形指令 */
+#define DWIN_DRAW_CMD_RECT_FILL			0x0004	//矩形域填充：(xs,ys) (xe,ye) color
+#define DWIN_DRAW_CMD_CUT_PASTE			0x0006	//图片剪切粘贴：pic_id (xs,ys) (xe,ye) (x,y)，进度条、图标都用它实现
+#define DWIN_DRAW_CMD_LINE				0x000A	//线段：color (xs,ys) (xe,ye)
+
+#define DWIN_DRAW_SLOT_MAX_WORDS		7		//一个图元最多的字数（图片剪切粘贴）
+#define DWIN_DRAW_HEAD_WORDS			2		//指令类型、图元个数
+#define DWIN_DRAW_END_WORDS				1		//结束标志0xFF00
+/* 图层写命令帧：帧头 + 指令头 + 所有槽位 + 结束标志，不超过一帧 */
+#define DWIN_DRAW_FRAME_SIZE(slot_words, slot_count)	\
+	(DWIN_WRITE_DATA_OFFSET + (DWIN_DRAW_HEAD_WORDS + (slot_words) * (slot_count) + DWIN_DRAW_END_WORDS) * 2)
+#define DWIN_DRAW_LAYER_MAX_SLOTS		32		//一个图层最多的槽位个数（受脏标记位数限制）
+/*============================ TYPES =========================================*/
+/**
+ * @struct dwin_draw_layer
+ * @brief 一个基本图形变量对应的图层
+ */
+typedef struct dwin_draw_layer
+{
+	rt_uint16_t var_address;		/**< 基本图形变量地址 */
+	rt_uint16_t command;			/**< 图元类型，图层内所有槽位相同 */
+	rt_uint16_t slot_words;			/**< 每个图元的字数 */
+	rt_uint16_t slot_count;			/**< 槽位个数 */
+	rt_uint32_t dirty_mask;			/**< 几何数据变化、尚未发送的槽位 */
+	rt_bool_t full_pending;			/**< 需要整条指令重新发送（初始化后、屏幕复位后） */
+	rt_uint8_t frame[DWIN_DATA_FRAME_MAX_LENGTH];	/**< 整条指令的写命令帧，各槽位保存上次发送的几何数据（迪文大端格式） */
+}dwin_draw_layer_t;
+/**
+ * @struct dwin_progress_bar
+ * @brief 进度条：从进度条原图剪切右端长度与进度成比例的一段，粘贴到页面上，进度条头部图案始终在最右端
+ */
+typedef struct dwin_progress_bar
+{
+	rt_uint16_t pic_id;				/**< 进度条原图所在页面 */
+	rt_uint16_t xs;					/**< 原图左上角 */
+	rt_uint16_t ys;
+	rt_uint16_t xe;					/**< 原图右下角 */
+	rt_uint16_t ye;
+	rt_uint16_t x;					/**< 粘贴到当前页的位置 */
+	rt_uint16_t y;
+	rt_uint16_t max;				/**< 满进度对应的数值 */
+}dwin_progress_bar_t;
+/**
+ * @struct dwin_icon_sheet
+ * @brief 图标表：同一页面上按行排列、大小相同的一组图标
+ */
+typedef struct dwin_icon_sheet
+{
+	rt_uint16_t pic_id;				/**< 图标表所在页面 */
+	rt_uint16_t x;					/**< 第一个图标左上角 */
+	rt_uint16_t y;
+	rt_uint16_t width;				/**< 图标宽、高 */
+	rt_uint16_t height;
+	rt_uint16_t per_row;			/**< 每行图标个数 */
+}dwin_icon_sheet_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ PROTOTYPES ====================================*/
+/*
+初始化图层；
+声明图元：线段、矩形填充、进度条、图标、通用图片剪切粘贴，隐藏图元；
+发送变化的槽位；
+要求下次整条指令重新发送；
+*/
+void dwin_draw_layer_init(dwin_draw_layer_t *layer, rt_uint16_t var_address, rt_uint16_t command, rt_uint16_t slot_count);
+void dwin_draw_line(dwin_draw_layer_t *layer, rt_uint16_t slot,
+		rt_uint16_t xs, rt_uint16_t ys, rt_uint16_t xe, rt_uint16_t ye, rt_uint16_t color);
+void dwin_draw_rect_fill(dwin_draw_layer_t *layer, rt_uint16_t slot,
+		rt_uint16_t xs, rt_uint16_t ys, rt_uint16_t xe, rt_uint16_t ye, rt_uint16_t color);
+void dwin_draw_progress_bar(dwin_draw_layer_t *layer, rt_uint16_t slot, const dwin_progress_bar_t *bar, rt_uint16_t value);
+void dwin_draw_icon(dwin_draw_layer_t *layer, rt_uint16_t slot, const dwin_icon_sheet_t *sheet,
+		rt_uint16_t icon_id, rt_uint16_t x, rt_uint16_t y);
+void dwin_draw_cut_paste(dwin_draw_layer_t *layer, rt_uint16_t slot, rt_uint16_t pic_id,
+		rt_uint16_t xs, rt_uint16_t ys, rt_uint16_t xe, rt_uint16_t ye, rt_uint16_t x, rt_uint16_t y);
+void dwin_draw_hide(dwin_draw_layer_t *layer, rt_uint16_t slot);
+void dwin_draw_flush(dwin_draw_layer_t *layer);
+void dwin_draw_invalidate(dwin_draw_layer_t *layer);
+/*============================ INCLUDES ======================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INTERFACE_DRAW_H__ */
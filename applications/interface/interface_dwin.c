@@ -14,6 +14,7 @@
 
 #include "interface_dwin.h"
 #include "dispatcher_can_dwin.h"
+#include "reactor.h"
 
 #define DBG_LEVEL	DBG_LOG
 #define DBG_TAG		"interface_dwin"
@@ -29,12 +30,16 @@
 /*============================ LOCAL VARIABLES ===============================*/
 /*
 	串口设备
-	非阻塞侦听线程：用完成量（简化设计、避免忙等待）
+	非阻塞侦听线程：用门铃（计数唤醒，突发的多次接收不会丢失通知，避免忙等待）
 */
 static struct 
 {
 	rt_device_t device;//串口设备
-	struct rt_completion cpt;//接收完成量
+#ifndef INTERFACE_CFG_USING_REACTOR
+	struct rt_doorbell bell;//接收门铃，每次接收回调响一次
+#endif /* INTERFACE_CFG_USING_REACTOR */
+	struct rt_completion first_frame;//第一帧发送完成，启动时main等它再初始化CAN
+	rt_bool_t first_frame_sent;
 }interface_dwin_serial;
 
 /*============================ PROTOTYPES ====================================*/
@@ -46,7 +51,11 @@ static struct
  */
 static rt_err_t dwin_serial_rx_callback(rt_device_t deveice, rt_size_t size)
 {
-	rt_completion_done(&interface_dwin_serial.cpt);//释放完成量
+#ifdef INTERFACE_CFG_USING_REACTOR
+	reactor_signal(REACTOR_EVENT_DWIN_RX);//通知事件循环
+#else
+	rt_doorbell_ring(&interface_dwin_serial.bell);//按门铃，只有计数从0变1时才唤醒线程
+#endif /* INTERFACE_CFG_USING_REACTOR */
 	return RT_EOK;
 }
 /**
@@ -98,6 +107,22 @@ static void collect_dwin_data_frame(rt_uint8_t *data_frame, rt_uint32_t size)
 		len = 0;//len归为0重置缓冲区，进行下一帧处理
 	}
 }
+#ifdef INTERFACE_CFG_USING_REACTOR
+/**
+ * @brief 串口接收事件处理函数（事件循环线程）
+ * @note 多次接收通知可能合并为一个事件，读到接收缓冲区为空为止
+ */
+static void dwin_serial_rx_handler(void)
+{
+	static rt_uint8_t rx_buffer[BSP_UART3_RX_BUFSIZE + 1];
+	rt_size_t len;
+
+	while ((len = rt_device_read(interface_dwin_serial.device, 0, rx_buffer, BSP_UART3_RX_BUFSIZE)) > 0)
+	{
+		collect_dwin_data_frame(rx_buffer, len);
+	}
+}
+#else
 /**
  * @brief 串口接收处理函数
  * @param arg 未使用
@@ -108,27 +133,35 @@ static void dwin_serail_rx_dealer(void *arg)
 	static rt_uint8_t rx_buffer[BSP_UART3_RX_BUFSIZE + 1];//创建用于设置串口处理接收到的数据的缓冲区
 	//BSP_UART3_RX_BUFSIZE是缓冲区大小，加1是考虑到如果是字符串需要预留结束位标志
 	rt_uint16_t len;//len代表实际发送的数据长度
+	rt_uint32_t count;//上次唤醒之后的接收回调次数，只用于统计突发深度
 	while (1)//数据接收处理线程要一直运行，所以用while(1)
 	{
 		//阻塞等待串口数据接收完成
-		rt_completion_wait(&interface_dwin_serial.cpt, RT_WAITING_FOREVER);
-		/* 读取串口数据帧 */
-		len = rt_device_read(interface_dwin_serial.device, 0, rx_buffer, BSP_UART3_RX_BUFSIZE);
-		// 接收迪文屏串口数据，这是“自动上传”类型的数据，需要进一步处理。
-		collect_dwin_data_frame(rx_buffer, len);
+		rt_doorbell_wait(&interface_dwin_serial.bell, &count, RT_WAITING_FOREVER);
+		/* 读取串口数据帧，回调次数和字节数没有对应关系，读到接收缓冲区为空为止 */
+		while ((len = rt_device_read(interface_dwin_serial.device, 0, rx_buffer, BSP_UART3_RX_BUFSIZE)) > 0)
+		{
+			// 接收迪文屏串口数据，这是“自动上传”类型的数据，需要进一步处理。
+			collect_dwin_data_frame(rx_buffer, len);
+		}
 	}
 }
+#endif /* INTERFACE_CFG_USING_REACTOR */
 
 /*============================ EXTERNAL IMPLEMENTATION =======================*/
 /**
  * @brief 初始化迪文屏串口
- * @note 1.配置串口参数 2.设置接收回调 3.创建接收线程
+ * @note 1.配置串口参数 2.设置接收回调 3.创建接收线程（使用事件循环时注册接收事件处理函数）
  */
 void init_dwin_serial(void)
 {
 	struct serial_configure config = RT_SERIAL_CONFIG_DEFAULT;/* RT-Thread提供的默认初始化配置参数,参数包含波特率、数据位、停止位、校验方式等 */
 	rt_err_t result;//result作为rt_err_t类型的变量会被多次使用，进行控制设备、打开设备成功与否的判断
+#ifndef INTERFACE_CFG_USING_REACTOR
 	rt_thread_t thread;//串口接收线程变量
+#endif /* INTERFACE_CFG_USING_REACTOR */
+	//显示线程可能已经在发送，第一帧的完成量在设备之前初始化
+	rt_completion_init(&interface_dwin_serial.first_frame);
 	//查找设备
 	interface_dwin_serial.device = rt_device_find(INTERFACE_DWIN_SERIAL_NAME);
 	RT_ASSERT(interface_dwin_serial.device != RT_NULL);//断言设备非空
@@ -138,8 +171,14 @@ void init_dwin_serial(void)
 	//打开设备
 	result = rt_device_open(interface_dwin_serial.device, RT_DEVICE_FLAG_RX_NON_BLOCKING | RT_DEVICE_FLAG_TX_BLOCKING);
 	RT_ASSERT(result == RT_EOK);//断言打开设备成功
-	//完成量初始化
-	rt_completion_init(&interface_dwin_serial.cpt);
+#ifdef INTERFACE_CFG_USING_REACTOR
+	//接收事件处理函数在接收回调之前注册
+	reactor_register(REACTOR_EVENT_DWIN_RX, dwin_serial_rx_handler);
+	result = rt_device_set_rx_indicate(interface_dwin_serial.device, dwin_serial_rx_callback);
+	RT_ASSERT(result == RT_EOK);
+#else
+	//门铃初始化
+	rt_doorbell_init(&interface_dwin_serial.bell);
 	//设置接收回调函数
 	result = rt_device_set_rx_indicate(interface_dwin_serial.device, dwin_serial_rx_callback);//dwin_serial_rx_callback是回调函数
 	RT_ASSERT(result == RT_EOK);//断言接收回调函数成功
@@ -151,14 +190,48 @@ void init_dwin_serial(void)
 	RT_ASSERT(thread != RT_NULL);//断言线程创建成功
 	//启动线程
 	rt_thread_startup(thread);
+#endif /* INTERFACE_CFG_USING_REACTOR */
 }
 /**
  * @brief 发送数据到迪文屏
  * @param buff 数据缓冲区指针
  * @param size 数据长度
  */
-void dwin_serial_send(rt_uint8_t *buff, rt_uint32_t size)
+void dwin_serial_send(const rt_uint8_t *buff, rt_uint32_t size)
 {
+	// 显示先于串口初始化，启动时main阻塞（如输出日志）期间显示线程可能已经在刷新，串口打开之前的帧丢弃
+	if (interface_dwin_serial.device == RT_NULL)
+	{
+		return;
+	}
 	// UART3发送的串口数据，会被迪文屏所接收！
-	rt_device_write(interface_dwin_serial.device, 0, buff, size);
+	// 只有显示线程发送，第一帧的标志不需要互斥
+	if (rt_device_write(interface_dwin_serial.device, 0, buff, size) == size && !interface_dwin_serial.first_frame_sent)
+	{
+		interface_dwin_serial.first_frame_sent = RT_TRUE;
+#ifdef RT_DEBUGING_INIT_PROFILE
+		rt_components_init_mark("dwin first frame");//上电到屏幕收到第一帧的时间，list_init 命令查看
+#endif /* RT_DEBUGING_INIT_PROFILE */
+		rt_completion_done(&interface_dwin_serial.first_frame);
+	}
+}
+/**
+ * @brief 等待迪文屏的第一帧发送完成
+ * @param timeout 最长等待时间（节拍）
+ * @return RT_EOK 已发送，-RT_ETIMEOUT 超时
+ * @note 只在启动时由一个线程调用，在 init_dwin_serial 之后
+ */
+rt_err_t wait_dwin_first_frame(rt_int32_t timeout)
+{
+	return rt_completion_wait(&interface_dwin_serial.first_frame, timeout);
+}
+#if defined(RT_USING_FINSH) && defined(RT_DOORBELL_USING_HIGH_WATER) && !defined(INTERFACE_CFG_USING_REACTOR)
+/**
+ * @brief msh命令：打印并清零串口接收门铃的最大突发深度（一次唤醒取走的最多回调次数）
+ */
+static void dwin_rx_burst(void)
+{
+	rt_kprintf("dwin rx burst high water: %u\n", rt_doorbell_high_water(&interface_dwin_serial.bell, RT_TRUE));
 }
+MSH_CMD_EXPORT(dwin_rx_burst, print and reset the DWIN RX doorbell burst high water);
+#endif /* defined(RT_USING_FINSH) && defined(RT_DOORBELL_USING_HIGH_WATER) && ... */
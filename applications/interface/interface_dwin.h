@@ -43,7 +43,8 @@ typedef struct dwin_data_frame_format
 /*============================ GLOBAL VARIABLES ==============================*/
 /*============================ PROTOTYPES ====================================*/
 void init_dwin_serial(void);
-void dwin_serial_send(rt_uint8_t *buff, rt_uint32_t size);
+void dwin_serial_send(const rt_uint8_t *buff, rt_uint32_t size);
+rt_err_t wait_dwin_first_frame(rt_int32_t timeout);
 /*============================ INCLUDES ======================================*/
 
 #ifdef __cplusplus
@@ -18,20 +18,60 @@
 
 #include "bll_can.h"
 #include "bll_dwin.h"
+#include "interface_dwin.h"
+#include "reactor.h"
+#include "profiler.h"
 
 /* defined the USER LED2 pin: PA1 */
 #define LED2_PIN               GET_PIN(A, 1)
 
+#define MAIN_FIRST_FRAME_TIMEOUT	100		//等待迪文屏第一帧的最长时间（ms），没有页面配置时不会发送
+
 // static rt_uint32_t cnt;
 
+#ifdef INTERFACE_CFG_USING_REACTOR
+static struct rt_timer led_timer;
+
+static void led_timeout(void *parameter)
+{
+	reactor_signal(REACTOR_EVENT_LED);
+}
+
+static void led_handler(void)
+{
+	rt_pin_write(LED2_PIN, !rt_pin_read(LED2_PIN));
+}
+#endif /* INTERFACE_CFG_USING_REACTOR */
+
 int main(void)
 {
-	init_bll_can();
+#ifdef INTERFACE_CFG_USING_PROFILER
+	// 最先启动统计，之后创建的线程都能分到计时槽
+	init_profiler();
+#endif /* INTERFACE_CFG_USING_PROFILER */
+#ifdef INTERFACE_CFG_USING_REACTOR
+	// 事件循环在各模块注册处理函数之前启动
+	init_reactor();
+#endif /* INTERFACE_CFG_USING_REACTOR */
+	// 显示路径最先初始化：迪文页面和显示线程、迪文串口，屏幕收到第一帧之后再加载路由表、打开CAN
+	init_bll_can_page();
 	init_bll_dwin();
+	if (wait_dwin_first_frame(rt_tick_from_millisecond(MAIN_FIRST_FRAME_TIMEOUT)) != RT_EOK)
+	{
+		LOG_W("no DWIN frame in %d ms", MAIN_FIRST_FRAME_TIMEOUT);
+	}
+	init_bll_can();
 	
     /* set LED0 pin mode to output */
     rt_pin_mode(LED2_PIN, PIN_MODE_OUTPUT);
 
+#ifdef INTERFACE_CFG_USING_REACTOR
+	// 运行指示灯也由事件循环翻转，main线程返回后释放线程栈
+	reactor_register(REACTOR_EVENT_LED, led_handler);
+	rt_timer_init(&led_timer, "led", led_timeout, RT_NULL, rt_tick_from_millisecond(500), RT_TIMER_FLAG_PERIODIC);
+	rt_timer_start(&led_timer);
+	return RT_EOK;
+#else
     while (1)
     {
         rt_pin_write(LED2_PIN, PIN_HIGH);
@@ -41,4 +81,5 @@ int main(void)
 		
 		//LOG_I("%d main thread is running!", ++cnt);
     }
+#endif /* INTERFACE_CFG_USING_REACTOR */
 }
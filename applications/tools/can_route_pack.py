@@ -0,0 +1,77 @@
+# -*- coding: utf-8 -*-
+#
+# @file can_route_pack.py
+# @brief 生成CAN路由表二进制文件，格式见 dispatcher/can_route.h
+#
+# 输入为文本文件，每行一条路由项，# 之后为注释：
+#   CAN帧id  起始字节  字节数(1/2)  signed|-  目标(var/curve/signal)  目标下标
+#   0x101    1         1            -         var                     7
+#   0x301    2         2            signed    signal                  3
+# 目标下标与固件中的 dwin_var_list 下标、曲线id、规则信号id 一致，固件加载时会检查范围。
+#
+# 用法：python can_route_pack.py route.txt route.bin
+# 生成的文件在 msh 中执行 can_route_update 后用终端软件以 ymodem 发送。
+#
+import struct
+import sys
+import zlib
+
+ROUTE_MAGIC = 0x54524E43
+ROUTE_VERSION = 1
+ROUTE_MAX_ROUTES = 128
+HEAD_FORMAT = '<IHHII'
+ENTRY_FORMAT = '<IBBBB'
+
+FLAG_SIGNED = 0x04
+TARGET_TYPE = {'var': 0, 'curve': 1, 'signal': 2}
+
+
+def parse_line(line, line_no):
+    fields = line.split('#', 1)[0].split()
+    if not fields:
+        return None
+    if len(fields) != 6:
+        raise ValueError('line %d: need 6 fields' % line_no)
+
+    can_id, offset, size, sign, target, index = fields
+    can_id = int(can_id, 0)
+    offset = int(offset, 0)
+    size = int(size, 0)
+    index = int(index, 0)
+    if size not in (1, 2) or offset + size > 8:
+        raise ValueError('line %d: byte range out of CAN frame' % line_no)
+    if sign not in ('signed', '-'):
+        raise ValueError('line %d: sign must be "signed" or "-"' % line_no)
+    if target not in TARGET_TYPE:
+        raise ValueError('line %d: unknown target "%s"' % (line_no, target))
+    if not 0 <= index <= 0xFF:
+        raise ValueError('line %d: target index out of range' % line_no)
+
+    flags = size | (FLAG_SIGNED if sign == 'signed' else 0)
+    return struct.pack(ENTRY_FORMAT, can_id, offset, flags, TARGET_TYPE[target], index)
+
+
+def pack(text):
+    entries = []
+    for line_no, line in enumerate(text.splitlines(), 1):
+        entry = parse_line(line, line_no)
+        if entry is not None:
+            entries.append(entry)
+    if not 0 < len(entries) <= ROUTE_MAX_ROUTES:
+        raise ValueError('route count %d out of range' % len(entries))
+
+    body = b''.join(entries)
+    head = struct.pack(HEAD_FORMAT, ROUTE_MAGIC, ROUTE_VERSION, len(entries),
+                       struct.calcsize(HEAD_FORMAT) + len(body), zlib.crc32(body) & 0xFFFFFFFF)
+    return head + body
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        print('usage: python can_route_pack.py route.txt route.bin')
+        sys.exit(1)
+    with open(sys.argv[1]) as f:
+        image = pack(f.read())
+    with open(sys.argv[2], 'wb') as f:
+        f.write(image)
+    print('%d routes, %d bytes' % ((len(image) - struct.calcsize(HEAD_FORMAT)) // struct.calcsize(ENTRY_FORMAT), len(image)))
@@ -0,0 +1,68 @@
+# -*- coding: utf-8 -*-
+#
+# @file check_double.py
+# @brief 检查 applications 下的 C 代码是否使用了双精度浮点
+#
+# Cortex-M4F 的FPU只支持单精度，double 运算由软件库模拟。本脚本在编译时由
+# applications/SConscript 调用，发现以下用法时报错：
+#   double 类型、不带 f 后缀的浮点常量、sqrt/sin/pow 等双精度数学函数。
+# 确实需要 double 的行（如性能对比基准）在行尾加注释 "lint: allow-double"。
+#
+# 也可以单独运行：python check_double.py [目录]
+#
+import os
+import re
+import sys
+
+ALLOW_MARK = 'lint: allow-double'
+
+DOUBLE_TYPE = re.compile(r'\bdouble\b')
+# 不带 f/F 后缀的浮点常量：1.0、.5、1e3、1.5e-3，排除十六进制常量
+DOUBLE_LITERAL = re.compile(r'(?<![\w.])(?:\d+\.\d*|\.\d+|\d+(?=[eE]))(?:[eE][+-]?\d+)?(?![\w.])')
+DOUBLE_FUNCTION = re.compile(r'\b(?:sqrt|sin|cos|tan|asin|acos|atan|atan2|exp|log|log10|pow|fabs|floor|ceil|round|fmod)\s*\(')
+
+STRIP_PATTERN = re.compile(r'//[^\n]*|/\*.*?\*/|"(?:\\.|[^"\\\n])*"|\'(?:\\.|[^\'\\\n])*\'', re.S)
+
+
+def strip_comment_and_string(text):
+    # 注释和字符串替换成等长的空白，保持行号不变
+    def blank(match):
+        return re.sub(r'[^\n]', ' ', match.group(0))
+    return STRIP_PATTERN.sub(blank, text)
+
+
+def check_file(path):
+    with open(path, 'r', encoding='utf-8', errors='ignore') as f:
+        raw = f.read()
+    raw_lines = raw.split('\n')
+    code_lines = strip_comment_and_string(raw).split('\n')
+
+    result = []
+    for number, (code, line) in enumerate(zip(code_lines, raw_lines), 1):
+        if ALLOW_MARK in line:
+            continue
+        for pattern, reason in ((DOUBLE_TYPE, 'double type'),
+                                (DOUBLE_LITERAL, 'floating literal without f suffix'),
+                                (DOUBLE_FUNCTION, 'double math function')):
+            if pattern.search(code):
+                result.append('%s:%d: %s: %s' % (path, number, reason, line.strip()))
+                break
+    return result
+
+
+def check(root):
+    result = []
+    for path, dirs, files in os.walk(root):
+        dirs.sort()
+        for name in sorted(files):
+            if name.endswith('.c') or name.endswith('.h'):
+                result += check_file(os.path.join(path, name))
+    return result
+
+
+if __name__ == '__main__':
+    root = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    result = check(root)
+    for item in result:
+        print(item)
+    sys.exit(1 if result else 0)
@@ -0,0 +1,535 @@
+/**
+ * @file curve_history.c
+ * @brief 曲线长历史压缩存储（差分 + 半字节变长编码）
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "curve_history.h"
+
+#define DBG_LEVEL	DBG_LOG
+#define DBG_TAG		"curve_history"
+#include <rtdbg.h>
+
+/*============================ MACROS ========================================*/
+#define NIBBLE_SMALL_MAX		0x0A	//小差值编码的最大半字节
+#define NIBBLE_MEDIUM			0x0B	//中差值标记，后跟1个半字节
+#define NIBBLE_BYTE				0x0C	//单字节差值标记，后跟2个半字节
+#define NIBBLE_REPEAT			0x0D	//短重复段标记，后跟1个半字节
+#define NIBBLE_REPEAT_LONG		0x0E	//长重复段标记，后跟2个半字节
+#define NIBBLE_ESCAPE			0x0F	//原始数据标记，后跟4个半字节
+#define MEDIUM_ZIGZAG_MIN		(NIBBLE_SMALL_MAX + 1)		//中差值zigzag编码范围（11~26）
+#define MEDIUM_ZIGZAG_MAX		(MEDIUM_ZIGZAG_MIN + 0x0F)
+#define BYTE_ZIGZAG_MAX			0xFF
+#define REPEAT_MIN				2		//短重复段长度（2~17）
+#define REPEAT_MAX				(REPEAT_MIN + 0x0F)
+#define REPEAT_LONG_MIN			(REPEAT_MAX + 1)		//长重复段长度（18~273）
+#define REPEAT_LONG_MAX			(REPEAT_LONG_MIN + 0xFF)
+/*============================ TYPES =========================================*/
+/**
+ * @brief 解码游标
+ * @note  从某个块开始顺序解码，跨块时自动进入下一个块，到达写入块末尾后再补上未编码的重复段
+ */
+struct history_cursor
+{
+	curve_history_t *history;
+	rt_uint16_t block_index;	// 当前块下标
+	rt_uint16_t nibble;			// 下一个待读半字节位置
+	rt_uint16_t produced;		// 当前块已解出的数据个数
+	rt_uint16_t value;			// 当前数据
+	rt_int16_t delta;			// 当前差值
+	rt_uint16_t repeat;			// 重复段剩余个数
+	rt_uint16_t pending;		// 写入块尚未编码的重复个数
+};
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+/* 有符号差值与zigzag编码互转，使绝对值小的差值编码也小 */
+static rt_uint16_t zigzag_encode(rt_int16_t delta)
+{
+	return (rt_uint16_t) (((rt_uint16_t) delta << 1) ^ (rt_uint16_t) (delta >> 15));
+}
+
+static rt_int16_t zigzag_decode(rt_uint16_t value)
+{
+	return (rt_int16_t) ((value >> 1) ^ -(rt_int16_t) (value & 1));
+}
+
+static void put_nibble(struct curve_history_block *block, rt_uint16_t pos, rt_uint8_t nibble)
+{
+	if ((pos & 1) == 0)
+	{
+		block->payload[pos >> 1] = nibble << 4;//高半字节在前，同时清掉该字节旧内容
+	}
+	else
+	{
+		block->payload[pos >> 1] |= nibble & 0x0F;
+	}
+}
+
+static rt_uint8_t get_nibble(const struct curve_history_block *block, rt_uint16_t pos)
+{
+	rt_uint8_t byte = block->payload[pos >> 1];
+
+	return (pos & 1) == 0 ? (byte >> 4) : (byte & 0x0F);
+}
+
+/* 写入块剩余的半字节数 */
+static rt_uint16_t free_nibbles(const curve_history_t *history)
+{
+	return CURVE_HISTORY_BLOCK_NIBBLES - history->nibble_count;
+}
+
+/* 单个差值编码所需的半字节数 */
+static rt_uint16_t literal_size(rt_int16_t delta)
+{
+	rt_uint16_t zigzag = zigzag_encode(delta);
+
+	if (zigzag <= NIBBLE_SMALL_MAX)
+	{
+		return 1;
+	}
+	if (zigzag <= MEDIUM_ZIGZAG_MAX)
+	{
+		return 2;
+	}
+
+	return zigzag <= BYTE_ZIGZAG_MAX ? 3 : 5;
+}
+
+/* 把 pending 个重复差值写出所需的半字节数 */
+static rt_uint16_t pending_size(const curve_history_t *history, rt_uint16_t pending)
+{
+	if (pending == 0)
+	{
+		return 0;
+	}
+	if (pending == 1)
+	{
+		return literal_size(history->last_delta);
+	}
+
+	return pending <= REPEAT_MAX ? 2 : 3;
+}
+
+/**
+ * @brief 编码一个差值（只写半字节，不修改计数）
+ * @param value 该差值对应的原始数据，差值过大时直接记录
+ */
+static void encode_delta(curve_history_t *history, rt_int16_t delta, rt_uint16_t value)
+{
+	struct curve_history_block *block = &history->block_list[history->tail];
+	rt_uint16_t zigzag = zigzag_encode(delta);
+
+	if (zigzag <= NIBBLE_SMALL_MAX)
+	{
+		put_nibble(block, history->nibble_count++, (rt_uint8_t) zigzag);
+		return;
+	}
+	if (zigzag <= MEDIUM_ZIGZAG_MAX)
+	{
+		put_nibble(block, history->nibble_count++, NIBBLE_MEDIUM);
+		put_nibble(block, history->nibble_count++, (rt_uint8_t) (zigzag - MEDIUM_ZIGZAG_MIN));
+		return;
+	}
+	if (zigzag <= BYTE_ZIGZAG_MAX)
+	{
+		put_nibble(block, history->nibble_count++, NIBBLE_BYTE);
+		put_nibble(block, history->nibble_count++, (zigzag >> 4) & 0x0F);
+		put_nibble(block, history->nibble_count++, zigzag & 0x0F);
+		return;
+	}
+
+	put_nibble(block, history->nibble_count++, NIBBLE_ESCAPE);
+	put_nibble(block, history->nibble_count++, (value >> 12) & 0x0F);
+	put_nibble(block, history->nibble_count++, (value >> 8) & 0x0F);
+	put_nibble(block, history->nibble_count++, (value >> 4) & 0x0F);
+	put_nibble(block, history->nibble_count++, value & 0x0F);
+}
+
+/* 把尚未编码的重复段写入当前块；调用前已保证空间足够 */
+static void flush_pending(curve_history_t *history)
+{
+	struct curve_history_block *block = &history->block_list[history->tail];
+
+	if (history->pending == 0)
+	{
+		return;
+	}
+
+	if (history->pending == 1)
+	{
+		encode_delta(history, history->last_delta, history->value);
+	}
+	else if (history->pending <= REPEAT_MAX)
+	{
+		put_nibble(block, history->nibble_count++, NIBBLE_REPEAT);
+		put_nibble(block, history->nibble_count++, history->pending - REPEAT_MIN);
+	}
+	else
+	{
+		put_nibble(block, history->nibble_count++, NIBBLE_REPEAT_LONG);
+		put_nibble(block, history->nibble_count++, ((history->pending - REPEAT_LONG_MIN) >> 4) & 0x0F);
+		put_nibble(block, history->nibble_count++, (history->pending - REPEAT_LONG_MIN) & 0x0F);
+	}
+	block->count += history->pending;
+	history->pending = 0;
+}
+
+/* 开启新块，新数据作为块首原始值；环形队列写满后丢弃最旧的块 */
+static void open_next_block(curve_history_t *history, rt_uint16_t data)
+{
+	struct curve_history_block *block;
+
+	if (history->used == 0)
+	{
+		history->head = history->tail = 0;
+		history->used = 1;
+	}
+	else
+	{
+		history->tail = (history->tail + 1) % history->block_count;
+		if (history->used == history->block_count)
+		{
+			history->head = (history->head + 1) % history->block_count;
+		}
+		else
+		{
+			++history->used;
+		}
+	}
+
+	block = &history->block_list[history->tail];
+	block->start_seq = history->next_seq;
+	block->first_value = data;
+	block->count = 1;
+
+	history->nibble_count = 0;
+	history->value = data;
+	history->last_delta = 0;
+	history->pending = 0;
+	++history->next_seq;
+}
+
+/* 游标定位到逻辑序号为 index 的块（0为最旧块） */
+static void cursor_init(struct history_cursor *cursor, curve_history_t *history, rt_uint16_t index)
+{
+	cursor->history = history;
+	cursor->block_index = (history->head + index) % history->block_count;
+	cursor->nibble = 0;
+	cursor->produced = 0;
+	cursor->value = 0;
+	cursor->delta = 0;
+	cursor->repeat = 0;
+	cursor->pending = history->pending;
+}
+
+/**
+ * @brief 游标解出下一个数据
+ * @return rt_bool_t 已到达最新数据时返回RT_FALSE
+ */
+static rt_bool_t cursor_next(struct history_cursor *cursor)
+{
+	curve_history_t *history = cursor->history;
+	const struct curve_history_block *block;
+	rt_uint8_t nibble;
+	rt_uint16_t value;
+
+	if (cursor->repeat > 0)//重复段内：按上一个差值递推
+	{
+		--cursor->repeat;
+		cursor->value += cursor->delta;
+		return RT_TRUE;
+	}
+
+	while (1)
+	{
+		block = &history->block_list[cursor->block_index];
+		if (cursor->produced == 0)//块首数据为原始值
+		{
+			cursor->value = block->first_value;
+			cursor->delta = 0;
+			cursor->produced = 1;
+			return RT_TRUE;
+		}
+
+		if (cursor->produced < block->count)
+		{
+			break;
+		}
+
+		if (cursor->block_index == history->tail)//写入块已解完，补上尚未编码的重复段
+		{
+			if (cursor->pending == 0)
+			{
+				return RT_FALSE;
+			}
+			--cursor->pending;
+			cursor->value += history->last_delta;
+			return RT_TRUE;
+		}
+		// 进入下一个块
+		cursor->block_index = (cursor->block_index + 1) % history->block_count;
+		cursor->nibble = 0;
+		cursor->produced = 0;
+	}
+
+	nibble = get_nibble(block, cursor->nibble++);
+	if (nibble <= NIBBLE_SMALL_MAX)
+	{
+		cursor->delta = zigzag_decode(nibble);
+		cursor->value += cursor->delta;
+		++cursor->produced;
+	}
+	else if (nibble == NIBBLE_MEDIUM)
+	{
+		cursor->delta = zigzag_decode(get_nibble(block, cursor->nibble++) + MEDIUM_ZIGZAG_MIN);
+		cursor->value += cursor->delta;
+		++cursor->produced;
+	}
+	else if (nibble == NIBBLE_BYTE)
+	{
+		value = get_nibble(block, cursor->nibble++) << 4;
+		value |= get_nibble(block, cursor->nibble++);
+		cursor->delta = zigzag_decode(value);
+		cursor->value += cursor->delta;
+		++cursor->produced;
+	}
+	else if (nibble == NIBBLE_REPEAT || nibble == NIBBLE_REPEAT_LONG)
+	{
+		if (nibble == NIBBLE_REPEAT)
+		{
+			cursor->repeat = get_nibble(block, cursor->nibble++) + REPEAT_MIN - 1;
+		}
+		else
+		{
+			cursor->repeat = get_nibble(block, cursor->nibble++) << 4;
+			cursor->repeat |= get_nibble(block, cursor->nibble++);
+			cursor->repeat += REPEAT_LONG_MIN - 1;
+		}
+		cursor->produced += cursor->repeat + 1;
+		cursor->value += cursor->delta;
+	}
+	else
+	{
+		value = get_nibble(block, cursor->nibble++) << 12;
+		value |= get_nibble(block, cursor->nibble++) << 8;
+		value |= get_nibble(block, cursor->nibble++) << 4;
+		value |= get_nibble(block, cursor->nibble++);
+		cursor->delta = (rt_int16_t) (value - cursor->value);
+		cursor->value = value;
+		++cursor->produced;
+	}
+
+	return RT_TRUE;
+}
+
+/**
+ * @brief 游标跳过 count 个数据
+ * @return rt_bool_t 数据不足时返回RT_FALSE
+ * @note  重复段内直接按差值乘个数推进，长保持段不用逐个解码
+ */
+static rt_bool_t cursor_skip(struct history_cursor *cursor, rt_uint32_t count)
+{
+	rt_uint16_t n;
+
+	while (count > 0)
+	{
+		if (cursor->repeat > 0)
+		{
+			n = cursor->repeat < count ? cursor->repeat : (rt_uint16_t) count;
+			cursor->repeat -= n;
+			cursor->value += (rt_uint16_t) (cursor->delta * n);
+			count -= n;
+			continue;
+		}
+		if (!cursor_next(cursor))
+		{
+			return RT_FALSE;
+		}
+		--count;
+	}
+
+	return RT_TRUE;
+}
+
+/* 二分查找包含序号 seq 的块，返回其逻辑序号 */
+static rt_uint16_t find_block(curve_history_t *history, rt_uint32_t seq)
+{
+	rt_uint16_t low = 0;
+	rt_uint16_t high = history->used - 1;
+	rt_uint16_t middle;
+
+	while (low < high)
+	{
+		middle = (low + high + 1) / 2;
+		if (history->block_list[(history->head + middle) % history->block_count].start_seq <= seq)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle - 1;
+		}
+	}
+
+	return low;
+}
+
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 初始化长历史
+ * @param history 长历史控制结构指针
+ * @param buff    压缩块存储区（4字节对齐）
+ * @param size    存储区字节数，按 CURVE_HISTORY_BLOCK_SIZE 划分成块
+ */
+void curve_history_init(curve_history_t *history, void *buff, rt_size_t size)
+{
+	rt_memset(history, 0, sizeof(curve_history_t));
+	history->block_list = (struct curve_history_block *) buff;
+	history->block_count = size / sizeof(struct curve_history_block);
+}
+/**
+ * @brief 添加数据到长历史
+ * @param history 长历史控制结构指针
+ * @param data    原始曲线数据
+ * @note  与上一个差值相同的数据先累计为重复段，差值改变或块空间不足时再写出；
+ *		当前块放不下时开启新块，新块以原始值开头，因此每个块都能独立解码
+ */
+void curve_history_add_data(curve_history_t *history, rt_uint16_t data)
+{
+	rt_int16_t delta;
+
+	if (history->block_count == 0)
+	{
+		return;
+	}
+
+	if (history->used == 0)//第一个数据
+	{
+		open_next_block(history, data);
+		return;
+	}
+
+	delta = (rt_int16_t) (data - history->value);
+	if (delta == history->last_delta && history->pending < REPEAT_LONG_MAX)
+	{
+		if (pending_size(history, history->pending + 1) <= free_nibbles(history))
+		{
+			++history->pending;
+			history->value = data;
+			++history->next_seq;
+			return;
+		}
+	}
+	else
+	{
+		flush_pending(history);
+		if (literal_size(delta) <= free_nibbles(history))
+		{
+			encode_delta(history, delta, data);
+			++history->block_list[history->tail].count;
+			history->value = data;
+			history->last_delta = delta;
+			++history->next_seq;
+			return;
+		}
+	}
+	// 当前块放不下，收尾后开启新块
+	flush_pending(history);
+	open_next_block(history, data);
+}
+/**
+ * @brief 获取可读取的最旧数据序号
+ */
+rt_uint32_t curve_history_first_seq(curve_history_t *history)
+{
+	if (history->used == 0)
+	{
+		return history->next_seq;
+	}
+
+	return history->block_list[history->head].start_seq;
+}
+/**
+ * @brief 获取下一个数据的序号，即最新数据序号加1
+ */
+rt_uint32_t curve_history_next_seq(curve_history_t *history)
+{
+	return history->next_seq;
+}
+/**
+ * @brief 按序号随机读取历史数据
+ * @param history 长历史控制结构指针
+ * @param seq     第一个数据的序号
+ * @param step    抽取步长，1为逐点读取，大于1时每step个数据取一个（缩放显示）
+ * @param buff    输出缓冲区
+ * @param count   最多读取的数据个数
+ * @return rt_uint16_t 实际读取的数据个数
+ * @note  只需解码 seq 所在块的前缀和 count * step 个数据，重复段整段跳过，单次读取耗时有上限
+ */
+rt_uint16_t curve_history_read(curve_history_t *history, rt_uint32_t seq, rt_uint16_t step,
+		rt_uint16_t *buff, rt_uint16_t count)
+{
+	struct history_cursor cursor;
+	rt_uint16_t index;
+	rt_uint16_t read_count = 0;
+
+	if (history->used == 0 || count == 0)
+	{
+		return 0;
+	}
+
+	if (step == 0)
+	{
+		step = 1;
+	}
+
+	if (seq < curve_history_first_seq(history))
+	{
+		seq = curve_history_first_seq(history);
+	}
+
+	if (seq >= history->next_seq)
+	{
+		return 0;
+	}
+
+	index = find_block(history, seq);
+	cursor_init(&cursor, history, index);
+	// 跳到 seq 所在位置
+	cursor_skip(&cursor, seq - history->block_list[cursor.block_index].start_seq);
+
+	while (read_count < count && cursor_next(&cursor))
+	{
+		buff[read_count++] = cursor.value;
+		if (!cursor_skip(&cursor, step - 1))
+		{
+			break;
+		}
+	}
+
+	return read_count;
+}
+/**
+ * @brief 获取已占用的字节数
+ * @note  写满的块按整块计算，写入块按块头加已用半字节计算；与保存的数据个数比较即为压缩比
+ */
+rt_size_t curve_history_used_bytes(curve_history_t *history)
+{
+	if (history->used == 0)
+	{
+		return 0;
+	}
+
+	return (history->used - 1) * sizeof(struct curve_history_block) + CURVE_HISTORY_BLOCK_HEAD_SIZE
+			+ (history->nibble_count + 1) / 2;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file curve_history.h
+ * @brief 曲线长历史压缩存储（差分 + 半字节变长编码）
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ */
+#ifndef __CURVE_HISTORY_H__
+#define __CURVE_HISTORY_H__
+
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================ MACROS ========================================*/
+#define CURVE_HISTORY_BLOCK_SIZE		256		//压缩块字节数（含块头），块大一些块头占比小
+#define CURVE_HISTORY_BLOCK_HEAD_SIZE	8		//块头字节数
+#define CURVE_HISTORY_BLOCK_NIBBLES		((CURVE_HISTORY_BLOCK_SIZE - CURVE_HISTORY_BLOCK_HEAD_SIZE) * 2)	//块内可用半字节数
+/*============================ TYPES =========================================*/
+/**
+ * @struct curve_history_block
+ * @brief 压缩块：块头记录首个原始数据，之后每个数据只记录与前一个数据的差值
+ * @note  编码以半字节为单位（高半字节在前），差值先做zigzag编码（z）：
+ *		0x0~0xA  ：z 为 0~10，差值 -5~+5
+ *		0xB z    ：z 为 11~26（半字节记 z-11），差值 -13~-6、+6~+13
+ *		0xC zz   ：z 为 0~255，差值 -128~+127
+ *		0xD r    ：重复上一个差值 r+2 次（2~17，保持段、匀速变化段）
+ *		0xE rr   ：重复上一个差值 rr+18 次（18~273，长保持段）
+ *		0xF xxxx ：差值更大，直接记录16位原始数据
+ *		保持不变的信号每3个半字节记273个数据，一块最多约4.5万个数据，count 不会溢出
+ */
+struct curve_history_block
+{
+	rt_uint32_t start_seq;		// 块内第一个数据的序号
+	rt_uint16_t first_value;	// 块内第一个数据（原始值）
+	rt_uint16_t count;			// 块内已编码的数据个数（含第一个数据）
+	rt_uint8_t payload[CURVE_HISTORY_BLOCK_SIZE - CURVE_HISTORY_BLOCK_HEAD_SIZE];// 半字节编码区
+};
+/**
+ * @struct curve_history
+ * @brief 一条曲线的长历史：若干压缩块组成的环形队列，写满后覆盖最旧的块
+ */
+struct curve_history
+{
+	struct curve_history_block *block_list;	// 压缩块数组（由调用者提供的内存）
+	rt_uint16_t block_count;	// 压缩块个数
+	rt_uint16_t head;			// 最旧块下标
+	rt_uint16_t tail;			// 正在写入的块下标
+	rt_uint16_t used;			// 已使用的块个数
+	rt_uint16_t nibble_count;	// 正在写入的块已用半字节数
+	rt_uint16_t value;			// 最新数据（含尚未编码的重复段）
+	rt_int16_t last_delta;		// 上一个差值，用于重复段编码
+	rt_uint16_t pending;		// 尚未编码的重复差值个数
+	rt_uint32_t next_seq;		// 下一个数据的序号（即累计数据个数）
+};
+
+typedef struct curve_history curve_history_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ PROTOTYPES ====================================*/
+/*
+初始化长历史；
+添加数据；
+查询可读取的序号范围；
+按序号随机读取（可按步长抽取）；
+查询已占用的字节数（用于计算压缩比）；
+*/
+void curve_history_init(curve_history_t *history, void *buff, rt_size_t size);
+void curve_history_add_data(curve_history_t *history, rt_uint16_t data);
+rt_uint32_t curve_history_first_seq(curve_history_t *history);
+rt_uint32_t curve_history_next_seq(curve_history_t *history);
+rt_uint16_t curve_history_read(curve_history_t *history, rt_uint32_t seq, rt_uint16_t step,
+		rt_uint16_t *buff, rt_uint16_t count);
+rt_size_t curve_history_used_bytes(curve_history_t *history);
+/*============================ INCLUDES ======================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CURVE_HISTORY_H__ */
@@ -0,0 +1,405 @@
+/**
+ * @file curve_history_bench.c
+ * @brief 曲线长历史压缩比、解码正确性和读取耗时测试
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-16
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  按固定随机种子生成几类按曲线采样周期取样的信号（保持、车速、加速度、跳变），
+ *		每类写入 HISTORY_BENCH_SAMPLES 个数据，统计：保存的数据个数、占用字节数和压缩比（原始16位数据 / 占用字节），
+ *		再重新生成同一信号，按步长 1、3、16 读出全部保存的数据逐个比较，最后测量历史视图读取一屏
+ *		（HISTORY_BENCH_SCREEN 个点、步长 HISTORY_BENCH_MAX_STEP）的最坏耗时。
+ *		不重复的差值每个至少占1个半字节，加上块头，噪声类信号（如加速度）压缩比上限约为 3.88。
+ *		msh 命令 curve_history_bench：压缩块从系统堆申请，单位为周期；运行中曲线的实际压缩比用 curve_history_info 查看。
+ *		在PC上测量（单位为ns），64位PC加 -DARCH_CPU_64BIT：
+ *		gcc -O2 -DHISTORY_BENCH_HOST -DARCH_CPU_64BIT -I. -Irt-thread/include -Irt-thread/components/finsh
+ *			-Irt-thread/components/drivers/include -Iapplications/util -ffunction-sections -Wl,--gc-sections
+ *			applications/util/curve_history_bench.c applications/util/curve_history.c rt-thread/src/kservice.c
+ *		PC上可以用 ./a.out <轨迹文件>... 测量实际记录的CAN信号，每行一个按采样周期取样的数据（十进制，可为负）。
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#ifdef HISTORY_BENCH_HOST
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#else
+#include <board.h>
+#endif /* HISTORY_BENCH_HOST */
+
+#include "curve_history.h"
+
+#if (defined(RT_USING_FINSH) && defined(RT_USING_HEAP)) || defined(HISTORY_BENCH_HOST)
+/*============================ MACROS ========================================*/
+#define HISTORY_BENCH_SAMPLES			20000	//每类信号的数据个数（50ms周期约17分钟）
+#define HISTORY_BENCH_SCREEN			20		//历史视图一屏的数据个数（DWIN_CURVE_DATA_MAX_COUNT）
+#define HISTORY_BENCH_MAX_STEP			16		//历史视图最大抽取步长（DWIN_CURVE_HISTORY_MAX_STEP）
+#define HISTORY_BENCH_READS				200		//测量读取耗时的次数
+#define HISTORY_BENCH_SEED				20250416UL
+
+#ifdef HISTORY_BENCH_HOST
+#define HISTORY_BENCH_BLOCKS			256		//压缩块个数，PC上足够大，不覆盖
+#define HISTORY_BENCH_PRINT				printf
+#define HISTORY_BENCH_UNIT				"ns"
+#else
+#define HISTORY_BENCH_BLOCKS			16		//压缩块个数，与实际曲线的配置相当，写满后覆盖
+#define HISTORY_BENCH_PRINT				rt_kprintf
+#define HISTORY_BENCH_UNIT				"cycles"
+#endif /* HISTORY_BENCH_HOST */
+/*============================ TYPES =========================================*/
+/* 信号生成器的状态，同一种子生成的序列相同 */
+typedef struct history_bench_signal
+{
+	const char *name;
+	rt_uint16_t (*next)(struct history_bench_signal *signal);
+	rt_uint32_t seed;
+	rt_int32_t value;			// 当前值
+	rt_int32_t target;			// 车速目标值 / 加速度均值
+	rt_uint32_t hold;			// 当前段剩余的数据个数
+	const rt_int16_t *data;		// 轨迹文件的数据
+	rt_uint32_t index;
+}history_bench_signal_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+static curve_history_t bench_history;
+static rt_uint32_t bench_error_count;
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+#ifdef HISTORY_BENCH_HOST
+static rt_uint32_t bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (rt_uint32_t) (ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+#else
+static rt_uint32_t bench_now(void)
+{
+	return DWT->CYCCNT;
+}
+#endif /* HISTORY_BENCH_HOST */
+/*线性同余随机数，结果可重复*/
+static rt_uint32_t bench_random(history_bench_signal_t *signal)
+{
+	signal->seed = signal->seed * 1103515245UL + 12345UL;
+	return signal->seed >> 8;
+}
+/*保持：长时间不变，偶尔跳到另一个值（停车、定速、开关量）*/
+static rt_uint16_t signal_hold(history_bench_signal_t *signal)
+{
+	if (signal->hold == 0)
+	{
+		signal->hold = 200 + bench_random(signal) % 2000;
+		signal->value = bench_random(signal) % 1200;
+	}
+	--signal->hold;
+
+	return (rt_uint16_t) signal->value;
+}
+/*车速（0.1km/h）：加速、定速、减速交替，每次最多变化 ±1.5km/h，带 ±1 的量化抖动*/
+static rt_uint16_t signal_speed(history_bench_signal_t *signal)
+{
+	rt_int32_t step;
+
+	if (signal->hold == 0)
+	{
+		signal->hold = 100 + bench_random(signal) % 600;
+		signal->target = bench_random(signal) % 1200;
+	}
+	--signal->hold;
+
+	step = (signal->target - signal->value) / 20;
+	step = step > 15 ? 15 : (step < -15 ? -15 : step);
+	signal->value += step;
+	if (bench_random(signal) % 4 == 0)
+	{
+		signal->value += (rt_int32_t) (bench_random(signal) % 3) - 1;
+	}
+
+	return (rt_uint16_t) signal->value;
+}
+/*加速度（0.01m/s²，有符号）：均值缓慢变化，叠加 ±4 的噪声*/
+static rt_uint16_t signal_acc(history_bench_signal_t *signal)
+{
+	if (signal->hold == 0)
+	{
+		signal->hold = 50 + bench_random(signal) % 400;
+		signal->target = (rt_int32_t) (bench_random(signal) % 600) - 300;
+	}
+	--signal->hold;
+
+	signal->value += (signal->target - signal->value) / 8;
+
+	return (rt_uint16_t) (rt_int16_t) (signal->value + (rt_int32_t) (bench_random(signal) % 9) - 4);
+}
+/*跳变：每个数据随机，压缩的最坏情况*/
+static rt_uint16_t signal_jump(history_bench_signal_t *signal)
+{
+	return (rt_uint16_t) bench_random(signal);
+}
+/*轨迹文件*/
+static rt_uint16_t signal_file(history_bench_signal_t *signal)
+{
+	return (rt_uint16_t) signal->data[signal->index++];
+}
+/*从头重新生成信号*/
+static void signal_reset(history_bench_signal_t *signal)
+{
+	signal->seed = HISTORY_BENCH_SEED;
+	signal->value = 0;
+	signal->target = 0;
+	signal->hold = 0;
+	signal->index = 0;
+}
+/*
+ * 按步长读出保存的全部数据，与重新生成的信号比较
+ */
+static void bench_verify(history_bench_signal_t *signal, rt_uint32_t samples, rt_uint16_t step)
+{
+	rt_uint16_t buff[HISTORY_BENCH_SCREEN];
+	rt_uint32_t first = curve_history_first_seq(&bench_history);
+	rt_uint32_t next = curve_history_next_seq(&bench_history);
+	rt_uint32_t seq;
+	rt_uint32_t expect_seq;
+	rt_uint16_t expect = 0;
+	rt_uint16_t count;
+	rt_uint16_t i;
+
+	signal_reset(signal);
+	for (expect_seq = 0; expect_seq < first; expect_seq++)//覆盖掉的数据
+	{
+		signal->next(signal);
+	}
+
+	for (seq = first; seq < next; seq += (rt_uint32_t) count * step)
+	{
+		count = curve_history_read(&bench_history, seq, step, buff, HISTORY_BENCH_SCREEN);
+		if (count == 0)
+		{
+			++bench_error_count;
+			return;
+		}
+		for (i = 0; i < count; i++)
+		{
+			for (; expect_seq <= seq + (rt_uint32_t) i * step; expect_seq++)
+			{
+				expect = signal->next(signal);
+			}
+			if (buff[i] != expect)
+			{
+				if (bench_error_count < 8)
+				{
+					HISTORY_BENCH_PRINT("%s: seq %u step %u read %u expect %u\n", signal->name,
+							(unsigned) (seq + i * step), step, buff[i], expect);
+				}
+				++bench_error_count;
+			}
+		}
+	}
+	if (next != samples)
+	{
+		++bench_error_count;
+	}
+}
+/*
+ * 随机位置读取一屏（最大步长）的最坏耗时
+ */
+static rt_uint32_t bench_read_time(history_bench_signal_t *signal)
+{
+	rt_uint16_t buff[HISTORY_BENCH_SCREEN];
+	rt_uint32_t first = curve_history_first_seq(&bench_history);
+	rt_uint32_t span = curve_history_next_seq(&bench_history) - first;
+	rt_uint32_t worst = 0;
+	rt_uint32_t start;
+	rt_uint32_t time;
+	rt_uint16_t i;
+
+	for (i = 0; i < HISTORY_BENCH_READS; i++)
+	{
+		start = bench_now();
+		curve_history_read(&bench_history, first + bench_random(signal) % span, HISTORY_BENCH_MAX_STEP,
+				buff, HISTORY_BENCH_SCREEN);
+		time = bench_now() - start;
+		worst = time > worst ? time : worst;
+	}
+
+	return worst;
+}
+/*
+ * 写入一类信号，打印压缩比，检查解码结果并测量读取耗时
+ */
+static void bench_signal(history_bench_signal_t *signal, rt_uint32_t samples, void *blocks)
+{
+	rt_uint32_t held;
+	rt_size_t bytes;
+	rt_uint32_t ratio;
+	rt_uint32_t i;
+
+	curve_history_init(&bench_history, blocks, HISTORY_BENCH_BLOCKS * sizeof(struct curve_history_block));
+	signal_reset(signal);
+	for (i = 0; i < samples; i++)
+	{
+		curve_history_add_data(&bench_history, signal->next(signal));
+	}
+
+	held = curve_history_next_seq(&bench_history) - curve_history_first_seq(&bench_history);
+	bytes = curve_history_used_bytes(&bench_history);
+	ratio = bytes != 0 ? (rt_uint32_t) ((rt_uint64_t) held * 2 * 100 / bytes) : 0;
+
+	bench_verify(signal, samples, 1);
+	bench_verify(signal, samples, 3);
+	bench_verify(signal, samples, HISTORY_BENCH_MAX_STEP);
+
+	HISTORY_BENCH_PRINT("%-10s %-8u %-8u %3u.%02u  %u\n", signal->name, (unsigned) held, (unsigned) bytes,
+			(unsigned) (ratio / 100), (unsigned) (ratio % 100), (unsigned) bench_read_time(signal));
+}
+/*打印表头*/
+static void bench_head(void)
+{
+	bench_error_count = 0;
+	HISTORY_BENCH_PRINT("%u blocks of %u bytes, read %u points at step %u in %s\n", HISTORY_BENCH_BLOCKS,
+			(unsigned) sizeof(struct curve_history_block), HISTORY_BENCH_SCREEN, HISTORY_BENCH_MAX_STEP,
+			HISTORY_BENCH_UNIT);
+	HISTORY_BENCH_PRINT("signal     samples  bytes    ratio   read\n");
+}
+/*
+ * 依次测试各类合成信号，返回错误个数
+ */
+static rt_uint32_t bench_run(void *blocks)
+{
+	static history_bench_signal_t signal_list[] =
+	{
+		{ "hold", signal_hold, 0, 0, 0, 0, RT_NULL, 0 },
+		{ "speed", signal_speed, 0, 0, 0, 0, RT_NULL, 0 },
+		{ "acc", signal_acc, 0, 0, 0, 0, RT_NULL, 0 },
+		{ "jump", signal_jump, 0, 0, 0, 0, RT_NULL, 0 },
+	};
+	rt_uint8_t i;
+
+	bench_head();
+	for (i = 0; i < sizeof(signal_list) / sizeof(signal_list[0]); i++)
+	{
+		bench_signal(&signal_list[i], HISTORY_BENCH_SAMPLES, blocks);
+	}
+	HISTORY_BENCH_PRINT("verify: %u errors\n", (unsigned) bench_error_count);
+
+	return bench_error_count;
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+#ifdef HISTORY_BENCH_HOST
+/* PC 上代替内核的输出，长历史只用到这些 */
+void rt_hw_console_output(const char *str)
+{
+	fputs(str, stdout);
+}
+rt_ssize_t rt_device_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+	RT_UNUSED(dev);
+	RT_UNUSED(pos);
+	RT_UNUSED(buffer);
+	RT_UNUSED(size);
+	return 0;
+}
+rt_base_t rt_hw_interrupt_disable(void)
+{
+	return 0;
+}
+void rt_hw_interrupt_enable(rt_base_t level)
+{
+	RT_UNUSED(level);
+}
+rt_uint8_t rt_interrupt_get_nest(void)
+{
+	return 0;
+}
+rt_thread_t rt_thread_self(void)
+{
+	return RT_NULL;
+}
+
+/*读入轨迹文件，每行一个数据*/
+static rt_int16_t *bench_load(const char *path, rt_uint32_t *count)
+{
+	static rt_int16_t *data;
+	rt_uint32_t size = 0;
+	FILE *file;
+	long value;
+
+	file = fopen(path, "r");
+	if (file == RT_NULL)
+	{
+		return RT_NULL;
+	}
+	*count = 0;
+	while (fscanf(file, "%ld", &value) == 1)
+	{
+		if (*count == size)
+		{
+			size = size != 0 ? size * 2 : 4096;
+			data = realloc(data, size * sizeof(rt_int16_t));
+		}
+		data[(*count)++] = (rt_int16_t) value;
+	}
+	fclose(file);
+
+	return data;
+}
+
+int main(int argc, char **argv)
+{
+	static struct curve_history_block blocks[HISTORY_BENCH_BLOCKS];
+	history_bench_signal_t signal;
+	rt_uint32_t count;
+	int i;
+
+	if (argc == 1)
+	{
+		return bench_run(blocks) == 0 ? 0 : 1;
+	}
+
+	bench_head();
+	for (i = 1; i < argc; i++)
+	{
+		rt_memset(&signal, 0, sizeof(signal));
+		signal.name = argv[i];
+		signal.next = signal_file;
+		signal.data = bench_load(argv[i], &count);
+		if (signal.data == RT_NULL || count == 0)
+		{
+			printf("can not read %s\n", argv[i]);
+			return 1;
+		}
+		bench_signal(&signal, count, blocks);
+	}
+	printf("verify: %u errors\n", (unsigned) bench_error_count);
+
+	return bench_error_count == 0 ? 0 : 1;
+}
+#else
+/**
+ * @brief msh命令：测量曲线长历史的压缩比和读取耗时
+ */
+static void curve_history_bench(int argc, char **argv)
+{
+	void *blocks;
+
+	RT_UNUSED(argc);
+	RT_UNUSED(argv);
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	blocks = rt_malloc(HISTORY_BENCH_BLOCKS * sizeof(struct curve_history_block));
+	if (blocks == RT_NULL)
+	{
+		rt_kprintf("no memory\n");
+		return;
+	}
+	bench_run(blocks);
+	rt_free(blocks);
+}
+MSH_CMD_EXPORT(curve_history_bench, measure curve history compression ratio and read time);
+#endif /* HISTORY_BENCH_HOST */
+#endif /* (defined(RT_USING_FINSH) && defined(RT_USING_HEAP)) || defined(HISTORY_BENCH_HOST) */
@@ -0,0 +1,138 @@
+/**
+ * @file fixed_math.c
+ * @brief 定点数与单精度浮点换算的性能测试
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  msh 命令 fixed_math_bench [次数]：用 DWT 周期计数器分别测量原来的 double 换算、
+ *		float 换算和Q16定点换算的平均周期数，并与 double 结果比较最大误差
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <board.h>
+#include <stdlib.h>
+
+#include "fixed_math.h"
+
+#define DBG_LEVEL	DBG_LOG
+#define DBG_TAG		"fixed_math"
+#include <rtdbg.h>
+
+#ifdef RT_USING_FINSH
+/*============================ MACROS ========================================*/
+#define FIXED_MATH_BENCH_DEFAULT_LOOPS	10000
+/*============================ TYPES =========================================*/
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+static const linear_map_q16_t bench_slope_map = LINEAR_MAP_Q16(0, 1000, -90, 90);
+static const linear_map_f_t bench_slope_map_f = LINEAR_MAP_F(0, 1000, -90, 90);
+// 输入输出都经过 volatile 变量，防止编译器把循环优化掉
+static volatile rt_int16_t bench_input;
+static volatile rt_int16_t bench_output;
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+/*启动 DWT 周期计数器*/
+static void bench_cycle_counter_start(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+/*空循环，用于扣除循环本身和 volatile 读写的开销*/
+static rt_uint32_t bench_empty(rt_uint32_t loops)
+{
+	rt_uint32_t start = DWT->CYCCNT;
+
+	for (rt_uint32_t i = 0; i < loops; i++)
+	{
+		bench_input = (rt_int16_t) (i % 1001);
+		bench_output = bench_input;
+	}
+	return DWT->CYCCNT - start;
+}
+/*原来的 double 换算*/
+static rt_uint32_t bench_double(rt_uint32_t loops)
+{
+	rt_uint32_t start = DWT->CYCCNT;
+
+	for (rt_uint32_t i = 0; i < loops; i++)
+	{
+		bench_input = (rt_int16_t) (i % 1001);
+		bench_output = (bench_input - 500) / 500.0 * 90;	// lint: allow-double 对比基准
+	}
+	return DWT->CYCCNT - start;
+}
+/*单精度换算*/
+static rt_uint32_t bench_float(rt_uint32_t loops)
+{
+	rt_uint32_t start = DWT->CYCCNT;
+
+	for (rt_uint32_t i = 0; i < loops; i++)
+	{
+		bench_input = (rt_int16_t) (i % 1001);
+		bench_output = float_to_i16_sat(linear_map_f(&bench_slope_map_f, bench_input));
+	}
+	return DWT->CYCCNT - start;
+}
+/*Q16定点换算*/
+static rt_uint32_t bench_q16(rt_uint32_t loops)
+{
+	rt_uint32_t start = DWT->CYCCNT;
+
+	for (rt_uint32_t i = 0; i < loops; i++)
+	{
+		bench_input = (rt_int16_t) (i % 1001);
+		bench_output = (rt_int16_t) linear_map_q16(&bench_slope_map, bench_input);
+	}
+	return DWT->CYCCNT - start;
+}
+/*与 double 结果比较最大误差*/
+static rt_int32_t bench_max_error(rt_bool_t use_q16)
+{
+	rt_int32_t max_error = 0;
+
+	for (rt_int16_t value = 0; value <= 1000; value++)
+	{
+		rt_int32_t expect = (rt_int32_t) ((value - 500) / 500.0 * 90);	// lint: allow-double 对比基准
+		rt_int32_t result = use_q16 ? linear_map_q16(&bench_slope_map, value)
+				: float_to_i16_sat(linear_map_f(&bench_slope_map_f, value));
+		rt_int32_t error = result > expect ? result - expect : expect - result;
+
+		max_error = error > max_error ? error : max_error;
+	}
+	return max_error;
+}
+/*打印一项测试结果（周期数放大100倍以保留两位小数）*/
+static void bench_print(const char *name, rt_uint32_t cycles, rt_uint32_t base, rt_uint32_t loops)
+{
+	rt_uint32_t per_100 = (rt_uint32_t) (((rt_uint64_t) (cycles > base ? cycles - base : 0) * 100) / loops);
+
+	rt_kprintf("%-8s %6u.%02u cycles/op\n", name, per_100 / 100, per_100 % 100);
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+static void fixed_math_bench(int argc, char **argv)
+{
+	rt_uint32_t loops = FIXED_MATH_BENCH_DEFAULT_LOOPS;
+	rt_uint32_t base;
+
+	if (argc > 1)
+	{
+		loops = atoi(argv[1]);
+	}
+	if (loops == 0)
+	{
+		rt_kprintf("usage: fixed_math_bench [loops]\n");
+		return;
+	}
+
+	bench_cycle_counter_start();
+	base = bench_empty(loops);
+	bench_print("double", bench_double(loops), base, loops);
+	bench_print("float", bench_float(loops), base, loops);
+	bench_print("q16", bench_q16(loops), base, loops);
+	rt_kprintf("max error vs double: float %d, q16 %d\n", bench_max_error(RT_FALSE), bench_max_error(RT_TRUE));
+}
+MSH_CMD_EXPORT(fixed_math_bench, benchmark fixed-point and float conversion);
+#endif /* RT_USING_FINSH */
@@ -0,0 +1,145 @@
+/**
+ * @file fixed_math.h
+ * @brief 定点数（Q15/Q16）与单精度浮点换算工具
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  Cortex-M4F 的FPU只支持单精度，double 运算由软件库模拟，一次乘除要上百个周期。
+ *		业务逻辑中的数值换算统一用本文件的定点线性映射或 float 函数实现，比例系数在编译时算好；
+ *		applications/tools/check_double.py 在编译时检查 applications 下新增的 double 用法
+ */
+#ifndef __FIXED_MATH_H__
+#define __FIXED_MATH_H__
+
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================ MACROS ========================================*/
+#define Q15_SHIFT		15
+#define Q16_SHIFT		16
+#define Q15_MAX			32767
+#define Q15_MIN			(-32768)
+
+/* 由浮点常量得到定点常量，参数为常量时由编译器折叠，不产生运行时浮点运算 */
+#define Q15_CONST(x)	((q15_t) ((x) >= 1.0f ? Q15_MAX : (x) * 32768.0f + ((x) >= 0 ? 0.5f : -0.5f)))
+#define Q16_CONST(x)	((q16_t) ((x) * 65536.0f + ((x) >= 0 ? 0.5f : -0.5f)))
+/* 整数比值 n / d 的Q16常量（四舍五入），纯整数常量表达式 */
+#define Q16_RATIO(n, d)	((q16_t) (((rt_int64_t) (n) * 65536 + ((((n) < 0) == ((d) < 0)) ? (d) / 2 : -((d) / 2))) / (d)))
+
+/**
+ * @brief 定义线性映射：把 [in_min, in_max] 映射到 [out_min, out_max]
+ * @note  用于静态常量初始化，斜率在编译时算好；输入超出范围时按同一直线外推，需要时先用 clamp_i32 限幅
+ */
+#define LINEAR_MAP_Q16(in_min, in_max, out_min, out_max)	\
+	{ (in_min), (out_min), Q16_RATIO((out_max) - (out_min), (in_max) - (in_min)) }
+#define LINEAR_MAP_F(in_min, in_max, out_min, out_max)	\
+	{ (float) (in_min), (float) (out_min), ((float) (out_max) - (float) (out_min)) / ((float) (in_max) - (float) (in_min)) }
+/*============================ TYPES =========================================*/
+typedef rt_int16_t q15_t;		// Q15：[-1, 1)，1 = 32768
+typedef rt_int32_t q16_t;		// Q16：16位整数 + 16位小数，1 = 65536
+
+/* 整数线性映射，斜率为Q16 */
+typedef struct linear_map_q16
+{
+	rt_int32_t in_min;			// 输入起点
+	rt_int32_t out_min;			// 输入起点对应的输出
+	q16_t slope;				// 斜率（输出/输入）
+}linear_map_q16_t;
+
+/* 单精度线性映射 */
+typedef struct linear_map_f
+{
+	float in_min;				// 输入起点
+	float out_min;				// 输入起点对应的输出
+	float slope;				// 斜率（输出/输入）
+}linear_map_f_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ PROTOTYPES ====================================*/
+/* 限幅 */
+rt_inline rt_int32_t clamp_i32(rt_int32_t value, rt_int32_t min, rt_int32_t max)
+{
+	return value < min ? min : (value > max ? max : value);
+}
+
+rt_inline float clamp_f(float value, float min, float max)
+{
+	return value < min ? min : (value > max ? max : value);
+}
+
+/* 饱和到 rt_int16_t */
+rt_inline rt_int16_t sat_i16(rt_int32_t value)
+{
+	return (rt_int16_t) clamp_i32(value, -32768, 32767);
+}
+
+/* float 四舍五入并饱和到 rt_int16_t */
+rt_inline rt_int16_t float_to_i16_sat(float value)
+{
+	value = clamp_f(value, -32768.0f, 32767.0f);
+	return (rt_int16_t) (value + (value >= 0 ? 0.5f : -0.5f));
+}
+
+/* Q15 乘法，四舍五入，-1 * -1 饱和到最大值 */
+rt_inline q15_t q15_mul(q15_t a, q15_t b)
+{
+	return sat_i16(((rt_int32_t) a * b + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT);
+}
+
+/* Q16 乘法，四舍五入 */
+rt_inline q16_t q16_mul(q16_t a, q16_t b)
+{
+	return (q16_t) (((rt_int64_t) a * b + (1 << (Q16_SHIFT - 1))) >> Q16_SHIFT);
+}
+
+/* Q16 四舍五入取整 */
+rt_inline rt_int32_t q16_to_int(q16_t value)
+{
+	return (value + (1 << (Q16_SHIFT - 1))) >> Q16_SHIFT;
+}
+
+/* 定点与 float 互换 */
+rt_inline q15_t q15_from_float(float value)
+{
+	return float_to_i16_sat(value * 32768.0f);
+}
+
+rt_inline float q15_to_float(q15_t value)
+{
+	return value * (1.0f / 32768.0f);
+}
+
+rt_inline q16_t q16_from_float(float value)
+{
+	return (q16_t) (value * 65536.0f + (value >= 0 ? 0.5f : -0.5f));
+}
+
+rt_inline float q16_to_float(q16_t value)
+{
+	return value * (1.0f / 65536.0f);
+}
+
+/* 整数线性映射，结果四舍五入；一次32x32乘法加移位 */
+rt_inline rt_int32_t linear_map_q16(const linear_map_q16_t *map, rt_int32_t value)
+{
+	return map->out_min + (rt_int32_t) (((rt_int64_t) (value - map->in_min) * map->slope + (1 << (Q16_SHIFT - 1))) >> Q16_SHIFT);
+}
+
+/* 单精度线性映射 */
+rt_inline float linear_map_f(const linear_map_f_t *map, float value)
+{
+	return map->out_min + (value - map->in_min) * map->slope;
+}
+/*============================ INCLUDES ======================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FIXED_MATH_H__ */
@@ -0,0 +1,663 @@
+/**
+ * @file heap_bench.c
+ * @brief 堆分配器（small mem、slab、memheap、TLSF）按分配轨迹回放的延迟和碎片对比
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-16
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  按固定随机种子生成几类申请/释放轨迹（内核对象和线程栈、帧缓冲、大小混合），
+ *		对每个已打开的分配器在同一块内存上初始化一个独立的堆，回放同一轨迹，统计：
+ *		malloc/free 的平均和最坏耗时、申请失败次数、最大占用，以及回放结束时的碎片率
+ *		（1 - 最大可申请块 / 空闲字节）。轨迹只取决于种子，不受申请结果影响，各分配器之间可比。
+ *		每项回放 HEAP_BENCH_RUNS 次取最小值，去掉偶发的中断和抢占。
+ *		msh 命令 heap_bench：测量 rtconfig.h 中打开的分配器，内存池从系统堆申请，单位为周期。
+ *		在PC上同时测量四种分配器（单位为ns），rtconfig.h 中没有打开的分配器在命令行上补充定义，64位PC加 -DARCH_CPU_64BIT：
+ *		gcc -O2 -DHEAP_BENCH_HOST -DARCH_CPU_64BIT -DRT_USING_SLAB -DRT_USING_MEMHEAP
+ *			-I. -Irt-thread/include -Irt-thread/components/finsh -ffunction-sections -Wl,--gc-sections
+ *			applications/util/heap_bench.c rt-thread/src/kservice.c rt-thread/src/mem.c
+ *			rt-thread/src/slab.c rt-thread/src/memheap.c rt-thread/src/tlsf.c
+ *		PC上可以用 ./a.out <轨迹文件> 回放实际记录的轨迹，每行 "a <编号> <大小>" 或 "f <编号>"，编号小于 HEAP_BENCH_SLOTS。
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#ifdef HEAP_BENCH_HOST
+#include <stdio.h>
+#include <time.h>
+#else
+#include <board.h>
+#endif /* HEAP_BENCH_HOST */
+
+#if (defined(RT_USING_FINSH) && defined(RT_USING_HEAP)) || defined(HEAP_BENCH_HOST)
+/*============================ MACROS ========================================*/
+#define HEAP_BENCH_SLOTS				256		//同时存在的块数上限
+#define HEAP_BENCH_STEPS				20000	//每条合成轨迹的操作数
+#define HEAP_BENCH_RUNS					3		//每项回放次数，取最小值
+#define HEAP_BENCH_LOAD_PERCENT			70		//轨迹中存活字节数不超过内存池的百分比
+#define HEAP_BENCH_SEED					20250416UL
+
+#ifdef HEAP_BENCH_HOST
+#define HEAP_BENCH_POOL_SIZE			(192 * 1024)
+#define HEAP_BENCH_PRINT				printf
+#define HEAP_BENCH_UNIT					"ns"
+#else
+#define HEAP_BENCH_POOL_SIZE			(40 * 1024)
+#define HEAP_BENCH_PRINT				rt_kprintf
+#define HEAP_BENCH_UNIT					"cycles"
+#endif /* HEAP_BENCH_HOST */
+/*============================ TYPES =========================================*/
+/* 分配器接口，heap 为各自的堆对象 */
+typedef struct heap_bench_ops
+{
+	const char *name;
+	void *(*init)(void *begin, rt_size_t size);
+	void (*detach)(void *heap);
+	void *(*alloc)(void *heap, rt_size_t size);
+	void (*free)(void *heap, void *ptr);
+	void (*info)(void *heap, rt_size_t *total, rt_size_t *used, rt_size_t *max_used);
+}heap_bench_ops_t;
+
+/* 合成轨迹的参数 */
+typedef struct heap_bench_profile
+{
+	const char *name;
+	const rt_uint16_t *sizes;			//非空时从表中取大小，否则按 min_size~max_size 取
+	rt_uint8_t size_count;
+	rt_uint8_t log_uniform;				//按对数均匀分布取大小
+	rt_uint16_t min_size;
+	rt_uint16_t max_size;
+	rt_uint8_t alloc_percent;			//每步申请的概率，其余为释放
+}heap_bench_profile_t;
+
+/* 轨迹的一步 */
+typedef struct heap_bench_op
+{
+	rt_uint8_t is_free;
+	rt_uint16_t slot;
+	rt_uint32_t size;
+}heap_bench_op_t;
+
+/* 轨迹生成器，只记录自己的存活状态，与分配结果无关 */
+typedef struct heap_bench_trace
+{
+	const heap_bench_profile_t *profile;
+#ifdef HEAP_BENCH_HOST
+	FILE *file;
+#endif /* HEAP_BENCH_HOST */
+	rt_uint32_t seed;
+	rt_uint32_t step;
+	rt_uint32_t live_bytes;
+	rt_uint16_t live_count;
+	rt_uint32_t size[HEAP_BENCH_SLOTS];	//0 表示空闲
+}heap_bench_trace_t;
+
+/* 一次回放的结果 */
+typedef struct heap_bench_result
+{
+	rt_uint32_t alloc_avg;
+	rt_uint32_t alloc_max;
+	rt_uint32_t free_avg;
+	rt_uint32_t free_max;
+	rt_uint32_t failed;
+	rt_uint32_t peak;
+	rt_uint32_t fragment;				//百分比
+}heap_bench_result_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+/* 内核对象、线程控制块和线程栈 */
+static const rt_uint16_t bench_object_sizes[] = { 24, 48, 64, 96, 128, 176, 256, 512, 1024, 2048 };
+
+static const heap_bench_profile_t bench_profile_list[] =
+{
+	{ "objects", bench_object_sizes, sizeof(bench_object_sizes) / sizeof(bench_object_sizes[0]), 0, 0, 0, 55 },
+	{ "frames", RT_NULL, 0, 0, 64, 4096, 52 },
+	{ "mixed", RT_NULL, 0, 1, 8, 4096, 55 },
+};
+
+static heap_bench_trace_t bench_trace;
+static void *bench_ptr[HEAP_BENCH_SLOTS];
+static rt_uint32_t bench_size[HEAP_BENCH_SLOTS];
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+#ifdef HEAP_BENCH_HOST
+static rt_uint32_t bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (rt_uint32_t) (ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+#else
+static rt_uint32_t bench_now(void)
+{
+	return DWT->CYCCNT;
+}
+#endif /* HEAP_BENCH_HOST */
+
+#ifdef RT_USING_SMALL_MEM
+static void *bench_small_init(void *begin, rt_size_t size)
+{
+	return rt_smem_init("hb_small", begin, size);
+}
+static void bench_small_detach(void *heap)
+{
+	rt_smem_detach(heap);
+}
+static void *bench_small_alloc(void *heap, rt_size_t size)
+{
+	return rt_smem_alloc(heap, size);
+}
+static void bench_small_free(void *heap, void *ptr)
+{
+	RT_UNUSED(heap);
+	rt_smem_free(ptr);
+}
+#endif /* RT_USING_SMALL_MEM */
+
+#ifdef RT_USING_SLAB
+static void *bench_slab_init(void *begin, rt_size_t size)
+{
+	return rt_slab_init("hb_slab", begin, size);
+}
+static void bench_slab_detach(void *heap)
+{
+	rt_slab_detach(heap);
+}
+static void *bench_slab_alloc(void *heap, rt_size_t size)
+{
+	return rt_slab_alloc(heap, size);
+}
+static void bench_slab_free(void *heap, void *ptr)
+{
+	rt_slab_free(heap, ptr);
+}
+#endif /* RT_USING_SLAB */
+
+#ifdef RT_USING_MEMHEAP
+static struct rt_memheap bench_memheap;
+
+static void *bench_memheap_init(void *begin, rt_size_t size)
+{
+	return rt_memheap_init(&bench_memheap, "hb_mheap", begin, size) == RT_EOK ? &bench_memheap : RT_NULL;
+}
+static void bench_memheap_detach(void *heap)
+{
+	rt_memheap_detach(heap);
+}
+static void *bench_memheap_alloc(void *heap, rt_size_t size)
+{
+	return rt_memheap_alloc(heap, size);
+}
+static void bench_memheap_free(void *heap, void *ptr)
+{
+	RT_UNUSED(heap);
+	rt_memheap_free(ptr);
+}
+static void bench_memheap_info(void *heap, rt_size_t *total, rt_size_t *used, rt_size_t *max_used)
+{
+	rt_memheap_info(heap, total, used, max_used);
+}
+#endif /* RT_USING_MEMHEAP */
+
+#ifdef RT_USING_TLSF
+static void *bench_tlsf_init(void *begin, rt_size_t size)
+{
+	return rt_tlsf_init("hb_tlsf", begin, size);
+}
+static void bench_tlsf_detach(void *heap)
+{
+	rt_tlsf_detach(heap);
+}
+static void *bench_tlsf_alloc(void *heap, rt_size_t size)
+{
+	return rt_tlsf_alloc(heap, size);
+}
+static void bench_tlsf_free(void *heap, void *ptr)
+{
+	rt_tlsf_free(heap, ptr);
+}
+#endif /* RT_USING_TLSF */
+
+#if defined(RT_USING_SMALL_MEM) || defined(RT_USING_SLAB) || defined(RT_USING_TLSF)
+/*small mem、slab、TLSF 的统计都在 struct rt_memory 中*/
+static void bench_memory_info(void *heap, rt_size_t *total, rt_size_t *used, rt_size_t *max_used)
+{
+	rt_mem_t m = heap;
+
+	*total = m->total;
+	*used = m->used;
+	*max_used = m->max;
+}
+#endif
+
+static const heap_bench_ops_t bench_ops_list[] =
+{
+#ifdef RT_USING_SMALL_MEM
+	{ "small", bench_small_init, bench_small_detach, bench_small_alloc, bench_small_free, bench_memory_info },
+#endif /* RT_USING_SMALL_MEM */
+#ifdef RT_USING_SLAB
+	{ "slab", bench_slab_init, bench_slab_detach, bench_slab_alloc, bench_slab_free, bench_memory_info },
+#endif /* RT_USING_SLAB */
+#ifdef RT_USING_MEMHEAP
+	{ "memheap", bench_memheap_init, bench_memheap_detach, bench_memheap_alloc, bench_memheap_free, bench_memheap_info },
+#endif /* RT_USING_MEMHEAP */
+#ifdef RT_USING_TLSF
+	{ "tlsf", bench_tlsf_init, bench_tlsf_detach, bench_tlsf_alloc, bench_tlsf_free, bench_memory_info },
+#endif /* RT_USING_TLSF */
+	{ RT_NULL },
+};
+
+/*线性同余随机数，结果可重复*/
+static rt_uint32_t bench_random(void)
+{
+	bench_trace.seed = bench_trace.seed * 1103515245UL + 12345UL;
+	return bench_trace.seed >> 8;
+}
+/*按轨迹参数取一个申请大小*/
+static rt_uint32_t bench_trace_size(const heap_bench_profile_t *profile)
+{
+	rt_uint32_t size;
+
+	if (profile->sizes != RT_NULL)
+	{
+		return profile->sizes[bench_random() % profile->size_count];
+	}
+	if (profile->log_uniform)
+	{
+		size = profile->min_size << (bench_random() % 10);
+		size += bench_random() % size;
+		return size > profile->max_size ? profile->max_size : size;
+	}
+
+	return profile->min_size + bench_random() % (profile->max_size - profile->min_size + 1);
+}
+/*开始一条轨迹，profile 为空时从文件读*/
+static void bench_trace_begin(const heap_bench_profile_t *profile)
+{
+	rt_memset(&bench_trace, 0, sizeof(bench_trace));
+	bench_trace.profile = profile;
+	bench_trace.seed = HEAP_BENCH_SEED;
+}
+/*
+ * 生成下一步；存活块过多或空间不足时释放，结束时返回 RT_FALSE
+ */
+static rt_bool_t bench_trace_next(heap_bench_op_t *op)
+{
+	const heap_bench_profile_t *profile = bench_trace.profile;
+	rt_uint32_t size;
+	rt_uint16_t slot;
+
+#ifdef HEAP_BENCH_HOST
+	if (profile == RT_NULL)
+	{
+		char kind;
+		unsigned int id;
+		unsigned int bytes = 0;
+		char line[64];
+
+		while (fgets(line, sizeof(line), bench_trace.file) != RT_NULL)
+		{
+			if (sscanf(line, " %c %u %u", &kind, &id, &bytes) >= 2 && id < HEAP_BENCH_SLOTS)
+			{
+				op->is_free = (kind == 'f');
+				op->slot = (rt_uint16_t) id;
+				op->size = bytes;
+				return RT_TRUE;
+			}
+		}
+		return RT_FALSE;
+	}
+#endif /* HEAP_BENCH_HOST */
+
+	if (bench_trace.step++ >= HEAP_BENCH_STEPS)
+	{
+		return RT_FALSE;
+	}
+
+	size = bench_trace_size(profile);
+	if (bench_trace.live_count < HEAP_BENCH_SLOTS
+			&& (bench_trace.live_count == 0 || bench_random() % 100 < profile->alloc_percent)
+			&& bench_trace.live_bytes + size <= HEAP_BENCH_POOL_SIZE / 100 * HEAP_BENCH_LOAD_PERCENT)
+	{
+		for (slot = bench_random() % HEAP_BENCH_SLOTS; bench_trace.size[slot] != 0; slot = (slot + 1) % HEAP_BENCH_SLOTS)
+		{
+		}
+		bench_trace.size[slot] = size;
+		bench_trace.live_bytes += size;
+		bench_trace.live_count++;
+		op->is_free = 0;
+		op->slot = slot;
+		op->size = size;
+	}
+	else
+	{
+		for (slot = bench_random() % HEAP_BENCH_SLOTS; bench_trace.size[slot] == 0; slot = (slot + 1) % HEAP_BENCH_SLOTS)
+		{
+		}
+		bench_trace.live_bytes -= bench_trace.size[slot];
+		bench_trace.size[slot] = 0;
+		bench_trace.live_count--;
+		op->is_free = 1;
+		op->slot = slot;
+		op->size = 0;
+	}
+
+	return RT_TRUE;
+}
+/*最大可申请块：二分查找*/
+static rt_uint32_t bench_largest_block(const heap_bench_ops_t *ops, void *heap, rt_size_t total)
+{
+	rt_uint32_t low = 0;
+	rt_uint32_t high = total;
+	rt_uint32_t mid;
+	void *ptr;
+
+	while (low < high)
+	{
+		mid = low + (high - low + 1) / 2;
+		ptr = ops->alloc(heap, mid);
+		if (ptr != RT_NULL)
+		{
+			ops->free(heap, ptr);
+			low = mid;
+		}
+		else
+		{
+			high = mid - 1;
+		}
+	}
+
+	return low;
+}
+/*
+ * 在 pool 上回放一条轨迹；块的首尾字节写入编号，释放时检查，发现分配器越界
+ */
+static rt_err_t bench_replay(const heap_bench_ops_t *ops, const heap_bench_profile_t *profile, void *pool,
+		heap_bench_result_t *result)
+{
+	rt_uint32_t alloc_count = 0;
+	rt_uint32_t free_count = 0;
+	rt_uint64_t alloc_sum = 0;
+	rt_uint64_t free_sum = 0;
+	rt_size_t total, used, max_used;
+	heap_bench_op_t op;
+	rt_uint32_t start;
+	rt_uint32_t cycles;
+	rt_uint8_t *ptr;
+	void *heap;
+	rt_uint16_t i;
+
+	heap = ops->init(pool, HEAP_BENCH_POOL_SIZE);
+	if (heap == RT_NULL)
+	{
+		return -RT_ERROR;
+	}
+	rt_memset(result, 0, sizeof(heap_bench_result_t));
+	rt_memset(bench_ptr, 0, sizeof(bench_ptr));
+
+	bench_trace_begin(profile);
+	while (bench_trace_next(&op))
+	{
+		if (op.is_free)
+		{
+			ptr = bench_ptr[op.slot];
+			if (ptr == RT_NULL)
+			{
+				continue;
+			}
+			if (ptr[0] != (rt_uint8_t) op.slot || ptr[bench_size[op.slot] - 1] != (rt_uint8_t) op.slot)
+			{
+				HEAP_BENCH_PRINT("%s: block %u overwritten\n", ops->name, op.slot);
+			}
+			start = bench_now();
+			ops->free(heap, ptr);
+			cycles = bench_now() - start;
+			bench_ptr[op.slot] = RT_NULL;
+			free_sum += cycles;
+			free_count++;
+			result->free_max = cycles > result->free_max ? cycles : result->free_max;
+		}
+		else
+		{
+			if (bench_ptr[op.slot] != RT_NULL)
+			{
+				/* 文件轨迹中重复使用未释放的编号 */
+				ops->free(heap, bench_ptr[op.slot]);
+			}
+			start = bench_now();
+			ptr = ops->alloc(heap, op.size);
+			cycles = bench_now() - start;
+			bench_ptr[op.slot] = ptr;
+			alloc_sum += cycles;
+			alloc_count++;
+			result->alloc_max = cycles > result->alloc_max ? cycles : result->alloc_max;
+			if (ptr == RT_NULL)
+			{
+				result->failed++;
+				continue;
+			}
+			bench_size[op.slot] = op.size;
+			ptr[0] = (rt_uint8_t) op.slot;
+			ptr[op.size - 1] = (rt_uint8_t) op.slot;
+		}
+	}
+	result->alloc_avg = alloc_count ? (rt_uint32_t) (alloc_sum / alloc_count) : 0;
+	result->free_avg = free_count ? (rt_uint32_t) (free_sum / free_count) : 0;
+
+	/* 回放结束时的碎片：空闲字节中最大可申请块的比例 */
+	ops->info(heap, &total, &used, &max_used);
+	result->peak = max_used;
+	if (total > used)
+	{
+		result->fragment = 100 - bench_largest_block(ops, heap, total - used) * 100 / (total - used);
+	}
+
+	for (i = 0; i < HEAP_BENCH_SLOTS; i++)
+	{
+		if (bench_ptr[i] != RT_NULL)
+		{
+			ops->free(heap, bench_ptr[i]);
+		}
+	}
+	ops->detach(heap);
+
+	return RT_EOK;
+}
+/*回放 HEAP_BENCH_RUNS 次，每项取最小值*/
+static void bench_profile(const heap_bench_profile_t *profile, const char *name, void *pool)
+{
+	const heap_bench_ops_t *ops;
+	heap_bench_result_t best;
+	heap_bench_result_t result;
+	rt_uint8_t run;
+
+	HEAP_BENCH_PRINT("trace %s, pool %u bytes, %s per call\n", name, HEAP_BENCH_POOL_SIZE, HEAP_BENCH_UNIT);
+	HEAP_BENCH_PRINT("heap     malloc(avg/max)  free(avg/max)  failed  peak     fragment\n");
+	for (ops = bench_ops_list; ops->name != RT_NULL; ops++)
+	{
+		for (run = 0; run < HEAP_BENCH_RUNS; run++)
+		{
+#ifdef HEAP_BENCH_HOST
+			if (profile == RT_NULL)
+			{
+				rewind(bench_trace.file);
+			}
+#endif /* HEAP_BENCH_HOST */
+			if (bench_replay(ops, profile, pool, &result) != RT_EOK)
+			{
+				break;
+			}
+			if (run == 0)
+			{
+				best = result;
+				continue;
+			}
+			best.alloc_avg = result.alloc_avg < best.alloc_avg ? result.alloc_avg : best.alloc_avg;
+			best.alloc_max = result.alloc_max < best.alloc_max ? result.alloc_max : best.alloc_max;
+			best.free_avg = result.free_avg < best.free_avg ? result.free_avg : best.free_avg;
+			best.free_max = result.free_max < best.free_max ? result.free_max : best.free_max;
+		}
+		if (run == 0)
+		{
+			HEAP_BENCH_PRINT("%-8s init failed\n", ops->name);
+			continue;
+		}
+		HEAP_BENCH_PRINT("%-8s %6u/%-9u %6u/%-7u %-7u %-8u %u%%\n", ops->name, (unsigned) best.alloc_avg,
+				(unsigned) best.alloc_max, (unsigned) best.free_avg, (unsigned) best.free_max, (unsigned) best.failed,
+				(unsigned) best.peak, (unsigned) best.fragment);
+	}
+}
+/*回放全部合成轨迹*/
+static void bench_run(void *pool)
+{
+	rt_uint8_t i;
+
+	for (i = 0; i < sizeof(bench_profile_list) / sizeof(bench_profile_list[0]); i++)
+	{
+		bench_profile(&bench_profile_list[i], bench_profile_list[i].name, pool);
+	}
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+#ifdef HEAP_BENCH_HOST
+/* PC 上代替内核的对象、信号量和互斥量，分配器只用到这些 */
+rt_thread_t rt_thread_self(void)
+{
+	return RT_NULL;
+}
+void rt_object_init(struct rt_object *object, enum rt_object_class_type type, const char *name)
+{
+	object->type = type | RT_Object_Class_Static;
+	rt_strncpy(object->name, name, RT_NAME_MAX);
+}
+void rt_object_detach(rt_object_t object)
+{
+	object->type = 0;
+}
+rt_bool_t rt_object_is_systemobject(rt_object_t object)
+{
+	return (object->type & RT_Object_Class_Static) ? RT_TRUE : RT_FALSE;
+}
+rt_uint8_t rt_object_get_type(rt_object_t object)
+{
+	return object->type & ~RT_Object_Class_Static;
+}
+struct rt_object_information *rt_object_get_information(enum rt_object_class_type type)
+{
+	RT_UNUSED(type);
+	return RT_NULL;
+}
+rt_err_t rt_sem_init(rt_sem_t sem, const char *name, rt_uint32_t value, rt_uint8_t flag)
+{
+	RT_UNUSED(sem);
+	RT_UNUSED(name);
+	RT_UNUSED(value);
+	RT_UNUSED(flag);
+	return RT_EOK;
+}
+rt_err_t rt_sem_detach(rt_sem_t sem)
+{
+	RT_UNUSED(sem);
+	return RT_EOK;
+}
+rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t timeout)
+{
+	RT_UNUSED(sem);
+	RT_UNUSED(timeout);
+	return RT_EOK;
+}
+rt_err_t rt_sem_release(rt_sem_t sem)
+{
+	RT_UNUSED(sem);
+	return RT_EOK;
+}
+rt_err_t rt_mutex_init(rt_mutex_t mutex, const char *name, rt_uint8_t flag)
+{
+	RT_UNUSED(mutex);
+	RT_UNUSED(name);
+	RT_UNUSED(flag);
+	return RT_EOK;
+}
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
+{
+	RT_UNUSED(mutex);
+	RT_UNUSED(time);
+	return RT_EOK;
+}
+rt_err_t rt_mutex_release(rt_mutex_t mutex)
+{
+	RT_UNUSED(mutex);
+	return RT_EOK;
+}
+rt_base_t rt_hw_interrupt_disable(void)
+{
+	return 0;
+}
+void rt_hw_interrupt_enable(rt_base_t level)
+{
+	RT_UNUSED(level);
+}
+void rt_hw_console_output(const char *str)
+{
+	fputs(str, stdout);
+}
+rt_uint8_t rt_interrupt_get_nest(void)
+{
+	return 0;
+}
+rt_ssize_t rt_device_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+	RT_UNUSED(dev);
+	RT_UNUSED(pos);
+	RT_UNUSED(buffer);
+	RT_UNUSED(size);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	static rt_uint64_t pool[HEAP_BENCH_POOL_SIZE / sizeof(rt_uint64_t)];
+
+	if (argc > 1)
+	{
+		bench_trace_begin(RT_NULL);
+		bench_trace.file = fopen(argv[1], "r");
+		if (bench_trace.file == RT_NULL)
+		{
+			printf("can not open %s\n", argv[1]);
+			return 1;
+		}
+		bench_profile(RT_NULL, argv[1], pool);
+		fclose(bench_trace.file);
+		return 0;
+	}
+	bench_run(pool);
+
+	return 0;
+}
+#else
+/**
+ * @brief msh命令：回放分配轨迹，比较已打开的分配器
+ */
+static void heap_bench(int argc, char **argv)
+{
+	void *pool;
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	pool = rt_malloc(HEAP_BENCH_POOL_SIZE);
+	if (pool == RT_NULL)
+	{
+		rt_kprintf("no memory for a %u bytes pool\n", HEAP_BENCH_POOL_SIZE);
+		return;
+	}
+	/* 锁调度器，只剩中断的干扰 */
+	rt_enter_critical();
+	bench_run(pool);
+	rt_exit_critical();
+	rt_free(pool);
+}
+MSH_CMD_EXPORT(heap_bench, replay allocation traces on every enabled heap allocator);
+#endif /* HEAP_BENCH_HOST */
+#endif /* (defined(RT_USING_FINSH) && defined(RT_USING_HEAP)) || defined(HEAP_BENCH_HOST) */
@@ -0,0 +1,269 @@
+/**
+ * @file mem_bench.c
+ * @brief rt_memcpy/rt_memset/rt_memmove 的性能测试和正确性检查
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-16
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  msh 命令 mem_bench：长度 1~1024、几种源/目的地址错位组合下，用 DWT 周期计数器测量每次调用的周期数
+ *		（取多次中的最小值，排除中断的影响），同时与逐字节结果比较并检查缓冲区前后的保护字节。
+ *		打开 RT_KSERVICE_USING_ARCH_MEMORY 时测量 libcpu 中的实现，关闭时测量 kservice.c 中的通用实现。
+ *		在PC上测量通用实现（单位为ns）：
+ *		gcc -O2 -DMEM_BENCH_HOST -I. -Irt-thread/include -Irt-thread/components/finsh
+ *			-ffunction-sections -Wl,--gc-sections applications/util/mem_bench.c rt-thread/src/kservice.c
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#ifdef MEM_BENCH_HOST
+#include <stdio.h>
+#include <time.h>
+#else
+#include <board.h>
+#endif /* MEM_BENCH_HOST */
+
+#if defined(RT_USING_FINSH) || defined(MEM_BENCH_HOST)
+/*============================ MACROS ========================================*/
+#define MEM_BENCH_MAX_SIZE				1024	//最大测试长度
+#define MEM_BENCH_GUARD					8		//缓冲区前后的保护字节数
+#define MEM_BENCH_REPEAT				8		//每项测量次数，取最小值
+#define MEM_BENCH_GUARD_BYTE			0xA5
+#define MEM_BENCH_FILL_BYTE				0x3C
+
+#ifdef MEM_BENCH_HOST
+#define MEM_BENCH_PRINT					printf
+#define MEM_BENCH_UNIT					"ns"
+#else
+#define MEM_BENCH_PRINT					rt_kprintf
+#define MEM_BENCH_UNIT					"cycles"
+#endif /* MEM_BENCH_HOST */
+/*============================ TYPES =========================================*/
+/* 目的/源地址相对字对齐的偏移 */
+typedef struct mem_bench_align
+{
+	rt_uint8_t dst;
+	rt_uint8_t src;
+}mem_bench_align_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+static const rt_uint16_t bench_size_list[] = { 1, 2, 3, 4, 7, 8, 15, 16, 31, 32, 63, 64, 127, 128, 255, 256, 512, 1024 };
+static const mem_bench_align_t bench_align_list[] = { {0, 0}, {1, 1}, {0, 1}, {2, 3} };
+// 用字数组保证缓冲区字对齐；memmove 在 bench_dst 内部移动
+static rt_uint32_t bench_src[(MEM_BENCH_MAX_SIZE + 2 * MEM_BENCH_GUARD) / 4];
+static rt_uint32_t bench_dst[(MEM_BENCH_MAX_SIZE + 4 * MEM_BENCH_GUARD) / 4];
+static rt_uint8_t bench_ref[MEM_BENCH_MAX_SIZE + 4 * MEM_BENCH_GUARD];
+static rt_uint32_t bench_error_count;
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+#ifdef MEM_BENCH_HOST
+static rt_uint32_t bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (rt_uint32_t) (ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+#else
+static rt_uint32_t bench_now(void)
+{
+	return DWT->CYCCNT;
+}
+#endif /* MEM_BENCH_HOST */
+/*缓冲区填入已知内容*/
+static void bench_prepare(void)
+{
+	rt_uint8_t *src = (rt_uint8_t *) bench_src;
+	rt_uint8_t *dst = (rt_uint8_t *) bench_dst;
+	rt_uint32_t i;
+
+	for (i = 0; i < sizeof(bench_src); i++)
+	{
+		src[i] = (rt_uint8_t) (i * 7 + 1);
+	}
+	for (i = 0; i < sizeof(bench_dst); i++)
+	{
+		dst[i] = MEM_BENCH_GUARD_BYTE;
+		bench_ref[i] = MEM_BENCH_GUARD_BYTE;
+	}
+}
+/*与参考结果比较整个目的缓冲区（含保护字节）*/
+static void bench_verify(const char *name, rt_uint16_t size, const mem_bench_align_t *align)
+{
+	rt_uint8_t *dst = (rt_uint8_t *) bench_dst;
+	rt_uint32_t i;
+
+	for (i = 0; i < sizeof(bench_dst); i++)
+	{
+		if (dst[i] != bench_ref[i])
+		{
+			MEM_BENCH_PRINT("%s size %u align %u/%u: mismatch at %u\n", name, size, align->dst, align->src,
+					(unsigned) i);
+			bench_error_count++;
+			return;
+		}
+	}
+}
+/*rt_memcpy：逐字节生成参考结果，测量后检查*/
+static rt_uint32_t bench_memcpy(rt_uint16_t size, const mem_bench_align_t *align)
+{
+	rt_uint8_t *dst = (rt_uint8_t *) bench_dst + MEM_BENCH_GUARD + align->dst;
+	rt_uint8_t *src = (rt_uint8_t *) bench_src + MEM_BENCH_GUARD + align->src;
+	rt_uint32_t best = RT_UINT32_MAX;
+	rt_uint32_t start;
+	rt_uint32_t cycles;
+	rt_uint16_t i;
+
+	bench_prepare();
+	for (i = 0; i < size; i++)
+	{
+		bench_ref[MEM_BENCH_GUARD + align->dst + i] = src[i];
+	}
+	for (i = 0; i < MEM_BENCH_REPEAT; i++)
+	{
+		start = bench_now();
+		rt_memcpy(dst, src, size);
+		cycles = bench_now() - start;
+		best = cycles < best ? cycles : best;
+	}
+	bench_verify("memcpy", size, align);
+
+	return best;
+}
+/*rt_memset*/
+static rt_uint32_t bench_memset(rt_uint16_t size, const mem_bench_align_t *align)
+{
+	rt_uint8_t *dst = (rt_uint8_t *) bench_dst + MEM_BENCH_GUARD + align->dst;
+	rt_uint32_t best = RT_UINT32_MAX;
+	rt_uint32_t start;
+	rt_uint32_t cycles;
+	rt_uint16_t i;
+
+	bench_prepare();
+	for (i = 0; i < size; i++)
+	{
+		bench_ref[MEM_BENCH_GUARD + align->dst + i] = MEM_BENCH_FILL_BYTE;
+	}
+	for (i = 0; i < MEM_BENCH_REPEAT; i++)
+	{
+		start = bench_now();
+		rt_memset(dst, MEM_BENCH_FILL_BYTE, size);
+		cycles = bench_now() - start;
+		best = cycles < best ? cycles : best;
+	}
+	bench_verify("memset", size, align);
+
+	return best;
+}
+/*
+ * rt_memmove：在同一缓冲区内向高地址移动（重叠时必须从后往前复制），
+ * 每次测量前恢复源数据，源数据取自 bench_src
+ */
+static rt_uint32_t bench_memmove(rt_uint16_t size, const mem_bench_align_t *align)
+{
+	rt_uint8_t *base = (rt_uint8_t *) bench_dst;
+	rt_uint8_t *src = base + MEM_BENCH_GUARD + align->src;
+	rt_uint8_t *dst = base + 2 * MEM_BENCH_GUARD + align->dst;
+	rt_uint8_t *pattern = (rt_uint8_t *) bench_src;
+	rt_uint32_t best = RT_UINT32_MAX;
+	rt_uint32_t start;
+	rt_uint32_t cycles;
+	rt_uint16_t i;
+	rt_uint16_t j;
+
+	bench_prepare();
+	for (i = 0; i < size; i++)
+	{
+		bench_ref[MEM_BENCH_GUARD + align->src + i] = pattern[i];
+	}
+	for (i = 0; i < size; i++)
+	{
+		bench_ref[2 * MEM_BENCH_GUARD + align->dst + i] = pattern[i];
+	}
+	for (i = 0; i < MEM_BENCH_REPEAT; i++)
+	{
+		for (j = 0; j < size; j++)
+		{
+			src[j] = pattern[j];
+		}
+		start = bench_now();
+		rt_memmove(dst, src, size);
+		cycles = bench_now() - start;
+		best = cycles < best ? cycles : best;
+	}
+	bench_verify("memmove", size, align);
+
+	return best;
+}
+/*测量计时本身的开销*/
+static rt_uint32_t bench_overhead(void)
+{
+	rt_uint32_t best = RT_UINT32_MAX;
+	rt_uint32_t start;
+	rt_uint32_t cycles;
+	rt_uint16_t i;
+
+	for (i = 0; i < MEM_BENCH_REPEAT; i++)
+	{
+		start = bench_now();
+		cycles = bench_now() - start;
+		best = cycles < best ? cycles : best;
+	}
+
+	return best;
+}
+/*执行全部测试，返回错误个数*/
+static rt_uint32_t bench_run(void)
+{
+	rt_uint32_t base = bench_overhead();
+	rt_uint32_t copy;
+	rt_uint32_t set;
+	rt_uint32_t move;
+	rt_uint8_t i;
+	rt_uint8_t j;
+
+	bench_error_count = 0;
+	MEM_BENCH_PRINT("%s memory functions, %s per call\n",
+#if defined(RT_KSERVICE_USING_ARCH_MEMORY) && !defined(MEM_BENCH_HOST)
+			"arch",
+#else
+			"generic",
+#endif
+			MEM_BENCH_UNIT);
+	MEM_BENCH_PRINT("size  dst/src  memcpy  memset  memmove\n");
+	for (i = 0; i < sizeof(bench_size_list) / sizeof(bench_size_list[0]); i++)
+	{
+		for (j = 0; j < sizeof(bench_align_list) / sizeof(bench_align_list[0]); j++)
+		{
+			copy = bench_memcpy(bench_size_list[i], &bench_align_list[j]) - base;
+			set = bench_memset(bench_size_list[i], &bench_align_list[j]) - base;
+			move = bench_memmove(bench_size_list[i], &bench_align_list[j]) - base;
+			MEM_BENCH_PRINT("%-5u %u/%u      %-7u %-7u %-7u\n", bench_size_list[i],
+					bench_align_list[j].dst, bench_align_list[j].src,
+					(unsigned) copy, (unsigned) set, (unsigned) move);
+		}
+	}
+	MEM_BENCH_PRINT("verify: %u errors\n", (unsigned) bench_error_count);
+
+	return bench_error_count;
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+#ifdef MEM_BENCH_HOST
+int main(void)
+{
+	return bench_run() == 0 ? 0 : 1;
+}
+#else
+/**
+ * @brief msh命令：测量内存复制、填充、移动函数
+ */
+static void mem_bench(int argc, char **argv)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	bench_run();
+}
+MSH_CMD_EXPORT(mem_bench, benchmark rt_memcpy rt_memset rt_memmove);
+#endif /* MEM_BENCH_HOST */
+#endif /* defined(RT_USING_FINSH) || defined(MEM_BENCH_HOST) */
@@ -0,0 +1,152 @@
+/**
+ * @file mutex_bench.c
+ * @brief rt_mutex 无竞争获取/释放开销的测试
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-16
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  msh 命令 mutex_bench：用 DWT 周期计数器测量无竞争时 rt_mutex_take、rt_mutex_release、
+ *		两者成对调用（曲线数据读写的用法）以及嵌套获取的开销，取 MUTEX_BENCH_LOOP 次中的最小值和平均值。
+ *		打开 RT_USING_MUTEX_FAST_PATH 时测量快速路径，关闭时测量原有的关中断路径，两次编译分别运行即可对比。
+ *		最后让一个更高优先级的线程来竞争，检查优先级继承在快速路径下依然生效：
+ *		等待期间持有者被提升到竞争者的优先级，释放后恢复原优先级，竞争者随后拿到互斥量。
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <board.h>
+
+#ifdef RT_USING_FINSH
+/*============================ MACROS ========================================*/
+#define MUTEX_BENCH_LOOP				1000	//每项测量的次数
+#define MUTEX_BENCH_STACK_SIZE			512		//竞争线程的栈大小
+/*============================ TYPES =========================================*/
+/* 一项测量结果，单位为周期 */
+typedef struct mutex_bench_result
+{
+	rt_uint32_t min;
+	rt_uint32_t sum;
+}mutex_bench_result_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+static struct rt_mutex bench_mutex;
+static volatile rt_uint8_t bench_contender_got;
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+static rt_uint32_t bench_now(void)
+{
+	return DWT->CYCCNT;
+}
+static void bench_add(mutex_bench_result_t *result, rt_uint32_t cycles)
+{
+	result->min = cycles < result->min ? cycles : result->min;
+	result->sum += cycles;
+}
+static void bench_print(const char *name, const mutex_bench_result_t *result)
+{
+	rt_kprintf("%-10s %6u %6u\n", name, result->min, result->sum / MUTEX_BENCH_LOOP);
+}
+/*竞争线程：阻塞在持有者手里的互斥量上，拿到后立即释放*/
+static void bench_contender_entry(void *parameter)
+{
+	if (rt_mutex_take(&bench_mutex, RT_WAITING_FOREVER) == RT_EOK)
+	{
+		bench_contender_got = 1;
+		rt_mutex_release(&bench_mutex);
+	}
+}
+/*
+ * 持有互斥量时让更高优先级的线程来竞争，检查优先级继承和交接
+ */
+static rt_bool_t bench_check_inherit(void)
+{
+	rt_thread_t self = rt_thread_self();
+	rt_uint8_t priority = self->current_priority;
+	rt_uint8_t boosted;
+	rt_thread_t contender;
+
+	if (priority == 0)
+	{
+		rt_kprintf("inherit check skipped: no priority above the current thread\n");
+		return RT_TRUE;
+	}
+
+	contender = rt_thread_create("mbench", bench_contender_entry, RT_NULL, MUTEX_BENCH_STACK_SIZE, priority - 1, 10);
+	if (contender == RT_NULL)
+	{
+		rt_kprintf("inherit check skipped: no memory for the contender\n");
+		return RT_TRUE;
+	}
+
+	bench_contender_got = 0;
+	rt_mutex_take(&bench_mutex, RT_WAITING_FOREVER);
+	/* 竞争线程优先级更高，启动后立即运行并阻塞在互斥量上 */
+	rt_thread_startup(contender);
+	boosted = self->current_priority;
+	rt_mutex_release(&bench_mutex);
+
+	rt_kprintf("inherit: boosted to %u (expect %u), restored to %u (expect %u), handed over %s\n", boosted, priority - 1,
+			self->current_priority, priority, bench_contender_got ? "yes" : "no");
+
+	return boosted == priority - 1 && self->current_priority == priority && bench_contender_got;
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief msh命令：测量互斥量无竞争时的开销并检查优先级继承
+ */
+static void mutex_bench(int argc, char **argv)
+{
+	mutex_bench_result_t take = { RT_UINT32_MAX, 0 };
+	mutex_bench_result_t release = { RT_UINT32_MAX, 0 };
+	mutex_bench_result_t pair = { RT_UINT32_MAX, 0 };
+	mutex_bench_result_t nested = { RT_UINT32_MAX, 0 };
+	rt_uint32_t start;
+	rt_uint32_t i;
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	rt_mutex_init(&bench_mutex, "mbench", RT_IPC_FLAG_PRIO);
+
+	for (i = 0; i < MUTEX_BENCH_LOOP; i++)
+	{
+		start = bench_now();
+		rt_mutex_take(&bench_mutex, RT_WAITING_FOREVER);
+		bench_add(&take, bench_now() - start);
+
+		start = bench_now();
+		rt_mutex_release(&bench_mutex);
+		bench_add(&release, bench_now() - start);
+
+		start = bench_now();
+		rt_mutex_take(&bench_mutex, RT_WAITING_FOREVER);
+		rt_mutex_release(&bench_mutex);
+		bench_add(&pair, bench_now() - start);
+
+		/* 已持有时再获取一次，测量嵌套的一对 */
+		rt_mutex_take(&bench_mutex, RT_WAITING_FOREVER);
+		start = bench_now();
+		rt_mutex_take(&bench_mutex, RT_WAITING_FOREVER);
+		rt_mutex_release(&bench_mutex);
+		bench_add(&nested, bench_now() - start);
+		rt_mutex_release(&bench_mutex);
+	}
+
+#ifdef RT_USING_MUTEX_FAST_PATH
+	rt_kprintf("mutex path: fast, %u loops, cycles\n", MUTEX_BENCH_LOOP);
+#else
+	rt_kprintf("mutex path: interrupt disabled, %u loops, cycles\n", MUTEX_BENCH_LOOP);
+#endif /* RT_USING_MUTEX_FAST_PATH */
+	rt_kprintf("operation     min    avg\n");
+	bench_print("take", &take);
+	bench_print("release", &release);
+	bench_print("pair", &pair);
+	bench_print("nested", &nested);
+
+	rt_kprintf("priority inheritance %s\n", bench_check_inherit() ? "ok" : "FAILED");
+
+	rt_mutex_detach(&bench_mutex);
+}
+MSH_CMD_EXPORT(mutex_bench, benchmark uncontended rt_mutex take and release);
+#endif /* RT_USING_FINSH */
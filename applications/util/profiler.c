@@ -0,0 +1,365 @@
+/**
+ * @file profiler.c
+ * @brief 线程CPU占用率和栈使用统计
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ */
+/*============================ INCLUDES ======================================*/
+#include <board.h>
+
+#include "profiler.h"
+
+#ifdef INTERFACE_CFG_USING_PROFILER
+
+#define DBG_LEVEL	DBG_LOG
+#define DBG_TAG		"profiler"
+#include <rtdbg.h>
+
+/*============================ MACROS ========================================*/
+#define PROFILER_STACK_FILL				'#'		//线程初始化时栈的填充字节
+/*============================ TYPES =========================================*/
+/**
+ * @struct profiler_slot
+ * @brief 计时槽：一个线程或中断的累计周期数
+ * @note 累计值为32位，按差值使用，桶的时间远小于计数器回绕时间
+ */
+typedef struct profiler_slot
+{
+	rt_thread_t thread;				/**< 线程，中断和合并统计的槽为 RT_NULL */
+	char name[RT_NAME_MAX];			/**< 线程名 */
+	rt_uint32_t total;				/**< 累计周期数 */
+	rt_uint32_t mark;				/**< 上一个桶结束时的累计值 */
+	rt_uint32_t bucket[PROFILER_BUCKET_COUNT];	/**< 各桶内的周期数 */
+}profiler_slot_t;
+/**
+ * @struct profiler_info
+ * @brief 统计状态
+ */
+typedef struct profiler_info
+{
+	profiler_slot_t slot_list[PROFILER_MAX_THREADS];	/**< 线程计时槽 */
+	rt_uint16_t slot_count;			/**< 已分配的线程计时槽个数 */
+	profiler_slot_t other;			/**< 计时槽用完后的线程合并统计 */
+	profiler_slot_t isr;			/**< 中断 */
+	profiler_slot_t elapsed;		/**< 总时间，只使用 mark 和 bucket */
+	profiler_slot_t *thread_slot;	/**< 当前线程的计时槽 */
+	profiler_slot_t *current;		/**< 正在计时的槽：当前线程或中断 */
+	rt_uint32_t last;				/**< 上次计时的周期计数 */
+	rt_uint32_t switch_count;		/**< 线程切换次数 */
+	rt_uint32_t switch_mark;		/**< 上一个桶结束时的切换次数 */
+	rt_uint32_t switch_bucket[PROFILER_BUCKET_COUNT];	/**< 各桶内的切换次数 */
+	rt_uint8_t bucket_index;		/**< 下一个要写的桶 */
+	rt_uint32_t hook_max_cycles;	/**< 切换钩子最长执行周期数 */
+	struct rt_timer timer;			/**< 换桶定时器 */
+}profiler_info_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+static profiler_info_t profiler;
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 把上次计时到现在的时间记到正在计时的槽上
+ */
+rt_inline void profiler_charge(rt_uint32_t now)
+{
+	profiler.current->total += now - profiler.last;
+	profiler.last = now;
+}
+/**
+ * @brief 取得线程的计时槽，第一次出现的线程分配一个槽
+ * @note 槽指针保存在 user_data 中，切换钩子里不需要查找
+ */
+rt_inline profiler_slot_t *profiler_slot_of(rt_thread_t thread)
+{
+	profiler_slot_t *slot = (profiler_slot_t *) thread->user_data;
+
+	if (slot == RT_NULL)
+	{
+		if (profiler.slot_count < PROFILER_MAX_THREADS)
+		{
+			slot = &profiler.slot_list[profiler.slot_count++];
+			slot->thread = thread;
+			rt_strncpy(slot->name, thread->parent.name, RT_NAME_MAX);
+		}
+		else
+		{
+			slot = &profiler.other;
+		}
+		thread->user_data = (rt_ubase_t) slot;
+	}
+
+	return slot;
+}
+/**
+ * @brief 调度器切换钩子（已关中断）
+ * @note 在中断中切换时，这段时间属于中断，在中断退出时记给中断
+ */
+static void profiler_switch_hook(rt_thread_t from, rt_thread_t to)
+{
+	rt_uint32_t now = DWT->CYCCNT;
+	rt_uint32_t cycles;
+
+	profiler.thread_slot = profiler_slot_of(to);
+	if (rt_interrupt_get_nest() == 0)
+	{
+		profiler_charge(now);
+		profiler.current = profiler.thread_slot;
+	}
+	profiler.switch_count++;
+
+	cycles = DWT->CYCCNT - now;
+	profiler.hook_max_cycles = cycles > profiler.hook_max_cycles ? cycles : profiler.hook_max_cycles;
+}
+/**
+ * @brief 中断进入钩子，只处理最外层中断
+ */
+static void profiler_interrupt_enter_hook(void)
+{
+	if (rt_interrupt_get_nest() == 1)
+	{
+		profiler_charge(DWT->CYCCNT);
+		profiler.current = &profiler.isr;
+	}
+}
+/**
+ * @brief 中断退出钩子，只处理最外层中断
+ */
+static void profiler_interrupt_leave_hook(void)
+{
+	if (rt_interrupt_get_nest() == 1)
+	{
+		profiler_charge(DWT->CYCCNT);
+		profiler.current = profiler.thread_slot;
+	}
+}
+/**
+ * @brief 把一个槽本桶内的周期数存入桶
+ */
+rt_inline void profiler_slot_rotate(profiler_slot_t *slot, rt_uint8_t index)
+{
+	slot->bucket[index] = slot->total - slot->mark;
+	slot->mark = slot->total;
+}
+/**
+ * @brief 换桶定时器（中断上下文）
+ * @note 先把时间记到当前槽（此时是中断），各槽之和与总时间一致
+ */
+static void profiler_timeout(void *parameter)
+{
+	rt_uint8_t index = profiler.bucket_index;
+	rt_base_t level;
+	rt_uint16_t i;
+
+	level = rt_hw_interrupt_disable();
+	profiler_charge(DWT->CYCCNT);
+	for (i = 0; i < profiler.slot_count; i++)
+	{
+		profiler_slot_rotate(&profiler.slot_list[i], index);
+	}
+	profiler_slot_rotate(&profiler.other, index);
+	profiler_slot_rotate(&profiler.isr, index);
+	profiler.elapsed.total = profiler.last;
+	profiler_slot_rotate(&profiler.elapsed, index);
+	profiler.switch_bucket[index] = profiler.switch_count - profiler.switch_mark;
+	profiler.switch_mark = profiler.switch_count;
+	profiler.bucket_index = (index + 1) % PROFILER_BUCKET_COUNT;
+	rt_hw_interrupt_enable(level);
+}
+/**
+ * @brief 一个槽在滑动窗口内的周期数
+ */
+static rt_uint32_t profiler_window_cycles(const profiler_slot_t *slot)
+{
+	rt_uint32_t sum = 0;
+	rt_uint8_t i;
+
+	for (i = 0; i < PROFILER_BUCKET_COUNT; i++)
+	{
+		sum += slot->bucket[i];
+	}
+
+	return sum;
+}
+/**
+ * @brief 周期数换算为千分比
+ */
+static rt_uint16_t profiler_permille(rt_uint32_t cycles, rt_uint32_t window)
+{
+	return window == 0 ? 0 : (rt_uint16_t) ((rt_uint64_t) cycles * 1000 / window);
+}
+/**
+ * @brief 线程栈最大使用量：从栈底开始数仍是填充字节的部分
+ */
+static rt_uint32_t profiler_stack_max_used(rt_thread_t thread)
+{
+	const rt_uint8_t *ptr = (const rt_uint8_t *) thread->stack_addr;
+	const rt_uint8_t *end = ptr + thread->stack_size;
+
+	while (ptr < end && *ptr == PROFILER_STACK_FILL)
+	{
+		ptr++;
+	}
+
+	return end - ptr;
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 初始化并启动统计
+ * @note 在main线程开始时调用，之前的时间不统计
+ */
+void init_profiler(void)
+{
+	rt_base_t level;
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	level = rt_hw_interrupt_disable();
+	rt_memset(&profiler, 0, sizeof(profiler));
+	rt_strncpy(profiler.other.name, "(other)", RT_NAME_MAX);
+	rt_strncpy(profiler.isr.name, "(isr)", RT_NAME_MAX);
+	profiler.thread_slot = profiler_slot_of(rt_thread_self());
+	profiler.current = profiler.thread_slot;
+	profiler.last = DWT->CYCCNT;
+	profiler.elapsed.mark = profiler.last;
+	rt_scheduler_sethook(profiler_switch_hook);
+	rt_interrupt_enter_sethook(profiler_interrupt_enter_hook);
+	rt_interrupt_leave_sethook(profiler_interrupt_leave_hook);
+	rt_hw_interrupt_enable(level);
+
+	rt_timer_init(&profiler.timer, "profiler", profiler_timeout, RT_NULL,
+			rt_tick_from_millisecond(PROFILER_BUCKET_MS), RT_TIMER_FLAG_PERIODIC);
+	rt_timer_start(&profiler.timer);
+}
+/**
+ * @brief 获取总体统计
+ * @param stat 返回统计结果
+ */
+void get_profiler_stat(profiler_stat_t *stat)
+{
+	rt_thread_t idle = rt_thread_idle_gethandler();
+	rt_uint32_t switch_sum = 0;
+	rt_base_t level;
+	rt_uint8_t i;
+
+	level = rt_hw_interrupt_disable();
+	stat->window_cycles = profiler_window_cycles(&profiler.elapsed);
+	stat->isr_permille = profiler_permille(profiler_window_cycles(&profiler.isr), stat->window_cycles);
+	stat->idle_permille = (idle != RT_NULL && idle->user_data != 0) ?
+			profiler_permille(profiler_window_cycles((profiler_slot_t *) idle->user_data), stat->window_cycles) : 0;
+	for (i = 0; i < PROFILER_BUCKET_COUNT; i++)
+	{
+		switch_sum += profiler.switch_bucket[i];
+	}
+	stat->hook_max_cycles = profiler.hook_max_cycles;
+	rt_hw_interrupt_enable(level);
+
+	stat->switch_per_second = switch_sum * 1000 / (PROFILER_BUCKET_MS * PROFILER_BUCKET_COUNT);
+}
+/**
+ * @brief 获取各线程统计
+ * @param list 返回统计结果
+ * @param count list 的元素个数
+ * @return rt_uint16_t 线程个数，超过 count 的线程不返回
+ * @note 只返回仍然存在的线程；计时槽用完后新建的线程CPU占用率合并在 "(other)" 中，这里显示为0
+ */
+rt_uint16_t get_profiler_thread_stat(profiler_thread_stat_t *list, rt_uint16_t count)
+{
+	rt_object_t thread_list[PROFILER_MAX_THREADS];
+	profiler_slot_t *slot;
+	rt_thread_t thread;
+	rt_uint32_t window;
+	rt_base_t level;
+	int thread_count;
+	int i;
+
+	rt_enter_critical();//统计过程中线程不会被删除
+	thread_count = rt_object_get_pointers(RT_Object_Class_Thread, thread_list, PROFILER_MAX_THREADS);
+	thread_count = thread_count > count ? count : thread_count;
+	for (i = 0; i < thread_count; i++)
+	{
+		thread = (rt_thread_t) thread_list[i];
+		slot = (profiler_slot_t *) thread->user_data;
+
+		rt_strncpy(list[i].name, thread->parent.name, RT_NAME_MAX);
+		level = rt_hw_interrupt_disable();
+		window = profiler_window_cycles(&profiler.elapsed);
+		list[i].cpu_permille = (slot != RT_NULL && slot->thread == thread) ?
+				profiler_permille(profiler_window_cycles(slot), window) : 0;
+		rt_hw_interrupt_enable(level);
+		list[i].stack_size = thread->stack_size;
+		list[i].stack_max_used = profiler_stack_max_used(thread);
+	}
+	rt_exit_critical();
+
+	return thread_count;
+}
+/**
+ * @brief 获取启动以来的线程切换次数
+ */
+rt_uint32_t get_profiler_switch_count(void)
+{
+	return profiler.switch_count;
+}
+#ifdef RT_USING_FINSH
+/**
+ * @brief msh命令：按线程显示CPU占用率和栈最大使用量
+ */
+static void top(int argc, char **argv)
+{
+	profiler_thread_stat_t list[PROFILER_MAX_THREADS];
+	profiler_stat_t stat;
+	rt_uint16_t count;
+	rt_uint16_t i;
+
+	get_profiler_stat(&stat);
+	count = get_profiler_thread_stat(list, PROFILER_MAX_THREADS);
+
+	rt_kprintf("window %d ms, busy %d.%d%%, isr %d.%d%%, idle %d.%d%%, %u switches/s, hook max %u cycles\n",
+			PROFILER_BUCKET_MS * PROFILER_BUCKET_COUNT,
+			(1000 - stat.idle_permille) / 10, (1000 - stat.idle_permille) % 10,
+			stat.isr_permille / 10, stat.isr_permille % 10,
+			stat.idle_permille / 10, stat.idle_permille % 10,
+			stat.switch_per_second, stat.hook_max_cycles);
+	rt_kprintf("%-*.*s   cpu%%   stack used/size\n", RT_NAME_MAX, RT_NAME_MAX, "thread");
+	for (i = 0; i < count; i++)
+	{
+		rt_kprintf("%-*.*s %3d.%d%%  %5u/%-5u %3u%%\n", RT_NAME_MAX, RT_NAME_MAX, list[i].name,
+				list[i].cpu_permille / 10, list[i].cpu_permille % 10,
+				list[i].stack_max_used, list[i].stack_size,
+				list[i].stack_size == 0 ? 0 : list[i].stack_max_used * 100 / list[i].stack_size);
+	}
+}
+MSH_CMD_EXPORT(top, show thread CPU usage and stack high-water marks);
+/**
+ * @brief msh命令：按行输出统计，便于上位机记录趋势
+ * @note 格式（逗号分隔）：
+ *		prof,<tick>,sys,<窗口周期数>,<isr千分比>,<idle千分比>,<切换次数/s>,<钩子最长周期>
+ *		prof,<tick>,thread,<线程名>,<cpu千分比>,<栈最大使用量>,<栈大小>
+ */
+static void prof_dump(int argc, char **argv)
+{
+	profiler_thread_stat_t list[PROFILER_MAX_THREADS];
+	profiler_stat_t stat;
+	rt_tick_t tick = rt_tick_get();
+	rt_uint16_t count;
+	rt_uint16_t i;
+
+	get_profiler_stat(&stat);
+	count = get_profiler_thread_stat(list, PROFILER_MAX_THREADS);
+
+	rt_kprintf("prof,%u,sys,%u,%u,%u,%u,%u\n", tick, stat.window_cycles, stat.isr_permille,
+			stat.idle_permille, stat.switch_per_second, stat.hook_max_cycles);
+	for (i = 0; i < count; i++)
+	{
+		rt_kprintf("prof,%u,thread,%.*s,%u,%u,%u\n", tick, RT_NAME_MAX, list[i].name,
+				list[i].cpu_permille, list[i].stack_max_used, list[i].stack_size);
+	}
+}
+MSH_CMD_EXPORT(prof_dump, dump profiler statistics as CSV lines);
+#endif /* RT_USING_FINSH */
+#endif /* INTERFACE_CFG_USING_PROFILER */
@@ -0,0 +1,71 @@
+/**
+ * @file profiler.h
+ * @brief 线程CPU占用率和栈使用统计
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  安装调度器切换钩子和中断进入/退出钩子，用 DWT 周期计数器把时间记到当前线程或中断上：
+ *		线程切换时记给切出的线程，最外层中断进入时记给被打断的线程，最外层中断退出时记给中断。
+ *		每 PROFILER_BUCKET_MS 毫秒把累计值存入一个桶，最近 PROFILER_BUCKET_COUNT 个桶组成滑动窗口；
+ *		空闲时间就是空闲线程的时间。线程的计时槽保存在 rt_thread.user_data 中，应用不能再使用该字段。
+ *		msh 命令 top 显示CPU占用率和栈最大使用量，prof_dump 按行输出便于记录趋势。
+ */
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================ MACROS ========================================*/
+#define PROFILER_MAX_THREADS			16		//最多统计的线程数，超出的线程合并统计
+#define PROFILER_BUCKET_MS				250		//桶的时间长度（ms）
+#define PROFILER_BUCKET_COUNT			4		//滑动窗口的桶数，窗口长度为 PROFILER_BUCKET_MS * PROFILER_BUCKET_COUNT
+/*============================ TYPES =========================================*/
+/**
+ * @struct profiler_thread_stat
+ * @brief 一个线程在滑动窗口内的统计
+ */
+typedef struct profiler_thread_stat
+{
+	char name[RT_NAME_MAX];			/**< 线程名 */
+	rt_uint16_t cpu_permille;		/**< CPU占用率（千分比） */
+	rt_uint32_t stack_size;			/**< 栈大小 */
+	rt_uint32_t stack_max_used;		/**< 栈最大使用量 */
+}profiler_thread_stat_t;
+/**
+ * @struct profiler_stat
+ * @brief 滑动窗口内的总体统计
+ */
+typedef struct profiler_stat
+{
+	rt_uint32_t window_cycles;		/**< 窗口内总周期数 */
+	rt_uint16_t isr_permille;		/**< 中断占用率（千分比） */
+	rt_uint16_t idle_permille;		/**< 空闲线程占用率（千分比） */
+	rt_uint32_t switch_per_second;	/**< 每秒线程切换次数 */
+	rt_uint32_t hook_max_cycles;	/**< 切换钩子最长执行周期数 */
+}profiler_stat_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ PROTOTYPES ====================================*/
+/* 初始化并启动统计，安装调度器和中断钩子 */
+void init_profiler(void);
+/* 获取总体统计 */
+void get_profiler_stat(profiler_stat_t *stat);
+/* 获取各线程统计，返回线程个数 */
+rt_uint16_t get_profiler_thread_stat(profiler_thread_stat_t *list, rt_uint16_t count);
+/* 获取启动以来的线程切换次数 */
+rt_uint32_t get_profiler_switch_count(void);
+/*============================ INCLUDES ======================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROFILER_H__ */
@@ -0,0 +1,286 @@
+/**
+ * @file ptask.c
+ * @brief 无栈协作任务（protothread），多个任务共用一个调度线程
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-16
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  除启动链表外，任务链表只在调度线程中访问，不需要关中断。
+ */
+/*============================ INCLUDES ======================================*/
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "ptask.h"
+
+#define DBG_LEVEL	DBG_LOG
+#define DBG_TAG		"ptask"
+#include <rtdbg.h>
+
+/*============================ MACROS ========================================*/
+#define PTASK_THREAD_SECTION			20		//调度线程时间片
+/*============================ TYPES =========================================*/
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+/*时刻 tick 是否已到（节拍计数回绕后仍正确）*/
+static rt_bool_t ptask_tick_reached(rt_tick_t tick)
+{
+	return (rt_tick_t)(rt_tick_get() - tick) < RT_TICK_MAX / 2;
+}
+/*加入就绪队列末尾*/
+static void ptask_make_ready(ptask_sched_t *sched, ptask_t *task)
+{
+	task->state = PTASK_STATE_READY;
+	rt_list_insert_before(&sched->ready_list[task->priority], &task->list);
+	sched->ready_group |= 1UL << task->priority;
+}
+/*按时刻插入定时链表，时刻相同的排在后面*/
+static void ptask_timer_insert(ptask_sched_t *sched, ptask_t *task)
+{
+	rt_list_t *node;
+
+	for (node = sched->timer_list.next; node != &sched->timer_list; node = node->next)
+	{
+		if ((rt_tick_t)(rt_list_entry(node, ptask_t, tlist)->wake_tick - task->wake_tick) < RT_TICK_MAX / 2 &&
+				rt_list_entry(node, ptask_t, tlist)->wake_tick != task->wake_tick)
+		{
+			break;
+		}
+	}
+	rt_list_insert_before(node, &task->tlist);
+}
+/*
+ * 距最近一个定时任务到时的节拍数，有就绪任务时为 0，没有定时任务时为 RT_WAITING_FOREVER
+ */
+static rt_int32_t ptask_next_timeout(ptask_sched_t *sched)
+{
+	rt_tick_t tick;
+
+	if (sched->ready_group != 0)
+	{
+		return 0;
+	}
+	if (rt_list_isempty(&sched->timer_list))
+	{
+		return RT_WAITING_FOREVER;
+	}
+
+	tick = rt_list_entry(sched->timer_list.next, ptask_t, tlist)->wake_tick;
+	return ptask_tick_reached(tick) ? 0 : (rt_int32_t)(tick - rt_tick_get());
+}
+/**
+ * @brief 等待通知或定时任务到时，最多 timeout 个节拍
+ * @note 被通知时取走新启动的任务，并让所有等待条件的任务重新检查；之后唤醒到时的定时任务
+ */
+static void ptask_sched_poll(ptask_sched_t *sched, rt_int32_t timeout)
+{
+	rt_uint32_t count;
+	rt_base_t level;
+	ptask_t *task;
+
+	if (rt_doorbell_wait(&sched->bell, &count, timeout) == RT_EOK)
+	{
+		level = rt_hw_interrupt_disable();
+		while (!rt_list_isempty(&sched->start_list))
+		{
+			task = rt_list_entry(sched->start_list.next, ptask_t, list);
+			rt_list_remove(&task->list);
+			ptask_make_ready(sched, task);
+		}
+		rt_hw_interrupt_enable(level);
+
+		/*等待的任务可能在定时链表中，条件成立后再移出*/
+		while (!rt_list_isempty(&sched->wait_list))
+		{
+			task = rt_list_entry(sched->wait_list.next, ptask_t, list);
+			rt_list_remove(&task->list);
+			ptask_make_ready(sched, task);
+		}
+		sched->notify_count++;
+	}
+
+	while (!rt_list_isempty(&sched->timer_list))
+	{
+		task = rt_list_entry(sched->timer_list.next, ptask_t, tlist);
+		if (!ptask_tick_reached(task->wake_tick))
+		{
+			break;
+		}
+		rt_list_remove(&task->tlist);
+		if (task->state != PTASK_STATE_READY)
+		{
+			rt_list_remove(&task->list);
+			ptask_make_ready(sched, task);
+		}
+	}
+}
+/**
+ * @brief 执行优先级最高的就绪任务到下一个断点
+ */
+static void ptask_sched_run(ptask_sched_t *sched)
+{
+	rt_uint8_t priority = __rt_ffs(sched->ready_group) - 1;
+	ptask_t *task = rt_list_entry(sched->ready_list[priority].next, ptask_t, list);
+	ptask_result_t result;
+
+	rt_list_remove(&task->list);
+	if (rt_list_isempty(&sched->ready_list[priority]))
+	{
+		sched->ready_group &= ~(1UL << priority);
+	}
+
+	result = task->entry(task);
+	sched->run_count++;
+
+	/*没有超时的等待、延时结束和等待结束的任务不在定时链表中*/
+	if (result != PTASK_WAITING || !task->timed)
+	{
+		rt_list_remove(&task->tlist);
+	}
+
+	switch (result)
+	{
+	case PTASK_YIELDED:
+		ptask_make_ready(sched, task);
+		break;
+	case PTASK_WAITING:
+		task->state = PTASK_STATE_WAITING;
+		rt_list_insert_before(&sched->wait_list, &task->list);
+		if (task->timed && rt_list_isempty(&task->tlist))
+		{
+			ptask_timer_insert(sched, task);
+		}
+		break;
+	case PTASK_SLEEPING:
+		task->state = PTASK_STATE_SLEEPING;
+		ptask_timer_insert(sched, task);
+		break;
+	default:
+		task->state = PTASK_STATE_INIT;
+		break;
+	}
+}
+/*调度线程*/
+static void ptask_sched_entry(void *parameter)
+{
+	ptask_sched_t *sched = parameter;
+
+	while (1)
+	{
+		/*有就绪任务时只查询，不阻塞；每执行一个任务查询一次，新就绪的高优先级任务先执行*/
+		ptask_sched_poll(sched, ptask_next_timeout(sched));
+		if (sched->ready_group != 0)
+		{
+			ptask_sched_run(sched);
+		}
+	}
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 初始化并启动调度线程
+ * @param sched 调度线程，一直有效
+ * @param name 线程名
+ * @param stack_size 线程栈大小，所有任务函数共用
+ * @param priority 线程优先级
+ * @return RT_EOK 成功，-RT_ENOMEM 创建线程失败
+ */
+rt_err_t ptask_sched_init(ptask_sched_t *sched, const char *name, rt_uint32_t stack_size, rt_uint8_t priority)
+{
+	rt_uint8_t i;
+
+	RT_ASSERT(sched != RT_NULL);
+
+	rt_memset(sched, 0, sizeof(ptask_sched_t));
+	rt_doorbell_init(&sched->bell);
+	for (i = 0; i < PTASK_PRIORITY_MAX; i++)
+	{
+		rt_list_init(&sched->ready_list[i]);
+	}
+	rt_list_init(&sched->wait_list);
+	rt_list_init(&sched->timer_list);
+	rt_list_init(&sched->start_list);
+
+	sched->thread = rt_thread_create(name, ptask_sched_entry, sched, stack_size, priority, PTASK_THREAD_SECTION);
+	if (sched->thread == RT_NULL)
+	{
+		LOG_E("%s thread failure!", name);
+		return -RT_ENOMEM;
+	}
+	rt_thread_startup(sched->thread);
+
+	return RT_EOK;
+}
+/**
+ * @brief 通知调度线程重新检查等待中的任务
+ * @note 可以在中断中调用；调度线程处理之前的多次通知合并为一次
+ */
+void ptask_sched_notify(ptask_sched_t *sched)
+{
+	RT_ASSERT(sched != RT_NULL);
+
+	rt_doorbell_ring(&sched->bell);
+}
+/**
+ * @brief 初始化任务
+ * @param task 任务，启动后到结束之前一直有效
+ * @param entry 任务函数
+ * @param parameter 任务参数，存入 task->parameter
+ * @param priority 优先级，0 最高，小于 PTASK_PRIORITY_MAX
+ */
+void ptask_init(ptask_t *task, ptask_entry_t entry, void *parameter, rt_uint8_t priority)
+{
+	RT_ASSERT(task != RT_NULL);
+	RT_ASSERT(entry != RT_NULL);
+	RT_ASSERT(priority < PTASK_PRIORITY_MAX);
+
+	rt_memset(task, 0, sizeof(ptask_t));
+	rt_list_init(&task->list);
+	rt_list_init(&task->tlist);
+	task->entry = entry;
+	task->parameter = parameter;
+	task->priority = priority;
+	task->state = PTASK_STATE_INIT;
+}
+/**
+ * @brief 启动任务，从任务函数开头执行
+ * @note 可以在中断和任务函数中调用，任务必须未启动或已结束
+ */
+void ptask_startup(ptask_sched_t *sched, ptask_t *task)
+{
+	rt_base_t level;
+
+	RT_ASSERT(sched != RT_NULL);
+	RT_ASSERT(task != RT_NULL);
+	RT_ASSERT(task->state == PTASK_STATE_INIT);
+
+	task->lc = 0;
+	level = rt_hw_interrupt_disable();
+	task->state = PTASK_STATE_START;
+	rt_list_insert_before(&sched->start_list, &task->list);
+	rt_hw_interrupt_enable(level);
+
+	rt_doorbell_ring(&sched->bell);
+}
+/**
+ * @brief 设置延时或等待超时
+ * @param ticks 节拍数，RT_WAITING_FOREVER 为没有超时
+ * @note 在任务函数中由 PT_xxx 宏调用，先移出定时链表，返回调度线程时按新的时刻插入
+ */
+void ptask_set_timeout(ptask_t *task, rt_int32_t ticks)
+{
+	rt_list_remove(&task->tlist);
+	task->timed = ticks != RT_WAITING_FOREVER;
+	task->wake_tick = rt_tick_get() + (ticks > 0 ? ticks : 0);
+}
+/**
+ * @brief 当前等待是否超时
+ */
+rt_bool_t ptask_timed_out(ptask_t *task)
+{
+	return task->timed && ptask_tick_reached(task->wake_tick);
+}
@@ -0,0 +1,150 @@
+/**
+ * @file ptask.h
+ * @brief 无栈协作任务（protothread），多个任务共用一个调度线程
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-16
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  任务函数用 PT_BEGIN/PT_END 包围，在 PT_YIELD、PT_SLEEP、PT_WAIT_xxx 处返回调度线程，
+ *		下次从返回处继续执行（断点是 switch 的 case 标签，存在 ptask.lc 中）。任务没有自己的栈：
+ *		局部变量在断点之后不保留，需要跨断点的变量放在包含 ptask_t 的结构体里（用 rt_container_of 取得）；
+ *		PT_xxx 宏不能写在任务函数里的 switch 语句中，同一行最多一个。
+ *		调度线程总是执行优先级最高（编号最小）的就绪任务，同优先级先进先出，任务执行到下一个断点才切换。
+ *		RT-Thread 的事件集和完成量只能挂起线程，任务等待它们时由调度线程以 0 超时查询：
+ *		等待中的任务在调度线程被通知（ptask_sched_notify）时重新检查条件，
+ *		所以发送事件、完成量之后要调用 ptask_sched_notify，可以在中断中调用。
+ *		任务函数不能调用会阻塞的接口，否则同一调度线程的所有任务都被阻塞。
+ */
+#ifndef __PTASK_H__
+#define __PTASK_H__
+
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================ MACROS ========================================*/
+#ifndef PTASK_PRIORITY_MAX
+#define PTASK_PRIORITY_MAX			8		//任务优先级数，不超过32
+#endif
+
+/* 任务函数的开始和结束，PT_END 之后任务结束，可以再次启动 */
+#define PT_BEGIN(task)				switch ((task)->lc) { case 0:
+#define PT_END(task)				} (task)->lc = 0; return PTASK_ENDED
+
+/* 提前结束任务 */
+#define PT_EXIT(task)				do { (task)->lc = 0; return PTASK_ENDED; } while (0)
+
+/* 让出调度线程，排到同优先级就绪任务的最后 */
+#define PT_YIELD(task)				do { (task)->lc = __LINE__; return PTASK_YIELDED; case __LINE__:; } while (0)
+
+/* 延时 ticks 个节拍 */
+#define PT_SLEEP(task, ticks)		do { ptask_set_timeout((task), (ticks)); (task)->lc = __LINE__; \
+										return PTASK_SLEEPING; case __LINE__:; } while (0)
+
+/*
+ * 等待条件 cond 成立，最多 ticks 个节拍（RT_WAITING_FOREVER 为一直等待），
+ * 之后 task->error 为 RT_EOK 或 -RT_ETIMEOUT。条件在被通知和超时时重新计算，只能在成立时有副作用（如取走事件）
+ */
+#define PT_WAIT_UNTIL_TIMEOUT(task, cond, ticks) \
+	do { \
+		ptask_set_timeout((task), (ticks)); \
+		(task)->lc = __LINE__; case __LINE__: \
+		if (cond) { (task)->error = RT_EOK; } \
+		else if (!ptask_timed_out(task)) { return PTASK_WAITING; } \
+		else { (task)->error = -RT_ETIMEOUT; } \
+	} while (0)
+#define PT_WAIT_UNTIL(task, cond)	PT_WAIT_UNTIL_TIMEOUT(task, cond, RT_WAITING_FOREVER)
+
+/* 等待事件集，参数同 rt_event_recv */
+#define PT_WAIT_EVENT(task, event, set, option, ticks, recved) \
+	PT_WAIT_UNTIL_TIMEOUT(task, rt_event_recv((event), (set), (option), 0, (recved)) == RT_EOK, ticks)
+
+/* 等待完成量 */
+#define PT_WAIT_COMPLETION(task, completion, ticks) \
+	PT_WAIT_UNTIL_TIMEOUT(task, rt_completion_wait((completion), 0) == RT_EOK, ticks)
+/*============================ TYPES =========================================*/
+/* 任务函数的返回值，由 PT_xxx 宏返回 */
+typedef enum ptask_result
+{
+	PTASK_YIELDED = 0,				// 让出
+	PTASK_WAITING,					// 等待条件
+	PTASK_SLEEPING,					// 延时
+	PTASK_ENDED,					// 结束
+}ptask_result_t;
+
+/* 任务状态 */
+typedef enum ptask_state
+{
+	PTASK_STATE_INIT = 0,			// 未启动或已结束
+	PTASK_STATE_START,				// 已启动，调度线程尚未取走
+	PTASK_STATE_READY,				// 就绪
+	PTASK_STATE_WAITING,			// 等待条件
+	PTASK_STATE_SLEEPING,			// 延时
+}ptask_state_t;
+
+typedef struct ptask ptask_t;
+
+/* 任务函数，只能通过 PT_xxx 宏返回 */
+typedef ptask_result_t (*ptask_entry_t)(ptask_t *task);
+
+/**
+ * @struct ptask
+ * @brief 无栈任务
+ */
+struct ptask
+{
+	rt_list_t list;					/**< 启动链表、就绪队列或等待链表中的节点 */
+	rt_list_t tlist;				/**< 定时链表中的节点 */
+	ptask_entry_t entry;			/**< 任务函数 */
+	void *parameter;				/**< 任务参数 */
+	rt_tick_t wake_tick;			/**< 延时结束或等待超时的时刻 */
+	rt_err_t error;					/**< 最近一次 PT_WAIT_xxx 的结果 */
+	rt_uint16_t lc;					/**< 断点，0 为从头执行 */
+	rt_uint8_t priority;			/**< 优先级，0 最高 */
+	rt_uint8_t state;				/**< ptask_state_t */
+	rt_uint8_t timed;				/**< 当前等待有超时 */
+};
+
+/**
+ * @struct ptask_sched
+ * @brief 调度线程
+ */
+typedef struct ptask_sched
+{
+	struct rt_doorbell bell;		/**< 通知和启动任务时响铃 */
+	rt_uint32_t ready_group;		/**< 就绪优先级位图 */
+	rt_list_t ready_list[PTASK_PRIORITY_MAX];	/**< 各优先级的就绪队列 */
+	rt_list_t wait_list;			/**< 等待条件的任务 */
+	rt_list_t timer_list;			/**< 延时和有超时的等待任务，按时刻排序 */
+	rt_list_t start_list;			/**< 已启动、调度线程尚未取走的任务，关中断访问 */
+	rt_thread_t thread;				/**< 调度线程 */
+	rt_uint32_t run_count;			/**< 执行任务函数的次数 */
+	rt_uint32_t notify_count;		/**< 被通知后重新检查等待任务的次数 */
+}ptask_sched_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ PROTOTYPES ====================================*/
+/* 初始化并启动调度线程 */
+rt_err_t ptask_sched_init(ptask_sched_t *sched, const char *name, rt_uint32_t stack_size, rt_uint8_t priority);
+/* 通知调度线程重新检查等待中的任务，可以在中断中调用 */
+void ptask_sched_notify(ptask_sched_t *sched);
+/* 初始化任务 */
+void ptask_init(ptask_t *task, ptask_entry_t entry, void *parameter, rt_uint8_t priority);
+/* 启动任务，可以在中断和任务函数中调用 */
+void ptask_startup(ptask_sched_t *sched, ptask_t *task);
+/* 设置延时或等待超时，供 PT_xxx 宏使用 */
+void ptask_set_timeout(ptask_t *task, rt_int32_t ticks);
+/* 等待是否超时，供 PT_xxx 宏使用 */
+rt_bool_t ptask_timed_out(ptask_t *task);
+/*============================ INCLUDES ======================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PTASK_H__ */
@@ -0,0 +1,298 @@
+/**
+ * @file ptask_bench.c
+ * @brief 无栈任务 ptask 与线程的内存占用、切换开销对比
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-16
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  msh 命令 ptask_bench：
+ *		内存：各创建 PTASK_BENCH_TASKS 个任务和线程（栈大小与 CAN、迪文线程相同），按堆使用量的增加计算每个的字节数，
+ *		调度线程本身的开销单独列出；
+ *		让出：两个同优先级的任务（线程）各让出 PTASK_BENCH_LOOPS 次，计算每次切换的周期数；
+ *		乒乓：两个任务（线程）用完成量轮流唤醒对方，计算每次唤醒到对方开始执行的周期数。
+ *		两个测试对象在调度器锁内一起启动，都就绪后才开始执行；每次循环记录上一次执行的对象，
+ *		换了对象才算一次切换，按实际切换次数计算周期数，同时打印切换次数以确认两者交替执行。
+ *		调度线程在第一次执行时创建，之后一直保留。
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <board.h>
+
+#include "ptask.h"
+
+#if defined(RT_USING_FINSH) && defined(RT_USING_HEAP)
+/*============================ MACROS ========================================*/
+#define PTASK_BENCH_LOOPS				10000	//每个任务让出或唤醒对方的次数
+#define PTASK_BENCH_TASKS				16		//内存测试的任务数
+#define PTASK_BENCH_THREAD_SIZE			1024	//对比线程的栈大小
+#define PTASK_BENCH_SCHED_SIZE			512		//调度线程的栈大小
+#define PTASK_BENCH_PRIORITY			5		//调度线程和对比线程的优先级，高于业务线程
+#define PTASK_BENCH_NO_MEMORY			RT_UINT32_MAX	//创建对比线程失败
+/*============================ TYPES =========================================*/
+/* 测试任务，跨断点的变量放在任务结构体后面 */
+typedef struct bench_task
+{
+	ptask_t task;
+	rt_uint32_t i;
+	struct rt_completion *wait;		//乒乓测试中等待自己的完成量
+	struct rt_completion *peer;		//乒乓测试中唤醒对方的完成量
+}bench_task_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+static ptask_sched_t bench_sched;
+static rt_bool_t bench_sched_started;
+static struct rt_semaphore bench_done;			//每个任务（线程）结束时释放一次
+static struct rt_completion bench_completion[2];
+static bench_task_t *bench_last;				//上一次执行的测试对象
+static rt_uint32_t bench_switch_count;			//测试对象之间的实际切换次数
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+static rt_uint32_t bench_now(void)
+{
+	return DWT->CYCCNT;
+}
+/*执行的测试对象与上一次不同时计一次切换*/
+static void bench_count_switch(bench_task_t *bt)
+{
+	if (bench_last != bt)
+	{
+		bench_last = bt;
+		bench_switch_count++;
+	}
+}
+static ptask_result_t bench_yield_task(ptask_t *task)
+{
+	bench_task_t *bt = rt_container_of(task, bench_task_t, task);
+
+	PT_BEGIN(task);
+	for (bt->i = 0; bt->i < PTASK_BENCH_LOOPS; bt->i++)
+	{
+		bench_count_switch(bt);
+		PT_YIELD(task);
+	}
+	rt_sem_release(&bench_done);
+	PT_END(task);
+}
+static ptask_result_t bench_pingpong_task(ptask_t *task)
+{
+	bench_task_t *bt = rt_container_of(task, bench_task_t, task);
+
+	PT_BEGIN(task);
+	for (bt->i = 0; bt->i < PTASK_BENCH_LOOPS; bt->i++)
+	{
+		PT_WAIT_COMPLETION(task, bt->wait, RT_WAITING_FOREVER);
+		bench_count_switch(bt);
+		rt_completion_done(bt->peer);
+		ptask_sched_notify(&bench_sched);
+	}
+	rt_sem_release(&bench_done);
+	PT_END(task);
+}
+static void bench_yield_thread(void *parameter)
+{
+	bench_task_t *bt = parameter;
+	rt_uint32_t i;
+
+	for (i = 0; i < PTASK_BENCH_LOOPS; i++)
+	{
+		bench_count_switch(bt);
+		rt_thread_yield();
+	}
+	rt_sem_release(&bench_done);
+}
+static void bench_pingpong_thread(void *parameter)
+{
+	bench_task_t *bt = parameter;
+	rt_uint32_t i;
+
+	for (i = 0; i < PTASK_BENCH_LOOPS; i++)
+	{
+		rt_completion_wait(bt->wait, RT_WAITING_FOREVER);
+		bench_count_switch(bt);
+		rt_completion_done(bt->peer);
+	}
+	rt_sem_release(&bench_done);
+}
+/*两个测试对象，0 等待 bench_completion[0] 唤醒 1，1 反之*/
+static void bench_pair_init(bench_task_t *pair)
+{
+	rt_uint8_t n;
+
+	bench_last = RT_NULL;
+	bench_switch_count = 0;
+	rt_completion_init(&bench_completion[0]);
+	rt_completion_init(&bench_completion[1]);
+	for (n = 0; n < 2; n++)
+	{
+		pair[n].wait = &bench_completion[n];
+		pair[n].peer = &bench_completion[!n];
+	}
+}
+/*
+ * 扣除第一次执行得到实际切换次数，返回每次切换的周期数
+ */
+static rt_uint32_t bench_cycles_per_switch(rt_uint32_t cycles)
+{
+	if (bench_switch_count > 0)
+	{
+		bench_switch_count--;
+	}
+	return bench_switch_count != 0 ? cycles / bench_switch_count : 0;
+}
+/*
+ * 用两个任务执行一项测试，返回每次切换的周期数
+ * @note 调度线程优先级高于调用者，锁住调度器让两个任务一起启动，否则第一个任务会独自执行完
+ */
+static rt_uint32_t bench_run_ptask(ptask_entry_t entry)
+{
+	bench_task_t pair[2];
+	rt_uint32_t start;
+	rt_uint8_t n;
+
+	bench_pair_init(pair);
+	rt_enter_critical();
+	start = bench_now();
+	for (n = 0; n < 2; n++)
+	{
+		ptask_init(&pair[n].task, entry, RT_NULL, 0);
+		ptask_startup(&bench_sched, &pair[n].task);
+	}
+	rt_completion_done(&bench_completion[0]);
+	ptask_sched_notify(&bench_sched);
+	rt_exit_critical();
+	rt_sem_take(&bench_done, RT_WAITING_FOREVER);
+	rt_sem_take(&bench_done, RT_WAITING_FOREVER);
+	return bench_cycles_per_switch(bench_now() - start);
+}
+/*
+ * 用两个线程执行一项测试，返回每次切换的周期数，创建线程失败返回 PTASK_BENCH_NO_MEMORY
+ * @note 测试线程优先级高于调用者，同样锁住调度器一起启动
+ */
+static rt_uint32_t bench_run_thread(void (*entry)(void *parameter))
+{
+	bench_task_t pair[2];
+	rt_thread_t thread[2];
+	rt_uint32_t start;
+	rt_uint8_t n;
+
+	bench_pair_init(pair);
+	for (n = 0; n < 2; n++)
+	{
+		thread[n] = rt_thread_create("pbench", entry, &pair[n], PTASK_BENCH_THREAD_SIZE, PTASK_BENCH_PRIORITY, 10);
+		if (thread[n] == RT_NULL)
+		{
+			if (n != 0)
+			{
+				rt_thread_delete(thread[0]);
+			}
+			return PTASK_BENCH_NO_MEMORY;
+		}
+	}
+
+	rt_enter_critical();
+	start = bench_now();
+	rt_thread_startup(thread[0]);
+	rt_thread_startup(thread[1]);
+	rt_completion_done(&bench_completion[0]);
+	rt_exit_critical();
+	rt_sem_take(&bench_done, RT_WAITING_FOREVER);
+	rt_sem_take(&bench_done, RT_WAITING_FOREVER);
+	return bench_cycles_per_switch(bench_now() - start);
+}
+/*
+ * 各创建 PTASK_BENCH_TASKS 个任务和线程，打印每个的堆占用
+ */
+static void bench_memory(void)
+{
+	void *object[PTASK_BENCH_TASKS];
+	rt_size_t total;
+	rt_size_t used;
+	rt_size_t max_used;
+	rt_size_t start;
+	rt_size_t ptask_size;
+	rt_size_t thread_size;
+	rt_uint8_t n;
+
+	rt_memory_info(&total, &start, &max_used);
+	for (n = 0; n < PTASK_BENCH_TASKS; n++)
+	{
+		object[n] = rt_malloc(sizeof(bench_task_t));
+		if (object[n] != RT_NULL)
+		{
+			ptask_init(object[n], bench_yield_task, RT_NULL, 0);
+		}
+	}
+	rt_memory_info(&total, &used, &max_used);
+	ptask_size = (used - start) / PTASK_BENCH_TASKS;
+	for (n = 0; n < PTASK_BENCH_TASKS; n++)
+	{
+		rt_free(object[n]);
+	}
+
+	rt_memory_info(&total, &start, &max_used);
+	for (n = 0; n < PTASK_BENCH_TASKS; n++)
+	{
+		object[n] = rt_thread_create("pbench", bench_yield_thread, RT_NULL, PTASK_BENCH_THREAD_SIZE,
+				PTASK_BENCH_PRIORITY, 10);
+	}
+	rt_memory_info(&total, &used, &max_used);
+	thread_size = (used - start) / PTASK_BENCH_TASKS;
+	for (n = 0; n < PTASK_BENCH_TASKS; n++)
+	{
+		if (object[n] != RT_NULL)
+		{
+			rt_thread_delete(object[n]);
+		}
+	}
+
+	rt_kprintf("memory (%u each, heap blocks included)\n", PTASK_BENCH_TASKS);
+	rt_kprintf("ptask  %-5u bytes, %u per 10 KB (scheduler %u bytes + %u stack)\n", ptask_size,
+			ptask_size != 0 ? 10240 / ptask_size : 0, sizeof(ptask_sched_t) + sizeof(struct rt_thread),
+			PTASK_BENCH_SCHED_SIZE);
+	rt_kprintf("thread %-5u bytes, %u per 10 KB\n", thread_size, thread_size != 0 ? 10240 / thread_size : 0);
+}
+/*打印一项测试的结果*/
+static void bench_print(const char *name, rt_uint32_t cycles)
+{
+	if (cycles == PTASK_BENCH_NO_MEMORY)
+	{
+		rt_kprintf("%-15s no memory\n", name);
+	}
+	else
+	{
+		rt_kprintf("%-15s %-14u %u\n", name, cycles, bench_switch_count);
+	}
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief msh命令：对比无栈任务与线程的内存占用和切换开销
+ */
+static void ptask_bench(int argc, char **argv)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	if (!bench_sched_started)
+	{
+		if (ptask_sched_init(&bench_sched, "pbench", PTASK_BENCH_SCHED_SIZE, PTASK_BENCH_PRIORITY) != RT_EOK)
+		{
+			rt_kprintf("no memory\n");
+			return;
+		}
+		rt_sem_init(&bench_done, "pbench", 0, RT_IPC_FLAG_PRIO);
+		bench_sched_started = RT_TRUE;
+	}
+
+	bench_memory();
+
+	rt_kprintf("%u loops x 2    cycles/switch  switches (expect %u)\n", PTASK_BENCH_LOOPS, PTASK_BENCH_LOOPS * 2 - 1);
+	bench_print("yield    ptask", bench_run_ptask(bench_yield_task));
+	bench_print("yield    thread", bench_run_thread(bench_yield_thread));
+	bench_print("pingpong ptask", bench_run_ptask(bench_pingpong_task));
+	bench_print("pingpong thread", bench_run_thread(bench_pingpong_thread));
+}
+MSH_CMD_EXPORT(ptask_bench, compare stackless ptask and thread memory and switch cost);
+#endif /* defined(RT_USING_FINSH) && defined(RT_USING_HEAP) */
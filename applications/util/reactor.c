@@ -0,0 +1,254 @@
+/**
+ * @file reactor.c
+ * @brief 单线程事件循环（可选，替代CAN接收、迪文接收、迪文显示三个线程）
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ */
+/*============================ INCLUDES ======================================*/
+#include <stdlib.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include "reactor.h"
+#include "profiler.h"
+
+#define DBG_LEVEL	DBG_LOG
+#define DBG_TAG		"reactor"
+#include <rtdbg.h>
+
+/*============================ MACROS ========================================*/
+#define REACTOR_EVENT_ALL				((1UL << REACTOR_EVENT_COUNT) - 1)
+#define REACTOR_THREAD_SECTION			20		//线程时间片
+/*============================ TYPES =========================================*/
+#ifdef INTERFACE_CFG_USING_REACTOR
+/**
+ * @struct reactor_info
+ * @brief 事件循环
+ */
+typedef struct reactor_info
+{
+	struct rt_event event;			/**< 事件集，一个事件一位 */
+	reactor_handler_t handler_list[REACTOR_EVENT_COUNT];	/**< 处理函数 */
+	rt_uint32_t signaled;			/**< 已置位、尚未开始处理的事件，用于记录第一次置位的时刻 */
+	rt_tick_t signal_tick[REACTOR_EVENT_COUNT];	/**< 第一次置位的时刻 */
+	reactor_stat_t stat[REACTOR_EVENT_COUNT];	/**< 统计 */
+}reactor_info_t;
+#endif /* INTERFACE_CFG_USING_REACTOR */
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+#ifdef INTERFACE_CFG_USING_REACTOR
+static reactor_info_t reactor;
+#endif /* INTERFACE_CFG_USING_REACTOR */
+#if defined(RT_USING_FINSH) && !defined(INTERFACE_CFG_USING_PROFILER)
+static volatile rt_uint32_t sched_switch_count;	/**< sched_stat 统计期间的线程切换次数 */
+#endif
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+#ifdef INTERFACE_CFG_USING_REACTOR
+/**
+ * @brief 执行一个事件的处理函数
+ * @note 先清除置位记录再执行，处理过程中再次置位的事件会再处理一次
+ */
+static void reactor_dispatch(reactor_event_t event)
+{
+	reactor_stat_t *stat = &reactor.stat[event];
+	rt_tick_t signal_tick;
+	rt_tick_t start;
+	rt_tick_t run;
+	rt_base_t level;
+
+	level = rt_hw_interrupt_disable();
+	reactor.signaled &= ~(1UL << event);
+	signal_tick = reactor.signal_tick[event];
+	rt_hw_interrupt_enable(level);
+
+	if (reactor.handler_list[event] == RT_NULL)
+	{
+		return;
+	}
+
+	start = rt_tick_get();
+	stat->max_latency = start - signal_tick > stat->max_latency ? start - signal_tick : stat->max_latency;
+	reactor.handler_list[event]();
+	run = rt_tick_get() - start;
+	stat->max_run = run > stat->max_run ? run : stat->max_run;
+	stat->run_count++;
+}
+/**
+ * @brief 事件循环线程
+ * @note 没有待处理事件时阻塞；有待处理事件时只查询新事件，不阻塞
+ */
+static void reactor_entry(void *parameter)
+{
+	rt_uint32_t pending = 0;
+	rt_uint32_t recved;
+	rt_uint8_t event;
+
+	while (1)
+	{
+		if (rt_event_recv(&reactor.event, REACTOR_EVENT_ALL, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+				pending != 0 ? 0 : RT_WAITING_FOREVER, &recved) == RT_EOK)
+		{
+			pending |= recved;
+		}
+
+		if (pending != 0)
+		{
+			event = __rt_ffs(pending) - 1;//编号最小的事件优先
+			pending &= ~(1UL << event);
+			reactor_dispatch((reactor_event_t) event);
+		}
+	}
+}
+#endif /* INTERFACE_CFG_USING_REACTOR */
+#if defined(RT_USING_FINSH) && !defined(INTERFACE_CFG_USING_PROFILER)
+static void sched_stat_hook(rt_thread_t from, rt_thread_t to)
+{
+	sched_switch_count++;
+}
+#endif
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+#ifdef INTERFACE_CFG_USING_REACTOR
+/**
+ * @brief 初始化并启动事件循环线程
+ * @note 线程创建后阻塞等待事件，处理函数可以之后再注册
+ */
+void init_reactor(void)
+{
+	rt_thread_t thread;
+
+	rt_memset(&reactor, 0, sizeof(reactor));
+	rt_event_init(&reactor.event, "reactor", RT_IPC_FLAG_PRIO);
+
+	thread = rt_thread_create("REACTOR", reactor_entry, RT_NULL,
+			INTERFACE_CFG_REACTOR_THREAD_SIZE,
+			INTERFACE_CFG_REACTOR_THREAD_PRO,
+			REACTOR_THREAD_SECTION);
+	if (thread == RT_NULL)
+	{
+		LOG_E("reactor thread failure!");
+		RT_ASSERT(0);
+	}
+	rt_thread_startup(thread);
+}
+/**
+ * @brief 注册事件处理函数
+ * @param event 事件
+ * @param handler 处理函数，在事件循环线程中执行
+ */
+void reactor_register(reactor_event_t event, reactor_handler_t handler)
+{
+	RT_ASSERT(event < REACTOR_EVENT_COUNT);
+	RT_ASSERT(reactor.handler_list[event] == RT_NULL);//一个事件只有一个处理函数
+
+	reactor.handler_list[event] = handler;
+}
+/**
+ * @brief 置事件位
+ * @param event 事件
+ * @note 可以在中断中调用；处理之前的多次置位合并为一次处理，处理函数需要一次处理完所有数据
+ */
+void reactor_signal(reactor_event_t event)
+{
+	rt_base_t level;
+
+	RT_ASSERT(event < REACTOR_EVENT_COUNT);
+
+	level = rt_hw_interrupt_disable();
+	reactor.stat[event].signal_count++;
+	if ((reactor.signaled & (1UL << event)) == 0)
+	{
+		reactor.signaled |= 1UL << event;
+		reactor.signal_tick[event] = rt_tick_get();
+	}
+	rt_hw_interrupt_enable(level);
+
+	rt_event_send(&reactor.event, 1UL << event);
+}
+/**
+ * @brief 获取事件统计
+ */
+void get_reactor_stat(reactor_event_t event, reactor_stat_t *stat)
+{
+	rt_base_t level;
+
+	RT_ASSERT(event < REACTOR_EVENT_COUNT);
+
+	level = rt_hw_interrupt_disable();
+	*stat = reactor.stat[event];
+	rt_hw_interrupt_enable(level);
+}
+#endif /* INTERFACE_CFG_USING_REACTOR */
+#ifdef RT_USING_FINSH
+#ifdef INTERFACE_CFG_USING_REACTOR
+/**
+ * @brief msh命令：打印事件循环统计
+ */
+static void reactor_info(int argc, char **argv)
+{
+	static const char *event_name[REACTOR_EVENT_COUNT] = { "can_rx", "dwin_rx", "dwin_show", "led" };
+	reactor_stat_t stat;
+	rt_uint8_t i;
+
+	rt_kprintf("event      signal     run        max latency max run\n");
+	for (i = 0; i < REACTOR_EVENT_COUNT; i++)
+	{
+		get_reactor_stat((reactor_event_t) i, &stat);
+		rt_kprintf("%-10s %-10u %-10u %-8u ms %-4u ms\n", event_name[i], stat.signal_count, stat.run_count,
+				stat.max_latency * 1000 / RT_TICK_PER_SECOND, stat.max_run * 1000 / RT_TICK_PER_SECOND);
+	}
+}
+MSH_CMD_EXPORT(reactor_info, show reactor event statistics);
+#endif /* INTERFACE_CFG_USING_REACTOR */
+/**
+ * @brief msh命令：统计线程切换次数和堆内存使用，用于对比事件循环和多线程两种方式
+ * @note 用法：sched_stat [统计时间ms]，默认1000ms；
+ *		使用统计模块时读取它的切换计数，否则统计期间占用调度器钩子
+ */
+static void sched_stat(int argc, char **argv)
+{
+	rt_int32_t period = argc > 1 ? atoi(argv[1]) : 1000;
+	rt_uint32_t count;
+#ifdef RT_USING_HEAP
+	rt_size_t total;
+	rt_size_t used;
+	rt_size_t max_used;
+#endif /* RT_USING_HEAP */
+
+	if (period <= 0)
+	{
+		rt_kprintf("usage: sched_stat [ms]\n");
+		return;
+	}
+
+#ifdef INTERFACE_CFG_USING_PROFILER
+	count = get_profiler_switch_count();
+	rt_thread_mdelay(period);
+	count = get_profiler_switch_count() - count;
+#else
+	sched_switch_count = 0;
+	rt_scheduler_sethook(sched_stat_hook);
+	rt_thread_mdelay(period);
+	rt_scheduler_sethook(RT_NULL);
+	count = sched_switch_count;
+#endif /* INTERFACE_CFG_USING_PROFILER */
+
+	rt_kprintf("layout: %s\n",
+#ifdef INTERFACE_CFG_USING_REACTOR
+			"reactor"
+#else
+			"threads"
+#endif /* INTERFACE_CFG_USING_REACTOR */
+			);
+	rt_kprintf("context switches: %u in %d ms (%u/s)\n", count, period, (rt_uint32_t) ((rt_uint64_t) count * 1000 / period));
+#ifdef RT_USING_HEAP
+	rt_memory_info(&total, &used, &max_used);
+	rt_kprintf("heap: total %u, used %u, max used %u\n", total, used, max_used);
+#endif /* RT_USING_HEAP */
+}
+MSH_CMD_EXPORT(sched_stat, count context switches and heap usage);
+#endif /* RT_USING_FINSH */
@@ -0,0 +1,75 @@
+/**
+ * @file reactor.h
+ * @brief 单线程事件循环（可选，替代CAN接收、迪文接收、迪文显示三个线程）
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-15
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  CAN、串口接收回调和刷新定时器只调用 reactor_signal 置事件位；事件循环线程阻塞在 rt_event 上，
+ *		被唤醒后按事件编号从小到大依次执行处理函数，每个处理函数执行完才执行下一个（不会被另一个处理函数打断），
+ *		每执行完一个处理函数就重新收取新到的事件，编号小的事件总是先处理。
+ *		处理函数都在同一线程中执行，相互之间不需要互斥；处理函数不能阻塞等待另一个事件。
+ *		选项 INTERFACE_CFG_USING_REACTOR 关闭时仍使用原来的多线程方式，可以用 sched_stat 命令对比两种方式。
+ */
+#ifndef __REACTOR_H__
+#define __REACTOR_H__
+
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================ MACROS ========================================*/
+#ifndef INTERFACE_CFG_REACTOR_THREAD_PRO
+#define INTERFACE_CFG_REACTOR_THREAD_PRO	20		//事件循环线程优先级
+#endif
+#ifndef INTERFACE_CFG_REACTOR_THREAD_SIZE
+#define INTERFACE_CFG_REACTOR_THREAD_SIZE	1536	//事件循环线程栈大小
+#endif
+/*============================ TYPES =========================================*/
+/* 事件，编号即优先级，编号小的先处理 */
+typedef enum reactor_event
+{
+	REACTOR_EVENT_CAN_RX = 0,		// CAN接收
+	REACTOR_EVENT_DWIN_RX,			// 迪文屏串口接收
+	REACTOR_EVENT_DWIN_SHOW,		// 迪文屏刷新（定时、页面切换）
+	REACTOR_EVENT_LED,				// 运行指示灯
+	REACTOR_EVENT_COUNT,
+}reactor_event_t;
+
+/* 事件处理函数 */
+typedef void (*reactor_handler_t)(void);
+
+/**
+ * @struct reactor_stat
+ * @brief 一个事件的统计
+ */
+typedef struct reactor_stat
+{
+	rt_uint32_t signal_count;		/**< 置位次数（含合并的重复置位） */
+	rt_uint32_t run_count;			/**< 处理次数 */
+	rt_tick_t max_latency;			/**< 置位到开始处理的最大延迟（节拍） */
+	rt_tick_t max_run;				/**< 处理函数最长执行时间（节拍） */
+}reactor_stat_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ PROTOTYPES ====================================*/
+/* 初始化并启动事件循环线程，在注册处理函数之前调用 */
+void init_reactor(void);
+/* 注册事件处理函数，在打开对应设备的接收回调之前调用 */
+void reactor_register(reactor_event_t event, reactor_handler_t handler);
+/* 置事件位，可以在中断中调用 */
+void reactor_signal(reactor_event_t event);
+/* 获取事件统计 */
+void get_reactor_stat(reactor_event_t event, reactor_stat_t *stat);
+/*============================ INCLUDES ======================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __REACTOR_H__ */
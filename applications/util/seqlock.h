@@ -0,0 +1,78 @@
+/**
+ * @file seqlock.h
+ * @brief 顺序锁：写者不加锁、不等待，读者发现读取期间有写入时重试
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-16
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  写者在修改前后分别把 begin、end 计数加1，多个写者（包括嵌套）也只是计数多加几次；
+ *		读者先确认 begin == end（没有写者正在修改），拷贝后确认 begin 没有变化（拷贝期间没有写者开始修改），
+ *		两者都成立时拷贝到的是某一时刻完整的数据，否则重试。
+ *		计数用原子操作读写，同时起编译器屏障的作用，受保护的数据读写不会被移到计数之外。
+ *		并发测试见 seqlock_torture.c
+ */
+#ifndef __SEQLOCK_H__
+#define __SEQLOCK_H__
+
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================ MACROS ========================================*/
+/*============================ TYPES =========================================*/
+/**
+ * @struct seqlock
+ * @brief 顺序锁，清零即为初始状态
+ */
+typedef struct seqlock
+{
+	rt_atomic_t begin;				/**< 写开始次数 */
+	rt_atomic_t end;				/**< 写结束次数 */
+}seqlock_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ PROTOTYPES ====================================*/
+/**
+ * @brief 写开始，与 seqlock_write_end 成对使用，可以嵌套，可以在中断中调用
+ */
+rt_inline void seqlock_write_begin(seqlock_t *lock)
+{
+	rt_atomic_add(&lock->begin, 1);
+}
+/**
+ * @brief 写结束
+ */
+rt_inline void seqlock_write_end(seqlock_t *lock)
+{
+	rt_atomic_add(&lock->end, 1);
+}
+/**
+ * @brief 开始读
+ * @param begin 返回当前的写开始次数，交给 seqlock_read_end
+ * @return rt_bool_t 没有写者正在修改返回RT_TRUE
+ */
+rt_inline rt_bool_t seqlock_read_begin(seqlock_t *lock, rt_atomic_t *begin)
+{
+	*begin = rt_atomic_load(&lock->begin);
+	return *begin == rt_atomic_load(&lock->end);
+}
+/**
+ * @brief 结束读
+ * @param begin seqlock_read_begin 得到的写开始次数
+ * @return rt_bool_t 读取期间没有写者开始修改返回RT_TRUE
+ */
+rt_inline rt_bool_t seqlock_read_end(seqlock_t *lock, rt_atomic_t begin)
+{
+	return begin == rt_atomic_load(&lock->begin);
+}
+/*============================ INCLUDES ======================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SEQLOCK_H__ */
@@ -0,0 +1,354 @@
+/**
+ * @file seqlock_torture.c
+ * @brief 顺序锁（seqlock.h）的并发正确性测试
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-16
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  几个写者线程反复把整块数据（模拟一个变量区）的每个字写成同一个值，写到一半时让出CPU，
+ *		部分写入再嵌套一层写开始/写结束（与 CAN 接收中的用法相同）；读者线程按顺序锁的方式拷贝整块数据，
+ *		拷贝到一半时也会让出CPU，检查每个字相同。受保护的拷贝出现不一致（torn）即为错误；同时统计不加锁拷贝的不一致次数，
+ *		为0说明写者没有和读者交错，测试无效。
+ *		msh 命令 seqlock_torture [ms]：写者优先级与 CAN 接收线程相同，读者与迪文显示线程相同。
+ *		在PC上用多个 pthread 并发测试（真正的多核并行，参数为秒数）：
+ *		gcc -O2 -DSEQLOCK_TORTURE_HOST -DARCH_CPU_64BIT -I. -Irt-thread/include -Irt-thread/components/finsh -Iapplications/util
+ *			applications/util/seqlock_torture.c -lpthread
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <stdlib.h>
+#include "seqlock.h"
+#ifdef SEQLOCK_TORTURE_HOST
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif /* SEQLOCK_TORTURE_HOST */
+
+#if defined(RT_USING_FINSH) || defined(SEQLOCK_TORTURE_HOST)
+/*============================ MACROS ========================================*/
+#define TORTURE_WORDS					16		//数据块字数
+#define TORTURE_WRITERS					3		//写者线程数
+#define TORTURE_NEST_INTERVAL			4		//每隔几次写入嵌套一层
+#define TORTURE_PAUSE_INTERVAL			8		//每隔几次读写在中途让出CPU
+#define TORTURE_RETRY					4		//受保护拷贝的最多尝试次数，与 DWIN_VAR_SNAPSHOT_RETRY 相同
+
+#ifdef SEQLOCK_TORTURE_HOST
+#define TORTURE_PRINT					printf
+#define TORTURE_DEFAULT_TIME			2		//默认测试时间，s
+#else
+#define TORTURE_PRINT					rt_kprintf
+#define TORTURE_DEFAULT_TIME			2000	//默认测试时间，ms
+#define TORTURE_WRITER_PRIORITY			20		//与 CAN 接收线程相同
+#define TORTURE_READER_PRIORITY			21		//与迪文显示线程相同
+#define TORTURE_STACK_SIZE				512
+#endif /* SEQLOCK_TORTURE_HOST */
+/*============================ TYPES =========================================*/
+/* 读者统计 */
+typedef struct torture_result
+{
+	rt_uint32_t ok;					/**< 一致的受保护拷贝次数 */
+	rt_uint32_t torn;				/**< 不一致的受保护拷贝次数，必须为0 */
+	rt_uint32_t busy;				/**< 开始读时写者正在修改的次数 */
+	rt_uint32_t retry;				/**< 拷贝期间写者开始修改、重新拷贝的次数 */
+	rt_uint32_t skip;				/**< 尝试 TORTURE_RETRY 次仍没有拷贝到、跳过的次数 */
+	rt_uint32_t raw_torn;			/**< 不一致的不加锁拷贝次数 */
+}torture_result_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+static seqlock_t torture_lock;
+static volatile rt_uint16_t torture_data[TORTURE_WORDS];
+static volatile rt_bool_t torture_stop;
+static rt_uint32_t torture_write_count[TORTURE_WRITERS];
+static torture_result_t torture_result;
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+#ifdef SEQLOCK_TORTURE_HOST
+static void torture_pause(void)
+{
+	sched_yield();
+}
+#else
+static void torture_pause(void)
+{
+	// 写者优先级高于读者，睡眠才能让读者在写入中途运行
+	rt_thread_mdelay(1);
+}
+#endif /* SEQLOCK_TORTURE_HOST */
+/*每个字相同返回RT_TRUE*/
+static rt_bool_t torture_check(const rt_uint16_t *copy)
+{
+	rt_uint32_t i;
+
+	for (i = 1; i < TORTURE_WORDS; i++)
+	{
+		if (copy[i] != copy[0])
+		{
+			return RT_FALSE;
+		}
+	}
+	return RT_TRUE;
+}
+/*写者：值的高4位为写者编号，低12位为写入序号*/
+static void torture_writer(rt_uint32_t id)
+{
+	rt_uint32_t seq = 0;
+	rt_uint16_t value;
+	rt_uint32_t i;
+
+	while (!torture_stop)
+	{
+		seq++;
+		value = (rt_uint16_t) ((id << 12) | (seq & 0x0FFF));
+		seqlock_write_begin(&torture_lock);
+		for (i = 0; i < TORTURE_WORDS / 2; i++)
+		{
+			torture_data[i] = value;
+		}
+		if (seq % TORTURE_PAUSE_INTERVAL == 0)
+		{
+			torture_pause();
+		}
+		if (seq % TORTURE_NEST_INTERVAL == 0)
+		{
+			seqlock_write_begin(&torture_lock);
+		}
+		for (; i < TORTURE_WORDS; i++)
+		{
+			torture_data[i] = value;
+		}
+		if (seq % TORTURE_NEST_INTERVAL == 0)
+		{
+			seqlock_write_end(&torture_lock);
+		}
+		seqlock_write_end(&torture_lock);
+		torture_write_count[id] = seq;
+		// 两次写入之间也让出CPU，否则读者只能在写入中途运行
+		torture_pause();
+	}
+}
+/*受保护拷贝，与 dwin_page_var.c 中的用法相同：最多尝试 TORTURE_RETRY 次*/
+static rt_bool_t torture_read(rt_uint16_t *copy, rt_uint32_t count)
+{
+	rt_uint32_t retry;
+	rt_atomic_t begin;
+	rt_uint32_t i;
+
+	for (retry = 0; retry < TORTURE_RETRY; retry++)
+	{
+		if (!seqlock_read_begin(&torture_lock, &begin))//有写者正在修改
+		{
+			torture_result.busy++;
+			continue;
+		}
+		for (i = 0; i < TORTURE_WORDS; i++)
+		{
+			copy[i] = torture_data[i];
+			// 拷贝中途让出CPU，让写者在拷贝期间开始修改
+			if (i == TORTURE_WORDS / 2 && (count + retry) % TORTURE_PAUSE_INTERVAL == 0)
+			{
+				torture_pause();
+			}
+		}
+		if (seqlock_read_end(&torture_lock, begin))//拷贝期间没有写者开始修改
+		{
+			return RT_TRUE;
+		}
+		torture_result.retry++;
+	}
+
+	return RT_FALSE;
+}
+/*读者：先做一次不加锁拷贝作为对照，再做受保护拷贝；取不到一致的拷贝时像显示线程一样跳过本轮*/
+static void torture_reader(void)
+{
+	rt_uint16_t copy[TORTURE_WORDS];
+	rt_uint32_t count = 0;
+	rt_uint32_t i;
+
+	while (!torture_stop)
+	{
+		count++;
+		for (i = 0; i < TORTURE_WORDS; i++)
+		{
+			copy[i] = torture_data[i];
+		}
+		if (!torture_check(copy))
+		{
+			torture_result.raw_torn++;
+		}
+
+		if (!torture_read(copy, count))
+		{
+			torture_result.skip++;
+			torture_pause();
+		}
+		else if (torture_check(copy))
+		{
+			torture_result.ok++;
+		}
+		else
+		{
+			torture_result.torn++;
+		}
+	}
+}
+static void torture_reset(void)
+{
+	static const seqlock_t lock_init = { 0 };
+	static const torture_result_t result_init = { 0 };
+	rt_uint32_t i;
+
+	torture_lock = lock_init;
+	torture_result = result_init;
+	for (i = 0; i < TORTURE_WORDS; i++)
+	{
+		torture_data[i] = 0;
+	}
+	for (i = 0; i < TORTURE_WRITERS; i++)
+	{
+		torture_write_count[i] = 0;
+	}
+	torture_stop = RT_FALSE;
+}
+/*打印结果，通过返回0*/
+static int torture_report(void)
+{
+	rt_uint32_t i;
+
+	TORTURE_PRINT("writes:");
+	for (i = 0; i < TORTURE_WRITERS; i++)
+	{
+		TORTURE_PRINT(" %u", (unsigned) torture_write_count[i]);
+	}
+	TORTURE_PRINT("\nreads: %u ok, %u torn, %u busy, %u retries, %u skipped; unprotected reads: %u torn\n",
+			(unsigned) torture_result.ok, (unsigned) torture_result.torn, (unsigned) torture_result.busy,
+			(unsigned) torture_result.retry, (unsigned) torture_result.skip, (unsigned) torture_result.raw_torn);
+	if (torture_result.torn > 0)
+	{
+		TORTURE_PRINT("FAIL: seqlock returned torn data\n");
+		return 1;
+	}
+	if (torture_result.ok == 0 || torture_result.raw_torn == 0 || torture_result.retry == 0)
+	{
+		TORTURE_PRINT("INCONCLUSIVE: writers never overlapped the reader\n");
+		return 2;
+	}
+	TORTURE_PRINT("PASS\n");
+	return 0;
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+#ifdef SEQLOCK_TORTURE_HOST
+/* PC 上用编译器内建的原子操作代替 libcpu 中的实现 */
+rt_atomic_t rt_hw_atomic_load(volatile rt_atomic_t *ptr)
+{
+	return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+}
+rt_atomic_t rt_hw_atomic_add(volatile rt_atomic_t *ptr, rt_atomic_t val)
+{
+	return __atomic_fetch_add(ptr, val, __ATOMIC_SEQ_CST);
+}
+
+static void *torture_writer_entry(void *parameter)
+{
+	torture_writer((rt_uint32_t) (rt_ubase_t) parameter);
+	return RT_NULL;
+}
+static void *torture_reader_entry(void *parameter)
+{
+	torture_reader();
+	return RT_NULL;
+}
+
+int main(int argc, char **argv)
+{
+	pthread_t writer[TORTURE_WRITERS];
+	pthread_t reader;
+	unsigned seconds = TORTURE_DEFAULT_TIME;
+	rt_uint32_t i;
+
+	if (argc > 1)
+	{
+		seconds = (unsigned) atoi(argv[1]);
+	}
+	torture_reset();
+	pthread_create(&reader, RT_NULL, torture_reader_entry, RT_NULL);
+	for (i = 0; i < TORTURE_WRITERS; i++)
+	{
+		pthread_create(&writer[i], RT_NULL, torture_writer_entry, (void *) (rt_ubase_t) i);
+	}
+	sleep(seconds);
+	__atomic_store_n(&torture_stop, RT_TRUE, __ATOMIC_SEQ_CST);
+	for (i = 0; i < TORTURE_WRITERS; i++)
+	{
+		pthread_join(writer[i], RT_NULL);
+	}
+	pthread_join(reader, RT_NULL);
+
+	return torture_report();
+}
+#else
+static struct rt_semaphore torture_exit_sem;
+
+static void torture_writer_entry(void *parameter)
+{
+	torture_writer((rt_uint32_t) (rt_ubase_t) parameter);
+	rt_sem_release(&torture_exit_sem);
+}
+static void torture_reader_entry(void *parameter)
+{
+	torture_reader();
+	rt_sem_release(&torture_exit_sem);
+}
+/**
+ * @brief msh命令：顺序锁并发测试
+ */
+static void seqlock_torture(int argc, char **argv)
+{
+	rt_int32_t time = TORTURE_DEFAULT_TIME;
+	rt_uint32_t started = 0;
+	rt_thread_t thread;
+	rt_uint32_t i;
+
+	if (argc > 1)
+	{
+		time = atoi(argv[1]);
+	}
+	torture_reset();
+	rt_sem_init(&torture_exit_sem, "torture", 0, RT_IPC_FLAG_PRIO);
+
+	thread = rt_thread_create("t_read", torture_reader_entry, RT_NULL,
+			TORTURE_STACK_SIZE, TORTURE_READER_PRIORITY, 10);
+	if (thread != RT_NULL && rt_thread_startup(thread) == RT_EOK)
+	{
+		started++;
+	}
+	for (i = 0; i < TORTURE_WRITERS; i++)
+	{
+		thread = rt_thread_create("t_write", torture_writer_entry, (void *) (rt_ubase_t) i,
+				TORTURE_STACK_SIZE, TORTURE_WRITER_PRIORITY, 10);
+		if (thread != RT_NULL && rt_thread_startup(thread) == RT_EOK)
+		{
+			started++;
+		}
+	}
+	if (started < TORTURE_WRITERS + 1)
+	{
+		rt_kprintf("only %u of %u threads started\n", (unsigned) started, TORTURE_WRITERS + 1);
+	}
+
+	rt_thread_mdelay(time);
+	torture_stop = RT_TRUE;
+	while (started--)
+	{
+		rt_sem_take(&torture_exit_sem, RT_WAITING_FOREVER);
+	}
+	rt_sem_detach(&torture_exit_sem);
+
+	torture_report();
+}
+MSH_CMD_EXPORT(seqlock_torture, seqlock writers/reader torture test);
+#endif /* SEQLOCK_TORTURE_HOST */
+#endif /* defined(RT_USING_FINSH) || defined(SEQLOCK_TORTURE_HOST) */
@@ -0,0 +1,179 @@
+/**
+ * @file timer_bench.c
+ * @brief rt_timer 启动/停止/到期处理开销的测试
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-16
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  msh 命令 timer_bench：分别在 10/100/500/1000 个活动定时器下，用 DWT 周期计数器测量
+ *		rt_timer_start（逐个加入时的平均/最大值）、rt_timer_stop 和再次 rt_timer_start（稳定状态下随机抽取），
+ *		以及每个系统节拍 rt_timer_check 的到期处理（平均/最大值），并检查所有定时器都按时到期。
+ *		打开 RT_USING_TIMER_WHEEL 时测量时间轮，关闭时测量跳表，两次编译分别运行即可对比。
+ *		测量期间关中断，到期测量用 rt_tick_set 人为推进系统节拍 TIMER_BENCH_SPAN 个，
+ *		命令结束后系统时间会比实际快这么多，只应在调试时使用。
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rthw.h>
+#include <board.h>
+
+#if defined(RT_USING_FINSH) && defined(RT_USING_HEAP)
+/*============================ MACROS ========================================*/
+#define TIMER_BENCH_SPAN				1000	//定时器超时时间在 1~TIMER_BENCH_SPAN 个节拍内随机
+#define TIMER_BENCH_RESTART				100		//稳定状态下随机停止/启动的次数
+/*============================ TYPES =========================================*/
+/* 一组测量结果，单位为周期 */
+typedef struct timer_bench_result
+{
+	rt_uint32_t start_avg;
+	rt_uint32_t start_max;
+	rt_uint32_t stop_avg;
+	rt_uint32_t restart_avg;
+	rt_uint32_t expire_avg;
+	rt_uint32_t expire_max;
+	rt_uint32_t fired;
+}timer_bench_result_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+static const rt_uint16_t bench_count_list[] = { 10, 100, 500, 1000 };
+static rt_uint32_t bench_random_seed = 1;
+static volatile rt_uint32_t bench_fired;
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+static rt_uint32_t bench_now(void)
+{
+	return DWT->CYCCNT;
+}
+/*线性同余随机数，结果可重复*/
+static rt_uint32_t bench_random(void)
+{
+	bench_random_seed = bench_random_seed * 1103515245UL + 12345UL;
+	return bench_random_seed >> 8;
+}
+/*定时器超时回调：只计数*/
+static void bench_timeout(void *parameter)
+{
+	bench_fired++;
+}
+/*设置随机超时时间并启动，返回启动花费的周期数*/
+static rt_uint32_t bench_start(rt_timer_t timer)
+{
+	rt_tick_t timeout = bench_random() % TIMER_BENCH_SPAN + 1;
+	rt_uint32_t start;
+
+	rt_timer_control(timer, RT_TIMER_CTRL_SET_TIME, &timeout);
+	start = bench_now();
+	rt_timer_start(timer);
+
+	return bench_now() - start;
+}
+/*
+ * 测量 count 个活动定时器时的开销，整个过程关中断，节拍只由本函数推进
+ */
+static void bench_run(struct rt_timer *timers, rt_uint16_t count, timer_bench_result_t *result)
+{
+	rt_uint32_t sum;
+	rt_uint32_t stop_sum;
+	rt_uint32_t cycles;
+	rt_uint32_t start;
+	rt_tick_t base;
+	rt_base_t level;
+	rt_uint16_t i;
+	rt_uint16_t index;
+
+	rt_memset(result, 0, sizeof(timer_bench_result_t));
+	for (i = 0; i < count; i++)
+	{
+		rt_timer_init(&timers[i], "tbench", bench_timeout, RT_NULL, 1, RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_HARD_TIMER);
+	}
+
+	level = rt_hw_interrupt_disable();
+	bench_fired = 0;
+
+	/* 逐个加入，活动定时器从 0 增加到 count */
+	sum = 0;
+	for (i = 0; i < count; i++)
+	{
+		cycles = bench_start(&timers[i]);
+		sum += cycles;
+		result->start_max = cycles > result->start_max ? cycles : result->start_max;
+	}
+	result->start_avg = sum / count;
+
+	/* 稳定状态：随机停止一个再启动，活动定时器个数不变 */
+	sum = 0;
+	stop_sum = 0;
+	for (i = 0; i < TIMER_BENCH_RESTART; i++)
+	{
+		index = bench_random() % count;
+		start = bench_now();
+		rt_timer_stop(&timers[index]);
+		stop_sum += bench_now() - start;
+		sum += bench_start(&timers[index]);
+	}
+	result->stop_avg = stop_sum / TIMER_BENCH_RESTART;
+	result->restart_avg = sum / TIMER_BENCH_RESTART;
+
+	/* 逐个节拍推进到所有定时器超时 */
+	sum = 0;
+	base = rt_tick_get();
+	for (i = 1; i <= TIMER_BENCH_SPAN; i++)
+	{
+		rt_tick_set(base + i);
+		start = bench_now();
+		rt_timer_check();
+		cycles = bench_now() - start;
+		sum += cycles;
+		result->expire_max = cycles > result->expire_max ? cycles : result->expire_max;
+	}
+	result->expire_avg = sum / TIMER_BENCH_SPAN;
+	result->fired = bench_fired;
+
+	rt_hw_interrupt_enable(level);
+
+	for (i = 0; i < count; i++)
+	{
+		rt_timer_detach(&timers[i]);
+	}
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief msh命令：测量定时器启动、停止和到期处理的开销
+ */
+static void timer_bench(int argc, char **argv)
+{
+	timer_bench_result_t result;
+	struct rt_timer *timers;
+	rt_uint8_t i;
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+#ifdef RT_USING_TIMER_WHEEL
+	rt_kprintf("timer backend: wheel, %u slots x %u levels, cycles\n", 1U << RT_TIMER_WHEEL_SLOT_BITS,
+			RT_TIMER_WHEEL_LEVELS);
+#else
+	rt_kprintf("timer backend: skip list, %u levels, cycles\n", RT_TIMER_SKIP_LIST_LEVEL);
+#endif /* RT_USING_TIMER_WHEEL */
+	rt_kprintf("timers  start(avg/max)  stop  restart  expire/tick(avg/max)  fired\n");
+	for (i = 0; i < sizeof(bench_count_list) / sizeof(bench_count_list[0]); i++)
+	{
+		timers = rt_malloc(bench_count_list[i] * sizeof(struct rt_timer));
+		if (timers == RT_NULL)
+		{
+			rt_kprintf("%-7u no memory for the timers\n", bench_count_list[i]);
+			continue;
+		}
+		bench_run(timers, bench_count_list[i], &result);
+		rt_free(timers);
+
+		rt_kprintf("%-7u %6u/%-8u %-5u %-8u %6u/%-13u %u%s\n", bench_count_list[i], result.start_avg, result.start_max,
+				result.stop_avg, result.restart_avg, result.expire_avg, result.expire_max, result.fired,
+				result.fired == bench_count_list[i] ? "" : " MISSING");
+	}
+	rt_kprintf("system tick moved ahead %u ticks per row\n", TIMER_BENCH_SPAN);
+}
+MSH_CMD_EXPORT(timer_bench, benchmark rt_timer start stop and expiry);
+#endif /* defined(RT_USING_FINSH) && defined(RT_USING_HEAP) */
@@ -24,19 +24,44 @@
 /*============================ LOCAL VARIABLES ===============================*/
 /*============================ PROTOTYPES ====================================*/
 /*============================ INTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief 确定读取起点
+ * @param queue 队列控制结构指针
+ * @param from 读取起点（head 或 read_point）
+ * @param max_count 最多读取的数据个数
+ * @return rt_uint16_t 实际读取起点
+ * @note 从 from 到 tail 的数据超过 max_count 时跳过较旧的数据，只读最新的 max_count 个
+ */
+static rt_uint16_t curve_data_queue_skip_old(const curve_data_queue_t *queue, rt_uint16_t from, rt_uint16_t max_count)
+{
+	rt_uint16_t count = (queue->tail + queue->size - from) % queue->size;//链表按下标顺序连接，个数可以直接算出
+
+	while (count > max_count)
+	{
+		from = queue->queue[from].next;
+		--count;
+	}
+
+	return from;
+}
 /*============================ EXTERNAL IMPLEMENTATION =======================*/
 /**
  * @brief 初始化队列结构
  * @param queue 队列控制结构指针
- * @note 构建初始循环链表：索引0->1, 1->2, ... 19->0
+ * @param buff  队列元素数组，由调用者提供，可按曲线需要的深度分配
+ * @param size  数组元素个数（CURVE_DATA_QUEUE_SIZE(容量)），不超过 CURVE_DATA_QUEUE_MAX_SIZE
+ * @note 构建初始循环链表：索引0->1, 1->2, ... size-1->0
  */
-void curve_data_queue_init(curve_data_queue_t *queue)
+void curve_data_queue_init(curve_data_queue_t *queue, struct array_link_element *buff, rt_uint16_t size)
 {
 	rt_uint16_t index;
 	
-	for (index = 0; index < MAX_COUNT; index++)
+	RT_ASSERT(size >= 2 && size <= CURVE_DATA_QUEUE_MAX_SIZE);
+	queue->queue = buff;
+	queue->size = size;
+	for (index = 0; index < size; index++)
 	{
-		queue->queue[index].next = (index + 1) % MAX_COUNT;//队列元素的next值随着index的增加而增加，到最后一个位置变为0，实现循环
+		queue->queue[index].next = (index + 1) % size;//队列元素的next值随着index的增加而增加，到最后一个位置变为0，实现循环
 	}
 	queue->head = queue->tail = queue->read_point = 0;// 读指针初始与头指针同步
 }
@@ -59,14 +84,15 @@ void curve_data_queue_init(curve_data_queue_t *queue)
  * @brief 获取队列所有有效数据
  * @param queue 队列控制结构指针
  * @param buff  输出缓冲区
+ * @param max_count 最多读取的数据个数，数据更多时只读最新的
  * @return index 实际读取的数据个数
  */
-rt_uint16_t curve_data_queue_get_all_data(curve_data_queue_t *queue, rt_uint16_t *buff)
+rt_uint16_t curve_data_queue_get_all_data(curve_data_queue_t *queue, rt_uint16_t *buff, rt_uint16_t max_count)
 {
 	rt_uint16_t index = 0;
 	rt_uint16_t head;
 	
-	head = queue->head;//从头指针开始读取。头指针在0的位置，这行代码给头指针赋值为0
+	head = curve_data_queue_skip_old(queue, queue->head, max_count);//从头指针开始读取，超出的旧数据跳过
 	while (head != queue->tail)// 遍历队列直到尾指针。头指针为0，而尾节点不为零，进入while循环内。头指针每次后移最终追上尾指针，跳出循环
 	{
 		buff[index++] = queue->queue[head].data;//读取队列数据到输出缓冲区，再index自加
@@ -80,13 +106,14 @@ rt_uint16_t curve_data_queue_get_all_data(curve_data_queue_t *queue, rt_uint16_t
  * @brief 获取上次读取后的新增数据
  * @param queue 队列控制结构指针
  * @param buff  输出缓冲区
+ * @param max_count 最多读取的数据个数，数据更多时只读最新的
  * @return index 读取新增数据个数
- */rt_uint16_t curve_data_queue_get_last_data(curve_data_queue_t *queue, rt_uint16_t *buff)
+ */rt_uint16_t curve_data_queue_get_last_data(curve_data_queue_t *queue, rt_uint16_t *buff, rt_uint16_t max_count)
 {
 	rt_uint16_t index = 0;
 	rt_uint16_t head;
 	
-	head = queue->read_point;// 从上次读取位置开始
+	head = curve_data_queue_skip_old(queue, queue->read_point, max_count);// 从上次读取位置开始
 	while (head != queue->tail)// 遍历新增数据（从read_point到tail）
 	{
 		buff[index++] = queue->queue[head].data;//读取队列数据到输出缓冲区，再index自加
@@ -20,9 +20,9 @@ extern "C" {
 #endif
 
 /*============================ MACROS ========================================*/
-#ifndef MAX_COUNT
-#define MAX_COUNT	20				//队列最大容量（根据迪文屏数据帧最大长度设定）
-#endif
+#define CURVE_DATA_QUEUE_MAX_SIZE	256		//队列元素最大个数，受 next 为8位限制
+/* 容量为 capacity 的队列需要的元素个数，伪链表留一个空位区分空和满 */
+#define CURVE_DATA_QUEUE_SIZE(capacity)	((capacity) + 1)
 /*============================ TYPES =========================================*/
 /**
  * @struct array_link_element
@@ -39,7 +39,8 @@ struct array_link_element
  */
 struct curve_data_queue
 {
-	struct array_link_element  queue[MAX_COUNT];//数据存储数组
+	struct array_link_element *queue;//数据存储数组（由调用者提供的内存）
+	rt_uint16_t size;		// 数组元素个数，最多存 size - 1 个数据
 	rt_uint16_t head;		// 队列头指针
 	rt_uint16_t tail;		// 队列尾指针
 	rt_uint16_t read_point;	// 队列读指针（记录读取的位置）
@@ -55,10 +56,10 @@ typedef struct curve_data_queue curve_data_queue_t;//curve_data_queue_t结构体
 读取新添加的数据；
 
 */
-void curve_data_queue_init(curve_data_queue_t *queue);
+void curve_data_queue_init(curve_data_queue_t *queue, struct array_link_element *buff, rt_uint16_t size);
 void curve_data_queue_add_data(curve_data_queue_t *queue, rt_uint16_t data);
-rt_uint16_t curve_data_queue_get_all_data(curve_data_queue_t *queue, rt_uint16_t *buff);
-rt_uint16_t curve_data_queue_get_last_data(curve_data_queue_t *queue, rt_uint16_t *buff);
+rt_uint16_t curve_data_queue_get_all_data(curve_data_queue_t *queue, rt_uint16_t *buff, rt_uint16_t max_count);
+rt_uint16_t curve_data_queue_get_last_data(curve_data_queue_t *queue, rt_uint16_t *buff, rt_uint16_t max_count);
 /*============================ INCLUDES ======================================*/
 
 #ifdef __cplusplus
@@ -0,0 +1,189 @@
+/**
+ * @file zcq_bench.c
+ * @brief 零拷贝队列 rt_zcqueue 与消息队列 rt_mq 的吞吐量对比
+ * @author Lee
+ * @version 1.0.0
+ * @date 2025-04-16
+ *
+ * @Copyright (c) 2023, PLKJ Development Team, All rights reserved.
+ *
+ * @note  msh 命令 zcq_bench：分别用 16 字节（一帧 CAN）和 256 字节（一帧 DWIN）的消息，
+ *		由当前线程发送 ZCQ_BENCH_COUNT 条，低一级优先级的接收线程逐条取出并读一遍内容，
+ *		用 DWT 周期计数器测量从第一条发送到最后一条处理完的时间，换算成每条的周期数和每秒条数。
+ *		rt_mq 的发送方先在本地缓冲区填好再拷入队列，接收方再拷出；rt_zcqueue 的发送方
+ *		直接在池里的缓冲区填写，接收方读完后释放，两者队列深度相同。
+ */
+/*============================ INCLUDES ======================================*/
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <board.h>
+
+#if defined(RT_USING_FINSH) && defined(RT_USING_HEAP) && defined(RT_USING_MESSAGEQUEUE) && \
+	defined(RT_USING_MEMPOOL) && defined(RT_USING_MAILBOX)
+/*============================ MACROS ========================================*/
+#define ZCQ_BENCH_COUNT					2000	//每项测试的消息条数
+#define ZCQ_BENCH_DEPTH					16		//队列深度
+#define ZCQ_BENCH_MAX_SIZE				256		//最大消息长度
+#define ZCQ_BENCH_STACK_SIZE			1024	//接收线程的栈大小，含一条最大消息的缓冲区
+/*============================ TYPES =========================================*/
+/* 一次测试的上下文，接收线程通过参数拿到 */
+typedef struct zcq_bench_ctx
+{
+	rt_mq_t mq;									//为 RT_NULL 时测试 zcq
+	rt_zcqueue_t zcq;
+	rt_size_t size;
+	rt_uint32_t checksum;
+	struct rt_semaphore done;
+}zcq_bench_ctx_t;
+/*============================ GLOBAL VARIABLES ==============================*/
+/*============================ LOCAL VARIABLES ===============================*/
+static const rt_uint16_t bench_size_list[] = { 16, ZCQ_BENCH_MAX_SIZE };
+/*============================ PROTOTYPES ====================================*/
+/*============================ INTERNAL IMPLEMENTATION =======================*/
+static rt_uint32_t bench_now(void)
+{
+	return DWT->CYCCNT;
+}
+/*读一遍消息内容，模拟接收方的解析*/
+static rt_uint32_t bench_sum(const rt_uint8_t *msg, rt_size_t size)
+{
+	rt_uint32_t sum = 0;
+	rt_size_t i;
+
+	for (i = 0; i < size; i++)
+	{
+		sum += msg[i];
+	}
+	return sum;
+}
+/*接收线程：取出 ZCQ_BENCH_COUNT 条消息后通知发送方*/
+static void bench_consumer_entry(void *parameter)
+{
+	zcq_bench_ctx_t *ctx = parameter;
+	rt_uint8_t buf[ZCQ_BENCH_MAX_SIZE];
+	void *msg;
+	rt_uint32_t i;
+
+	for (i = 0; i < ZCQ_BENCH_COUNT; i++)
+	{
+		if (ctx->mq != RT_NULL)
+		{
+			if (rt_mq_recv(ctx->mq, buf, ctx->size, RT_WAITING_FOREVER) <= 0)
+			{
+				break;
+			}
+			ctx->checksum += bench_sum(buf, ctx->size);
+		}
+		else
+		{
+			if (rt_zcqueue_recv(ctx->zcq, &msg, RT_WAITING_FOREVER) != RT_EOK)
+			{
+				break;
+			}
+			ctx->checksum += bench_sum(msg, ctx->size);
+			rt_zcqueue_free(ctx->zcq, msg);
+		}
+	}
+	rt_sem_release(&ctx->done);
+}
+/*
+ * 发送 ZCQ_BENCH_COUNT 条消息并等待接收完成，返回总周期数，失败返回 0
+ */
+static rt_uint32_t bench_run(zcq_bench_ctx_t *ctx)
+{
+	rt_uint8_t buf[ZCQ_BENCH_MAX_SIZE];
+	rt_thread_t consumer;
+	rt_uint32_t start;
+	rt_uint32_t i;
+	void *msg;
+
+	ctx->checksum = 0;
+	rt_sem_init(&ctx->done, "qbench", 0, RT_IPC_FLAG_PRIO);
+	consumer = rt_thread_create("qbench", bench_consumer_entry, ctx, ZCQ_BENCH_STACK_SIZE,
+			rt_thread_self()->current_priority + 1, 10);
+	if (consumer == RT_NULL)
+	{
+		rt_sem_detach(&ctx->done);
+		return 0;
+	}
+	rt_thread_startup(consumer);
+
+	start = bench_now();
+	for (i = 0; i < ZCQ_BENCH_COUNT; i++)
+	{
+		if (ctx->mq != RT_NULL)
+		{
+			rt_memset(buf, (rt_uint8_t)i, ctx->size);
+			rt_mq_send_wait(ctx->mq, buf, ctx->size, RT_WAITING_FOREVER);
+		}
+		else
+		{
+			msg = rt_zcqueue_alloc(ctx->zcq, RT_WAITING_FOREVER);
+			rt_memset(msg, (rt_uint8_t)i, ctx->size);
+			rt_zcqueue_send(ctx->zcq, msg);
+		}
+	}
+	rt_sem_take(&ctx->done, RT_WAITING_FOREVER);
+	start = bench_now() - start;
+
+	rt_sem_detach(&ctx->done);
+	return start;
+}
+static void bench_print(const char *name, rt_size_t size, rt_uint32_t cycles, rt_uint32_t checksum, rt_uint32_t expect)
+{
+	if (cycles == 0)
+	{
+		rt_kprintf("%-6s %-5u no memory\n", name, size);
+		return;
+	}
+	rt_kprintf("%-6s %-5u %-10u %-9u %u%s\n", name, size, cycles / ZCQ_BENCH_COUNT,
+			(rt_uint32_t)((rt_uint64_t)ZCQ_BENCH_COUNT * SystemCoreClock / cycles), checksum,
+			checksum == expect ? "" : " BAD");
+}
+/*============================ EXTERNAL IMPLEMENTATION =======================*/
+/**
+ * @brief msh命令：对比 rt_zcqueue 与 rt_mq 的吞吐量
+ */
+static void zcq_bench(int argc, char **argv)
+{
+	zcq_bench_ctx_t ctx;
+	rt_uint32_t cycles;
+	rt_uint32_t expect;
+	rt_uint32_t i;
+	rt_uint8_t n;
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	rt_kprintf("%u messages, depth %u\n", ZCQ_BENCH_COUNT, ZCQ_BENCH_DEPTH);
+	rt_kprintf("queue  size  cycles/msg msgs/s    checksum\n");
+	for (n = 0; n < sizeof(bench_size_list) / sizeof(bench_size_list[0]); n++)
+	{
+		rt_memset(&ctx, 0, sizeof(ctx));
+		ctx.size = bench_size_list[n];
+		expect = 0;
+		for (i = 0; i < ZCQ_BENCH_COUNT; i++)
+		{
+			expect += (rt_uint8_t)i * ctx.size;
+		}
+
+		ctx.mq = rt_mq_create("qbench", ctx.size, ZCQ_BENCH_DEPTH, RT_IPC_FLAG_PRIO);
+		cycles = ctx.mq != RT_NULL ? bench_run(&ctx) : 0;
+		bench_print("rt_mq", ctx.size, cycles, ctx.checksum, expect);
+		if (ctx.mq != RT_NULL)
+		{
+			rt_mq_delete(ctx.mq);
+			ctx.mq = RT_NULL;
+		}
+
+		ctx.zcq = rt_zcqueue_create("qbench", ctx.size, ZCQ_BENCH_DEPTH);
+		cycles = ctx.zcq != RT_NULL ? bench_run(&ctx) : 0;
+		bench_print("zcq", ctx.size, cycles, ctx.checksum, expect);
+		if (ctx.zcq != RT_NULL)
+		{
+			rt_zcqueue_delete(ctx.zcq);
+		}
+	}
+}
+MSH_CMD_EXPORT(zcq_bench, compare rt_zcqueue and rt_mq throughput);
+#endif /* defined(RT_USING_FINSH) && defined(RT_USING_HEAP) && ... */
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-04-15     Lee          first version
+ */
+
+#ifndef _FAL_CFG_H_
+#define _FAL_CFG_H_
+
+#include <rtconfig.h>
+#include <board.h>
+
+/* STM32F412 扇区：0~3 为16K，4 为64K，5 以后为128K */
+#define FLASH_SIZE_GRANULARITY_16K      (4 * 16 * 1024)
+#define FLASH_SIZE_GRANULARITY_64K      (64 * 1024)
+#define FLASH_SIZE_GRANULARITY_128K     (STM32_FLASH_SIZE - FLASH_SIZE_GRANULARITY_16K - FLASH_SIZE_GRANULARITY_64K)
+
+#define STM32_FLASH_START_ADRESS_16K    STM32_FLASH_START_ADRESS
+#define STM32_FLASH_START_ADRESS_64K    (STM32_FLASH_START_ADRESS_16K + FLASH_SIZE_GRANULARITY_16K)
+#define STM32_FLASH_START_ADRESS_128K   (STM32_FLASH_START_ADRESS_64K + FLASH_SIZE_GRANULARITY_64K)
+
+/* 程序区 0x08000000 ~ 0x0805FFFF（384K，链接脚本同步限制），CAN路由表占用 0x08060000 开始的一个128K扇区 */
+#define FAL_APP_SIZE                    (384 * 1024)
+#define FAL_ROUTE_OFFSET                (FAL_APP_SIZE - FLASH_SIZE_GRANULARITY_16K - FLASH_SIZE_GRANULARITY_64K)
+#define FAL_ROUTE_SIZE                  (128 * 1024)
+
+extern const struct fal_flash_dev stm32_onchip_flash_16k;
+extern const struct fal_flash_dev stm32_onchip_flash_64k;
+extern const struct fal_flash_dev stm32_onchip_flash_128k;
+
+/* flash device table */
+#define FAL_FLASH_DEV_TABLE                                          \
+{                                                                    \
+    &stm32_onchip_flash_16k,                                         \
+    &stm32_onchip_flash_64k,                                         \
+    &stm32_onchip_flash_128k,                                        \
+}
+/* ====================== Partition Configuration ========================== */
+#ifdef FAL_PART_HAS_TABLE_CFG
+
+/* partition table，程序区不作为分区，只登记需要读写的分区 */
+#define FAL_PART_TABLE                                                                          \
+{                                                                                               \
+    {FAL_PART_MAGIC_WORD, "route", "onchip_flash_128k", FAL_ROUTE_OFFSET, FAL_ROUTE_SIZE, 0},   \
+}
+
+#endif /* FAL_PART_HAS_TABLE_CFG */
+#endif /* _FAL_CFG_H_ */
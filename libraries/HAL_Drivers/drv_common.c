@@ -19,6 +19,10 @@
 #endif /* RT_USING_SERIAL */
 #endif /* RT_USING_SERIAL_V2 */
 
+#ifdef RT_DEBUGING_IRQ_MASK
+#include <cpuport.h>
+#endif
+
 #define DBG_TAG    "drv_common"
 #define DBG_LVL    DBG_INFO
 #include <rtdbg.h>
@@ -53,6 +57,11 @@ void rt_hw_systick_init(void)
  */
 void SysTick_Handler(void)
 {
+#ifdef RT_DEBUGING_IRQ_MASK
+    /* before anything else, the latency is taken from the SysTick counter */
+    rt_hw_irqmask_systick_enter();
+#endif
+
     /* enter interrupt */
     rt_interrupt_enter();
 
@@ -161,6 +170,34 @@ void rt_hw_us_delay(rt_uint32_t us)
     }
 }
 
+#ifdef RT_DEBUGING_INIT_PROFILE
+/**
+ * This function will get the DWT cycle counter for the initialization profile,
+ * the counter is started by the first call.
+ */
+rt_uint32_t rt_hw_init_cycles_get(void)
+{
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0)
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    return DWT->CYCCNT;
+}
+
+/**
+ * This function will get the frequency of the cycle counter. The cycles before
+ * the system clock is configured run at the reset clock but are converted with
+ * the final one too.
+ */
+rt_uint32_t rt_hw_init_cycles_freq(void)
+{
+    return SystemCoreClock;
+}
+#endif /* RT_DEBUGING_INIT_PROFILE */
+
 /**
  * This function will initial STM32 board.
  */
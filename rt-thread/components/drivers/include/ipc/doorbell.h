@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-04-16     Lee          the first version
+ */
+#ifndef DOORBELL_H_
+#define DOORBELL_H_
+
+#include <rtdef.h>
+#include <rtconfig.h>
+
+/**
+ * Doorbell
+ *
+ * A counting wake-up from interrupt to one thread. rt_doorbell_ring adds one to
+ * the pending count with an atomic operation and only wakes the waiter when the
+ * count goes from 0 to 1. rt_doorbell_wait returns all the rings since it last
+ * returned, so no ring is lost when they come in bursts.
+ */
+
+struct rt_doorbell
+{
+    rt_atomic_t pending;
+#ifdef RT_DOORBELL_USING_HIGH_WATER
+    rt_atomic_t high_water;
+#endif /* RT_DOORBELL_USING_HIGH_WATER */
+
+    /* suspended list */
+    rt_list_t suspended_list;
+};
+
+void rt_doorbell_init(struct rt_doorbell *doorbell);
+void rt_doorbell_ring(struct rt_doorbell *doorbell);
+rt_err_t rt_doorbell_wait(struct rt_doorbell *doorbell,
+                          rt_uint32_t        *count,
+                          rt_int32_t          timeout);
+#ifdef RT_DOORBELL_USING_HIGH_WATER
+rt_uint32_t rt_doorbell_high_water(struct rt_doorbell *doorbell, rt_bool_t reset);
+#endif /* RT_DOORBELL_USING_HIGH_WATER */
+
+#endif
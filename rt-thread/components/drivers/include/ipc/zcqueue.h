@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-04-16     Lee          the first version
+ */
+
+#ifndef ZCQUEUE_H__
+#define ZCQUEUE_H__
+
+#include <rtdef.h>
+#include <rtconfig.h>
+
+#if defined(RT_USING_MEMPOOL) && defined(RT_USING_MAILBOX)
+
+/*
+ * Introduction:
+ * The zero copy queue passes message buffers between threads by address. The producer
+ * allocates a fixed size buffer from the pool of the queue, fills it in place and sends
+ * it; the consumer receives the same buffer and frees it back to the pool. The payload
+ * is never copied, unlike rt_mq which copies it into and out of the queue.
+ *
+ * The mailbox holds as many entries as the pool has buffers, so sending never blocks.
+ * rt_zcqueue_alloc with timeout 0, rt_zcqueue_send and rt_zcqueue_free can be called
+ * from interrupt.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the buffer size rt_zcqueue_init needs for count messages of msg_size bytes */
+#define RT_ZCQUEUE_BUF_SIZE(msg_size, count) \
+    (RT_ALIGN((count) * sizeof(rt_ubase_t), RT_ALIGN_SIZE) + \
+     RT_ALIGN((count) * (RT_ALIGN((msg_size), RT_ALIGN_SIZE) + sizeof(rt_uint8_t *)), RT_ALIGN_SIZE))
+
+struct rt_zcqueue
+{
+    struct rt_mempool pool;                             /* the message buffers */
+    struct rt_mailbox mb;                               /* the addresses of the sent buffers */
+};
+typedef struct rt_zcqueue *rt_zcqueue_t;
+
+rt_err_t rt_zcqueue_init(rt_zcqueue_t zcq,
+                         const char  *name,
+                         void        *buf,
+                         rt_size_t    buf_size,
+                         rt_size_t    msg_size);
+rt_err_t rt_zcqueue_detach(rt_zcqueue_t zcq);
+#ifdef RT_USING_HEAP
+rt_zcqueue_t rt_zcqueue_create(const char *name, rt_size_t msg_size, rt_size_t count);
+rt_err_t rt_zcqueue_delete(rt_zcqueue_t zcq);
+#endif /* RT_USING_HEAP */
+
+void *rt_zcqueue_alloc(rt_zcqueue_t zcq, rt_int32_t timeout);
+void rt_zcqueue_free(rt_zcqueue_t zcq, void *msg);
+rt_err_t rt_zcqueue_send(rt_zcqueue_t zcq, void *msg);
+rt_err_t rt_zcqueue_urgent(rt_zcqueue_t zcq, void *msg);
+rt_err_t rt_zcqueue_recv(rt_zcqueue_t zcq, void **msg, rt_int32_t timeout);
+rt_size_t rt_zcqueue_len(rt_zcqueue_t zcq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* defined(RT_USING_MEMPOOL) && defined(RT_USING_MAILBOX) */
+
+#endif /* ZCQUEUE_H__ */
@@ -16,12 +16,14 @@
 
 #include "ipc/ringbuffer.h"
 #include "ipc/completion.h"
+#include "ipc/doorbell.h"
 #include "ipc/dataqueue.h"
 #include "ipc/workqueue.h"
 #include "ipc/waitqueue.h"
 #include "ipc/pipe.h"
 #include "ipc/poll.h"
 #include "ipc/ringblk_buf.h"
+#include "ipc/zcqueue.h"
 
 #ifdef __cplusplus
 extern "C" {
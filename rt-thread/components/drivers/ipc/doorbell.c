@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-04-16     Lee          the first version
+ */
+
+#include <rthw.h>
+#include <rtdevice.h>
+
+/**
+ * @brief This function will initialize a doorbell object.
+ *
+ * @param doorbell is a pointer to a doorbell object.
+ */
+void rt_doorbell_init(struct rt_doorbell *doorbell)
+{
+    RT_ASSERT(doorbell != RT_NULL);
+
+    rt_atomic_store(&doorbell->pending, 0);
+#ifdef RT_DOORBELL_USING_HIGH_WATER
+    rt_atomic_store(&doorbell->high_water, 0);
+#endif /* RT_DOORBELL_USING_HIGH_WATER */
+    rt_list_init(&doorbell->suspended_list);
+}
+RTM_EXPORT(rt_doorbell_init);
+
+/**
+ * @brief This function will ring a doorbell. It can be called in interrupt.
+ *
+ * @note  Only the ring that makes the pending count go from 0 to 1 disables interrupt to wake the
+ *        waiter, the others only add to the count.
+ *
+ * @param doorbell is a pointer to a doorbell object.
+ */
+void rt_doorbell_ring(struct rt_doorbell *doorbell)
+{
+    rt_atomic_t pending;
+    rt_base_t level;
+#ifdef RT_DOORBELL_USING_HIGH_WATER
+    rt_atomic_t high_water;
+#endif /* RT_DOORBELL_USING_HIGH_WATER */
+
+    RT_ASSERT(doorbell != RT_NULL);
+
+    pending = rt_atomic_add(&doorbell->pending, 1) + 1;
+
+#ifdef RT_DOORBELL_USING_HIGH_WATER
+    high_water = rt_atomic_load(&doorbell->high_water);
+    while (pending > high_water)
+    {
+        if (rt_atomic_compare_exchange_strong(&doorbell->high_water, &high_water, pending))
+        {
+            break;
+        }
+    }
+#endif /* RT_DOORBELL_USING_HIGH_WATER */
+
+    if (pending != 1)
+    {
+        /* the waiter has been woken by the first ring and has not taken the count yet */
+        return;
+    }
+
+    level = rt_hw_interrupt_disable();
+    if (!rt_list_isempty(&(doorbell->suspended_list)))
+    {
+        /* there is one thread in suspended list */
+        struct rt_thread *thread;
+
+        /* get thread entry */
+        thread = rt_list_entry(doorbell->suspended_list.next,
+                               struct rt_thread,
+                               tlist);
+
+        /* resume it */
+        rt_thread_resume(thread);
+        rt_hw_interrupt_enable(level);
+
+        /* perform a schedule */
+        rt_schedule();
+    }
+    else
+    {
+        rt_hw_interrupt_enable(level);
+    }
+}
+RTM_EXPORT(rt_doorbell_ring);
+
+/**
+ * @brief This function will wait for a doorbell to ring, and take all the rings since the last
+ *        successful wait.
+ *
+ * @param doorbell is a pointer to a doorbell object.
+ *
+ * @param count is where the number of rings is returned, at least 1 on success.
+ *
+ * @param timeout is a timeout period (unit: OS ticks), RT_WAITING_FOREVER or 0.
+ *
+ * @return Return RT_EOK if the doorbell has rung, -RT_ETIMEOUT or another error of the thread otherwise.
+ *
+ * @warning Only one thread can wait on a doorbell. It can ONLY be called in the thread context.
+ */
+rt_err_t rt_doorbell_wait(struct rt_doorbell *doorbell,
+                          rt_uint32_t        *count,
+                          rt_int32_t          timeout)
+{
+    rt_err_t result;
+    rt_base_t level;
+    rt_thread_t thread;
+
+    RT_ASSERT(doorbell != RT_NULL);
+    RT_ASSERT(count != RT_NULL);
+
+    /* rung already, no need to disable interrupt */
+    *count = (rt_uint32_t)rt_atomic_exchange(&doorbell->pending, 0);
+    if (*count != 0)
+    {
+        return RT_EOK;
+    }
+
+    if (timeout == 0)
+    {
+        return -RT_ETIMEOUT;
+    }
+
+    /* current context checking */
+    RT_DEBUG_SCHEDULER_AVAILABLE(RT_TRUE);
+
+    result = -RT_ETIMEOUT;
+    thread = rt_thread_self();
+
+    level = rt_hw_interrupt_disable();
+    /* a ring after the exchange above found no waiter, it must not be slept through */
+    if (rt_atomic_load(&doorbell->pending) == 0)
+    {
+        /* only one thread can suspend on doorbell */
+        RT_ASSERT(rt_list_isempty(&(doorbell->suspended_list)));
+
+        /* reset thread error number */
+        thread->error = RT_EOK;
+
+        /* suspend thread */
+        rt_thread_suspend_with_flag(thread, RT_UNINTERRUPTIBLE);
+        /* add to suspended list */
+        rt_list_insert_before(&(doorbell->suspended_list),
+                              &(thread->tlist));
+
+        /* start timer */
+        if (timeout > 0)
+        {
+            /* reset the timeout of thread timer and start it */
+            rt_timer_control(&(thread->thread_timer),
+                             RT_TIMER_CTRL_SET_TIME,
+                             &timeout);
+            rt_timer_start(&(thread->thread_timer));
+        }
+        /* enable interrupt */
+        rt_hw_interrupt_enable(level);
+
+        /* do schedule */
+        rt_schedule();
+
+        /* thread is waked up */
+        if (thread->error != RT_EOK)
+        {
+            result = thread->error;
+        }
+    }
+    else
+    {
+        rt_hw_interrupt_enable(level);
+    }
+
+    /* the rings may also come between a timeout and here */
+    *count = (rt_uint32_t)rt_atomic_exchange(&doorbell->pending, 0);
+
+    return *count != 0 ? RT_EOK : result;
+}
+RTM_EXPORT(rt_doorbell_wait);
+
+#ifdef RT_DOORBELL_USING_HIGH_WATER
+/**
+ * @brief This function will get the largest pending count a doorbell has reached, that is
+ *        the deepest burst of rings between two waits.
+ *
+ * @param doorbell is a pointer to a doorbell object.
+ *
+ * @param reset is RT_TRUE to start measuring again.
+ *
+ * @return Return the high water mark of the pending count.
+ */
+rt_uint32_t rt_doorbell_high_water(struct rt_doorbell *doorbell, rt_bool_t reset)
+{
+    RT_ASSERT(doorbell != RT_NULL);
+
+    if (reset)
+    {
+        return (rt_uint32_t)rt_atomic_exchange(&doorbell->high_water, 0);
+    }
+
+    return (rt_uint32_t)rt_atomic_load(&doorbell->high_water);
+}
+RTM_EXPORT(rt_doorbell_high_water);
+#endif /* RT_DOORBELL_USING_HIGH_WATER */
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-04-16     Lee          the first version
+ */
+
+#include <rthw.h>
+#include <rtdevice.h>
+
+/**
+ * @brief This function will initialize a zero copy queue on a static buffer.
+ *
+ * @param zcq is a pointer to the zero copy queue object.
+ *
+ * @param name is the name of the queue, it is also used for its pool and mailbox.
+ *
+ * @param buf is the buffer holding the messages and the mailbox, aligned to RT_ALIGN_SIZE.
+ *
+ * @param buf_size is the size of buf. RT_ZCQUEUE_BUF_SIZE(msg_size, count) gives the size for count messages.
+ *
+ * @param msg_size is the maximum size of one message.
+ *
+ * @return Return RT_EOK if successful, -RT_EINVAL if the buffer is too small for one message.
+ */
+rt_err_t rt_zcqueue_init(rt_zcqueue_t zcq,
+                         const char  *name,
+                         void        *buf,
+                         rt_size_t    buf_size,
+                         rt_size_t    msg_size)
+{
+    rt_size_t count;
+    rt_size_t block_size;
+
+    RT_ASSERT(zcq != RT_NULL);
+    RT_ASSERT(buf != RT_NULL);
+    RT_ASSERT(msg_size > 0);
+
+    /* every message costs one pool block with its header and one mailbox entry */
+    block_size = RT_ALIGN(msg_size, RT_ALIGN_SIZE) + sizeof(rt_uint8_t *);
+    count = buf_size / (block_size + sizeof(rt_ubase_t));
+    if (count > RT_UINT16_MAX)
+    {
+        count = RT_UINT16_MAX;
+    }
+    /* both parts are aligned, the estimate above may be a few messages too many */
+    while (count > 0 && RT_ZCQUEUE_BUF_SIZE(msg_size, count) > buf_size)
+    {
+        count--;
+    }
+    if (count == 0)
+    {
+        return -RT_EINVAL;
+    }
+
+    rt_mp_init(&zcq->pool, name, (rt_uint8_t *)buf + RT_ALIGN(count * sizeof(rt_ubase_t), RT_ALIGN_SIZE),
+               RT_ALIGN(count * block_size, RT_ALIGN_SIZE), msg_size);
+    /* the mailbox must hold every buffer of the pool, or a send could find it full */
+    RT_ASSERT(zcq->pool.block_total_count == count);
+    rt_mb_init(&zcq->mb, name, buf, zcq->pool.block_total_count, RT_IPC_FLAG_PRIO);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_zcqueue_init);
+
+/**
+ * @brief This function will detach a zero copy queue, the threads waiting on it are resumed with an error.
+ *
+ * @param zcq is a pointer to the zero copy queue object.
+ *
+ * @return Return RT_EOK.
+ */
+rt_err_t rt_zcqueue_detach(rt_zcqueue_t zcq)
+{
+    RT_ASSERT(zcq != RT_NULL);
+
+    rt_mb_detach(&zcq->mb);
+    rt_mp_detach(&zcq->pool);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_zcqueue_detach);
+
+#ifdef RT_USING_HEAP
+/**
+ * @brief This function will create a zero copy queue with its buffer on the heap.
+ *
+ * @param name is the name of the queue.
+ *
+ * @param msg_size is the maximum size of one message.
+ *
+ * @param count is the number of messages.
+ *
+ * @return Return the queue, RT_NULL if there is no memory.
+ */
+rt_zcqueue_t rt_zcqueue_create(const char *name, rt_size_t msg_size, rt_size_t count)
+{
+    rt_size_t head_size = RT_ALIGN(sizeof(struct rt_zcqueue), RT_ALIGN_SIZE);
+    rt_size_t buf_size = RT_ZCQUEUE_BUF_SIZE(msg_size, count);
+    rt_zcqueue_t zcq;
+
+    RT_ASSERT(count > 0 && count <= RT_UINT16_MAX);
+
+    zcq = (rt_zcqueue_t)rt_malloc(head_size + buf_size);
+    if (zcq == RT_NULL)
+    {
+        return RT_NULL;
+    }
+
+    if (rt_zcqueue_init(zcq, name, (rt_uint8_t *)zcq + head_size, buf_size, msg_size) != RT_EOK)
+    {
+        rt_free(zcq);
+        return RT_NULL;
+    }
+
+    return zcq;
+}
+RTM_EXPORT(rt_zcqueue_create);
+
+/**
+ * @brief This function will delete a zero copy queue created by rt_zcqueue_create.
+ *
+ * @param zcq is a pointer to the zero copy queue object.
+ *
+ * @return Return RT_EOK.
+ */
+rt_err_t rt_zcqueue_delete(rt_zcqueue_t zcq)
+{
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    rt_zcqueue_detach(zcq);
+    rt_free(zcq);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_zcqueue_delete);
+#endif /* RT_USING_HEAP */
+
+/**
+ * @brief This function will allocate a message buffer from the pool of the queue.
+ *
+ * @param zcq is a pointer to the zero copy queue object.
+ *
+ * @param timeout is the ticks to wait when all buffers are in use. It must be 0 in interrupt.
+ *
+ * @return Return the message buffer, RT_NULL on timeout.
+ */
+void *rt_zcqueue_alloc(rt_zcqueue_t zcq, rt_int32_t timeout)
+{
+    RT_ASSERT(zcq != RT_NULL);
+
+    return rt_mp_alloc(&zcq->pool, timeout);
+}
+RTM_EXPORT(rt_zcqueue_alloc);
+
+/**
+ * @brief This function will free a message buffer back to the pool of the queue. It can be called in interrupt.
+ *
+ * @param zcq is a pointer to the zero copy queue object.
+ *
+ * @param msg is a buffer returned by rt_zcqueue_alloc or rt_zcqueue_recv.
+ */
+void rt_zcqueue_free(rt_zcqueue_t zcq, void *msg)
+{
+    RT_ASSERT(zcq != RT_NULL);
+    RT_ASSERT(msg != RT_NULL);
+    RT_ASSERT((rt_uint8_t *)msg > (rt_uint8_t *)zcq->pool.start_address &&
+              (rt_uint8_t *)msg < (rt_uint8_t *)zcq->pool.start_address + zcq->pool.size);
+
+    rt_mp_free(msg);
+}
+RTM_EXPORT(rt_zcqueue_free);
+
+/**
+ * @brief This function will send a message buffer to the end of the queue. It never blocks
+ *        and can be called in interrupt.
+ *
+ * @param zcq is a pointer to the zero copy queue object.
+ *
+ * @param msg is a buffer returned by rt_zcqueue_alloc, owned by the receiver after this call.
+ *
+ * @return Return RT_EOK.
+ */
+rt_err_t rt_zcqueue_send(rt_zcqueue_t zcq, void *msg)
+{
+    RT_ASSERT(zcq != RT_NULL);
+    RT_ASSERT(msg != RT_NULL);
+
+    /* the mailbox has an entry for every buffer of the pool, it can not be full */
+    return rt_mb_send(&zcq->mb, (rt_ubase_t)msg);
+}
+RTM_EXPORT(rt_zcqueue_send);
+
+/**
+ * @brief This function will send a message buffer to the front of the queue. It never blocks
+ *        and can be called in interrupt.
+ *
+ * @param zcq is a pointer to the zero copy queue object.
+ *
+ * @param msg is a buffer returned by rt_zcqueue_alloc, owned by the receiver after this call.
+ *
+ * @return Return RT_EOK.
+ */
+rt_err_t rt_zcqueue_urgent(rt_zcqueue_t zcq, void *msg)
+{
+    RT_ASSERT(zcq != RT_NULL);
+    RT_ASSERT(msg != RT_NULL);
+
+    return rt_mb_urgent(&zcq->mb, (rt_ubase_t)msg);
+}
+RTM_EXPORT(rt_zcqueue_urgent);
+
+/**
+ * @brief This function will receive a message buffer from the queue, waiting up to timeout ticks.
+ *
+ * @param zcq is a pointer to the zero copy queue object.
+ *
+ * @param msg is where the buffer is returned. The receiver frees it with rt_zcqueue_free.
+ *
+ * @param timeout is the ticks to wait when the queue is empty, RT_WAITING_FOREVER or 0.
+ *
+ * @return Return RT_EOK if a message is received, -RT_ETIMEOUT on timeout, other errors if the wait
+ *         is interrupted or the queue is detached.
+ */
+rt_err_t rt_zcqueue_recv(rt_zcqueue_t zcq, void **msg, rt_int32_t timeout)
+{
+    RT_ASSERT(zcq != RT_NULL);
+    RT_ASSERT(msg != RT_NULL);
+
+    return rt_mb_recv(&zcq->mb, (rt_ubase_t *)msg, timeout);
+}
+RTM_EXPORT(rt_zcqueue_recv);
+
+/**
+ * @brief This function will get the number of messages in the queue.
+ *
+ * @param zcq is a pointer to the zero copy queue object.
+ *
+ * @return Return the number of sent messages not received yet.
+ */
+rt_size_t rt_zcqueue_len(rt_zcqueue_t zcq)
+{
+    RT_ASSERT(zcq != RT_NULL);
+
+    return zcq->mb.entry;
+}
+RTM_EXPORT(rt_zcqueue_len);
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-04-16     Lee          the first version
+ */
+
+#include <stdarg.h>
+#include <ulog.h>
+
+/*
+ * Binary (deferred format) log mode.
+ *
+ * Every LOG_X call site owns a constant descriptor in the "ulog_fmt" section
+ * holding its level, tag, format string and argument count. At run time only
+ * the descriptor address, the tick and the raw 32-bit arguments are written
+ * into a word ring; no formatting and no output happen on the calling thread,
+ * so it is safe in interrupts and does not block.
+ *
+ * Writers reserve space with a compare-and-swap on the head and write the
+ * descriptor address last, which publishes the record. The single reader
+ * copies published records out, clears their words and advances the tail.
+ * When the ring is full the new record is dropped and counted; the reader
+ * reports the count as a record with id ULOG_BINARY_ID_DROPPED.
+ *
+ * Record: [descriptor address] [tick] [argument 0] ... [argument argc - 1]
+ *
+ * Arguments are stored as 32-bit words, so 64-bit integers and floating point
+ * numbers are not supported. A "%s" argument is stored as its address and is
+ * only readable by the decoder when it points to a constant string in flash.
+ * The runtime filters of ulog are not applied, only LOG_LVL and ULOG_OUTPUT_LVL.
+ *
+ * The host tool ulog_binary_decode.py turns a dump back into text with the
+ * help of the firmware ELF file.
+ */
+
+#ifdef ULOG_USING_BINARY
+
+#ifndef ULOG_BINARY_BUF_SIZE
+#define ULOG_BINARY_BUF_SIZE           2048
+#endif
+
+#define ULOG_BINARY_WORDS              (ULOG_BINARY_BUF_SIZE / 4)
+#define ULOG_BINARY_MASK               (ULOG_BINARY_WORDS - 1)
+/* words of a record before the arguments */
+#define ULOG_BINARY_HEAD_WORDS         2
+
+#if (ULOG_BINARY_WORDS & ULOG_BINARY_MASK) != 0
+#error "ULOG_BINARY_BUF_SIZE must be a power of two"
+#endif
+
+struct ulog_binary
+{
+    /* free running word counters, the ring index is the counter & ULOG_BINARY_MASK */
+    rt_atomic_t head;
+    rt_atomic_t tail;
+    rt_atomic_t dropped;
+    rt_atomic_t reading;
+    rt_uint32_t reported;
+    volatile rt_uint32_t ring[ULOG_BINARY_WORDS];
+};
+
+static struct ulog_binary ulog_binary;
+
+/**
+ * record a log, called by the LOG_X API
+ *
+ * @param fmt is the call site's format descriptor.
+ * @param format is the format string, the same as fmt->format.
+ * @param ... is fmt->argc 32-bit arguments.
+ */
+void ulog_binary_output(const struct ulog_binary_fmt *fmt, const char *format, ...)
+{
+    rt_ubase_t len = ULOG_BINARY_HEAD_WORDS + fmt->argc;
+    rt_atomic_t head = rt_atomic_load(&ulog_binary.head);
+    va_list args;
+    rt_uint8_t i;
+
+    RT_ASSERT(fmt->argc <= ULOG_BINARY_MAX_ARGS);
+
+    do
+    {
+        if (ULOG_BINARY_WORDS - ((rt_ubase_t)head - (rt_ubase_t)rt_atomic_load(&ulog_binary.tail)) < len)
+        {
+            rt_atomic_add(&ulog_binary.dropped, 1);
+            return;
+        }
+    } while (!rt_atomic_compare_exchange_strong(&ulog_binary.head, &head, head + len));
+
+    ulog_binary.ring[(head + 1) & ULOG_BINARY_MASK] = rt_tick_get();
+    va_start(args, format);
+    for (i = 0; i < fmt->argc; i++)
+    {
+        ulog_binary.ring[(head + ULOG_BINARY_HEAD_WORDS + i) & ULOG_BINARY_MASK] = va_arg(args, rt_uint32_t);
+    }
+    va_end(args);
+    /* publish the record */
+    ulog_binary.ring[head & ULOG_BINARY_MASK] = (rt_uint32_t)(rt_ubase_t)fmt;
+}
+
+/**
+ * copy the published records out of the ring, whole records only
+ *
+ * @param buf is the destination.
+ * @param words is the size of buf in words.
+ *
+ * @return the copied words, 0 when there is nothing to read or another reader is running.
+ */
+rt_size_t ulog_binary_read(rt_uint32_t *buf, rt_size_t words)
+{
+    const struct ulog_binary_fmt *fmt;
+    rt_atomic_t idle = 0;
+    rt_uint32_t dropped;
+    rt_size_t count = 0;
+    rt_ubase_t tail;
+    rt_ubase_t len;
+    rt_ubase_t i;
+
+    if (!rt_atomic_compare_exchange_strong(&ulog_binary.reading, &idle, 1))
+    {
+        return 0;
+    }
+
+    dropped = (rt_uint32_t)rt_atomic_load(&ulog_binary.dropped) - ulog_binary.reported;
+    if (dropped != 0 && words >= ULOG_BINARY_HEAD_WORDS)
+    {
+        buf[count++] = ULOG_BINARY_ID_DROPPED;
+        buf[count++] = dropped;
+        ulog_binary.reported += dropped;
+    }
+
+    tail = (rt_ubase_t)rt_atomic_load(&ulog_binary.tail);
+    while (tail != (rt_ubase_t)rt_atomic_load(&ulog_binary.head))
+    {
+        fmt = (const struct ulog_binary_fmt *)(rt_ubase_t)ulog_binary.ring[tail & ULOG_BINARY_MASK];
+        if (fmt == RT_NULL)
+        {
+            /* the writer has not finished this record yet */
+            break;
+        }
+
+        len = ULOG_BINARY_HEAD_WORDS + fmt->argc;
+        if (count + len > words)
+        {
+            break;
+        }
+
+        /* the free part of the ring stays zero so a reserved record reads as unpublished */
+        for (i = 0; i < len; i++)
+        {
+            buf[count++] = ulog_binary.ring[(tail + i) & ULOG_BINARY_MASK];
+            ulog_binary.ring[(tail + i) & ULOG_BINARY_MASK] = 0;
+        }
+        tail += len;
+        rt_atomic_store(&ulog_binary.tail, (rt_atomic_t)tail);
+    }
+
+    rt_atomic_store(&ulog_binary.reading, 0);
+
+    return count;
+}
+
+/**
+ * get the number of records dropped because the ring was full
+ *
+ * @return the dropped records since startup.
+ */
+rt_uint32_t ulog_binary_dropped(void)
+{
+    return (rt_uint32_t)rt_atomic_load(&ulog_binary.dropped);
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+#define ULOG_BINARY_DUMP_WORDS         16
+
+/* print the records as hex text lines, ulog_binary_decode.py reads them from a terminal capture */
+static void ulog_bin_dump(void)
+{
+    rt_uint32_t buf[ULOG_BINARY_DUMP_WORDS];
+    rt_size_t count;
+    rt_size_t i;
+
+    /* a full dump buffer always holds the largest record */
+    RT_ASSERT(ULOG_BINARY_DUMP_WORDS >= ULOG_BINARY_HEAD_WORDS + ULOG_BINARY_MAX_ARGS);
+
+    while ((count = ulog_binary_read(buf, ULOG_BINARY_DUMP_WORDS)) != 0)
+    {
+        rt_kprintf("ULOGB");
+        for (i = 0; i < count; i++)
+        {
+            rt_kprintf(" %08x", buf[i]);
+        }
+        rt_kprintf("\n");
+    }
+    rt_kprintf("ulog binary: %u records dropped since startup\n", ulog_binary_dropped());
+}
+MSH_CMD_EXPORT(ulog_bin_dump, dump the binary log records as hex text);
+#endif /* RT_USING_FINSH */
+
+#endif /* ULOG_USING_BINARY */
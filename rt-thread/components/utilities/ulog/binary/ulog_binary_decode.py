@@ -0,0 +1,159 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) 2006-2023, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Change Logs:
+# Date           Author       Notes
+# 2025-04-16     Lee          the first version
+#
+# Decode the ulog binary log (ULOG_USING_BINARY) into text with the firmware ELF file.
+#
+# usage: python ulog_binary_decode.py rtthread.elf capture.txt
+#        python ulog_binary_decode.py rtthread.elf dump.bin
+#
+# capture.txt is a terminal capture holding the "ULOGB ..." lines printed by ulog_bin_dump,
+# other lines are ignored. dump.bin is the little-endian words returned by ulog_binary_read().
+# The ELF file must be the one running on the target, the record ids are descriptor addresses.
+#
+import re
+import struct
+import sys
+
+ID_DROPPED = 1
+DESC_FORMAT = '<BBHII'
+LEVEL_NAME = {0: 'A', 3: 'E', 4: 'W', 6: 'I', 7: 'D'}
+
+SHT_PROGBITS = 1
+SHT_SYMTAB = 2
+SHF_ALLOC = 0x2
+
+CONVERSION = re.compile(r'%([-+ #0]*)(\d*)(?:\.(\d+))?(?:hh|h|ll|l|z|t|j)?([diouxXcsp%])')
+
+
+class Elf(object):
+    """the loadable sections and symbols of a 32-bit little-endian ELF file"""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError('%s: not a 32-bit little-endian ELF file' % path)
+
+        shoff, = struct.unpack_from('<I', self.data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', self.data, 0x2E)
+        headers = [struct.unpack_from('<IIIIIIIIII', self.data, shoff + i * shentsize) for i in range(shnum)]
+        names = headers[shstrndx][4]
+
+        self.sections = {}
+        self.regions = []
+        self.symbols = {}
+        for name, sh_type, flags, addr, offset, size, link, _, _, entsize in headers:
+            self.sections[self.cstr_at(names + name)] = (addr, size)
+            if sh_type == SHT_PROGBITS and flags & SHF_ALLOC:
+                self.regions.append((addr, offset, size))
+            elif sh_type == SHT_SYMTAB:
+                strtab = headers[link][4]
+                for i in range(size // entsize):
+                    sym_name, value = struct.unpack_from('<II', self.data, offset + i * entsize)
+                    self.symbols[self.cstr_at(strtab + sym_name)] = value
+
+    def cstr_at(self, offset):
+        end = self.data.index(b'\0', offset)
+        return self.data[offset:end].decode('utf-8', 'replace')
+
+    def offset_of(self, addr, size=1):
+        for start, offset, length in self.regions:
+            if start <= addr and addr + size <= start + length:
+                return offset + addr - start
+        return None
+
+    def read(self, addr, size):
+        offset = self.offset_of(addr, size)
+        return None if offset is None else self.data[offset:offset + size]
+
+    def string(self, addr):
+        offset = self.offset_of(addr)
+        return None if offset is None else self.cstr_at(offset)
+
+    def descriptor_range(self):
+        if 'ulog_fmt' in self.sections:
+            addr, size = self.sections['ulog_fmt']
+            return addr, addr + size
+        if '__ulog_fmt_start' in self.symbols and '__ulog_fmt_end' in self.symbols:
+            return self.symbols['__ulog_fmt_start'], self.symbols['__ulog_fmt_end']
+        return None
+
+
+def format_log(elf, fmt, args):
+    args = list(args)
+
+    def convert(match):
+        flags, width, precision, conv = match.groups()
+        if conv == '%':
+            return '%'
+        if not args:
+            return match.group(0)
+        value = args.pop(0)
+        spec = '%' + flags + width + ('.' + precision if precision is not None else '')
+        if conv in 'di':
+            return (spec + 'd') % (value - (1 << 32) if value & 0x80000000 else value)
+        if conv == 'u':
+            return (spec + 'd') % value
+        if conv in 'oxX':
+            return (spec + conv) % value
+        if conv == 'c':
+            return (spec + 'c') % chr(value & 0xFF)
+        if conv == 's':
+            text = elf.string(value)
+            return (spec + 's') % (text if text is not None else '<0x%08x>' % value)
+        return '0x%08x' % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode(elf, words):
+    lines = []
+    valid = elf.descriptor_range()
+    size = struct.calcsize(DESC_FORMAT)
+    i = 0
+    while i + 2 <= len(words):
+        record_id, tick = words[i], words[i + 1]
+        if record_id == ID_DROPPED:
+            lines.append('--- %d records dropped ---' % tick)
+            i += 2
+            continue
+
+        desc = elf.read(record_id, size)
+        if desc is None or (valid is not None and not valid[0] <= record_id < valid[1]):
+            raise ValueError('word %d: 0x%08x is not a format descriptor, wrong ELF file?' % (i, record_id))
+        level, argc, _, tag, fmt = struct.unpack(DESC_FORMAT, desc)
+        if i + 2 + argc > len(words):
+            break
+
+        text = format_log(elf, elf.string(fmt) or '', words[i + 2:i + 2 + argc])
+        lines.append('[%d] %s/%s: %s' % (tick, LEVEL_NAME.get(level, str(level)), elf.string(tag) or '?', text))
+        i += 2 + argc
+    return lines
+
+
+def load_words(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    if b'ULOGB' in data:
+        words = []
+        for line in data.decode('utf-8', 'replace').splitlines():
+            fields = line.split()
+            if 'ULOGB' in fields:
+                words += [int(word, 16) for word in fields[fields.index('ULOGB') + 1:]]
+        return words
+    return list(struct.unpack('<%dI' % (len(data) // 4), data[:len(data) // 4 * 4]))
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        print('usage: python ulog_binary_decode.py rtthread.elf capture.txt|dump.bin')
+        sys.exit(1)
+    for line in decode(Elf(sys.argv[1]), load_words(sys.argv[2])):
+        print(line)
@@ -95,6 +95,15 @@ void ulog_hexdump(const char *tag, rt_size_t width, const rt_uint8_t *buf, rt_si
 void ulog_output(rt_uint32_t level, const char *tag, rt_bool_t newline, const char *format, ...);
 void ulog_raw(const char *format, ...);
 
+#ifdef ULOG_USING_BINARY
+/*
+ * binary log API, the LOG_X API uses it when ULOG_USING_BINARY is enabled
+ */
+void ulog_binary_output(const struct ulog_binary_fmt *fmt, const char *format, ...);
+rt_size_t ulog_binary_read(rt_uint32_t *buf, rt_size_t words);
+rt_uint32_t ulog_binary_dropped(void);
+#endif /* ULOG_USING_BINARY */
+
 #ifdef __cplusplus
 }
 #endif
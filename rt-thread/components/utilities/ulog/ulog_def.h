@@ -76,26 +76,33 @@ extern "C" {
     #endif
 #endif /* !defined(LOG_LVL) */
 
+#ifdef ULOG_USING_BINARY
+    /* record the call site's format descriptor and the raw arguments, see ulog_binary.c */
+    #define ulog_lvl_output(level, TAG, ...)  ulog_binary(level, TAG, __VA_ARGS__)
+#else
+    #define ulog_lvl_output(level, TAG, ...)  ulog_output(level, TAG, RT_TRUE, __VA_ARGS__)
+#endif /* ULOG_USING_BINARY */
+
 #if (LOG_LVL >= LOG_LVL_DBG) && (ULOG_OUTPUT_LVL >= LOG_LVL_DBG)
-    #define ulog_d(TAG, ...)           ulog_output(LOG_LVL_DBG, TAG, RT_TRUE, __VA_ARGS__)
+    #define ulog_d(TAG, ...)           ulog_lvl_output(LOG_LVL_DBG, TAG, __VA_ARGS__)
 #else
     #define ulog_d(TAG, ...)
 #endif /* (LOG_LVL >= LOG_LVL_DBG) && (ULOG_OUTPUT_LVL >= LOG_LVL_DBG) */
 
 #if (LOG_LVL >= LOG_LVL_INFO) && (ULOG_OUTPUT_LVL >= LOG_LVL_INFO)
-    #define ulog_i(TAG, ...)           ulog_output(LOG_LVL_INFO, TAG, RT_TRUE, __VA_ARGS__)
+    #define ulog_i(TAG, ...)           ulog_lvl_output(LOG_LVL_INFO, TAG, __VA_ARGS__)
 #else
     #define ulog_i(TAG, ...)
 #endif /* (LOG_LVL >= LOG_LVL_INFO) && (ULOG_OUTPUT_LVL >= LOG_LVL_INFO) */
 
 #if (LOG_LVL >= LOG_LVL_WARNING) && (ULOG_OUTPUT_LVL >= LOG_LVL_WARNING)
-    #define ulog_w(TAG, ...)           ulog_output(LOG_LVL_WARNING, TAG, RT_TRUE, __VA_ARGS__)
+    #define ulog_w(TAG, ...)           ulog_lvl_output(LOG_LVL_WARNING, TAG, __VA_ARGS__)
 #else
     #define ulog_w(TAG, ...)
 #endif /* (LOG_LVL >= LOG_LVL_WARNING) && (ULOG_OUTPUT_LVL >= LOG_LVL_WARNING) */
 
 #if (LOG_LVL >= LOG_LVL_ERROR) && (ULOG_OUTPUT_LVL >= LOG_LVL_ERROR)
-    #define ulog_e(TAG, ...)           ulog_output(LOG_LVL_ERROR, TAG, RT_TRUE, __VA_ARGS__)
+    #define ulog_e(TAG, ...)           ulog_lvl_output(LOG_LVL_ERROR, TAG, __VA_ARGS__)
 #else
     #define ulog_e(TAG, ...)
 #endif /* (LOG_LVL >= LOG_LVL_ERROR) && (ULOG_OUTPUT_LVL >= LOG_LVL_ERROR) */
@@ -215,6 +222,40 @@ struct ulog_backend
 typedef struct ulog_backend *ulog_backend_t;
 typedef rt_bool_t (*ulog_backend_filter_t)(struct ulog_backend *backend, rt_uint32_t level, const char *tag, rt_bool_t is_raw, const char *log, rt_size_t len);
 
+#ifdef ULOG_USING_BINARY
+/* the section holding the format descriptors, a descriptor's address is its record id */
+#define ULOG_BINARY_SECTION            "ulog_fmt"
+/* the most arguments after the format string */
+#define ULOG_BINARY_MAX_ARGS           8
+/* record id of the lost records counter inserted by ulog_binary_read(), never a descriptor address */
+#define ULOG_BINARY_ID_DROPPED         1
+
+/* format descriptor of one binary log call site, placed in flash */
+struct ulog_binary_fmt
+{
+    rt_uint8_t level;
+    rt_uint8_t argc;
+    rt_uint16_t reserved;
+    const char *tag;
+    const char *format;
+};
+
+/* number of arguments after the format string, 0 .. ULOG_BINARY_MAX_ARGS */
+#define ULOG_BINARY_ARGC(...)          ULOG_BINARY_ARGC_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0, 0)
+#define ULOG_BINARY_ARGC_(fmt, a1, a2, a3, a4, a5, a6, a7, a8, n, ...) n
+/* the format string, it must be a literal */
+#define ULOG_BINARY_FORMAT(...)        ULOG_BINARY_FORMAT_(__VA_ARGS__, 0)
+#define ULOG_BINARY_FORMAT_(fmt, ...)  fmt
+
+#define ulog_binary(level, tag, ...)                                                            \
+    do                                                                                          \
+    {                                                                                           \
+        static const struct ulog_binary_fmt _ulog_fmt rt_section(ULOG_BINARY_SECTION) =         \
+            { level, ULOG_BINARY_ARGC(__VA_ARGS__), 0, tag, ULOG_BINARY_FORMAT(__VA_ARGS__) };  \
+        ulog_binary_output(&_ulog_fmt, __VA_ARGS__);                                            \
+    } while (0)
+#endif /* ULOG_USING_BINARY */
+
 #ifdef __cplusplus
 }
 #endif
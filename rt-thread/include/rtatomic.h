@@ -26,6 +26,9 @@ rt_atomic_t rt_hw_atomic_exchange(volatile rt_atomic_t *ptr, rt_atomic_t val);
 void rt_hw_atomic_flag_clear(volatile rt_atomic_t *ptr);
 rt_atomic_t rt_hw_atomic_flag_test_and_set(volatile rt_atomic_t *ptr);
 rt_atomic_t rt_hw_atomic_compare_exchange_strong(volatile rt_atomic_t *ptr, rt_atomic_t *expected, rt_atomic_t desired);
+/* exclusive access, only on the architectures with load/store exclusive instructions */
+rt_atomic_t rt_hw_atomic_load_exclusive(volatile rt_atomic_t *ptr);
+rt_atomic_t rt_hw_atomic_store_exclusive(volatile rt_atomic_t *ptr, rt_atomic_t val);
 
 /* To detect stdatomic */
 #if !defined(RT_USING_HW_ATOMIC) && !defined(RT_USING_STDC_ATOMIC)
@@ -288,7 +288,7 @@ typedef __gnuc_va_list              va_list;
 typedef int (*init_fn_t)(void);
 #ifdef _MSC_VER
 #pragma section("rti_fn$f",read)
-    #ifdef RT_DEBUGING_INIT
+    #if defined(RT_DEBUGING_INIT) || defined(RT_DEBUGING_INIT_PROFILE)
         struct rt_init_desc
         {
             const char* level;
@@ -314,7 +314,7 @@ typedef int (*init_fn_t)(void);
                                 {__rti_level_##fn, fn };
     #endif
 #else
-    #ifdef RT_DEBUGING_INIT
+    #if defined(RT_DEBUGING_INIT) || defined(RT_DEBUGING_INIT_PROFILE)
         struct rt_init_desc
         {
             const char* fn_name;
@@ -364,6 +364,13 @@ typedef int (*init_fn_t)(void);
 /* init in secondary_cpu_c_start */
 #define INIT_SECONDARY_CPU_EXPORT(fn)   INIT_EXPORT(fn, "7")
 
+/* init after the application is up, in a low priority thread, or as APP_EXPORT if not enabled */
+#ifdef RT_USING_COMPONENTS_DEFERRED_INIT
+#define INIT_DEFERRED_EXPORT(fn)        INIT_EXPORT(fn, "8.1")
+#else
+#define INIT_DEFERRED_EXPORT(fn)        INIT_APP_EXPORT(fn)
+#endif /* RT_USING_COMPONENTS_DEFERRED_INIT */
+
 #if !defined(RT_USING_FINSH)
 /* define these to empty, even if not include finsh.h file */
 #define FINSH_FUNCTION_EXPORT(name, desc)
@@ -1118,6 +1125,10 @@ typedef rt_mem_t rt_smem_t;
 typedef rt_mem_t rt_slab_t;
 #endif /* RT_USING_SLAB */
 
+#ifdef RT_USING_TLSF
+typedef rt_mem_t rt_tlsf_t;
+#endif /* RT_USING_TLSF */
+
 #ifdef RT_USING_MEMHEAP
 /**
  * memory item on the heap
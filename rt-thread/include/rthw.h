@@ -88,6 +88,11 @@ void rt_hw_cpu_shutdown(void);
 
 const char *rt_hw_cpu_arch(void);
 
+#ifdef RT_DEBUGING_INIT_PROFILE
+rt_uint32_t rt_hw_init_cycles_get(void);
+rt_uint32_t rt_hw_init_cycles_freq(void);
+#endif /* RT_DEBUGING_INIT_PROFILE */
+
 rt_uint8_t *rt_hw_stack_init(void       *entry,
                              void       *parameter,
                              rt_uint8_t *stack_addr,
@@ -335,6 +335,17 @@ void *rt_slab_realloc(rt_slab_t m, void *ptr, rt_size_t size);
 void rt_slab_free(rt_slab_t m, void *ptr);
 #endif /* RT_USING_SLAB */
 
+#ifdef RT_USING_TLSF
+/**
+ * TLSF memory object interface
+ */
+rt_tlsf_t rt_tlsf_init(const char *name, void *begin_addr, rt_size_t size);
+rt_err_t rt_tlsf_detach(rt_tlsf_t m);
+void *rt_tlsf_alloc(rt_tlsf_t m, rt_size_t size);
+void *rt_tlsf_realloc(rt_tlsf_t m, void *rmem, rt_size_t newsize);
+void rt_tlsf_free(rt_tlsf_t m, void *rmem);
+#endif /* RT_USING_TLSF */
+
 /**@}*/
 
 /**
@@ -632,6 +643,9 @@ void rt_interrupt_leave_sethook(void (*hook)(void));
 #ifdef RT_USING_COMPONENTS_INIT
 void rt_components_init(void);
 void rt_components_board_init(void);
+#ifdef RT_DEBUGING_INIT_PROFILE
+void rt_components_init_mark(const char *name);
+#endif /* RT_DEBUGING_INIT_PROFILE */
 #endif /* RT_USING_COMPONENTS_INIT */
 
 /**
@@ -186,3 +186,14 @@ rt_atomic_t rt_hw_atomic_compare_exchange_strong(volatile rt_atomic_t *ptr, rt_a
     } while ((__STREXW(new, ptr)) != 0U);
     return (result == temp);
 }
+
+rt_atomic_t rt_hw_atomic_load_exclusive(volatile rt_atomic_t *ptr)
+{
+    return __LDREXW(ptr);
+}
+
+/* return 0 if the value is stored, 1 if the exclusive access has been lost */
+rt_atomic_t rt_hw_atomic_store_exclusive(volatile rt_atomic_t *ptr, rt_atomic_t val)
+{
+    return __STREXW(val, ptr);
+}
@@ -20,4 +20,10 @@ typedef union {
 } rt_hw_spinlock_t;
 #endif
 
+#ifdef RT_DEBUGING_IRQ_MASK
+void rt_hw_irqmask_systick_enter(void);
+void rt_hw_irqmask_reset(void);
+rt_size_t rt_hw_irqmask_dump(rt_uint32_t *buf, rt_size_t words);
+#endif
+
 #endif  /*CPUPORT_H__*/
@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-04-16     Lee          first version, profiler of the interrupt masked sections.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef RT_DEBUGING_IRQ_MASK
+
+/*
+ * These replace the weak rt_hw_interrupt_disable/rt_hw_interrupt_enable in
+ * context_*.S and time every outermost masked section with the DWT cycle
+ * counter, that is from a disable with interrupt enabled to the enable that
+ * enables it again.
+ *
+ * Sections are accounted to the return address of their disable in an open
+ * addressing table of RT_DEBUGING_IRQ_MASK_SITES entries; when the table is
+ * full they are only counted as lost. A section that ends with an exception
+ * other than PendSV pending has delayed that interrupt, the pending vector is
+ * recorded with it. When it is SysTick, the time since the SysTick reload is
+ * the tick latency caused by the section.
+ *
+ * rt_hw_irqmask_systick_enter, called first in SysTick_Handler, measures the
+ * real SysTick entry latency from the reload of the counter.
+ *
+ * The bookkeeping runs with interrupt disabled, after the end of the section
+ * is taken, so it lengthens the sections but is not part of the results.
+ * IAR has no intrinsic for the caller address, all sections go to address 0.
+ */
+
+#if (RT_DEBUGING_IRQ_MASK_SITES & (RT_DEBUGING_IRQ_MASK_SITES - 1)) != 0
+#error "RT_DEBUGING_IRQ_MASK_SITES must be a power of two"
+#endif
+
+#define DWT_CTRL                (*(volatile rt_uint32_t *)0xE0001000)
+#define DWT_CYCCNT              (*(volatile rt_uint32_t *)0xE0001004)
+#define DEMCR                   (*(volatile rt_uint32_t *)0xE000EDFC)
+#define SCB_ICSR                (*(volatile rt_uint32_t *)0xE000ED04)
+#define SYST_RVR                (*(volatile rt_uint32_t *)0xE000E014)
+#define SYST_CVR                (*(volatile rt_uint32_t *)0xE000E018)
+
+#define DEMCR_TRCENA            (1UL << 24)
+#define DWT_CTRL_CYCCNTENA      (1UL << 0)
+#define ICSR_VECTPENDING(icsr)  (((icsr) >> 12) & 0x1FF)
+#define ICSR_PENDSTSET          (1UL << 26)
+#define VECTOR_PENDSV           14
+
+#define IRQMASK_DUMP_MAGIC      0x4D515249  /* "IRQM" */
+#define IRQMASK_DUMP_VERSION    1
+#define IRQMASK_SHOW_MAX        16
+
+#if defined(__CC_ARM)
+static __inline rt_uint32_t _primask_get(void)
+{
+    register rt_uint32_t primask __asm("primask");
+    return primask;
+}
+static __inline void _primask_set(rt_uint32_t value)
+{
+    register rt_uint32_t primask __asm("primask");
+    primask = value;
+}
+#define _irq_disable()          __disable_irq()
+#define _caller_address()       ((rt_ubase_t)__return_address())
+#elif defined(__ICCARM__)
+#include <intrinsics.h>
+#define _primask_get()          __get_PRIMASK()
+#define _primask_set(value)     __set_PRIMASK(value)
+#define _irq_disable()          __disable_interrupt()
+#define _caller_address()       ((rt_ubase_t)0)
+#else
+rt_inline rt_uint32_t _primask_get(void)
+{
+    rt_uint32_t primask;
+    __asm volatile ("mrs %0, primask" : "=r" (primask));
+    return primask;
+}
+rt_inline void _primask_set(rt_uint32_t value)
+{
+    __asm volatile ("msr primask, %0" : : "r" (value) : "memory");
+}
+#define _irq_disable()          __asm volatile ("cpsid i" : : : "memory")
+#define _caller_address()       ((rt_ubase_t)__builtin_return_address(0))
+#endif
+
+struct irqmask_site
+{
+    rt_ubase_t  pc;                     /* return address of the disable, 0 for a free entry */
+    rt_uint32_t count;
+    rt_uint32_t max;
+    rt_uint64_t total;
+    rt_uint32_t delayed;                /* sections that ended with an interrupt pending */
+    rt_uint32_t vector;                 /* the last delayed exception number */
+};
+
+struct irqmask_prof
+{
+    /* the section in progress */
+    rt_uint32_t start;
+    rt_ubase_t  pc;
+
+    rt_uint32_t lost;
+    struct irqmask_site site[RT_DEBUGING_IRQ_MASK_SITES];
+
+    /* SysTick latency caused by a section, and the section */
+    rt_uint32_t tick_masked_max;
+    rt_ubase_t  tick_masked_pc;
+
+    /* SysTick entry latency */
+    rt_uint32_t tick_count;
+    rt_uint32_t tick_max;
+    rt_uint64_t tick_total;
+};
+
+static struct irqmask_prof irqmask;
+
+static void _irqmask_record(rt_ubase_t pc, rt_uint32_t cycles)
+{
+    struct irqmask_site *site;
+    rt_uint32_t index = (rt_uint32_t)(pc >> 1);
+    rt_uint32_t icsr = SCB_ICSR;
+    rt_uint32_t vector = ICSR_VECTPENDING(icsr);
+    rt_uint32_t latency;
+    rt_uint32_t probe;
+
+    for (probe = 0; probe < RT_DEBUGING_IRQ_MASK_SITES; probe ++, index ++)
+    {
+        site = &irqmask.site[index & (RT_DEBUGING_IRQ_MASK_SITES - 1)];
+        if (site->pc == pc || site->count == 0)
+        {
+            break;
+        }
+    }
+    if (probe == RT_DEBUGING_IRQ_MASK_SITES)
+    {
+        irqmask.lost ++;
+        return;
+    }
+
+    site->pc = pc;
+    site->count ++;
+    site->total += cycles;
+    if (cycles > site->max)
+    {
+        site->max = cycles;
+    }
+
+    if (vector != 0 && vector != VECTOR_PENDSV)
+    {
+        site->delayed ++;
+        site->vector = vector;
+    }
+
+    if (icsr & ICSR_PENDSTSET)
+    {
+        latency = SYST_RVR - SYST_CVR;
+        if (latency > irqmask.tick_masked_max)
+        {
+            irqmask.tick_masked_max = latency;
+            irqmask.tick_masked_pc = pc;
+        }
+    }
+}
+
+rt_base_t rt_hw_interrupt_disable(void)
+{
+    rt_uint32_t level = _primask_get();
+
+    _irq_disable();
+    if (level == 0)
+    {
+        irqmask.start = DWT_CYCCNT;
+        irqmask.pc = _caller_address();
+    }
+
+    return (rt_base_t)level;
+}
+
+void rt_hw_interrupt_enable(rt_base_t level)
+{
+    rt_uint32_t cycles;
+
+    /* only the enable that ends a section, the nested ones keep interrupt disabled */
+    if (level == 0 && _primask_get() != 0)
+    {
+        cycles = DWT_CYCCNT - irqmask.start;
+        _irqmask_record(irqmask.pc, cycles);
+    }
+    _primask_set((rt_uint32_t)level);
+}
+
+/**
+ * This function measures the SysTick entry latency, call it first in SysTick_Handler.
+ */
+void rt_hw_irqmask_systick_enter(void)
+{
+    /* the counter counts down from the reload value since the interrupt was raised */
+    rt_uint32_t latency = SYST_RVR - SYST_CVR;
+
+    irqmask.tick_count ++;
+    irqmask.tick_total += latency;
+    if (latency > irqmask.tick_max)
+    {
+        irqmask.tick_max = latency;
+    }
+}
+
+/**
+ * This function clears the results.
+ */
+void rt_hw_irqmask_reset(void)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+
+    rt_memset(&irqmask.lost, 0, sizeof(irqmask) - ((rt_ubase_t)&irqmask.lost - (rt_ubase_t)&irqmask));
+    /* the section of this function is recorded again when it ends */
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function copies the results as 32-bit words:
+ * magic, version, sites, lost, tick count, tick max, tick total (low, high),
+ * tick masked max, tick masked pc, then for every used site:
+ * pc, count, max, total (low, high), delayed, vector.
+ *
+ * @param buf is the destination.
+ *
+ * @param words is the size of buf in words.
+ *
+ * @return the copied words, the sites that do not fit are left out.
+ */
+rt_size_t rt_hw_irqmask_dump(rt_uint32_t *buf, rt_size_t words)
+{
+    struct irqmask_site site;
+    rt_base_t level;
+    rt_size_t count = 0;
+    rt_size_t i;
+
+    if (words < 10)
+    {
+        return 0;
+    }
+
+    level = rt_hw_interrupt_disable();
+    buf[count ++] = IRQMASK_DUMP_MAGIC;
+    buf[count ++] = IRQMASK_DUMP_VERSION;
+    buf[count ++] = 0;
+    buf[count ++] = irqmask.lost;
+    buf[count ++] = irqmask.tick_count;
+    buf[count ++] = irqmask.tick_max;
+    buf[count ++] = (rt_uint32_t)irqmask.tick_total;
+    buf[count ++] = (rt_uint32_t)(irqmask.tick_total >> 32);
+    buf[count ++] = irqmask.tick_masked_max;
+    buf[count ++] = (rt_uint32_t)irqmask.tick_masked_pc;
+    rt_hw_interrupt_enable(level);
+
+    for (i = 0; i < RT_DEBUGING_IRQ_MASK_SITES && count + 7 <= words; i ++)
+    {
+        level = rt_hw_interrupt_disable();
+        site = irqmask.site[i];
+        rt_hw_interrupt_enable(level);
+        if (site.count == 0)
+        {
+            continue;
+        }
+
+        buf[count ++] = (rt_uint32_t)site.pc;
+        buf[count ++] = site.count;
+        buf[count ++] = site.max;
+        buf[count ++] = (rt_uint32_t)site.total;
+        buf[count ++] = (rt_uint32_t)(site.total >> 32);
+        buf[count ++] = site.delayed;
+        buf[count ++] = site.vector;
+        buf[2] ++;
+    }
+
+    return count;
+}
+
+static int rt_hw_irqmask_init(void)
+{
+    /* only the differences are used, the counter is not cleared for the other users */
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+
+    return 0;
+}
+INIT_BOARD_EXPORT(rt_hw_irqmask_init);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void _irqmask_show(void)
+{
+    struct irqmask_site *site;
+    struct irqmask_site *next;
+    rt_uint32_t limit = RT_UINT32_MAX;
+    rt_ubase_t limit_pc = 0;
+    rt_size_t shown;
+    rt_size_t i;
+
+    rt_kprintf("masked sections by longest, cycles (addr2line -f -e rtthread.elf <pc>)\n");
+    rt_kprintf("pc         count      max        avg        delayed irq\n");
+    /* the table is read live, sorted by max then pc without copying it */
+    for (shown = 0; shown < IRQMASK_SHOW_MAX; shown ++)
+    {
+        next = RT_NULL;
+        for (i = 0; i < RT_DEBUGING_IRQ_MASK_SITES; i ++)
+        {
+            site = &irqmask.site[i];
+            if (site->count == 0 || site->max > limit || (site->max == limit && site->pc >= limit_pc))
+            {
+                continue;
+            }
+            if (next == RT_NULL || site->max > next->max || (site->max == next->max && site->pc > next->pc))
+            {
+                next = site;
+            }
+        }
+        if (next == RT_NULL)
+        {
+            break;
+        }
+        limit = next->max;
+        limit_pc = next->pc;
+
+        rt_kprintf("0x%08x %-10u %-10u %-10u %-7u", (rt_uint32_t)next->pc, next->count, next->max,
+                   (rt_uint32_t)(next->total / next->count), next->delayed);
+        if (next->delayed != 0)
+        {
+            /* external interrupts are numbered as IRQn, the system exceptions as negative numbers */
+            rt_kprintf(" %d", (int)next->vector - 16);
+        }
+        rt_kprintf("\n");
+    }
+    rt_kprintf("sections of sites not in the table: %u\n", irqmask.lost);
+    rt_kprintf("systick entry latency: max %u avg %u cycles over %u ticks\n", irqmask.tick_max,
+               irqmask.tick_count ? (rt_uint32_t)(irqmask.tick_total / irqmask.tick_count) : 0, irqmask.tick_count);
+    rt_kprintf("systick delayed by a section: max %u cycles at 0x%08x\n", irqmask.tick_masked_max,
+               (rt_uint32_t)irqmask.tick_masked_pc);
+}
+
+/* print the results as hex text lines, irqmask_decode.py reads them from a terminal capture */
+static void _irqmask_dump(void)
+{
+    rt_uint32_t *buf;
+    rt_size_t words = 10 + 7 * RT_DEBUGING_IRQ_MASK_SITES;
+    rt_size_t count;
+    rt_size_t i;
+
+    buf = rt_malloc(words * sizeof(rt_uint32_t));
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("no memory for the dump\n");
+        return;
+    }
+
+    count = rt_hw_irqmask_dump(buf, words);
+    for (i = 0; i < count; i ++)
+    {
+        if (i % 8 == 0)
+        {
+            rt_kprintf(i == 0 ? "IRQM" : "\nIRQM");
+        }
+        rt_kprintf(" %08x", buf[i]);
+    }
+    rt_kprintf("\n");
+
+    rt_free(buf);
+}
+
+static void irqmask_cmd(int argc, char **argv)
+{
+    if (argc == 1)
+    {
+        _irqmask_show();
+    }
+    else if (argc == 2 && rt_strcmp(argv[1], "-r") == 0)
+    {
+        rt_hw_irqmask_reset();
+    }
+    else if (argc == 2 && rt_strcmp(argv[1], "-d") == 0)
+    {
+        _irqmask_dump();
+    }
+    else
+    {
+        rt_kprintf("usage: irqmask [-r | -d]\n");
+        rt_kprintf("  without option, show the longest interrupt masked sections\n");
+        rt_kprintf("  -r  reset the results\n");
+        rt_kprintf("  -d  dump the results as hex lines for irqmask_decode.py\n");
+    }
+}
+MSH_CMD_EXPORT_ALIAS(irqmask_cmd, irqmask, profile of the interrupt masked sections);
+#endif /* RT_USING_FINSH */
+
+#endif /* RT_DEBUGING_IRQ_MASK */
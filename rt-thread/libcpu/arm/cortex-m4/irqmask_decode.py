@@ -0,0 +1,106 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) 2006-2023, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Change Logs:
+# Date           Author       Notes
+# 2025-04-16     Lee          the first version
+#
+# Decode the "irqmask -d" dump (RT_DEBUGING_IRQ_MASK) with the firmware ELF file.
+#
+# usage: python irqmask_decode.py rtthread.elf capture.txt [core clock in MHz]
+#
+# capture.txt is a terminal capture holding the "IRQM ..." lines, other lines are ignored.
+# The call sites are shown as function+offset, sorted by the longest section.
+#
+import struct
+import sys
+
+MAGIC = 0x4D515249
+HEAD_WORDS = 10
+SITE_WORDS = 7
+
+SHT_SYMTAB = 2
+STT_FUNC = 2
+
+
+def load_functions(path):
+    """the function symbols of a 32-bit little-endian ELF file as (start, size, name)"""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+        raise ValueError('%s: not a 32-bit little-endian ELF file' % path)
+
+    def cstr(offset):
+        return data[offset:data.index(b'\0', offset)].decode('utf-8', 'replace')
+
+    shoff, = struct.unpack_from('<I', data, 0x20)
+    shentsize, shnum = struct.unpack_from('<HH', data, 0x2E)
+    headers = [struct.unpack_from('<IIIIIIIIII', data, shoff + i * shentsize) for i in range(shnum)]
+    functions = []
+    for _, sh_type, _, _, offset, size, link, _, _, entsize in headers:
+        if sh_type != SHT_SYMTAB:
+            continue
+        strtab = headers[link][4]
+        for i in range(size // entsize):
+            name, value, sym_size, info = struct.unpack_from('<IIIB', data, offset + i * entsize)
+            if info & 0xF == STT_FUNC:
+                functions.append((value & ~1, sym_size, cstr(strtab + name)))
+    return functions
+
+
+def site_name(functions, pc):
+    # the return address is after the call, look up the call instruction itself
+    addr = (pc & ~1) - 2
+    for start, size, name in functions:
+        if start <= addr < start + max(size, 1):
+            return '%s+0x%x' % (name, (pc & ~1) - start)
+    return '0x%08x' % pc
+
+
+def load_words(path):
+    words = []
+    with open(path, 'rb') as f:
+        for line in f.read().decode('utf-8', 'replace').splitlines():
+            fields = line.split()
+            if 'IRQM' in fields:
+                words += [int(word, 16) for word in fields[fields.index('IRQM') + 1:]]
+    return words
+
+
+def main():
+    if len(sys.argv) not in (3, 4):
+        print('usage: python irqmask_decode.py rtthread.elf capture.txt [core clock in MHz]')
+        sys.exit(1)
+    functions = load_functions(sys.argv[1])
+    words = load_words(sys.argv[2])
+    mhz = float(sys.argv[3]) if len(sys.argv) == 4 else None
+
+    if len(words) < HEAD_WORDS or words[0] != MAGIC:
+        raise ValueError('no irqmask dump found in %s' % sys.argv[2])
+    _, version, sites, lost, tick_count, tick_max, total_lo, total_hi, masked_max, masked_pc = words[:HEAD_WORDS]
+
+    def cycles(value):
+        return '%d' % value if mhz is None else '%d (%.1f us)' % (value, value / mhz)
+
+    records = []
+    for i in range(sites):
+        base = HEAD_WORDS + i * SITE_WORDS
+        pc, count, max_cycles, lo, hi, delayed, vector = words[base:base + SITE_WORDS]
+        records.append((max_cycles, pc, count, (hi << 32 | lo) // max(count, 1), delayed, vector))
+
+    print('%-40s %10s %20s %20s %8s %s' % ('call site', 'count', 'max', 'avg', 'delayed', 'irq'))
+    for max_cycles, pc, count, avg, delayed, vector in sorted(records, reverse=True):
+        print('%-40s %10d %20s %20s %8d %s' % (site_name(functions, pc), count, cycles(max_cycles), cycles(avg),
+                                             delayed, vector - 16 if delayed else ''))
+    print('sections of sites not in the table: %d' % lost)
+    if tick_count:
+        print('systick entry latency: max %s avg %s over %d ticks' % (
+            cycles(tick_max), cycles((total_hi << 32 | total_lo) // tick_count), tick_count))
+    print('systick delayed by a section: max %s at %s' % (cycles(masked_max), site_name(functions, masked_pc)))
+
+
+if __name__ == '__main__':
+    main()
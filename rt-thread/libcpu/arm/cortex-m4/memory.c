@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-04-16     Lee          first version, rt_memcpy/rt_memset/rt_memmove for Cortex-M4.
+ */
+
+#include <rtthread.h>
+
+#ifdef RT_KSERVICE_USING_ARCH_MEMORY
+
+/*
+ * These replace the weak generic versions in src/kservice.c.
+ *
+ * The destination is aligned to a word first, then the bulk is moved in
+ * 32-byte bursts (one LDM/STM pair of 8 registers), then in words, then the
+ * tail in bytes. When the source is not aligned the same way as the
+ * destination, aligned source words are merged with shifts, so no unaligned
+ * access is made and CCR.UNALIGN_TRP may be set.
+ *
+ * GCC and armclang use inline assembly for the bursts; the other compilers
+ * get an unrolled word loop, which armcc and IAR turn into LDM/STM as well.
+ */
+
+#define MEMORY_WORD_SIZE        (sizeof(rt_uint32_t))
+#define MEMORY_WORD_MASK        (MEMORY_WORD_SIZE - 1)
+#define MEMORY_BURST_SIZE       (8 * MEMORY_WORD_SIZE)
+/* below this the alignment fix-up costs more than it saves */
+#define MEMORY_SMALL_SIZE       8
+/* word aligned copies of this size take a straight path, e.g. struct rt_can_msg */
+#define MEMORY_FAST_SIZE        16
+
+#if defined(__GNUC__) && defined(__ARM_ARCH_7EM__)
+#define MEMORY_USING_ASM_BURST
+#endif
+
+/* copy count bursts, advancing both pointers */
+rt_inline void memory_copy_burst(rt_uint32_t **dst, const rt_uint32_t **src, rt_ubase_t count)
+{
+    rt_uint32_t *d = *dst;
+    const rt_uint32_t *s = *src;
+
+#ifdef MEMORY_USING_ASM_BURST
+    /* r7 is left out, it is the frame pointer in Thumb debug builds */
+    __asm volatile(
+        "1:                                         \n"
+        "   ldmia   %[s]!, {r2-r6, r8, r10, r12}    \n"
+        "   stmia   %[d]!, {r2-r6, r8, r10, r12}    \n"
+        "   subs    %[n], %[n], #1                  \n"
+        "   bne     1b                              \n"
+        : [d] "+r" (d), [s] "+r" (s), [n] "+r" (count)
+        :
+        : "r2", "r3", "r4", "r5", "r6", "r8", "r10", "r12", "cc", "memory");
+#else
+    while (count--)
+    {
+        rt_uint32_t w0 = s[0], w1 = s[1], w2 = s[2], w3 = s[3];
+        rt_uint32_t w4 = s[4], w5 = s[5], w6 = s[6], w7 = s[7];
+
+        d[0] = w0; d[1] = w1; d[2] = w2; d[3] = w3;
+        d[4] = w4; d[5] = w5; d[6] = w6; d[7] = w7;
+        d += 8;
+        s += 8;
+    }
+#endif /* MEMORY_USING_ASM_BURST */
+
+    *dst = d;
+    *src = s;
+}
+
+/* fill count bursts with word, advancing the pointer */
+rt_inline void memory_set_burst(rt_uint32_t **dst, rt_uint32_t word, rt_ubase_t count)
+{
+    rt_uint32_t *d = *dst;
+
+#ifdef MEMORY_USING_ASM_BURST
+    __asm volatile(
+        "   mov     r2, %[w]                        \n"
+        "   mov     r3, %[w]                        \n"
+        "   mov     r4, %[w]                        \n"
+        "   mov     r5, %[w]                        \n"
+        "   mov     r6, %[w]                        \n"
+        "   mov     r8, %[w]                        \n"
+        "   mov     r10, %[w]                       \n"
+        "   mov     r12, %[w]                       \n"
+        "1:                                         \n"
+        "   stmia   %[d]!, {r2-r6, r8, r10, r12}    \n"
+        "   subs    %[n], %[n], #1                  \n"
+        "   bne     1b                              \n"
+        : [d] "+r" (d), [n] "+r" (count)
+        : [w] "r" (word)
+        : "r2", "r3", "r4", "r5", "r6", "r8", "r10", "r12", "cc", "memory");
+#else
+    while (count--)
+    {
+        d[0] = word; d[1] = word; d[2] = word; d[3] = word;
+        d[4] = word; d[5] = word; d[6] = word; d[7] = word;
+        d += 8;
+    }
+#endif /* MEMORY_USING_ASM_BURST */
+
+    *dst = d;
+}
+
+/*
+ * copy count words to an aligned destination from a source that is offset
+ * bytes (1..3) past a word boundary; only the words holding source bytes
+ * are read
+ */
+rt_inline void memory_copy_shift(rt_uint32_t *d, const rt_uint8_t *src, rt_ubase_t count)
+{
+    const rt_uint32_t *s = (const rt_uint32_t *)((rt_ubase_t)src & ~MEMORY_WORD_MASK);
+    rt_uint32_t right = ((rt_ubase_t)src & MEMORY_WORD_MASK) * 8;
+    rt_uint32_t left = 32 - right;
+    rt_uint32_t low = *s++;
+    rt_uint32_t high;
+
+    while (count--)
+    {
+        high = *s++;
+        *d++ = (low >> right) | (high << left);
+        low = high;
+    }
+}
+
+/**
+ * @brief  This function will set the content of memory to specified value.
+ *
+ * @param  s is the address of source memory, point to the memory block to be filled.
+ *
+ * @param  c is the value to be set.
+ *
+ * @param  count number of bytes to be set.
+ *
+ * @return The address of source memory.
+ */
+void *rt_memset(void *s, int c, rt_ubase_t count)
+{
+    rt_uint8_t *ptr = (rt_uint8_t *)s;
+    rt_uint8_t byte = (rt_uint8_t)c;
+    rt_uint32_t *aligned;
+    rt_uint32_t word;
+
+    if (count >= MEMORY_SMALL_SIZE)
+    {
+        while ((rt_ubase_t)ptr & MEMORY_WORD_MASK)
+        {
+            *ptr++ = byte;
+            count--;
+        }
+
+        word = byte * 0x01010101UL;
+        aligned = (rt_uint32_t *)ptr;
+        if (count >= MEMORY_BURST_SIZE)
+        {
+            memory_set_burst(&aligned, word, count / MEMORY_BURST_SIZE);
+            count %= MEMORY_BURST_SIZE;
+        }
+        while (count >= MEMORY_WORD_SIZE)
+        {
+            *aligned++ = word;
+            count -= MEMORY_WORD_SIZE;
+        }
+        ptr = (rt_uint8_t *)aligned;
+    }
+
+    while (count--)
+    {
+        *ptr++ = byte;
+    }
+
+    return s;
+}
+
+/**
+ * @brief  This function will copy memory content from source address to destination address.
+ *
+ * @param  dst is the address of destination memory, points to the copied content.
+ *
+ * @param  src  is the address of source memory, pointing to the data source to be copied.
+ *
+ * @param  count is the copied length.
+ *
+ * @return The address of destination memory
+ */
+void *rt_memcpy(void *dst, const void *src, rt_ubase_t count)
+{
+    rt_uint8_t *d = (rt_uint8_t *)dst;
+    const rt_uint8_t *s = (const rt_uint8_t *)src;
+    rt_uint32_t *aligned_d;
+    const rt_uint32_t *aligned_s;
+
+    if (count == MEMORY_FAST_SIZE && (((rt_ubase_t)d | (rt_ubase_t)s) & MEMORY_WORD_MASK) == 0)
+    {
+        aligned_d = (rt_uint32_t *)d;
+        aligned_s = (const rt_uint32_t *)s;
+        aligned_d[0] = aligned_s[0];
+        aligned_d[1] = aligned_s[1];
+        aligned_d[2] = aligned_s[2];
+        aligned_d[3] = aligned_s[3];
+
+        return dst;
+    }
+
+    if (count >= MEMORY_SMALL_SIZE)
+    {
+        while ((rt_ubase_t)d & MEMORY_WORD_MASK)
+        {
+            *d++ = *s++;
+            count--;
+        }
+
+        aligned_d = (rt_uint32_t *)d;
+        if (((rt_ubase_t)s & MEMORY_WORD_MASK) == 0)
+        {
+            aligned_s = (const rt_uint32_t *)s;
+            if (count >= MEMORY_BURST_SIZE)
+            {
+                memory_copy_burst(&aligned_d, &aligned_s, count / MEMORY_BURST_SIZE);
+                count %= MEMORY_BURST_SIZE;
+            }
+            while (count >= MEMORY_WORD_SIZE)
+            {
+                *aligned_d++ = *aligned_s++;
+                count -= MEMORY_WORD_SIZE;
+            }
+            d = (rt_uint8_t *)aligned_d;
+            s = (const rt_uint8_t *)aligned_s;
+        }
+        else
+        {
+            memory_copy_shift(aligned_d, s, count / MEMORY_WORD_SIZE);
+            d += count & ~MEMORY_WORD_MASK;
+            s += count & ~MEMORY_WORD_MASK;
+            count &= MEMORY_WORD_MASK;
+        }
+    }
+
+    while (count--)
+    {
+        *d++ = *s++;
+    }
+
+    return dst;
+}
+
+/**
+ * @brief  This function will move memory content from source address to destination
+ * address. If the destination memory does not overlap with the source memory,
+ * the function is the same as memcpy().
+ *
+ * @param  dest is the address of destination memory, points to the copied content.
+ *
+ * @param  src is the address of source memory, point to the data source to be copied.
+ *
+ * @param  n is the copied length.
+ *
+ * @return The address of destination memory.
+ */
+void *rt_memmove(void *dest, const void *src, rt_size_t n)
+{
+    rt_uint8_t *d = (rt_uint8_t *)dest;
+    const rt_uint8_t *s = (const rt_uint8_t *)src;
+    rt_uint32_t *aligned_d;
+    const rt_uint32_t *aligned_s;
+
+    /* a forward copy reads every byte before it is overwritten unless dest is inside src */
+    if (d <= s || d >= s + n)
+    {
+        return rt_memcpy(dest, src, n);
+    }
+
+    d += n;
+    s += n;
+    if (n >= MEMORY_SMALL_SIZE)
+    {
+        while ((rt_ubase_t)d & MEMORY_WORD_MASK)
+        {
+            *--d = *--s;
+            n--;
+        }
+
+        if (((rt_ubase_t)s & MEMORY_WORD_MASK) == 0)
+        {
+            aligned_d = (rt_uint32_t *)d;
+            aligned_s = (const rt_uint32_t *)s;
+            while (n >= MEMORY_WORD_SIZE)
+            {
+                *--aligned_d = *--aligned_s;
+                n -= MEMORY_WORD_SIZE;
+            }
+            d = (rt_uint8_t *)aligned_d;
+            s = (const rt_uint8_t *)aligned_s;
+        }
+    }
+
+    while (n--)
+    {
+        *--d = *--s;
+    }
+
+    return dest;
+}
+
+#endif /* RT_KSERVICE_USING_ARCH_MEMORY */
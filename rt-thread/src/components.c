@@ -45,6 +45,8 @@
  *
  * rti_end           --> 6.end
  *
+ * DEFERRED_EXPORT   --> 8.1, run in a thread (RT_USING_COMPONENTS_DEFERRED_INIT)
+ *
  * These automatically initialization, the driver or component initial function must
  * be defined with:
  * INIT_BOARD_EXPORT(fn);
@@ -77,57 +79,215 @@ static int rti_end(void)
 }
 INIT_EXPORT(rti_end, "6.end");
 
+#ifdef RT_USING_COMPONENTS_DEFERRED_INIT
+static int rti_deferred_start(void)
+{
+    return 0;
+}
+INIT_EXPORT(rti_deferred_start, "8.0");
+
+static int rti_deferred_end(void)
+{
+    return 0;
+}
+INIT_EXPORT(rti_deferred_end, "8.end");
+#endif /* RT_USING_COMPONENTS_DEFERRED_INIT */
+
+#ifdef RT_DEBUGING_INIT_PROFILE
+struct rt_init_record
+{
+    const char *name;
+    rt_uint32_t start;
+    rt_uint32_t cycles;
+    rt_int16_t result;
+    char stage;                 /* 'B'oard, 'C'omponents, 'D'eferred or 'M'ark */
+};
+
+static struct rt_init_record _init_record[RT_DEBUGING_INIT_PROFILE_RECORDS];
+static rt_uint16_t _init_record_count;
+static rt_uint16_t _init_record_lost;
+
 /**
- * @brief  Onboard components initialization. In this function, the board-level
- *         initialization function will be called to complete the initialization
- *         of the on-board peripherals.
+ * @brief  The cycle counter for the initialization profile. The BSP overrides it with a
+ *         free running counter started by its first call, the default one counts OS ticks.
  */
-void rt_components_board_init(void)
+rt_weak rt_uint32_t rt_hw_init_cycles_get(void)
+{
+    return (rt_uint32_t)rt_tick_get();
+}
+
+/**
+ * @brief  The frequency of rt_hw_init_cycles_get in Hz.
+ */
+rt_weak rt_uint32_t rt_hw_init_cycles_freq(void)
+{
+    return RT_TICK_PER_SECOND;
+}
+
+static void _rt_init_record(char stage, const char *name, rt_uint32_t start, rt_uint32_t cycles, int result)
+{
+    struct rt_init_record *record;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (_init_record_count < RT_DEBUGING_INIT_PROFILE_RECORDS)
+    {
+        record = &_init_record[_init_record_count++];
+        record->name = name;
+        record->start = start;
+        record->cycles = cycles;
+        record->result = (rt_int16_t)result;
+        record->stage = stage;
+    }
+    else
+    {
+        _init_record_lost++;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief  Record a boot milestone in the initialization profile, such as the first frame
+ *         on a display. The name must stay valid, a string literal is fine.
+ *
+ * @param  name is the name of the milestone.
+ */
+void rt_components_init_mark(const char *name)
+{
+    _rt_init_record('M', name, rt_hw_init_cycles_get(), 0, 0);
+}
+#endif /* RT_DEBUGING_INIT_PROFILE */
+
+#if defined(RT_DEBUGING_INIT) || defined(RT_DEBUGING_INIT_PROFILE)
+static void _rt_init_call(char stage, const struct rt_init_desc *desc, const struct rt_init_desc *desc_end)
 {
-#ifdef RT_DEBUGING_INIT
     int result;
-    const struct rt_init_desc *desc;
-    for (desc = &__rt_init_desc_rti_board_start; desc < &__rt_init_desc_rti_board_end; desc ++)
+#ifdef RT_DEBUGING_INIT_PROFILE
+    rt_uint32_t start;
+#endif /* RT_DEBUGING_INIT_PROFILE */
+
+    for (; desc < desc_end; desc ++)
     {
+#ifdef RT_DEBUGING_INIT
         rt_kprintf("initialize %s", desc->fn_name);
+#endif /* RT_DEBUGING_INIT */
+#ifdef RT_DEBUGING_INIT_PROFILE
+        start = rt_hw_init_cycles_get();
         result = desc->fn();
+        _rt_init_record(stage, desc->fn_name, start, rt_hw_init_cycles_get() - start, result);
+#else
+        result = desc->fn();
+#endif /* RT_DEBUGING_INIT_PROFILE */
+#ifdef RT_DEBUGING_INIT
         rt_kprintf(":%d done\n", result);
+#endif /* RT_DEBUGING_INIT */
     }
+}
+#define RT_INIT_CALL(stage, start, end) _rt_init_call(stage, &__rt_init_desc_##start, &__rt_init_desc_##end)
 #else
-    volatile const init_fn_t *fn_ptr;
-
-    for (fn_ptr = &__rt_init_rti_board_start; fn_ptr < &__rt_init_rti_board_end; fn_ptr++)
+static void _rt_init_call(volatile const init_fn_t *fn_ptr, volatile const init_fn_t *fn_end)
+{
+    for (; fn_ptr < fn_end; fn_ptr ++)
     {
         (*fn_ptr)();
     }
-#endif /* RT_DEBUGING_INIT */
 }
+#define RT_INIT_CALL(stage, start, end) _rt_init_call(&__rt_init_##start, &__rt_init_##end)
+#endif /* defined(RT_DEBUGING_INIT) || defined(RT_DEBUGING_INIT_PROFILE) */
+
+/**
+ * @brief  Onboard components initialization. In this function, the board-level
+ *         initialization function will be called to complete the initialization
+ *         of the on-board peripherals.
+ */
+void rt_components_board_init(void)
+{
+    RT_INIT_CALL('B', rti_board_start, rti_board_end);
+}
+
+#ifdef RT_USING_COMPONENTS_DEFERRED_INIT
+static void _rt_components_deferred_entry(void *parameter)
+{
+    RT_INIT_CALL('D', rti_deferred_start, rti_deferred_end);
+}
+#endif /* RT_USING_COMPONENTS_DEFERRED_INIT */
 
 /**
  * @brief  RT-Thread Components Initialization.
+ *
+ * @note   The DEFERRED_EXPORT functions are started in a low priority thread at the end,
+ *         they run when the threads of the application leave the CPU idle.
  */
 void rt_components_init(void)
 {
-#ifdef RT_DEBUGING_INIT
-    int result;
-    const struct rt_init_desc *desc;
+#ifdef RT_USING_COMPONENTS_DEFERRED_INIT
+#ifdef RT_USING_HEAP
+    rt_thread_t tid;
+#endif /* RT_USING_HEAP */
+#endif /* RT_USING_COMPONENTS_DEFERRED_INIT */
 
+#ifdef RT_DEBUGING_INIT
     rt_kprintf("do components initialization.\n");
-    for (desc = &__rt_init_desc_rti_board_end; desc < &__rt_init_desc_rti_end; desc ++)
+#endif /* RT_DEBUGING_INIT */
+    RT_INIT_CALL('C', rti_board_end, rti_end);
+
+#ifdef RT_USING_COMPONENTS_DEFERRED_INIT
+#ifdef RT_USING_HEAP
+    tid = rt_thread_create("deferred", _rt_components_deferred_entry, RT_NULL,
+                           RT_DEFERRED_INIT_THREAD_STACK_SIZE, RT_DEFERRED_INIT_THREAD_PRIORITY, 20);
+    if (tid != RT_NULL)
     {
-        rt_kprintf("initialize %s", desc->fn_name);
-        result = desc->fn();
-        rt_kprintf(":%d done\n", result);
+        rt_thread_startup(tid);
+        return;
     }
-#else
-    volatile const init_fn_t *fn_ptr;
+#endif /* RT_USING_HEAP */
+    /* no thread for them, run them now */
+    _rt_components_deferred_entry(RT_NULL);
+#endif /* RT_USING_COMPONENTS_DEFERRED_INIT */
+}
 
-    for (fn_ptr = &__rt_init_rti_board_end; fn_ptr < &__rt_init_rti_end; fn_ptr ++)
+#if defined(RT_DEBUGING_INIT_PROFILE) && defined(RT_USING_FINSH)
+static rt_uint32_t _init_cycles_to_us(rt_uint32_t cycles)
+{
+    return (rt_uint32_t)((rt_uint64_t)cycles * 1000000 / rt_hw_init_cycles_freq());
+}
+
+static int list_init(void)
+{
+    struct rt_init_record *record;
+    rt_uint16_t index;
+
+    if (_init_record_count == 0)
     {
-        (*fn_ptr)();
+        rt_kprintf("no initialization recorded\n");
+        return 0;
     }
-#endif /* RT_DEBUGING_INIT */
+
+    rt_kprintf("stage name                         start(us)  time(us)   result\n");
+    rt_kprintf("----- ---------------------------- ---------- ---------- ------\n");
+    for (index = 0; index < _init_record_count; index ++)
+    {
+        record = &_init_record[index];
+        rt_kprintf("%c     %-28.28s %-10u ", record->stage, record->name,
+                   _init_cycles_to_us(record->start - _init_record[0].start));
+        if (record->stage == 'M')
+        {
+            rt_kprintf("\n");
+        }
+        else
+        {
+            rt_kprintf("%-10u %d\n", _init_cycles_to_us(record->cycles), record->result);
+        }
+    }
+    if (_init_record_lost != 0)
+    {
+        rt_kprintf("%u not recorded, RT_DEBUGING_INIT_PROFILE_RECORDS is too small\n", _init_record_lost);
+    }
+
+    return 0;
 }
+MSH_CMD_EXPORT(list_init, list the time of the initialization functions and boot milestones);
+#endif /* defined(RT_DEBUGING_INIT_PROFILE) && defined(RT_USING_FINSH) */
 #endif /* RT_USING_COMPONENTS_INIT */
 
 #ifdef RT_USING_USER_MAIN
@@ -186,6 +346,10 @@ void main_thread_entry(void *parameter)
     rt_components_init();
 #endif /* RT_USING_COMPONENTS_INIT */
 
+#ifdef RT_DEBUGING_INIT_PROFILE
+    rt_components_init_mark("main");
+#endif /* RT_DEBUGING_INIT_PROFILE */
+
 #ifdef RT_USING_SMP
     rt_hw_secondary_cpu_up();
 #endif /* RT_USING_SMP */
@@ -237,6 +401,11 @@ int rtthread_startup(void)
 {
     rt_hw_interrupt_disable();
 
+#ifdef RT_DEBUGING_INIT_PROFILE
+    /* the time of the initialization profile starts here */
+    rt_components_init_mark("startup");
+#endif /* RT_DEBUGING_INIT_PROFILE */
+
     /* board level initialization
      * NOTE: please initialize heap inside board initialization.
      */
@@ -269,6 +438,10 @@ int rtthread_startup(void)
     rt_hw_spin_lock(&_cpus_lock);
 #endif /* RT_USING_SMP */
 
+#ifdef RT_DEBUGING_INIT_PROFILE
+    rt_components_init_mark("scheduler");
+#endif /* RT_DEBUGING_INIT_PROFILE */
+
     /* start scheduler */
     rt_system_scheduler_start();
 
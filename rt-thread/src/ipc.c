@@ -788,6 +788,117 @@ rt_inline rt_uint8_t _thread_get_mutex_priority(struct rt_thread* thread)
     return priority;
 }
 
+#ifdef RT_USING_MUTEX_FAST_PATH
+/*
+ * Uncontended fast path.
+ *
+ * A free mutex is taken by a compare-and-swap of its owner from RT_NULL to the
+ * current thread, without disabling interrupt. Such a mutex is not inserted into
+ * the taken object list of its owner; the first thread that has to wait for it
+ * inserts it under interrupt disabled (_mutex_fast_path_exit), and from then on
+ * the mutex goes through the slow path until the owner releases it, so priority
+ * inheritance works as before. A mutex with a priority ceiling always takes the
+ * slow path.
+ *
+ * The release clears the owner only if the mutex is still outside the taken
+ * object list. On Cortex-M the check is done between the exclusive load and the
+ * exclusive store of the owner; an exception clears the exclusive monitor, so a
+ * contender that preempted the owner in between makes the store fail.
+ */
+#if defined(ARCH_ARM_CORTEX_M) && defined(RT_USING_HW_ATOMIC)
+#define _MUTEX_RELEASE_EXCLUSIVE
+#endif
+
+/* the slow path is going to work on a mutex which may be taken by the fast path, interrupt is disabled */
+rt_inline void _mutex_fast_path_exit(struct rt_mutex *mutex)
+{
+    if (mutex->owner != RT_NULL && rt_list_isempty(&mutex->taken_list))
+    {
+        rt_list_insert_after(&mutex->owner->taken_object_list, &mutex->taken_list);
+    }
+}
+
+rt_inline rt_bool_t _mutex_fast_take(struct rt_mutex *mutex, struct rt_thread *thread)
+{
+    rt_atomic_t owner = 0;
+
+    if (mutex->owner == thread)
+    {
+        /* only the owner changes the hold of a taken mutex */
+        if (mutex->hold < RT_MUTEX_HOLD_MAX)
+        {
+            mutex->hold ++;
+            return RT_TRUE;
+        }
+
+        return RT_FALSE;
+    }
+
+    if (mutex->ceiling_priority != 0xFF)
+    {
+        return RT_FALSE;
+    }
+
+    if (!rt_atomic_compare_exchange_strong((volatile rt_atomic_t *)&mutex->owner, &owner, (rt_atomic_t)thread))
+    {
+        return RT_FALSE;
+    }
+    /* the priority of a free mutex is always 0xff */
+    mutex->hold = 1;
+
+    return RT_TRUE;
+}
+
+rt_inline rt_bool_t _mutex_fast_release(struct rt_mutex *mutex, struct rt_thread *thread)
+{
+#ifdef _MUTEX_RELEASE_EXCLUSIVE
+    volatile rt_atomic_t *owner = (volatile rt_atomic_t *)&mutex->owner;
+    rt_atomic_t value;
+#else
+    rt_base_t level;
+#endif /* _MUTEX_RELEASE_EXCLUSIVE */
+
+    if (mutex->owner != thread)
+    {
+        return RT_FALSE;
+    }
+
+    if (mutex->hold > 1)
+    {
+        mutex->hold --;
+        return RT_TRUE;
+    }
+
+    /* clear the hold first, the mutex may be taken by another thread right after the owner is cleared */
+    mutex->hold = 0;
+#ifdef _MUTEX_RELEASE_EXCLUSIVE
+    do
+    {
+        value = rt_hw_atomic_load_exclusive(owner);
+        if (!rt_list_isempty(&mutex->taken_list))
+        {
+            /* close the exclusive access */
+            rt_hw_atomic_store_exclusive(owner, value);
+            mutex->hold = 1;
+            return RT_FALSE;
+        }
+    } while (rt_hw_atomic_store_exclusive(owner, 0) != 0);
+#else
+    level = rt_hw_interrupt_disable();
+    if (!rt_list_isempty(&mutex->taken_list))
+    {
+        rt_hw_interrupt_enable(level);
+        mutex->hold = 1;
+        return RT_FALSE;
+    }
+    mutex->owner = RT_NULL;
+    rt_hw_interrupt_enable(level);
+#endif /* _MUTEX_RELEASE_EXCLUSIVE */
+
+    return RT_TRUE;
+}
+#endif /* RT_USING_MUTEX_FAST_PATH */
+
 /* update priority of target thread and the thread suspended it if any */
 rt_inline void _thread_update_priority(struct rt_thread *thread, rt_uint8_t priority, int suspend_flag)
 {
@@ -1017,6 +1128,9 @@ rt_uint8_t rt_mutex_setprioceiling(rt_mutex_t mutex, rt_uint8_t priority)
         mutex->ceiling_priority = priority;
         if (mutex->owner)
         {
+#ifdef RT_USING_MUTEX_FAST_PATH
+            _mutex_fast_path_exit(mutex);
+#endif /* RT_USING_MUTEX_FAST_PATH */
             rt_uint8_t priority = _thread_get_mutex_priority(mutex->owner);
             if (priority != mutex->owner->current_priority)
                 _thread_update_priority(mutex->owner, priority, RT_UNINTERRUPTIBLE);
@@ -1189,6 +1303,17 @@ static rt_err_t _rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout, int suspend
     /* get current thread */
     thread = rt_thread_self();
 
+#ifdef RT_USING_MUTEX_FAST_PATH
+    if (_mutex_fast_take(mutex, thread))
+    {
+        RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mutex->parent.parent)));
+        thread->error = RT_EOK;
+        RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mutex->parent.parent)));
+
+        return RT_EOK;
+    }
+#endif /* RT_USING_MUTEX_FAST_PATH */
+
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
@@ -1250,6 +1375,11 @@ static rt_err_t _rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout, int suspend
             {
                 rt_uint8_t priority = thread->current_priority;
 
+#ifdef RT_USING_MUTEX_FAST_PATH
+                /* the owner has to release it through the slow path from now on */
+                _mutex_fast_path_exit(mutex);
+#endif /* RT_USING_MUTEX_FAST_PATH */
+
                 /* mutex is unavailable, push to suspend list */
                 LOG_D("mutex_take: suspend thread: %s",
                       thread->parent.name);
@@ -1441,6 +1571,15 @@ rt_err_t rt_mutex_release(rt_mutex_t mutex)
     /* get current thread */
     thread = rt_thread_self();
 
+#ifdef RT_USING_MUTEX_FAST_PATH
+    if (_mutex_fast_release(mutex, thread))
+    {
+        RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mutex->parent.parent)));
+
+        return RT_EOK;
+    }
+#endif /* RT_USING_MUTEX_FAST_PATH */
+
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
@@ -19,6 +19,7 @@
  * 2021-08-15     supperthomas add the comment
  * 2022-01-07     Gabriel      Moving __on_rt_xxxxx_hook to timer.c
  * 2022-04-19     Stanley      Correct descriptions
+ * 2025-04-16     Lee          add the hierarchical timing wheel (RT_USING_TIMER_WHEEL)
  */
 
 #include <rtthread.h>
@@ -28,8 +29,48 @@
 #define DBG_LVL           DBG_INFO
 #include <rtdbg.h>
 
+#ifdef RT_USING_TIMER_WHEEL
+/*
+ * Hierarchical timing wheel: level 0 has one slot per tick, a slot of level n
+ * covers 2^(RT_TIMER_WHEEL_SLOT_BITS * n) ticks. A timer is linked by row[0]
+ * into the slot of its timeout tick on the lowest level that reaches it, so
+ * start and stop are O(1). Each processed tick expires one level 0 slot; when
+ * a level turns over, the next slot of the level above is cascaded (its
+ * timers are placed again, one level lower or more).
+ */
+#ifndef RT_TIMER_WHEEL_SLOT_BITS
+#define RT_TIMER_WHEEL_SLOT_BITS        6
+#endif /* RT_TIMER_WHEEL_SLOT_BITS */
+
+#ifndef RT_TIMER_WHEEL_LEVELS
+#define RT_TIMER_WHEEL_LEVELS           4
+#endif /* RT_TIMER_WHEEL_LEVELS */
+
+#define _WHEEL_SLOTS                    (1UL << RT_TIMER_WHEEL_SLOT_BITS)
+#define _WHEEL_MASK                     (_WHEEL_SLOTS - 1)
+/* ticks covered by one slot of the level */
+#define _WHEEL_SPAN(level)              ((rt_tick_t)1 << (RT_TIMER_WHEEL_SLOT_BITS * (level)))
+/* the farthest timeout the wheel holds directly, later ones are parked and placed again */
+#if RT_TIMER_WHEEL_SLOT_BITS * RT_TIMER_WHEEL_LEVELS >= 32
+#define _WHEEL_MAX_DELTA                (RT_TICK_MAX / 2)
+#else
+#define _WHEEL_MAX_DELTA                (_WHEEL_SPAN(RT_TIMER_WHEEL_LEVELS) - 1)
+#endif
+
+struct _timer_wheel
+{
+    rt_tick_t tick;                     /* the next tick to be processed */
+    rt_list_t slot[RT_TIMER_WHEEL_LEVELS][_WHEEL_SLOTS];
+};
+
+/* hard timer wheel */
+static struct _timer_wheel _timer_wheel;
+/* set while rt_timer_check catches up, interrupts are enabled between the ticks */
+static rt_uint8_t _timer_check_busy;
+#else
 /* hard timer list */
 static rt_list_t _timer_list[RT_TIMER_SKIP_LIST_LEVEL];
+#endif /* RT_USING_TIMER_WHEEL */
 
 #ifdef RT_USING_TIMER_SOFT
 
@@ -46,8 +87,13 @@ static rt_list_t _timer_list[RT_TIMER_SKIP_LIST_LEVEL];
 
 /* soft timer status */
 static rt_uint8_t _soft_timer_status = RT_SOFT_TIMER_IDLE;
+#ifdef RT_USING_TIMER_WHEEL
+/* soft timer wheel */
+static struct _timer_wheel _soft_timer_wheel;
+#else
 /* soft timer list */
 static rt_list_t _soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL];
+#endif /* RT_USING_TIMER_WHEEL */
 static struct rt_thread _timer_thread;
 rt_align(RT_ALIGN_SIZE)
 static rt_uint8_t _timer_thread_stack[RT_TIMER_THREAD_STACK_SIZE];
@@ -148,6 +194,152 @@ static void _timer_init(rt_timer_t timer,
     }
 }
 
+#ifdef RT_USING_TIMER_WHEEL
+/**
+ * @brief Initialize a timer wheel
+ *
+ * @param wheel is the timer wheel
+ */
+static void _timer_wheel_init(struct _timer_wheel *wheel)
+{
+    rt_size_t level, index;
+
+    for (level = 0; level < RT_TIMER_WHEEL_LEVELS; level++)
+    {
+        for (index = 0; index < _WHEEL_SLOTS; index++)
+        {
+            rt_list_init(&wheel->slot[level][index]);
+        }
+    }
+    wheel->tick = rt_tick_get();
+}
+
+/**
+ * @brief Link the timer into the slot of its timeout tick, O(1)
+ *
+ *        Timers already due go to the slot processed next, timers beyond
+ *        the wheel are parked in the farthest slot and placed again when
+ *        that slot is cascaded or expired.
+ *
+ * @param wheel is the timer wheel
+ *
+ * @param timer is the timer, its timeout_tick is set
+ */
+static void _timer_wheel_insert(struct _timer_wheel *wheel, rt_timer_t timer)
+{
+    rt_tick_t timeout_tick = timer->timeout_tick;
+    rt_tick_t delta = timeout_tick - wheel->tick;
+    rt_size_t level;
+
+    if (delta >= RT_TICK_MAX / 2)
+    {
+        timeout_tick = wheel->tick;
+        delta = 0;
+    }
+    else if (delta > _WHEEL_MAX_DELTA)
+    {
+        timeout_tick = wheel->tick + _WHEEL_MAX_DELTA;
+        delta = _WHEEL_MAX_DELTA;
+    }
+
+    for (level = 0; level < RT_TIMER_WHEEL_LEVELS - 1 && delta >= _WHEEL_SPAN(level + 1); level++);
+
+    /* insert to the tail, the timer started early is called early */
+    rt_list_insert_before(&wheel->slot[level][(timeout_tick >> (RT_TIMER_WHEEL_SLOT_BITS * level)) & _WHEEL_MASK],
+                          &(timer->row[0]));
+}
+
+/**
+ * @brief Process the next tick of the wheel: cascade the upper levels
+ *        that turn over and move the due level 0 slot to the expired list
+ *
+ * @param wheel is the timer wheel
+ *
+ * @param expired is the list the due timers are appended to
+ *
+ * @return the processed tick
+ */
+static rt_tick_t _timer_wheel_advance(struct _timer_wheel *wheel, rt_list_t *expired)
+{
+    rt_tick_t tick = wheel->tick;
+    rt_list_t *slot;
+    rt_size_t level;
+
+    for (level = 1; level < RT_TIMER_WHEEL_LEVELS && (tick & (_WHEEL_SPAN(level) - 1)) == 0; level++)
+    {
+        slot = &wheel->slot[level][(tick >> (RT_TIMER_WHEEL_SLOT_BITS * level)) & _WHEEL_MASK];
+        while (!rt_list_isempty(slot))
+        {
+            struct rt_timer *t = rt_list_entry(slot->next, struct rt_timer, row[0]);
+
+            rt_list_remove(&(t->row[0]));
+            _timer_wheel_insert(wheel, t);
+        }
+    }
+
+    wheel->tick = tick + 1;
+
+    slot = &wheel->slot[0][tick & _WHEEL_MASK];
+    if (!rt_list_isempty(slot))
+    {
+        slot->next->prev = expired->prev;
+        expired->prev->next = slot->next;
+        slot->prev->next = expired;
+        expired->prev = slot->prev;
+        rt_list_init(slot);
+    }
+
+    return tick;
+}
+
+/**
+ * @brief Find the earliest tick at which the wheel has work: a level 0
+ *        timeout or an upper level cascade
+ *
+ * @param wheel is the timer wheel
+ *
+ * @param timeout_tick is the next timer's ticks
+ *
+ * @return Return the operation status. If the return value is RT_EOK, the function is successfully executed.
+ *          If the return value is any other values, it means there is no timer.
+ */
+static rt_err_t _timer_wheel_next_timeout(struct _timer_wheel *wheel, rt_tick_t *timeout_tick)
+{
+    rt_tick_t base, next, candidate;
+    rt_size_t level, start, i;
+    rt_err_t result = -RT_ERROR;
+    rt_base_t irq_level;
+
+    irq_level = rt_hw_interrupt_disable();
+
+    next = wheel->tick + RT_TICK_MAX / 2;
+    for (level = 0; level < RT_TIMER_WHEEL_LEVELS; level++)
+    {
+        base = wheel->tick >> (RT_TIMER_WHEEL_SLOT_BITS * level);
+        /* unless the level turns over at the next tick, its current slot holds the next round */
+        start = (wheel->tick & (_WHEEL_SPAN(level) - 1)) == 0 ? 0 : 1;
+        for (i = start; i < start + _WHEEL_SLOTS; i++)
+        {
+            if (!rt_list_isempty(&wheel->slot[level][(base + i) & _WHEEL_MASK]))
+            {
+                candidate = (base + i) << (RT_TIMER_WHEEL_SLOT_BITS * level);
+                if (candidate - wheel->tick < next - wheel->tick)
+                {
+                    next = candidate;
+                }
+                result = RT_EOK;
+                break;
+            }
+        }
+    }
+
+    rt_hw_interrupt_enable(irq_level);
+
+    *timeout_tick = next;
+
+    return result;
+}
+#else
 /**
  * @brief  Find the next emtpy timer ticks
  *
@@ -183,6 +375,7 @@ static rt_err_t _timer_list_next_timeout(rt_list_t timer_list[], rt_tick_t *time
 
     return -RT_ERROR;
 }
+#endif /* RT_USING_TIMER_WHEEL */
 
 /**
  * @brief Remove the timer
@@ -199,7 +392,7 @@ rt_inline void _timer_remove(rt_timer_t timer)
     }
 }
 
-#if (DBG_LVL == DBG_LOG)
+#if (DBG_LVL == DBG_LOG) && !defined(RT_USING_TIMER_WHEEL)
 /**
  * @brief The number of timer
  *
@@ -238,7 +431,7 @@ void rt_timer_dump(rt_list_t timer_heads[])
     }
     rt_kprintf("\n");
 }
-#endif /* (DBG_LVL == DBG_LOG) */
+#endif /* (DBG_LVL == DBG_LOG) && !defined(RT_USING_TIMER_WHEEL) */
 
 /**
  * @addtogroup Clock
@@ -410,13 +603,17 @@ RTM_EXPORT(rt_timer_delete);
  */
 rt_err_t rt_timer_start(rt_timer_t timer)
 {
+#ifdef RT_USING_TIMER_WHEEL
+    struct _timer_wheel *timer_wheel;
+#else
     unsigned int row_lvl;
     rt_list_t *timer_list;
-    rt_base_t level;
-    rt_bool_t need_schedule;
     rt_list_t *row_head[RT_TIMER_SKIP_LIST_LEVEL];
     unsigned int tst_nr;
     static unsigned int random_nr;
+#endif /* RT_USING_TIMER_WHEEL */
+    rt_base_t level;
+    rt_bool_t need_schedule;
 
     /* parameter check */
     RT_ASSERT(timer != RT_NULL);
@@ -435,6 +632,22 @@ rt_err_t rt_timer_start(rt_timer_t timer)
 
     timer->timeout_tick = rt_tick_get() + timer->init_tick;
 
+#ifdef RT_USING_TIMER_WHEEL
+#ifdef RT_USING_TIMER_SOFT
+    if (timer->parent.flag & RT_TIMER_FLAG_SOFT_TIMER)
+    {
+        /* insert timer to soft timer wheel */
+        timer_wheel = &_soft_timer_wheel;
+    }
+    else
+#endif /* RT_USING_TIMER_SOFT */
+    {
+        /* insert timer to system timer wheel */
+        timer_wheel = &_timer_wheel;
+    }
+
+    _timer_wheel_insert(timer_wheel, timer);
+#else
 #ifdef RT_USING_TIMER_SOFT
     if (timer->parent.flag & RT_TIMER_FLAG_SOFT_TIMER)
     {
@@ -498,6 +711,7 @@ rt_err_t rt_timer_start(rt_timer_t timer)
          * bits. */
         tst_nr >>= (RT_TIMER_SKIP_LIST_MASK + 1) >> 1;
     }
+#endif /* RT_USING_TIMER_WHEEL */
 
     timer->parent.flag |= RT_TIMER_FLAG_ACTIVATED;
 
@@ -648,6 +862,102 @@ RTM_EXPORT(rt_timer_control);
  *
  * @note This function shall be invoked in operating system timer interrupt.
  */
+#ifdef RT_USING_TIMER_WHEEL
+void rt_timer_check(void)
+{
+    struct rt_timer *t;
+    rt_tick_t current_tick;
+    rt_tick_t tick;
+    rt_base_t level;
+    rt_list_t expired;
+    rt_list_t list;
+
+    rt_list_init(&expired);
+    rt_list_init(&list);
+
+    LOG_D("timer check enter");
+
+    current_tick = rt_tick_get();
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    /* a nested call leaves the ticks to the catch-up already running */
+    if (_timer_check_busy)
+    {
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+    _timer_check_busy = 1;
+
+    /* process every tick up to the current one, there are more after a tick jump */
+    while ((current_tick - _timer_wheel.tick) < RT_TICK_MAX / 2)
+    {
+        tick = _timer_wheel_advance(&_timer_wheel, &expired);
+
+        while (!rt_list_isempty(&expired))
+        {
+            t = rt_list_entry(expired.next, struct rt_timer, row[0]);
+
+            /* a timer parked beyond the wheel is not due yet, place it again */
+            if ((tick - t->timeout_tick) >= RT_TICK_MAX / 2)
+            {
+                rt_list_remove(&(t->row[0]));
+                _timer_wheel_insert(&_timer_wheel, t);
+                continue;
+            }
+
+            RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
+
+            /* remove timer from the expired list firstly */
+            _timer_remove(t);
+            if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
+            {
+                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+            }
+            /* add timer to temporary list  */
+            rt_list_insert_after(&list, &(t->row[0]));
+            /* call timeout function */
+            t->timeout_func(t->parameter);
+
+            RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
+
+            /* Check whether the timer object is detached or started again */
+            if (rt_list_isempty(&list))
+            {
+                continue;
+            }
+            rt_list_remove(&(t->row[0]));
+            if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
+                (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
+            {
+                /* start it */
+                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+                rt_timer_start(t);
+            }
+        }
+
+        /*
+         * let the interrupts in between the ticks of a catch-up, after a long
+         * critical section the latency stays that of one tick, not of all the
+         * missed ones
+         */
+        rt_hw_interrupt_enable(level);
+        level = rt_hw_interrupt_disable();
+
+        /* re-get tick */
+        current_tick = rt_tick_get();
+        LOG_D("current tick: %d", current_tick);
+    }
+
+    _timer_check_busy = 0;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    LOG_D("timer check leave");
+}
+#else
 void rt_timer_check(void)
 {
     struct rt_timer *t;
@@ -716,16 +1026,27 @@ void rt_timer_check(void)
 
     LOG_D("timer check leave");
 }
+#endif /* RT_USING_TIMER_WHEEL */
 
 /**
  * @brief This function will return the next timeout tick in the system.
  *
+ * @note With RT_USING_TIMER_WHEEL it may be a tick at which timers are only
+ *       cascaded, which is never later than the real timeout.
+ *
  * @return the next timeout tick in the system
  */
 rt_tick_t rt_timer_next_timeout_tick(void)
 {
     rt_tick_t next_timeout = RT_TICK_MAX;
+#ifdef RT_USING_TIMER_WHEEL
+    if (_timer_wheel_next_timeout(&_timer_wheel, &next_timeout) != RT_EOK)
+    {
+        next_timeout = RT_TICK_MAX;
+    }
+#else
     _timer_list_next_timeout(_timer_list, &next_timeout);
+#endif /* RT_USING_TIMER_WHEEL */
     return next_timeout;
 }
 
@@ -734,6 +1055,93 @@ rt_tick_t rt_timer_next_timeout_tick(void)
  * @brief This function will check software-timer list, if a timeout event happens, the
  *        corresponding timeout function will be invoked.
  */
+#ifdef RT_USING_TIMER_WHEEL
+void rt_soft_timer_check(void)
+{
+    rt_tick_t current_tick;
+    rt_tick_t tick;
+    struct rt_timer *t;
+    rt_base_t level;
+    rt_list_t expired;
+    rt_list_t list;
+
+    rt_list_init(&expired);
+    rt_list_init(&list);
+
+    LOG_D("software timer check enter");
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    current_tick = rt_tick_get();
+    while ((current_tick - _soft_timer_wheel.tick) < RT_TICK_MAX / 2)
+    {
+        tick = _timer_wheel_advance(&_soft_timer_wheel, &expired);
+
+        while (!rt_list_isempty(&expired))
+        {
+            t = rt_list_entry(expired.next, struct rt_timer, row[0]);
+
+            /* a timer parked beyond the wheel is not due yet, place it again */
+            if ((tick - t->timeout_tick) >= RT_TICK_MAX / 2)
+            {
+                rt_list_remove(&(t->row[0]));
+                _timer_wheel_insert(&_soft_timer_wheel, t);
+                continue;
+            }
+
+            RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
+
+            /* remove timer from the expired list firstly */
+            _timer_remove(t);
+            if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
+            {
+                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+            }
+            /* add timer to temporary list  */
+            rt_list_insert_after(&list, &(t->row[0]));
+
+            _soft_timer_status = RT_SOFT_TIMER_BUSY;
+            /* enable interrupt */
+            rt_hw_interrupt_enable(level);
+
+            /* call timeout function */
+            t->timeout_func(t->parameter);
+
+            RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
+
+            /* disable interrupt */
+            level = rt_hw_interrupt_disable();
+
+            _soft_timer_status = RT_SOFT_TIMER_IDLE;
+            /* Check whether the timer object is detached or started again */
+            if (rt_list_isempty(&list))
+            {
+                continue;
+            }
+            rt_list_remove(&(t->row[0]));
+            if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
+                (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
+            {
+                /* start it */
+                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+                rt_timer_start(t);
+            }
+        }
+
+        /* let the interrupts in between the ticks of a catch-up */
+        rt_hw_interrupt_enable(level);
+        level = rt_hw_interrupt_disable();
+
+        current_tick = rt_tick_get();
+        LOG_D("current tick: %d", current_tick);
+    }
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    LOG_D("software timer check leave");
+}
+#else
 void rt_soft_timer_check(void)
 {
     rt_tick_t current_tick;
@@ -807,6 +1215,7 @@ void rt_soft_timer_check(void)
 
     LOG_D("software timer check leave");
 }
+#endif /* RT_USING_TIMER_WHEEL */
 
 /**
  * @brief System timer thread entry
@@ -820,7 +1229,11 @@ static void _timer_thread_entry(void *parameter)
     while (1)
     {
         /* get the next timeout tick */
+#ifdef RT_USING_TIMER_WHEEL
+        if (_timer_wheel_next_timeout(&_soft_timer_wheel, &next_timeout) != RT_EOK)
+#else
         if (_timer_list_next_timeout(_soft_timer_list, &next_timeout) != RT_EOK)
+#endif /* RT_USING_TIMER_WHEEL */
         {
             /* no software timer exist, suspend self. */
             rt_thread_suspend_with_flag(rt_thread_self(), RT_UNINTERRUPTIBLE);
@@ -854,12 +1267,16 @@ static void _timer_thread_entry(void *parameter)
  */
 void rt_system_timer_init(void)
 {
+#ifdef RT_USING_TIMER_WHEEL
+    _timer_wheel_init(&_timer_wheel);
+#else
     rt_size_t i;
 
     for (i = 0; i < sizeof(_timer_list) / sizeof(_timer_list[0]); i++)
     {
         rt_list_init(_timer_list + i);
     }
+#endif /* RT_USING_TIMER_WHEEL */
 }
 
 /**
@@ -870,6 +1287,9 @@ void rt_system_timer_init(void)
 void rt_system_timer_thread_init(void)
 {
 #ifdef RT_USING_TIMER_SOFT
+#ifdef RT_USING_TIMER_WHEEL
+    _timer_wheel_init(&_soft_timer_wheel);
+#else
     int i;
 
     for (i = 0;
@@ -878,6 +1298,7 @@ void rt_system_timer_thread_init(void)
     {
         rt_list_init(_soft_timer_list + i);
     }
+#endif /* RT_USING_TIMER_WHEEL */
 
     /* start software timer thread */
     rt_thread_init(&_timer_thread,
@@ -0,0 +1,545 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-04-16     Lee          the first version
+ */
+
+/*
+ * Two-level segregated fit (TLSF) memory allocator.
+ *
+ * Free blocks are kept in segregated lists: the first level splits sizes
+ * by powers of two, the second level splits every power of two into
+ * TLSF_SL_COUNT linear ranges. A bitmap for each level tells which
+ * lists are not empty, so a fitting list is found with two bit scans and
+ * malloc and free run in bounded time, independent of the heap history.
+ *
+ * Every block starts with a header holding the previous physical block
+ * and the payload size; the lowest bit of the size marks a free block.
+ * Free blocks additionally link themselves into their list in the payload.
+ * Adjacent free blocks are always merged on free, and a used sentinel
+ * block at the end of the pool stops the merge.
+ *
+ * Reference: M. Masmano, I. Ripoll, A. Crespo, J. Real, "TLSF: a New Dynamic
+ * Memory Allocator for Real-Time Systems", ECRTS 2004.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#if defined (RT_USING_TLSF)
+
+#define DBG_TAG           "kernel.tlsf"
+#define DBG_LVL           DBG_INFO
+#include <rtdbg.h>
+
+#ifndef RT_TLSF_MAX_BLOCK_BITS
+#define RT_TLSF_MAX_BLOCK_BITS  20
+#endif /* RT_TLSF_MAX_BLOCK_BITS */
+
+/* log2 of the second level list count */
+#define TLSF_SL_COUNT_LOG2      4
+#define TLSF_SL_COUNT           (1UL << TLSF_SL_COUNT_LOG2)
+
+#if RT_ALIGN_SIZE == 4
+#define TLSF_ALIGN_LOG2         2
+#elif RT_ALIGN_SIZE == 8
+#define TLSF_ALIGN_LOG2         3
+#elif RT_ALIGN_SIZE == 16
+#define TLSF_ALIGN_LOG2         4
+#else
+#error "TLSF supports RT_ALIGN_SIZE 4, 8 or 16"
+#endif
+#define TLSF_ALIGN              (1UL << TLSF_ALIGN_LOG2)
+
+/* sizes below TLSF_SMALL_SIZE share the first list of the first level, linearly split */
+#define TLSF_FL_SHIFT           (TLSF_SL_COUNT_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_SMALL_SIZE         (1UL << TLSF_FL_SHIFT)
+#define TLSF_FL_COUNT           (RT_TLSF_MAX_BLOCK_BITS - TLSF_FL_SHIFT + 1)
+/* every block is smaller than this */
+#define TLSF_BLOCK_SIZE_MAX     (1UL << RT_TLSF_MAX_BLOCK_BITS)
+
+#define TLSF_BLOCK_FREE         0x1UL
+#define TLSF_SIZE_MASK          (~(TLSF_ALIGN - 1))
+
+struct rt_tlsf_block
+{
+    struct rt_tlsf_block       *prev_phys;              /**< previous physical block */
+    rt_size_t                   size;                   /**< payload size, the lowest bit is TLSF_BLOCK_FREE */
+    /* the free list links only exist in free blocks, they are part of the payload */
+    struct rt_tlsf_block       *next_free;              /**< next free block in the same list */
+    struct rt_tlsf_block       *prev_free;              /**< previous free block in the same list */
+};
+
+#define TLSF_HEADER_SIZE        RT_ALIGN(2 * sizeof(void *), TLSF_ALIGN)
+#define TLSF_PAYLOAD_MIN        RT_ALIGN(2 * sizeof(void *), TLSF_ALIGN)
+
+/**
+ * Base structure of TLSF memory object
+ */
+struct rt_tlsf
+{
+    struct rt_memory            parent;                 /**< inherit from rt_memory */
+    struct rt_tlsf_block       *heap_begin;             /**< the first block */
+    struct rt_tlsf_block       *heap_end;               /**< the sentinel block */
+    rt_uint32_t                 fl_bitmap;              /**< the first levels having free blocks */
+    rt_uint32_t                 sl_bitmap[TLSF_FL_COUNT];
+    struct rt_tlsf_block       *blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+};
+
+#define BLOCK_SIZE(_block)      ((_block)->size & TLSF_SIZE_MASK)
+#define BLOCK_IS_FREE(_block)   ((_block)->size & TLSF_BLOCK_FREE)
+#define BLOCK_PAYLOAD(_block)   ((void *)((rt_uint8_t *)(_block) + TLSF_HEADER_SIZE))
+#define BLOCK_FROM_PAYLOAD(_p)  ((struct rt_tlsf_block *)((rt_uint8_t *)(_p) - TLSF_HEADER_SIZE))
+#define BLOCK_NEXT(_block)      \
+    ((struct rt_tlsf_block *)((rt_uint8_t *)(_block) + TLSF_HEADER_SIZE + BLOCK_SIZE(_block)))
+
+/* index of the least significant set bit, value is not 0 */
+rt_inline int _tlsf_ffs(rt_uint32_t value)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(value);
+#else
+    return __rt_ffs((int)value) - 1;
+#endif
+}
+
+/* index of the most significant set bit, value is not 0 */
+rt_inline int _tlsf_fls(rt_size_t value)
+{
+#if defined(__GNUC__)
+    return (int)(sizeof(unsigned long) * 8) - 1 - __builtin_clzl((unsigned long)value);
+#else
+    int bit = 0;
+
+    while (value >>= 1)
+    {
+        bit++;
+    }
+
+    return bit;
+#endif
+}
+
+/* the list of a free block of this size */
+rt_inline void _tlsf_mapping_insert(rt_size_t size, int *fl, int *sl)
+{
+    if (size < TLSF_SMALL_SIZE)
+    {
+        *fl = 0;
+        *sl = (int)(size >> TLSF_ALIGN_LOG2);
+    }
+    else
+    {
+        int bit = _tlsf_fls(size);
+
+        *sl = (int)(size >> (bit - TLSF_SL_COUNT_LOG2)) ^ (int)TLSF_SL_COUNT;
+        *fl = bit - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+/* the first list whose every block fits this size */
+rt_inline void _tlsf_mapping_search(rt_size_t size, int *fl, int *sl)
+{
+    if (size >= TLSF_SMALL_SIZE)
+    {
+        size += (1UL << (_tlsf_fls(size) - TLSF_SL_COUNT_LOG2)) - 1;
+    }
+    _tlsf_mapping_insert(size, fl, sl);
+}
+
+static void _tlsf_remove_free(struct rt_tlsf *tlsf, struct rt_tlsf_block *block, int fl, int sl)
+{
+    struct rt_tlsf_block *prev = block->prev_free;
+    struct rt_tlsf_block *next = block->next_free;
+
+    if (next != RT_NULL)
+    {
+        next->prev_free = prev;
+    }
+    if (prev != RT_NULL)
+    {
+        prev->next_free = next;
+    }
+    else
+    {
+        /* it is the head of the list */
+        tlsf->blocks[fl][sl] = next;
+        if (next == RT_NULL)
+        {
+            tlsf->sl_bitmap[fl] &= ~(1UL << sl);
+            if (tlsf->sl_bitmap[fl] == 0)
+            {
+                tlsf->fl_bitmap &= ~(1UL << fl);
+            }
+        }
+    }
+}
+
+static void _tlsf_insert_free(struct rt_tlsf *tlsf, struct rt_tlsf_block *block)
+{
+    struct rt_tlsf_block *head;
+    int fl, sl;
+
+    _tlsf_mapping_insert(BLOCK_SIZE(block), &fl, &sl);
+    head = tlsf->blocks[fl][sl];
+
+    block->size |= TLSF_BLOCK_FREE;
+    block->prev_free = RT_NULL;
+    block->next_free = head;
+    if (head != RT_NULL)
+    {
+        head->prev_free = block;
+    }
+    tlsf->blocks[fl][sl] = block;
+    tlsf->fl_bitmap |= (1UL << fl);
+    tlsf->sl_bitmap[fl] |= (1UL << sl);
+}
+
+/* take a free block out of its list */
+rt_inline void _tlsf_take_free(struct rt_tlsf *tlsf, struct rt_tlsf_block *block)
+{
+    int fl, sl;
+
+    _tlsf_mapping_insert(BLOCK_SIZE(block), &fl, &sl);
+    _tlsf_remove_free(tlsf, block, fl, sl);
+    block->size &= ~TLSF_BLOCK_FREE;
+}
+
+/* cut the payload of a block to size, the rest becomes a free block when it is large enough */
+static void _tlsf_trim(struct rt_tlsf *tlsf, struct rt_tlsf_block *block, rt_size_t size)
+{
+    struct rt_tlsf_block *rest;
+    struct rt_tlsf_block *next;
+
+    if (BLOCK_SIZE(block) < size + TLSF_HEADER_SIZE + TLSF_PAYLOAD_MIN)
+    {
+        return;
+    }
+
+    rest = (struct rt_tlsf_block *)((rt_uint8_t *)BLOCK_PAYLOAD(block) + size);
+    rest->size = BLOCK_SIZE(block) - size - TLSF_HEADER_SIZE;
+    rest->prev_phys = block;
+    block->size = size;
+
+    /* merge the rest with a free block behind it */
+    next = BLOCK_NEXT(rest);
+    if (BLOCK_IS_FREE(next))
+    {
+        _tlsf_take_free(tlsf, next);
+        rest->size += TLSF_HEADER_SIZE + BLOCK_SIZE(next);
+        next = BLOCK_NEXT(rest);
+    }
+    next->prev_phys = rest;
+
+    _tlsf_insert_free(tlsf, rest);
+}
+
+/**
+ * @brief This function will initialize TLSF memory management algorithm.
+ *
+ * @param name is the name of the TLSF memory management object.
+ *
+ * @param begin_addr the beginning address of memory.
+ *
+ * @param size is the size of the memory.
+ *
+ * @return Return a pointer to the memory object. When the return value is RT_NULL, it means the init failed.
+ */
+rt_tlsf_t rt_tlsf_init(const char *name, void *begin_addr, rt_size_t size)
+{
+    struct rt_tlsf *tlsf;
+    struct rt_tlsf_block *block;
+    rt_ubase_t begin_align, end_align;
+    rt_size_t mem_size;
+
+    tlsf = (struct rt_tlsf *)RT_ALIGN((rt_ubase_t)begin_addr, RT_ALIGN_SIZE);
+    begin_align = RT_ALIGN((rt_ubase_t)tlsf + sizeof(*tlsf), TLSF_ALIGN);
+    end_align   = RT_ALIGN_DOWN((rt_ubase_t)begin_addr + size, TLSF_ALIGN);
+
+    /* the first block, its payload and the sentinel must fit */
+    if (end_align < begin_align + 2 * TLSF_HEADER_SIZE + TLSF_PAYLOAD_MIN)
+    {
+        rt_kprintf("tlsf init, error begin address 0x%x, and end address 0x%x\n",
+                   (rt_ubase_t)begin_addr, (rt_ubase_t)begin_addr + size);
+
+        return RT_NULL;
+    }
+
+    mem_size = end_align - begin_align - 2 * TLSF_HEADER_SIZE;
+    if (mem_size >= TLSF_BLOCK_SIZE_MAX)
+    {
+        LOG_W("tlsf init, only %d of %d bytes are used, enlarge RT_TLSF_MAX_BLOCK_BITS",
+              TLSF_BLOCK_SIZE_MAX - TLSF_ALIGN, mem_size);
+        mem_size = TLSF_BLOCK_SIZE_MAX - TLSF_ALIGN;
+    }
+
+    rt_memset(tlsf, 0, sizeof(*tlsf));
+    /* initialize TLSF memory object */
+    rt_object_init(&(tlsf->parent.parent), RT_Object_Class_Memory, name);
+    tlsf->parent.algorithm = "tlsf";
+    tlsf->parent.address = begin_align;
+    tlsf->parent.total = mem_size;
+
+    /* one free block covers the whole pool */
+    block = (struct rt_tlsf_block *)begin_align;
+    block->prev_phys = RT_NULL;
+    block->size = mem_size;
+    tlsf->heap_begin = block;
+
+    /* the used sentinel block stops the merge */
+    tlsf->heap_end = BLOCK_NEXT(block);
+    tlsf->heap_end->prev_phys = block;
+    tlsf->heap_end->size = 0;
+
+    _tlsf_insert_free(tlsf, block);
+
+    LOG_D("tlsf init, heap begin address 0x%x, size %d", begin_align, mem_size);
+
+    return &tlsf->parent;
+}
+RTM_EXPORT(rt_tlsf_init);
+
+/**
+ * @brief This function will remove a TLSF memory object from the system.
+ *
+ * @param m the TLSF memory management object.
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_tlsf_detach(rt_tlsf_t m)
+{
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+
+    rt_object_detach(&(m->parent));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_tlsf_detach);
+
+/**
+ * @addtogroup MM
+ */
+
+/**@{*/
+
+/**
+ * @brief Allocate a block of memory with a minimum of 'size' bytes.
+ *
+ * @param m the TLSF memory management object.
+ *
+ * @param size is the minimum size of the requested block in bytes.
+ *
+ * @return the pointer to allocated memory or NULL if no free memory was found.
+ */
+void *rt_tlsf_alloc(rt_tlsf_t m, rt_size_t size)
+{
+    struct rt_tlsf *tlsf;
+    struct rt_tlsf_block *block;
+    rt_uint32_t map;
+    int fl, sl;
+
+    if (size == 0)
+        return RT_NULL;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+
+    tlsf = (struct rt_tlsf *)m;
+    if (size >= TLSF_BLOCK_SIZE_MAX)
+    {
+        LOG_D("no memory");
+
+        return RT_NULL;
+    }
+
+    /* alignment size, every free block must hold the list links */
+    size = RT_ALIGN(size, TLSF_ALIGN);
+    if (size < TLSF_PAYLOAD_MIN)
+        size = TLSF_PAYLOAD_MIN;
+
+    _tlsf_mapping_search(size, &fl, &sl);
+    if (fl >= TLSF_FL_COUNT)
+    {
+        LOG_D("no memory");
+
+        return RT_NULL;
+    }
+
+    /* the first non-empty list at or above (fl, sl) */
+    map = tlsf->sl_bitmap[fl] & (~0UL << sl);
+    if (map == 0)
+    {
+        map = tlsf->fl_bitmap & (~0UL << (fl + 1));
+        if (map == 0)
+        {
+            LOG_D("no memory");
+
+            return RT_NULL;
+        }
+        fl = _tlsf_ffs(map);
+        map = tlsf->sl_bitmap[fl];
+    }
+    sl = _tlsf_ffs(map);
+
+    block = tlsf->blocks[fl][sl];
+    RT_ASSERT(block != RT_NULL && BLOCK_SIZE(block) >= size);
+    _tlsf_remove_free(tlsf, block, fl, sl);
+    block->size &= ~TLSF_BLOCK_FREE;
+
+    _tlsf_trim(tlsf, block, size);
+
+    tlsf->parent.used += BLOCK_SIZE(block) + TLSF_HEADER_SIZE;
+    if (tlsf->parent.max < tlsf->parent.used)
+        tlsf->parent.max = tlsf->parent.used;
+
+    LOG_D("allocate memory at 0x%x, size: %d", (rt_ubase_t)BLOCK_PAYLOAD(block), BLOCK_SIZE(block));
+
+    return BLOCK_PAYLOAD(block);
+}
+RTM_EXPORT(rt_tlsf_alloc);
+
+/**
+ * @brief This function will release the previously allocated memory block by
+ *        rt_tlsf_alloc. The released memory block is taken back to the TLSF heap.
+ *
+ * @param m the TLSF memory management object.
+ *
+ * @param rmem the address of memory which will be released.
+ */
+void rt_tlsf_free(rt_tlsf_t m, void *rmem)
+{
+    struct rt_tlsf *tlsf;
+    struct rt_tlsf_block *block;
+    struct rt_tlsf_block *neighbor;
+
+    if (rmem == RT_NULL)
+        return;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+    RT_ASSERT((((rt_ubase_t)rmem) & (TLSF_ALIGN - 1)) == 0);
+
+    tlsf = (struct rt_tlsf *)m;
+    block = BLOCK_FROM_PAYLOAD(rmem);
+    RT_ASSERT(block >= tlsf->heap_begin && block < tlsf->heap_end);
+    /* ... which has to be in a used state ... */
+    RT_ASSERT(!BLOCK_IS_FREE(block));
+    RT_ASSERT(BLOCK_NEXT(block)->prev_phys == block);
+
+    LOG_D("release memory 0x%x, size: %d", (rt_ubase_t)rmem, BLOCK_SIZE(block));
+
+    tlsf->parent.used -= BLOCK_SIZE(block) + TLSF_HEADER_SIZE;
+
+    /* merge with the free neighbors */
+    neighbor = block->prev_phys;
+    if (neighbor != RT_NULL && BLOCK_IS_FREE(neighbor))
+    {
+        _tlsf_take_free(tlsf, neighbor);
+        neighbor->size += TLSF_HEADER_SIZE + BLOCK_SIZE(block);
+        block = neighbor;
+    }
+    neighbor = BLOCK_NEXT(block);
+    if (BLOCK_IS_FREE(neighbor))
+    {
+        _tlsf_take_free(tlsf, neighbor);
+        block->size += TLSF_HEADER_SIZE + BLOCK_SIZE(neighbor);
+    }
+    BLOCK_NEXT(block)->prev_phys = block;
+
+    _tlsf_insert_free(tlsf, block);
+}
+RTM_EXPORT(rt_tlsf_free);
+
+/**
+ * @brief This function will change the size of previously allocated memory block.
+ *
+ * @param m the TLSF memory management object.
+ *
+ * @param rmem is the pointer to memory allocated by rt_tlsf_alloc.
+ *
+ * @param newsize is the required new size.
+ *
+ * @return the changed memory block address.
+ */
+void *rt_tlsf_realloc(rt_tlsf_t m, void *rmem, rt_size_t newsize)
+{
+    struct rt_tlsf *tlsf;
+    struct rt_tlsf_block *block;
+    struct rt_tlsf_block *next;
+    rt_size_t size;
+    void *nmem;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+
+    tlsf = (struct rt_tlsf *)m;
+    if (newsize >= TLSF_BLOCK_SIZE_MAX)
+    {
+        LOG_D("realloc: out of memory");
+
+        return RT_NULL;
+    }
+    else if (newsize == 0)
+    {
+        rt_tlsf_free(m, rmem);
+        return RT_NULL;
+    }
+
+    /* allocate a new memory block */
+    if (rmem == RT_NULL)
+        return rt_tlsf_alloc(m, newsize);
+
+    block = BLOCK_FROM_PAYLOAD(rmem);
+    RT_ASSERT(block >= tlsf->heap_begin && block < tlsf->heap_end);
+    RT_ASSERT(!BLOCK_IS_FREE(block));
+
+    newsize = RT_ALIGN(newsize, TLSF_ALIGN);
+    if (newsize < TLSF_PAYLOAD_MIN)
+        newsize = TLSF_PAYLOAD_MIN;
+
+    size = BLOCK_SIZE(block);
+    next = BLOCK_NEXT(block);
+    if (newsize > size && BLOCK_IS_FREE(next) &&
+        size + TLSF_HEADER_SIZE + BLOCK_SIZE(next) >= newsize)
+    {
+        /* grow in place into the free block behind */
+        _tlsf_take_free(tlsf, next);
+        block->size += TLSF_HEADER_SIZE + BLOCK_SIZE(next);
+        BLOCK_NEXT(block)->prev_phys = block;
+    }
+
+    if (newsize <= BLOCK_SIZE(block))
+    {
+        _tlsf_trim(tlsf, block, newsize);
+
+        tlsf->parent.used = tlsf->parent.used - size + BLOCK_SIZE(block);
+        if (tlsf->parent.max < tlsf->parent.used)
+            tlsf->parent.max = tlsf->parent.used;
+
+        return rmem;
+    }
+
+    /* expand memory */
+    nmem = rt_tlsf_alloc(m, newsize);
+    if (nmem != RT_NULL) /* check memory */
+    {
+        rt_memcpy(nmem, rmem, size);
+        rt_tlsf_free(m, rmem);
+    }
+
+    return nmem;
+}
+RTM_EXPORT(rt_tlsf_realloc);
+
+/**@}*/
+
+#endif /* defined (RT_USING_TLSF) */
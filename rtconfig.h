@@ -36,6 +36,8 @@
 
 #define RT_USING_MEMPOOL
 #define RT_USING_SMALL_MEM
+#define RT_USING_TLSF
+#define RT_TLSF_MAX_BLOCK_BITS 20
 #define RT_USING_SMALL_MEM_AS_HEAP
 #define RT_USING_HEAP
 
@@ -75,11 +77,15 @@
 
 /* DFS: device virtual file system */
 
+#define RT_USING_FAL
+#define FAL_DEBUG 0
+#define FAL_PART_HAS_TABLE_CFG
 
 /* Device Drivers */
 
 #define RT_USING_DEVICE_IPC
 #define RT_UNAMED_PIPE_NUMBER 64
+#define RT_DOORBELL_USING_HIGH_WATER
 #define RT_USING_SERIAL
 #define RT_USING_SERIAL_V2
 #define RT_SERIAL_USING_DMA
@@ -114,6 +120,7 @@
 
 /* Utilities */
 
+#define RT_USING_RYM
 
 /* RT-Thread online packages */
 
@@ -247,6 +254,7 @@
 /* On-chip Peripheral Drivers */
 
 #define BSP_USING_GPIO
+#define BSP_USING_ON_CHIP_FLASH
 #define BSP_USING_UART
 #define BSP_USING_UART1
 #define BSP_UART1_RX_USING_DMA
@@ -262,5 +270,10 @@
 #define INTERFACE_CFG_CAN_THREAD_PRO 20
 #define INTERFACE_CFG_CAN_THREAD_SIZE 1024
 #define INTERFACE_CFG_CAN_THREAD_CPU_SECTION 20
+#define INTERFACE_CFG_CAN_ROUTE_TABLE
+
+/* Application Config */
+
+#define INTERFACE_CFG_USING_PROFILER
 
 #endif